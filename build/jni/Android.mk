@@ -25,19 +25,29 @@ LOCAL_SRC_FILES :=$(LOCAL_PATH)/../../ouzel/android/ApplicationAndroid.cpp \
     $(LOCAL_PATH)/../../ouzel/animators/Sequence.cpp \
     $(LOCAL_PATH)/../../ouzel/animators/Shake.cpp \
     $(LOCAL_PATH)/../../ouzel/audio/Audio.cpp \
+    $(LOCAL_PATH)/../../ouzel/audio/Convert.cpp \
+    $(LOCAL_PATH)/../../ouzel/audio/Decoder.cpp \
+    $(LOCAL_PATH)/../../ouzel/audio/FileSink.cpp \
+    $(LOCAL_PATH)/../../ouzel/audio/Mixer.cpp \
     $(LOCAL_PATH)/../../ouzel/audio/Sound.cpp \
     $(LOCAL_PATH)/../../ouzel/audio/SoundData.cpp \
+    $(LOCAL_PATH)/../../ouzel/audio/WaveDecoder.cpp \
     $(LOCAL_PATH)/../../ouzel/core/Application.cpp \
     $(LOCAL_PATH)/../../ouzel/core/Cache.cpp \
     $(LOCAL_PATH)/../../ouzel/core/Engine.cpp \
     $(LOCAL_PATH)/../../ouzel/core/Window.cpp \
+    $(LOCAL_PATH)/../../ouzel/events/Event.cpp \
     $(LOCAL_PATH)/../../ouzel/events/EventDispatcher.cpp \
     $(LOCAL_PATH)/../../ouzel/events/EventHandler.cpp \
+    $(LOCAL_PATH)/../../ouzel/events/EventQueue.cpp \
+    $(LOCAL_PATH)/../../ouzel/files/Archive.cpp \
     $(LOCAL_PATH)/../../ouzel/files/FileSystem.cpp \
+    $(LOCAL_PATH)/../../ouzel/files/FileView.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/BlendState.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/Color.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/Image.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/MeshBuffer.cpp \
+    $(LOCAL_PATH)/../../ouzel/graphics/PixelFormat.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/Renderer.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/RenderTarget.cpp \
     $(LOCAL_PATH)/../../ouzel/graphics/Shader.cpp \
@@ -48,6 +58,8 @@ LOCAL_SRC_FILES :=$(LOCAL_PATH)/../../ouzel/android/ApplicationAndroid.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/CheckBox.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/ComboBox.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/EditBox.cpp \
+    $(LOCAL_PATH)/../../ouzel/gui/Font.cpp \
+    $(LOCAL_PATH)/../../ouzel/gui/GlyphAtlas.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/Label.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/Menu.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/Popup.cpp \
@@ -55,6 +67,8 @@ LOCAL_SRC_FILES :=$(LOCAL_PATH)/../../ouzel/android/ApplicationAndroid.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/ScrollArea.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/ScrollBar.cpp \
 	$(LOCAL_PATH)/../../ouzel/gui/SlideBar.cpp \
+    $(LOCAL_PATH)/../../ouzel/gui/TTFont.cpp \
+    $(LOCAL_PATH)/../../ouzel/gui/TextLayout.cpp \
     $(LOCAL_PATH)/../../ouzel/gui/Widget.cpp \
     $(LOCAL_PATH)/../../ouzel/input/Gamepad.cpp \
     $(LOCAL_PATH)/../../ouzel/input/Input.cpp \
@@ -77,7 +91,6 @@ LOCAL_SRC_FILES :=$(LOCAL_PATH)/../../ouzel/android/ApplicationAndroid.cpp \
     $(LOCAL_PATH)/../../ouzel/opengl/ShaderOGL.cpp \
     $(LOCAL_PATH)/../../ouzel/opengl/TextureOGL.cpp \
     $(LOCAL_PATH)/../../ouzel/opensl/AudioSL.cpp \
-    $(LOCAL_PATH)/../../ouzel/opensl/SoundSL.cpp \
     $(LOCAL_PATH)/../../ouzel/opensl/SoundDataSL.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/Camera.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/Component.cpp \
@@ -86,12 +99,17 @@ LOCAL_SRC_FILES :=$(LOCAL_PATH)/../../ouzel/android/ApplicationAndroid.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/NodeContainer.cpp \
 	$(LOCAL_PATH)/../../ouzel/scene/ParticleDefinition.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/ParticleSystem.cpp \
+    $(LOCAL_PATH)/../../ouzel/scene/ParticleWorld.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/Scene.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/SceneManager.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/ShapeDrawable.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/Sprite.cpp \
+    $(LOCAL_PATH)/../../ouzel/scene/SpriteAnimationSystem.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/SpriteFrame.cpp \
+    $(LOCAL_PATH)/../../ouzel/scene/TextBatch.cpp \
     $(LOCAL_PATH)/../../ouzel/scene/TextDrawable.cpp \
+    $(LOCAL_PATH)/../../ouzel/scene/TileMap.cpp \
+    $(LOCAL_PATH)/../../ouzel/utils/Compression.cpp \
     $(LOCAL_PATH)/../../ouzel/utils/Utils.cpp
 
 include $(BUILD_STATIC_LIBRARY)
@@ -458,8 +458,7 @@ namespace ouzel
             std::shared_ptr<GamepadApple> gamepad(new GamepadApple(controller));
             gamepads.push_back(gamepad);
 
-            Event event;
-            event.type = Event::Type::GAMEPAD_CONNECT;
+            Event event(Event::Type::GAMEPAD_CONNECT);
 
             event.gamepadEvent.gamepad = gamepad;
 
@@ -474,8 +473,7 @@ namespace ouzel
 
             if (i != gamepads.end())
             {
-                Event event;
-                event.type = Event::Type::GAMEPAD_DISCONNECT;
+                Event event(Event::Type::GAMEPAD_DISCONNECT);
 
                 event.gamepadEvent.gamepad = *i;
 
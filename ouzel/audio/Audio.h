@@ -4,6 +4,7 @@
 #pragma once
 
 #include "utils/Types.h"
+#include "audio/Mixer.h"
 
 #ifdef OPENAL
 #undef OPENAL
@@ -38,10 +39,14 @@ namespace ouzel
 
             bool isReady() const { return ready; }
 
+            // the sounds of every backend are mixed by the mixer and output as one stream
+            Mixer& getMixer() { return mixer; }
+
         protected:
             Audio(Driver pDriver = Driver::NONE);
 
             Driver driver;
+            Mixer mixer;
 
             bool ready = false;
         };
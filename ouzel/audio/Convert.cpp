@@ -0,0 +1,650 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Convert.h"
+#include "math/MathUtils.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+        // rounds to the nearest integer like the SSE conversion and lrint, vcvtq_s32_f32 truncates towards zero
+        static inline int32x4_t roundToInt(float32x4_t value)
+        {
+#if OUZEL_SUPPORTS_NEON64
+            return vcvtnq_s32_f32(value);
+#else
+            // ARMv7 has no conversion that rounds, so a half with the sign of the value is added before truncating
+            // (halfway cases are rounded away from zero instead of to even)
+            uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(value), vdupq_n_u32(0x80000000));
+            float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vdupq_n_f32(0.5f)), sign));
+            return vcvtq_s32_f32(vaddq_f32(value, half));
+#endif
+        }
+#endif
+
+        static void convert8ToFloat(const uint8_t* input, uint32_t count, float* output, float scale)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                int16x8_t bias = vdupq_n_s16(128);
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    int16x8_t sample8 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(input + i))), bias);
+
+                    vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(sample8))), scale));
+                    vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(sample8))), scale));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(scale);
+            __m128i bias = _mm_set1_epi16(128);
+            __m128i zero = _mm_setzero_si128();
+
+            for (; i + 16 <= count; i += 16)
+            {
+                __m128i sample16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+                // 8-bit samples are unsigned
+                __m128i low8 = _mm_sub_epi16(_mm_unpacklo_epi8(sample16, zero), bias);
+                __m128i high8 = _mm_sub_epi16(_mm_unpackhi_epi8(sample16, zero), bias);
+
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(low8, low8), 16)), scale4));
+                _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(low8, low8), 16)), scale4));
+                _mm_storeu_ps(output + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(high8, high8), 16)), scale4));
+                _mm_storeu_ps(output + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(high8, high8), 16)), scale4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = (static_cast<int32_t>(input[i]) - 128) * scale;
+            }
+        }
+
+        static void convert16ToFloat(const int16_t* input, uint32_t count, float* output, float scale)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 8 <= count; i += 8)
+                {
+                    int16x8_t sample8 = vld1q_s16(input + i);
+
+                    vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(sample8))), scale));
+                    vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(sample8))), scale));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(scale);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128i sample8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+                // sign extended to 32 bits by shifting the duplicated value
+                __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(sample8, sample8), 16);
+                __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(sample8, sample8), 16);
+
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale4));
+                _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = input[i] * scale;
+            }
+        }
+
+        static inline int32_t read24(const uint8_t* input)
+        {
+            // the sign is extended by shifting the value to the top of the 32 bits and back
+            return static_cast<int32_t>(static_cast<uint32_t>(input[0]) << 8 |
+                                        static_cast<uint32_t>(input[1]) << 16 |
+                                        static_cast<uint32_t>(input[2]) << 24) >> 8;
+        }
+
+        static void convert24ToFloat(const uint8_t* input, uint32_t count, float* output, float scale)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 8 <= count; i += 8)
+                {
+                    // the bytes of the samples are deinterleaved and put into the top 24 bits of every lane
+                    uint8x8x3_t bytes = vld3_u8(input + i * 3);
+                    uint16x8_t low = vshll_n_u8(bytes.val[0], 8);
+                    uint16x8_t high = vorrq_u16(vmovl_u8(bytes.val[1]), vshll_n_u8(bytes.val[2], 8));
+
+                    int32x4_t first = vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_low_u16(high), 16), vmovl_u16(vget_low_u16(low))));
+                    int32x4_t second = vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_high_u16(high), 16), vmovl_u16(vget_high_u16(low))));
+
+                    vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vshrq_n_s32(first, 8)), scale));
+                    vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vshrq_n_s32(second, 8)), scale));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(scale);
+
+            // every sample is read as 4 bytes, so the last group is left to the scalar loop to not read past the input
+            for (; i + 5 <= count; i += 4)
+            {
+                int32_t words[4];
+                memcpy(&words[0], input + i * 3, sizeof(int32_t));
+                memcpy(&words[1], input + i * 3 + 3, sizeof(int32_t));
+                memcpy(&words[2], input + i * 3 + 6, sizeof(int32_t));
+                memcpy(&words[3], input + i * 3 + 9, sizeof(int32_t));
+
+                __m128i sample4 = _mm_srai_epi32(_mm_slli_epi32(_mm_set_epi32(words[3], words[2], words[1], words[0]), 8), 8);
+
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(sample4), scale4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = read24(input + i * 3) * scale;
+            }
+        }
+
+        static void convert32ToFloat(const int32_t* input, uint32_t count, float* output, float scale)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 4 <= count; i += 4)
+                {
+                    vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(input + i)), scale));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(scale);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i sample4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+
+                _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(sample4), scale4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = input[i] * scale;
+            }
+        }
+
+        static void convertFloatTo8(const float* input, uint32_t count, uint8_t* output)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                int16x8_t bias = vdupq_n_s16(128);
+                float32x4_t minimum = vdupq_n_f32(-1.0f);
+                float32x4_t maximum = vdupq_n_f32(1.0f);
+
+                for (; i + 8 <= count; i += 8)
+                {
+                    // clamped before the bias is added, so that the sum can not overflow
+                    float32x4_t sample0 = vminq_f32(vmaxq_f32(vld1q_f32(input + i), minimum), maximum);
+                    float32x4_t sample1 = vminq_f32(vmaxq_f32(vld1q_f32(input + i + 4), minimum), maximum);
+
+                    int16x4_t low = vmovn_s32(roundToInt(vmulq_n_f32(sample0, 127.0f)));
+                    int16x4_t high = vmovn_s32(roundToInt(vmulq_n_f32(sample1, 127.0f)));
+
+                    vst1_u8(output + i, vqmovun_s16(vaddq_s16(vcombine_s16(low, high), bias)));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(127.0f);
+            __m128 minimum = _mm_set1_ps(-1.0f);
+            __m128 maximum = _mm_set1_ps(1.0f);
+            __m128i bias = _mm_set1_epi16(128);
+
+            for (; i + 16 <= count; i += 16)
+            {
+                // clamped before the bias is added, so that the sum can not overflow
+                __m128i sample0 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), minimum), maximum), scale4));
+                __m128i sample1 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), minimum), maximum), scale4));
+                __m128i sample2 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 8), minimum), maximum), scale4));
+                __m128i sample3 = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 12), minimum), maximum), scale4));
+
+                __m128i low = _mm_add_epi16(_mm_packs_epi32(sample0, sample1), bias);
+                __m128i high = _mm_add_epi16(_mm_packs_epi32(sample2, sample3), bias);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(low, high));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = static_cast<uint8_t>(std::lrint(clamp(input[i], -1.0f, 1.0f) * 127.0f) + 128);
+            }
+        }
+
+        static void convertFloatTo16(const float* input, uint32_t count, int16_t* output)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t minimum = vdupq_n_f32(-1.0f);
+                float32x4_t maximum = vdupq_n_f32(1.0f);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t sample = vminq_f32(vmaxq_f32(vld1q_f32(input + i), minimum), maximum);
+
+                    vst1_s16(output + i, vmovn_s32(roundToInt(vmulq_n_f32(sample, 32767.0f))));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 scale4 = _mm_set1_ps(32767.0f);
+            __m128 minimum = _mm_set1_ps(-1.0f);
+            __m128 maximum = _mm_set1_ps(1.0f);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                // clamped first, the conversion returns the smallest integer for values that do not fit in 32 bits
+                __m128i low = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), minimum), maximum), scale4));
+                __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), minimum), maximum), scale4));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] = static_cast<int16_t>(std::lrint(clamp(input[i], -1.0f, 1.0f) * 32767.0f));
+            }
+        }
+
+        static void convertFloatTo24(const float* input, uint32_t count, uint8_t* output)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                int32_t sample = static_cast<int32_t>(std::lrint(clamp(input[i], -1.0f, 1.0f) * 8388607.0f));
+
+                output[i * 3 + 0] = static_cast<uint8_t>(sample);
+                output[i * 3 + 1] = static_cast<uint8_t>(sample >> 8);
+                output[i * 3 + 2] = static_cast<uint8_t>(sample >> 16);
+            }
+        }
+
+        static void convertFloatTo32(const float* input, uint32_t count, int32_t* output)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                // calculated in double precision, because the float closest to the maximum value is out of the range
+                output[i] = static_cast<int32_t>(std::lrint(static_cast<double>(clamp(input[i], -1.0f, 1.0f)) * 2147483647.0));
+            }
+        }
+
+        bool isSupportedBitDepth(uint16_t bitsPerSample)
+        {
+            return bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32;
+        }
+
+        bool convertToFloat(const uint8_t* input, uint16_t bitsPerSample, uint32_t sampleCount, float* output, float gain)
+        {
+            switch (bitsPerSample)
+            {
+                case 8:
+                    convert8ToFloat(input, sampleCount, output, gain / 128.0f);
+                    return true;
+                case 16:
+                    convert16ToFloat(reinterpret_cast<const int16_t*>(input), sampleCount, output, gain / 32768.0f);
+                    return true;
+                case 24:
+                    convert24ToFloat(input, sampleCount, output, gain / 8388608.0f);
+                    return true;
+                case 32:
+                    convert32ToFloat(reinterpret_cast<const int32_t*>(input), sampleCount, output, gain / 2147483648.0f);
+                    return true;
+                default:
+                    log(LOG_LEVEL_ERROR, "Unsupported sample size %u", static_cast<uint32_t>(bitsPerSample));
+                    return false;
+            }
+        }
+
+        bool convertFromFloat(const float* input, uint32_t sampleCount, uint16_t bitsPerSample, uint8_t* output)
+        {
+            switch (bitsPerSample)
+            {
+                case 8:
+                    convertFloatTo8(input, sampleCount, output);
+                    return true;
+                case 16:
+                    convertFloatTo16(input, sampleCount, reinterpret_cast<int16_t*>(output));
+                    return true;
+                case 24:
+                    convertFloatTo24(input, sampleCount, output);
+                    return true;
+                case 32:
+                    convertFloatTo32(input, sampleCount, reinterpret_cast<int32_t*>(output));
+                    return true;
+                default:
+                    log(LOG_LEVEL_ERROR, "Unsupported sample size %u", static_cast<uint32_t>(bitsPerSample));
+                    return false;
+            }
+        }
+
+        void convertChannels(const float* input, uint16_t inputChannels, uint32_t frames, uint16_t outputChannels, float* output)
+        {
+            if (inputChannels == outputChannels)
+            {
+                std::copy(input, input + frames * inputChannels, output);
+            }
+            else if (inputChannels == 1)
+            {
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                {
+                    std::fill(output + frame * outputChannels, output + (frame + 1) * outputChannels, input[frame]);
+                }
+            }
+            else if (outputChannels == 1)
+            {
+                float scale = 1.0f / inputChannels;
+
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                {
+                    float sum = 0.0f;
+
+                    for (uint16_t channel = 0; channel < inputChannels; ++channel)
+                    {
+                        sum += input[frame * inputChannels + channel];
+                    }
+
+                    output[frame] = sum * scale;
+                }
+            }
+            else
+            {
+                uint16_t common = std::min(inputChannels, outputChannels);
+
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                {
+                    const float* inputFrame = input + frame * inputChannels;
+                    float* outputFrame = output + frame * outputChannels;
+
+                    std::copy(inputFrame, inputFrame + common, outputFrame);
+                    std::fill(outputFrame + common, outputFrame + outputChannels, 0.0f);
+                }
+            }
+        }
+
+        // the count has to be a multiple of 4
+        static inline float dotProduct(const float* a, const float* b, uint32_t count)
+        {
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t sum = vdupq_n_f32(0.0f);
+
+                for (uint32_t i = 0; i < count; i += 4)
+                {
+                    sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+                }
+
+                float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+
+                return vget_lane_f32(vpadd_f32(pair, pair), 0);
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 sum = _mm_setzero_ps();
+
+            for (uint32_t i = 0; i < count; i += 4)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            }
+
+            __m128 shuffled = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(2, 3, 0, 1));
+            sum = _mm_add_ps(sum, shuffled);
+            shuffled = _mm_movehl_ps(shuffled, sum);
+
+            return _mm_cvtss_f32(_mm_add_ss(sum, shuffled));
+#endif
+
+#if !OUZEL_SUPPORTS_SSE
+            float sum = 0.0f;
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                sum += a[i] * b[i];
+            }
+
+            return sum;
+#endif
+        }
+
+        static uint32_t greatestCommonDivisor(uint32_t a, uint32_t b)
+        {
+            while (b)
+            {
+                uint32_t remainder = a % b;
+                a = b;
+                b = remainder;
+            }
+
+            return a;
+        }
+
+        static const uint32_t MAX_PHASES = 1024;
+        static const uint32_t MIN_TAPS = 16;
+        static const uint32_t MAX_TAPS = 64;
+
+        bool Resampler::init(uint32_t newInputRate, uint32_t newOutputRate, uint16_t newChannels)
+        {
+            if (newInputRate == 0 || newOutputRate == 0 || newChannels == 0)
+            {
+                log(LOG_LEVEL_ERROR, "Invalid resampler format");
+                return false;
+            }
+
+            if (newInputRate != inputRate || newOutputRate != outputRate)
+            {
+                inputRate = newInputRate;
+                outputRate = newOutputRate;
+
+                uint32_t divisor = greatestCommonDivisor(inputRate, outputRate);
+                phaseCount = outputRate / divisor;
+                step = inputRate / divisor;
+
+                // rates without a small common divisor are approximated, the pitch changes by less than 0.1%
+                if (phaseCount > MAX_PHASES)
+                {
+                    step = static_cast<uint32_t>((static_cast<uint64_t>(inputRate) * MAX_PHASES + outputRate / 2) / outputRate);
+                    phaseCount = MAX_PHASES;
+                }
+
+                // when downsampling, the cutoff is lowered to the output Nyquist frequency and the filter is made longer,
+                // so that the transition band stays equally steep
+                double ratio = std::min(1.0, static_cast<double>(phaseCount) / step);
+                tapCount = static_cast<uint32_t>(std::ceil(MIN_TAPS / ratio));
+                tapCount = std::min(MAX_TAPS, (tapCount + 3) & ~3U);
+
+                double cutoff = ratio * 0.9;
+                double halfWidth = tapCount / 2.0;
+                uint32_t center = tapCount / 2 - 1;
+
+                coefficients.resize(phaseCount * tapCount);
+
+                for (uint32_t p = 0; p < phaseCount; ++p)
+                {
+                    float* phaseCoefficients = coefficients.data() + p * tapCount;
+                    double sum = 0.0;
+
+                    for (uint32_t k = 0; k < tapCount; ++k)
+                    {
+                        double t = static_cast<double>(k) - center - static_cast<double>(p) / phaseCount;
+                        double x = PI * cutoff * t;
+                        double sinc = (std::fabs(x) < 1e-9) ? 1.0 : std::sin(x) / x;
+
+                        // Blackman window
+                        double w = PI * t / halfWidth;
+                        double window = (std::fabs(t) >= halfWidth) ? 0.0 : 0.42 + 0.5 * std::cos(w) + 0.08 * std::cos(2.0 * w);
+
+                        phaseCoefficients[k] = static_cast<float>(sinc * window);
+                        sum += phaseCoefficients[k];
+                    }
+
+                    // every phase has a unity gain at DC
+                    for (uint32_t k = 0; k < tapCount; ++k)
+                    {
+                        phaseCoefficients[k] = static_cast<float>(phaseCoefficients[k] / sum);
+                    }
+                }
+            }
+
+            channels = newChannels;
+            reset();
+
+            return true;
+        }
+
+        void Resampler::reset()
+        {
+            // the input starts at the center of the filter, so that the first output frame is the first input frame
+            historyFrames = tapCount / 2 - 1;
+            history.resize(channels);
+
+            for (std::vector<float>& channelHistory : history)
+            {
+                channelHistory.assign(historyFrames, 0.0f);
+            }
+
+            position = 0;
+            phase = 0;
+        }
+
+        uint32_t Resampler::getInputFrames(uint32_t outputFrames) const
+        {
+            if (outputFrames == 0)
+            {
+                return 0;
+            }
+
+            uint64_t last = position + (phase + static_cast<uint64_t>(outputFrames - 1) * step) / phaseCount;
+            uint64_t needed = last + tapCount;
+
+            return (needed > historyFrames) ? static_cast<uint32_t>(needed - historyFrames) : 0;
+        }
+
+        uint32_t Resampler::process(const float* input, uint32_t inputFrames, uint32_t& consumedFrames, float* output, uint32_t outputFrames)
+        {
+            consumedFrames = std::min(inputFrames, getInputFrames(outputFrames));
+
+            for (uint16_t channel = 0; channel < channels; ++channel)
+            {
+                std::vector<float>& channelHistory = history[channel];
+                channelHistory.resize(historyFrames + consumedFrames);
+
+                for (uint32_t frame = 0; frame < consumedFrames; ++frame)
+                {
+                    channelHistory[historyFrames + frame] = input[frame * channels + channel];
+                }
+            }
+
+            historyFrames += consumedFrames;
+
+            uint32_t written = 0;
+
+            for (; written < outputFrames && position + tapCount <= historyFrames; ++written)
+            {
+                const float* phaseCoefficients = coefficients.data() + phase * tapCount;
+
+                for (uint16_t channel = 0; channel < channels; ++channel)
+                {
+                    output[written * channels + channel] = dotProduct(history[channel].data() + position, phaseCoefficients, tapCount);
+                }
+
+                phase += step;
+                position += phase / phaseCount;
+                phase %= phaseCount;
+            }
+
+            // the frames before the filter window of the next output frame are not needed anymore
+            uint32_t dropped = std::min(position, historyFrames);
+
+            if (dropped)
+            {
+                for (std::vector<float>& channelHistory : history)
+                {
+                    channelHistory.erase(channelHistory.begin(), channelHistory.begin() + dropped);
+                }
+
+                historyFrames -= dropped;
+                position -= dropped;
+            }
+
+            return written;
+        }
+
+        bool Resampler::resample(const std::vector<float>& input, std::vector<float>& output)
+        {
+            if (!channels)
+            {
+                log(LOG_LEVEL_ERROR, "Resampler is not initialized");
+                return false;
+            }
+
+            reset();
+
+            uint32_t inputFrames = static_cast<uint32_t>(input.size() / channels);
+            uint32_t outputFrames = static_cast<uint32_t>((static_cast<uint64_t>(inputFrames) * phaseCount + step - 1) / step);
+
+            // the input is followed by silence, so that the filter reaches its last frames
+            std::vector<float> padded(input.begin(), input.begin() + inputFrames * channels);
+            padded.resize((inputFrames + tapCount) * channels, 0.0f);
+
+            output.resize(outputFrames * channels);
+
+            uint32_t consumed;
+            uint32_t written = process(padded.data(), inputFrames + tapCount, consumed, output.data(), outputFrames);
+            output.resize(written * channels);
+
+            reset();
+
+            return true;
+        }
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,67 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // 8-bit samples are unsigned, 16, 24 and 32-bit samples are signed little-endian integers
+        bool isSupportedBitDepth(uint16_t bitsPerSample);
+
+        // converts the integer samples to floats in the range [-1, 1] multiplied by the gain
+        bool convertToFloat(const uint8_t* input, uint16_t bitsPerSample, uint32_t sampleCount, float* output, float gain = 1.0f);
+
+        // converts the floats to integer samples, the samples outside of the range [-1, 1] are clipped
+        bool convertFromFloat(const float* input, uint32_t sampleCount, uint16_t bitsPerSample, uint8_t* output);
+
+        // converts interleaved frames between channel counts, mono is duplicated to every channel, channels are averaged
+        // to mono, between other counts the common channels are copied and the rest are left silent
+        void convertChannels(const float* input, uint16_t inputChannels, uint32_t frames, uint16_t outputChannels, float* output);
+
+        // band-limited resampler of interleaved float frames, that uses a windowed sinc filter split into one phase for
+        // every output position between two input frames, it keeps the frames it has not used yet, so that a stream can
+        // be resampled in pieces of any size
+        class Resampler
+        {
+        public:
+            bool init(uint32_t newInputRate, uint32_t newOutputRate, uint16_t newChannels);
+            void reset();
+
+            uint32_t getInputRate() const { return inputRate; }
+            uint32_t getOutputRate() const { return outputRate; }
+            uint16_t getChannels() const { return channels; }
+
+            // number of input frames that have to be passed to produce the given number of output frames
+            uint32_t getInputFrames(uint32_t outputFrames) const;
+
+            // reads at most inputFrames and writes at most outputFrames, returns the number of written frames
+            uint32_t process(const float* input, uint32_t inputFrames, uint32_t& consumedFrames, float* output, uint32_t outputFrames);
+
+            // resamples the whole input at once, the filter is flushed at the end
+            bool resample(const std::vector<float>& input, std::vector<float>& output);
+
+        protected:
+            uint32_t inputRate = 0;
+            uint32_t outputRate = 0;
+            uint16_t channels = 0;
+
+            // every output frame advances the input by step / phaseCount frames
+            uint32_t phaseCount = 0;
+            uint32_t step = 0;
+            uint32_t tapCount = 0;
+            std::vector<float> coefficients;
+
+            // planar input of every channel, that starts with the frames kept from the previous call, the position is
+            // the first frame of the filter window of the next output frame, it can be past the kept frames
+            std::vector<std::vector<float>> history;
+            uint32_t historyFrames = 0;
+            uint32_t position = 0;
+            uint32_t phase = 0;
+        };
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,18 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "Decoder.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        Decoder::Decoder()
+        {
+        }
+
+        Decoder::~Decoder()
+        {
+        }
+    } // namespace audio
+} // namespace ouzel
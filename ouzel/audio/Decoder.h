@@ -0,0 +1,42 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // Decodes a sound file to PCM in chunks, so that it can be streamed without loading the whole file. Decoders
+        // for compressed formats (e.g. Ogg Vorbis) are registered with SoundData::registerDecoder.
+        class Decoder: public Noncopyable
+        {
+        public:
+            virtual ~Decoder();
+
+            virtual bool open(const std::string& filename) = 0;
+
+            // decodes up to the given number of frames of interleaved 8-bit unsigned or 16-bit signed little-endian
+            // samples, returns the number of decoded frames (0 at the end of the file)
+            virtual uint32_t read(uint8_t* output, uint32_t frames) = 0;
+
+            // seeks back to the first frame
+            virtual bool rewind() = 0;
+
+            uint16_t getChannels() const { return channels; }
+            uint32_t getSamplesPerSecond() const { return samplesPerSecond; }
+            uint16_t getBitsPerSample() const { return bitsPerSample; }
+
+        protected:
+            Decoder();
+
+            uint16_t channels = 0;
+            uint32_t samplesPerSecond = 0;
+            uint16_t bitsPerSample = 0;
+        };
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,117 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "FileSink.h"
+#include "Mixer.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        static const uint32_t HEADER_SIZE = 44;
+
+        static void writeUInt16(std::ofstream& file, uint16_t value)
+        {
+            uint8_t bytes[2] = {
+                static_cast<uint8_t>(value & 0xFF),
+                static_cast<uint8_t>((value >> 8) & 0xFF)
+            };
+
+            file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+
+        static void writeUInt32(std::ofstream& file, uint32_t value)
+        {
+            uint8_t bytes[4] = {
+                static_cast<uint8_t>(value & 0xFF),
+                static_cast<uint8_t>((value >> 8) & 0xFF),
+                static_cast<uint8_t>((value >> 16) & 0xFF),
+                static_cast<uint8_t>((value >> 24) & 0xFF)
+            };
+
+            file.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+        }
+
+        FileSink::FileSink(Mixer& pMixer):
+            mixer(pMixer)
+        {
+        }
+
+        FileSink::~FileSink()
+        {
+            close();
+        }
+
+        bool FileSink::open(const std::string& filename)
+        {
+            close();
+
+            file.open(filename, std::ios::binary | std::ios::trunc);
+
+            if (!file)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to open file %s", filename.c_str());
+                return false;
+            }
+
+            writtenFrames = 0;
+
+            // the sizes are written when the file is closed
+            file.write("RIFF", 4);
+            writeUInt32(file, 0);
+            file.write("WAVE", 4);
+
+            file.write("fmt ", 4);
+            writeUInt32(file, 16);
+            writeUInt16(file, 1); // PCM
+            writeUInt16(file, Mixer::CHANNELS);
+            writeUInt32(file, mixer.getSampleRate());
+            writeUInt32(file, mixer.getSampleRate() * Mixer::CHANNELS * sizeof(int16_t));
+            writeUInt16(file, Mixer::CHANNELS * sizeof(int16_t));
+            writeUInt16(file, 16);
+
+            file.write("data", 4);
+            writeUInt32(file, 0);
+
+            return true;
+        }
+
+        void FileSink::close()
+        {
+            if (file.is_open())
+            {
+                uint32_t dataSize = static_cast<uint32_t>(writtenFrames * Mixer::CHANNELS * sizeof(int16_t));
+
+                file.seekp(4);
+                writeUInt32(file, HEADER_SIZE - 8 + dataSize);
+                file.seekp(HEADER_SIZE - 4);
+                writeUInt32(file, dataSize);
+
+                file.close();
+            }
+        }
+
+        bool FileSink::write(uint32_t frames)
+        {
+            buffer.resize(frames * Mixer::CHANNELS);
+
+            mixer.mix(buffer.data(), frames);
+
+            if (file.is_open())
+            {
+                file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(int16_t)));
+
+                if (!file)
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to write audio data");
+                    return false;
+                }
+            }
+
+            writtenFrames += frames;
+
+            return true;
+        }
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,42 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        class Mixer;
+
+        // Writes the output of a mixer to a 16-bit WAVE file instead of an audio device, so that the mixing can be run
+        // and measured without any audio hardware. Without a file the mixed frames are discarded.
+        class FileSink: public Noncopyable
+        {
+        public:
+            FileSink(Mixer& pMixer);
+            ~FileSink();
+
+            bool open(const std::string& filename);
+            void close();
+
+            // mixes the given number of frames and writes them to the file
+            bool write(uint32_t frames);
+
+            uint64_t getWrittenFrames() const { return writtenFrames; }
+
+        protected:
+            Mixer& mixer;
+
+            std::ofstream file;
+            std::vector<int16_t> buffer;
+            uint64_t writtenFrames = 0;
+        };
+    } // namespace audio
+} // namespace ouzel
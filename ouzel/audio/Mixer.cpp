@@ -0,0 +1,496 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include "Mixer.h"
+#include "Convert.h"
+#include "SoundData.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // adds the stereo samples to the output
+        static void addStereo(const float* samples, float* output, uint32_t frames)
+        {
+            uint32_t count = frames * 2;
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 4 <= count; i += 4)
+                {
+                    vst1q_f32(output + i, vaddq_f32(vld1q_f32(output + i), vld1q_f32(samples + i)));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            for (; i + 4 <= count; i += 4)
+            {
+                _mm_storeu_ps(output + i, _mm_add_ps(_mm_loadu_ps(output + i), _mm_loadu_ps(samples + i)));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                output[i] += samples[i];
+            }
+        }
+
+        // adds the mono samples to both channels of the output
+        static void addMono(const float* samples, float* output, uint32_t frames)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 4 <= frames; i += 4)
+                {
+                    float32x4_t sample4 = vld1q_f32(samples + i);
+                    float32x4x2_t stereo = vzipq_f32(sample4, sample4);
+
+                    vst1q_f32(output + i * 2, vaddq_f32(vld1q_f32(output + i * 2), stereo.val[0]));
+                    vst1q_f32(output + i * 2 + 4, vaddq_f32(vld1q_f32(output + i * 2 + 4), stereo.val[1]));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            for (; i + 4 <= frames; i += 4)
+            {
+                __m128 sample4 = _mm_loadu_ps(samples + i);
+
+                _mm_storeu_ps(output + i * 2, _mm_add_ps(_mm_loadu_ps(output + i * 2), _mm_unpacklo_ps(sample4, sample4)));
+                _mm_storeu_ps(output + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(output + i * 2 + 4), _mm_unpackhi_ps(sample4, sample4)));
+            }
+#endif
+
+            for (; i < frames; ++i)
+            {
+                output[i * 2] += samples[i];
+                output[i * 2 + 1] += samples[i];
+            }
+        }
+
+        Mixer::Mixer(uint32_t newVoiceCount, uint32_t newSampleRate):
+            sampleRate(newSampleRate), voices(newVoiceCount)
+        {
+        }
+
+        uint32_t Mixer::play(const SoundDataPtr& soundData, bool repeat, int32_t priority, float gain)
+        {
+            if (!soundData || !soundData->isReady())
+            {
+                log(LOG_LEVEL_ERROR, "Sound data is not ready");
+                return 0;
+            }
+
+            if (soundData->getChannels() == 0 || !isSupportedBitDepth(soundData->getBitsPerSample()))
+            {
+                log(LOG_LEVEL_ERROR, "Unsupported audio format");
+                return 0;
+            }
+
+            if (soundData->isStreaming())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(voiceMutex);
+
+                    // a stream is read by one voice at a time
+                    for (Voice& current : voices)
+                    {
+                        if (current.id && current.soundData == soundData)
+                        {
+                            current.soundData.reset();
+                            current.id = 0;
+                        }
+                    }
+                }
+
+                if (!soundData->restartStream(repeat))
+                {
+                    return 0;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = nullptr;
+
+            for (Voice& current : voices)
+            {
+                if (!current.id)
+                {
+                    voice = &current;
+                    break;
+                }
+                else if (!voice ||
+                         current.priority < voice->priority ||
+                         (current.priority == voice->priority && current.order < voice->order))
+                {
+                    voice = &current;
+                }
+            }
+
+            if (!voice || (voice->id && voice->priority > priority))
+            {
+                return 0;
+            }
+
+            if (++lastVoiceId == 0) ++lastVoiceId;
+
+            voice->soundData = soundData;
+            voice->id = lastVoiceId;
+            voice->priority = priority;
+            voice->gain = gain;
+            voice->repeat = repeat;
+            voice->paused = false;
+            voice->restarting = false;
+            voice->order = ++lastOrder;
+            voice->position = 0;
+
+            if (soundData->getSamplesPerSecond() != sampleRate)
+            {
+                voice->resampler.init(soundData->getSamplesPerSecond(), sampleRate, soundData->getChannels());
+            }
+
+            return voice->id;
+        }
+
+        bool Mixer::stop(uint32_t voiceId)
+        {
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = getVoice(voiceId);
+
+            if (!voice)
+            {
+                return false;
+            }
+
+            voice->soundData.reset();
+            voice->id = 0;
+
+            return true;
+        }
+
+        bool Mixer::pause(uint32_t voiceId)
+        {
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = getVoice(voiceId);
+
+            if (!voice)
+            {
+                return false;
+            }
+
+            voice->paused = true;
+
+            return true;
+        }
+
+        bool Mixer::resume(uint32_t voiceId)
+        {
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = getVoice(voiceId);
+
+            if (!voice)
+            {
+                return false;
+            }
+
+            voice->paused = false;
+
+            return true;
+        }
+
+        bool Mixer::rewind(uint32_t voiceId)
+        {
+            SoundDataPtr soundData;
+            bool repeat;
+
+            {
+                std::lock_guard<std::mutex> lock(voiceMutex);
+
+                Voice* voice = getVoice(voiceId);
+
+                if (!voice)
+                {
+                    return false;
+                }
+
+                if (!voice->soundData->isStreaming())
+                {
+                    voice->position = 0;
+                    voice->resampler.reset();
+
+                    return true;
+                }
+
+                // the stream is not mixed while it is restarted
+                voice->restarting = true;
+                soundData = voice->soundData;
+                repeat = voice->repeat;
+            }
+
+            // restarting decodes the first chunk, so it is done without holding the voice mutex
+            bool result = soundData->restartStream(repeat);
+
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = getVoice(voiceId);
+
+            // the voice could have been stopped or taken by another sound in the meantime
+            if (voice && voice->soundData == soundData)
+            {
+                voice->restarting = false;
+                voice->position = 0;
+                voice->resampler.reset();
+            }
+
+            return result;
+        }
+
+        bool Mixer::isPlaying(uint32_t voiceId)
+        {
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            Voice* voice = getVoice(voiceId);
+
+            return voice && !voice->paused;
+        }
+
+        uint32_t Mixer::getActiveVoiceCount()
+        {
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            uint32_t count = 0;
+
+            for (const Voice& voice : voices)
+            {
+                if (voice.id) ++count;
+            }
+
+            return count;
+        }
+
+        void Mixer::mix(float* output, uint32_t frames)
+        {
+            std::fill(output, output + frames * CHANNELS, 0.0f);
+
+            std::lock_guard<std::mutex> lock(voiceMutex);
+
+            for (Voice& voice : voices)
+            {
+                if (voice.id && !voice.paused && !voice.restarting)
+                {
+                    mixVoice(voice, output, frames);
+                }
+            }
+        }
+
+        void Mixer::mix(int16_t* output, uint32_t frames)
+        {
+            uint32_t count = frames * CHANNELS;
+
+            if (mixBuffer.size() < count)
+            {
+                mixBuffer.resize(count);
+            }
+
+            mix(mixBuffer.data(), frames);
+
+            convertFromFloat(mixBuffer.data(), count, 16, reinterpret_cast<uint8_t*>(output));
+        }
+
+        Mixer::Voice* Mixer::getVoice(uint32_t voiceId)
+        {
+            if (!voiceId)
+            {
+                return nullptr;
+            }
+
+            for (Voice& voice : voices)
+            {
+                if (voice.id == voiceId)
+                {
+                    return &voice;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void Mixer::mixVoice(Voice& voice, float* output, uint32_t frames)
+        {
+            if (voice.soundData->isStreaming())
+            {
+                mixStream(voice, output, frames);
+                return;
+            }
+
+            const std::vector<uint8_t>& data = voice.soundData->getData();
+            uint16_t channels = voice.soundData->getChannels();
+            uint16_t bitsPerSample = voice.soundData->getBitsPerSample();
+            uint32_t frameSize = channels * (bitsPerSample / 8);
+            uint32_t frameCount = static_cast<uint32_t>(data.size() / frameSize);
+
+            // sound data is usually resampled to the rate of the mixer when it is loaded
+            bool resampling = (voice.soundData->getSamplesPerSecond() != sampleRate);
+            bool finished = (frameCount == 0);
+            uint32_t written = 0;
+
+            while (!finished && written < frames)
+            {
+                uint32_t needed = resampling ? voice.resampler.getInputFrames(frames - written) : frames - written;
+
+                if (needed > 0 && voice.position >= frameCount)
+                {
+                    if (voice.repeat)
+                    {
+                        voice.position = 0;
+                    }
+                    else
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+
+                uint32_t count = std::min(needed, frameCount - voice.position);
+                const uint8_t* source = data.data() + voice.position * frameSize;
+
+                if (resampling)
+                {
+                    uint32_t consumed;
+                    uint32_t produced = resample(voice, source, count, consumed, frames - written, output + written * CHANNELS);
+
+                    voice.position += consumed;
+                    written += produced;
+                }
+                else
+                {
+                    addFrames(source, count, channels, bitsPerSample, voice.gain, output + written * CHANNELS);
+
+                    voice.position += count;
+                    written += count;
+                }
+            }
+
+            if (finished)
+            {
+                voice.soundData.reset();
+                voice.id = 0;
+            }
+        }
+
+        void Mixer::mixStream(Voice& voice, float* output, uint32_t frames)
+        {
+            SoundData& soundData = *voice.soundData;
+            uint16_t channels = soundData.getChannels();
+            uint16_t bitsPerSample = soundData.getBitsPerSample();
+            uint32_t frameSize = channels * (bitsPerSample / 8);
+
+            bool resampling = (soundData.getSamplesPerSecond() != sampleRate);
+            uint32_t needed = resampling ? voice.resampler.getInputFrames(frames) : frames;
+
+            if (streamData.size() < needed * frameSize)
+            {
+                streamData.resize(needed * frameSize);
+            }
+
+            // if the decoder falls behind, the rest of the buffer stays silent
+            uint32_t count = soundData.peekStream(streamData.data(), needed);
+
+            if (resampling)
+            {
+                uint32_t consumed;
+                resample(voice, streamData.data(), count, consumed, frames, output);
+
+                soundData.skipStream(consumed);
+            }
+            else
+            {
+                addFrames(streamData.data(), count, channels, bitsPerSample, voice.gain, output);
+
+                soundData.skipStream(count);
+            }
+
+            if (soundData.isStreamFinished())
+            {
+                voice.soundData.reset();
+                voice.id = 0;
+            }
+        }
+
+        uint32_t Mixer::resample(Voice& voice, const uint8_t* source, uint32_t count, uint32_t& consumed, uint32_t frames, float* output)
+        {
+            uint16_t channels = voice.soundData->getChannels();
+
+            if (sampleBuffer.size() < count * channels)
+            {
+                sampleBuffer.resize(count * channels);
+            }
+
+            if (resampleBuffer.size() < frames * channels)
+            {
+                resampleBuffer.resize(frames * channels);
+            }
+
+            convertToFloat(source, voice.soundData->getBitsPerSample(), count * channels, sampleBuffer.data(), voice.gain);
+
+            uint32_t produced = voice.resampler.process(sampleBuffer.data(), count, consumed, resampleBuffer.data(), frames);
+
+            addSamples(resampleBuffer.data(), produced, channels, output);
+
+            return produced;
+        }
+
+        void Mixer::addFrames(const uint8_t* source, uint32_t count, uint16_t channels, uint16_t bitsPerSample, float gain, float* output)
+        {
+            uint32_t sampleCount = count * channels;
+
+            if (sampleBuffer.size() < sampleCount)
+            {
+                sampleBuffer.resize(sampleCount);
+            }
+
+            convertToFloat(source, bitsPerSample, sampleCount, sampleBuffer.data(), gain);
+
+            addSamples(sampleBuffer.data(), count, channels, output);
+        }
+
+        void Mixer::addSamples(const float* samples, uint32_t count, uint16_t channels, float* output)
+        {
+            if (channels == 1)
+            {
+                addMono(samples, output, count);
+            }
+            else if (channels == 2)
+            {
+                addStereo(samples, output, count);
+            }
+            else
+            {
+                // only the front left and right channels are mixed
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    output[i * 2] += samples[i * channels];
+                    output[i * 2 + 1] += samples[i * channels + 1];
+                }
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,84 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "audio/Convert.h"
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // Mixes the sounds that are playing into one interleaved stereo stream, that the audio backend outputs.
+        // Sounds are played on a fixed pool of voices, that reference the sample data of the sound data, so playing
+        // the same sound data many times does not copy it. When every voice is taken, the voice with the lowest
+        // priority (the oldest one of them) is stolen, unless its priority is higher than of the new sound.
+        class Mixer: public Noncopyable
+        {
+        public:
+            static const uint16_t CHANNELS = 2;
+
+            Mixer(uint32_t newVoiceCount = 32, uint32_t newSampleRate = 44100);
+
+            uint32_t getVoiceCount() const { return static_cast<uint32_t>(voices.size()); }
+            uint32_t getSampleRate() const { return sampleRate; }
+
+            // returns the id of the voice or 0 if there was no voice to play the sound on
+            uint32_t play(const SoundDataPtr& soundData, bool repeat = false, int32_t priority = 0, float gain = 1.0f);
+            bool stop(uint32_t voiceId);
+            bool pause(uint32_t voiceId);
+            bool resume(uint32_t voiceId);
+            bool rewind(uint32_t voiceId);
+            bool isPlaying(uint32_t voiceId);
+
+            uint32_t getActiveVoiceCount();
+
+            // writes the given number of interleaved stereo frames
+            void mix(float* output, uint32_t frames);
+            void mix(int16_t* output, uint32_t frames);
+
+        protected:
+            struct Voice
+            {
+                SoundDataPtr soundData;
+                uint32_t id = 0;
+                int32_t priority = 0;
+                float gain = 1.0f;
+                bool repeat = false;
+                bool paused = false;
+                bool restarting = false;
+                uint64_t order = 0;
+
+                // position in frames of the sound data (streamed sound data keeps its own)
+                uint32_t position = 0;
+
+                // used if the sample rate of the sound data differs from the mixer's
+                Resampler resampler;
+            };
+
+            Voice* getVoice(uint32_t voiceId);
+            void mixVoice(Voice& voice, float* output, uint32_t frames);
+            void mixStream(Voice& voice, float* output, uint32_t frames);
+            uint32_t resample(Voice& voice, const uint8_t* source, uint32_t count, uint32_t& consumed, uint32_t frames, float* output);
+            void addFrames(const uint8_t* source, uint32_t count, uint16_t channels, uint16_t bitsPerSample, float gain, float* output);
+            void addSamples(const float* samples, uint32_t count, uint16_t channels, float* output);
+
+            uint32_t sampleRate;
+
+            std::mutex voiceMutex;
+            std::vector<Voice> voices;
+            uint32_t lastVoiceId = 0;
+            uint64_t lastOrder = 0;
+
+            std::vector<uint8_t> streamData;
+            std::vector<float> sampleBuffer;
+            std::vector<float> resampleBuffer;
+            std::vector<float> mixBuffer;
+        };
+    } // namespace audio
+} // namespace ouzel
@@ -2,6 +2,8 @@
 // This file is part of the Ouzel engine.
 
 #include "Sound.h"
+#include "Audio.h"
+#include "core/Engine.h"
 
 namespace ouzel
 {
@@ -13,15 +15,23 @@ namespace ouzel
 
         Sound::~Sound()
         {
+            if (voiceId && sharedEngine && sharedEngine->getAudio())
+            {
+                sharedEngine->getAudio()->getMixer().stop(voiceId);
+            }
         }
 
         void Sound::free()
         {
+            stop(true);
+
             ready = false;
         }
 
         bool Sound::init(const SoundDataPtr& newSoundData)
         {
+            stop(true);
+
             soundData = newSoundData;
             ready = true;
 
@@ -30,18 +40,39 @@ namespace ouzel
 
         bool Sound::play(bool repeatSound)
         {
+            Mixer& mixer = sharedEngine->getAudio()->getMixer();
+
+            // a paused sound continues from where it was paused (with the repeat mode it was started with), a sound
+            // that is playing is started again
+            if (voiceId && !mixer.isPlaying(voiceId) && mixer.resume(voiceId))
+            {
+                return true;
+            }
+
             repeat = repeatSound;
 
             stop(true);
 
-            return true;
+            voiceId = mixer.play(soundData, repeat, priority);
+
+            return voiceId != 0;
         }
 
         bool Sound::stop(bool resetSound)
         {
+            if (!voiceId)
+            {
+                return true;
+            }
+
             if (resetSound)
             {
-                reset();
+                sharedEngine->getAudio()->getMixer().stop(voiceId);
+                voiceId = 0;
+            }
+            else
+            {
+                sharedEngine->getAudio()->getMixer().pause(voiceId);
             }
 
             return true;
@@ -49,7 +80,17 @@ namespace ouzel
 
         bool Sound::reset()
         {
+            if (voiceId)
+            {
+                sharedEngine->getAudio()->getMixer().rewind(voiceId);
+            }
+
             return true;
         }
+
+        bool Sound::isPlaying() const
+        {
+            return voiceId && sharedEngine->getAudio()->getMixer().isPlaying(voiceId);
+        }
     } // namespace audio
 } // namespace ouzel
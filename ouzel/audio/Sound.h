@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include "utils/Types.h"
 
 namespace ouzel
@@ -27,6 +28,11 @@ namespace ouzel
             virtual bool reset();
 
             bool isRepeating() const { return repeat; }
+            bool isPlaying() const;
+
+            // sounds with a lower priority are stopped to play this one when every voice of the mixer is taken
+            int32_t getPriority() const { return priority; }
+            void setPriority(int32_t newPriority) { priority = newPriority; }
 
             bool isReady() const { return ready; }
 
@@ -35,6 +41,8 @@ namespace ouzel
 
             SoundDataPtr soundData;
             bool repeat = false;
+            int32_t priority = 0;
+            uint32_t voiceId = 0;
 
             bool ready = false;
         };
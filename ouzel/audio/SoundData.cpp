@@ -1,8 +1,16 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <map>
 #include "SoundData.h"
+#include "Audio.h"
+#include "Convert.h"
+#include "WaveDecoder.h"
 #include "core/Application.h"
+#include "core/Engine.h"
 #include "files/FileSystem.h"
 #include "utils/Utils.h"
 
@@ -10,41 +18,115 @@ namespace ouzel
 {
     namespace audio
     {
-        SoundData::SoundData()
+        static std::map<std::string, std::function<Decoder*()>>& getDecoders()
+        {
+            static std::map<std::string, std::function<Decoder*()>> decoders = {
+                {"wav", []() { return new WaveDecoder(); }}
+            };
+
+            return decoders;
+        }
+
+        void SoundData::registerDecoder(const std::string& extension, const std::function<Decoder*()>& factory)
+        {
+            getDecoders()[extension] = factory;
+        }
+
+        SoundData::SoundData():
+            streamReadPosition(0), streamWritePosition(0), streamEnded(false)
         {
         }
 
         SoundData::~SoundData()
         {
+            stopStream();
         }
 
         void SoundData::free()
         {
+            stopStream();
+
             data.clear();
+            streamBuffer.clear();
+            decoder.reset();
+            streaming = false;
 
             ready = false;
         }
 
-        bool SoundData::initFromFile(const std::string& newFilename)
+        bool SoundData::initFromFile(const std::string& newFilename, bool newStreaming)
         {
             filename = newFilename;
 
-            std::vector<uint8_t> newData;
-            if (!sharedApplication->getFileSystem()->loadFile(newFilename, newData))
+            if (newStreaming)
+            {
+                free();
+
+                std::string extension = FileSystem::getExtensionPart(newFilename);
+                std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+                auto i = getDecoders().find(extension);
+
+                if (i == getDecoders().end())
+                {
+                    log(LOG_LEVEL_ERROR, "No decoder for sound file %s", newFilename.c_str());
+                    return false;
+                }
+
+                decoder.reset(i->second());
+
+                if (!decoder->open(newFilename))
+                {
+                    return false;
+                }
+
+                if (decoder->getChannels() == 0 || !isSupportedBitDepth(decoder->getBitsPerSample()))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load sound file, unsupported format");
+                    return false;
+                }
+
+                formatTag = 1;
+                channels = decoder->getChannels();
+                samplesPerSecond = decoder->getSamplesPerSecond();
+                bitsPerSample = decoder->getBitsPerSample();
+                frameSize = channels * (bitsPerSample / 8);
+                blockAlign = static_cast<uint16_t>(frameSize);
+                averageBytesPerSecond = samplesPerSecond * frameSize;
+
+                streamBuffer.resize(CHUNK_FRAMES * CHUNK_COUNT * frameSize);
+                streaming = true;
+
+                if (!restartStream(false))
+                {
+                    return false;
+                }
+
+                streamRunning = true;
+                streamThread = std::thread(&SoundData::runStream, this);
+
+                ready = true;
+
+                return true;
+            }
+
+            // only the data chunk is copied out of the mapped file
+            FileView view;
+            if (!sharedApplication->getFileSystem()->mapFile(newFilename, view))
             {
                 return false;
             }
 
-            return initFromBuffer(newData);
+            return initFromBuffer(view.getData(), view.getSize());
         }
 
-        bool SoundData::initFromBuffer(const std::vector<uint8_t>& newData)
+        bool SoundData::initFromBuffer(const uint8_t* newData, size_t newSize)
         {
             ready = false;
 
             uint32_t offset = 0;
 
-            if (newData.size() < 16) // RIFF + size + WAVE
+            if (newSize < 16) // RIFF + size + WAVE
             {
                 log(LOG_LEVEL_ERROR, "Failed to load sound file, file too small");
                 return false;
@@ -61,11 +143,11 @@ namespace ouzel
 
             offset += 4;
 
-            uint32_t length = readUInt32Little(newData.data() + offset);
+            uint32_t length = readUInt32Little(newData + offset);
 
             offset += 4;
 
-            if (newData.size() != length + 8)
+            if (newSize != length + 8)
             {
                 log(LOG_LEVEL_ERROR, "Failed to load sound file, size mismatch");
             }
@@ -84,9 +166,9 @@ namespace ouzel
             bool formatChunkFound = false;
             bool dataChunkFound = false;
 
-            for (; offset < newData.size();)
+            for (; offset < newSize;)
             {
-                if (newData.size() < offset + 8)
+                if (newSize < offset + 8)
                 {
                     log(LOG_LEVEL_ERROR, "Failed to load sound file, not enough data to read chunk");
                     return false;
@@ -100,10 +182,10 @@ namespace ouzel
 
                 offset += 4;
 
-                uint32_t chunkSize = readUInt32Little(newData.data() + offset);
+                uint32_t chunkSize = readUInt32Little(newData + offset);
                 offset += 4;
 
-                if (newData.size() < offset + chunkSize)
+                if (newSize < offset + chunkSize)
                 {
                     log(LOG_LEVEL_ERROR, "Failed to load sound file, not enough data to read chunk");
                     return false;
@@ -119,7 +201,7 @@ namespace ouzel
 
                     uint32_t i = offset;
 
-                    formatTag = readUInt16Little(newData.data() + i);
+                    formatTag = readUInt16Little(newData + i);
                     i += 2;
 
                     if (formatTag != 1)
@@ -128,26 +210,26 @@ namespace ouzel
                         return false;
                     }
 
-                    channels = readUInt16Little(newData.data() + i);
+                    channels = readUInt16Little(newData + i);
                     i += 2;
 
-                    samplesPerSecond = readUInt32Little(newData.data() + i);
+                    samplesPerSecond = readUInt32Little(newData + i);
                     i += 4;
 
-                    averageBytesPerSecond = readUInt32Little(newData.data() + i);
+                    averageBytesPerSecond = readUInt32Little(newData + i);
                     i += 4;
 
-                    blockAlign = readUInt16Little(newData.data() + i);
+                    blockAlign = readUInt16Little(newData + i);
                     i += 2;
 
-                    bitsPerSample = readUInt16Little(newData.data() + i);
+                    bitsPerSample = readUInt16Little(newData + i);
                     i += 2;
 
                     formatChunkFound = true;
                 }
                 else if (chunkHeader[0] == 'd' && chunkHeader[1] == 'a' && chunkHeader[2] == 't' && chunkHeader[3] == 'a')
                 {
-                    data.assign(newData.begin() + static_cast<int>(offset), newData.begin() + static_cast<int>(offset + chunkSize));
+                    data.assign(newData + offset, newData + offset + chunkSize);
 
                     dataChunkFound = true;
                 }
@@ -167,9 +249,208 @@ namespace ouzel
                 return false;
             }
 
+            // resampled once here instead of every time it is played
+            uint32_t mixerSampleRate = samplesPerSecond;
+
+            if (sharedEngine && sharedEngine->getAudio())
+            {
+                mixerSampleRate = sharedEngine->getAudio()->getMixer().getSampleRate();
+            }
+
+            if (!convert(mixerSampleRate))
+            {
+                return false;
+            }
+
             ready = true;
 
             return true;
         }
+
+        bool SoundData::convert(uint32_t newSamplesPerSecond)
+        {
+            if (streaming)
+            {
+                log(LOG_LEVEL_ERROR, "Streamed sound data can not be converted");
+                return false;
+            }
+
+            if (channels == 0 || !isSupportedBitDepth(bitsPerSample))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to convert sound data, unsupported format");
+                return false;
+            }
+
+            bool resampling = (newSamplesPerSecond != samplesPerSecond);
+
+            // the mixer reads 8 and 16-bit samples the fastest, resampled samples are stored with 16 bits
+            uint16_t newBitsPerSample = (resampling || bitsPerSample > 16) ? 16 : bitsPerSample;
+
+            if (!resampling && newBitsPerSample == bitsPerSample)
+            {
+                return true;
+            }
+
+            uint32_t sampleCount = static_cast<uint32_t>(data.size() / (channels * (bitsPerSample / 8))) * channels;
+
+            std::vector<float> samples(sampleCount);
+
+            if (!convertToFloat(data.data(), bitsPerSample, sampleCount, samples.data()))
+            {
+                return false;
+            }
+
+            if (resampling)
+            {
+                Resampler resampler;
+                std::vector<float> resampled;
+
+                if (!resampler.init(samplesPerSecond, newSamplesPerSecond, channels) ||
+                    !resampler.resample(samples, resampled))
+                {
+                    return false;
+                }
+
+                samples.swap(resampled);
+            }
+
+            data.resize(samples.size() * (newBitsPerSample / 8));
+
+            if (!convertFromFloat(samples.data(), static_cast<uint32_t>(samples.size()), newBitsPerSample, data.data()))
+            {
+                return false;
+            }
+
+            samplesPerSecond = newSamplesPerSecond;
+            bitsPerSample = newBitsPerSample;
+            blockAlign = static_cast<uint16_t>(channels * (bitsPerSample / 8));
+            averageBytesPerSecond = samplesPerSecond * blockAlign;
+
+            return true;
+        }
+
+        bool SoundData::restartStream(bool loop)
+        {
+            if (!streaming)
+            {
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(streamMutex);
+
+                looping = loop;
+
+                if (!decoder->rewind())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to rewind sound stream");
+                    return false;
+                }
+
+                streamReadPosition = 0;
+                streamWritePosition = 0;
+                streamEnded = false;
+
+                // the first chunk is decoded right away, so that the playback starts with the next mixed buffer
+                decodeChunk();
+            }
+
+            streamCondition.notify_one();
+
+            return true;
+        }
+
+        uint32_t SoundData::peekStream(uint8_t* output, uint32_t frames)
+        {
+            uint64_t readPosition = streamReadPosition.load(std::memory_order_relaxed);
+            uint64_t available = streamWritePosition.load(std::memory_order_acquire) - readPosition;
+            uint32_t count = static_cast<uint32_t>(std::min(static_cast<uint64_t>(frames), available));
+
+            uint32_t capacity = CHUNK_FRAMES * CHUNK_COUNT;
+            uint32_t start = static_cast<uint32_t>(readPosition % capacity);
+            uint32_t first = std::min(count, capacity - start);
+
+            memcpy(output, streamBuffer.data() + start * frameSize, first * frameSize);
+            memcpy(output + first * frameSize, streamBuffer.data(), (count - first) * frameSize);
+
+            return count;
+        }
+
+        void SoundData::skipStream(uint32_t frames)
+        {
+            streamReadPosition.fetch_add(frames, std::memory_order_release);
+            streamCondition.notify_one();
+        }
+
+        bool SoundData::isStreamFinished() const
+        {
+            return streamEnded.load(std::memory_order_acquire) &&
+                streamReadPosition.load(std::memory_order_relaxed) == streamWritePosition.load(std::memory_order_relaxed);
+        }
+
+        void SoundData::stopStream()
+        {
+            {
+                std::lock_guard<std::mutex> lock(streamMutex);
+                streamRunning = false;
+            }
+
+            streamCondition.notify_one();
+
+            if (streamThread.joinable()) streamThread.join();
+        }
+
+        void SoundData::runStream()
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+
+            while (streamRunning)
+            {
+                uint64_t used = streamWritePosition.load(std::memory_order_relaxed) - streamReadPosition.load(std::memory_order_acquire);
+
+                if (!streamEnded && used + CHUNK_FRAMES <= CHUNK_FRAMES * CHUNK_COUNT)
+                {
+                    decodeChunk();
+                }
+                else
+                {
+                    // woken up when the mixer consumes frames, the timeout covers a notification that came before the wait
+                    streamCondition.wait_for(lock, std::chrono::milliseconds(10));
+                }
+            }
+        }
+
+        // called with the stream mutex locked
+        void SoundData::decodeChunk()
+        {
+            uint64_t writePosition = streamWritePosition.load(std::memory_order_relaxed);
+            uint8_t* output = streamBuffer.data() + (writePosition % (CHUNK_FRAMES * CHUNK_COUNT)) * frameSize;
+
+            uint32_t decoded = 0;
+            bool rewound = false;
+
+            while (decoded < CHUNK_FRAMES)
+            {
+                uint32_t count = decoder->read(output + decoded * frameSize, CHUNK_FRAMES - decoded);
+
+                if (count > 0)
+                {
+                    decoded += count;
+                    rewound = false;
+                }
+                else if (looping && !rewound && decoder->rewind())
+                {
+                    // the start of the file follows its end in the same chunk, so the loop has no gap
+                    rewound = true;
+                }
+                else
+                {
+                    streamEnded = true;
+                    break;
+                }
+            }
+
+            streamWritePosition.store(writePosition + decoded, std::memory_order_release);
+        }
     } // namespace audio
 } // namespace ouzel
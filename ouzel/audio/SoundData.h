@@ -3,9 +3,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
+#include "audio/Decoder.h"
 
 namespace ouzel
 {
@@ -20,8 +27,17 @@ namespace ouzel
             virtual ~SoundData();
             virtual void free();
 
-            virtual bool initFromFile(const std::string& newFilename);
-            virtual bool initFromBuffer(const std::vector<uint8_t>& newData);
+            // if streaming, only a few chunks of the file are kept decoded and the rest are decoded while playing
+            virtual bool initFromFile(const std::string& newFilename, bool newStreaming = false);
+            virtual bool initFromBuffer(const uint8_t* newData, size_t newSize);
+            bool initFromBuffer(const std::vector<uint8_t>& newData) { return initFromBuffer(newData.data(), newData.size()); }
+
+            // converts the samples to the sample rate and to at most 16 bits, so that the mixer does not have to convert
+            // them while playing, loaded sound data is converted to the rate of the mixer
+            bool convert(uint32_t newSamplesPerSecond);
+
+            // the decoder is selected by the extension of the streamed file
+            static void registerDecoder(const std::string& extension, const std::function<Decoder*()>& factory);
 
             const std::vector<uint8_t>& getData() const { return data; }
 
@@ -32,11 +48,26 @@ namespace ouzel
             uint16_t getBlockAlign() const { return blockAlign; }
             uint16_t getBitsPerSample() const { return bitsPerSample; }
 
+            bool isStreaming() const { return streaming; }
+
+            // bytes of decoded samples that are kept in memory
+            size_t getMemorySize() const { return data.size() + streamBuffer.size(); }
+
+            // a streamed sound data can be played by one voice at a time, the mixer reads the stream from its thread
+            bool restartStream(bool loop);
+            uint32_t peekStream(uint8_t* output, uint32_t frames);
+            void skipStream(uint32_t frames);
+            bool isStreamFinished() const;
+
             bool isReady() const { return ready; }
 
         protected:
             SoundData();
 
+            void stopStream();
+            void runStream();
+            void decodeChunk();
+
             std::string filename;
 
             uint16_t formatTag = 0;
@@ -48,6 +79,25 @@ namespace ouzel
 
             std::vector<uint8_t> data;
 
+            static const uint32_t CHUNK_FRAMES = 4096;
+            static const uint32_t CHUNK_COUNT = 4;
+
+            bool streaming = false;
+            std::unique_ptr<Decoder> decoder;
+            uint32_t frameSize = 0;
+
+            // ring of decoded chunks, the positions are in frames and only grow until the stream is restarted
+            std::vector<uint8_t> streamBuffer;
+            std::atomic<uint64_t> streamReadPosition;
+            std::atomic<uint64_t> streamWritePosition;
+            std::atomic<bool> streamEnded;
+            bool looping = false;
+
+            std::mutex streamMutex;
+            std::condition_variable streamCondition;
+            bool streamRunning = false;
+            std::thread streamThread;
+
             bool ready = false;
         };
     } // namespace audio
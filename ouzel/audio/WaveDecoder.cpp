@@ -0,0 +1,166 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "WaveDecoder.h"
+#include "core/Application.h"
+#include "files/FileSystem.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        WaveDecoder::WaveDecoder()
+        {
+        }
+
+        WaveDecoder::~WaveDecoder()
+        {
+        }
+
+        bool WaveDecoder::open(const std::string& filename)
+        {
+            std::string path = sharedApplication->getFileSystem()->getPath(filename);
+
+            if (path.empty())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to find file %s", filename.c_str());
+                return false;
+            }
+
+            file.open(path, std::ios::binary);
+
+            if (!file)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to open file %s", path.c_str());
+                return false;
+            }
+
+            uint8_t header[12];
+
+            if (!file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, file too small");
+                return false;
+            }
+
+            if (header[0] != 'R' || header[1] != 'I' || header[2] != 'F' || header[3] != 'F')
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, not a RIFF format");
+                return false;
+            }
+
+            if (header[8] != 'W' || header[9] != 'A' || header[10] != 'V' || header[11] != 'E')
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, not a WAVE file");
+                return false;
+            }
+
+            bool formatChunkFound = false;
+            bool dataChunkFound = false;
+
+            // only the chunk headers are read, the data chunk is read when decoding
+            while (!formatChunkFound || !dataChunkFound)
+            {
+                uint8_t chunkHeader[8];
+
+                if (!file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader)))
+                {
+                    break;
+                }
+
+                uint32_t chunkSize = readUInt32Little(chunkHeader + 4);
+                std::streamoff chunkOffset = file.tellg();
+
+                if (chunkHeader[0] == 'f' && chunkHeader[1] == 'm' && chunkHeader[2] == 't' && chunkHeader[3] == ' ')
+                {
+                    uint8_t format[16];
+
+                    if (chunkSize < 16 || !file.read(reinterpret_cast<char*>(format), sizeof(format)))
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load sound file, not enough data to read chunk");
+                        return false;
+                    }
+
+                    if (readUInt16Little(format) != 1)
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load sound file, bad format tag.");
+                        return false;
+                    }
+
+                    channels = readUInt16Little(format + 2);
+                    samplesPerSecond = readUInt32Little(format + 4);
+                    bitsPerSample = readUInt16Little(format + 14);
+
+                    formatChunkFound = true;
+                }
+                else if (chunkHeader[0] == 'd' && chunkHeader[1] == 'a' && chunkHeader[2] == 't' && chunkHeader[3] == 'a')
+                {
+                    dataOffset = chunkOffset;
+                    dataSize = chunkSize;
+
+                    dataChunkFound = true;
+                }
+
+                file.seekg(chunkOffset + ((chunkSize + 1) & 0xFFFFFFFE));
+            }
+
+            if (!formatChunkFound)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, failed to find a format chunk");
+                return false;
+            }
+
+            if (!dataChunkFound)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, failed to find a data chunk");
+                return false;
+            }
+
+            frameSize = channels * (bitsPerSample / 8);
+
+            if (frameSize == 0)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load sound file, invalid format");
+                return false;
+            }
+
+            return rewind();
+        }
+
+        uint32_t WaveDecoder::read(uint8_t* output, uint32_t frames)
+        {
+            uint32_t size = std::min(frames * frameSize, remainingSize - remainingSize % frameSize);
+
+            if (size == 0)
+            {
+                return 0;
+            }
+
+            file.read(reinterpret_cast<char*>(output), size);
+            size = static_cast<uint32_t>(file.gcount());
+
+            if (!file)
+            {
+                // the file is shorter than the data chunk
+                remainingSize = 0;
+            }
+            else
+            {
+                remainingSize -= size;
+            }
+
+            return size / frameSize;
+        }
+
+        bool WaveDecoder::rewind()
+        {
+            file.clear();
+            file.seekg(dataOffset);
+            remainingSize = dataSize;
+
+            return static_cast<bool>(file);
+        }
+    } // namespace audio
+} // namespace ouzel
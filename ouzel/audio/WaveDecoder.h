@@ -0,0 +1,32 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <fstream>
+#include "audio/Decoder.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // reads the PCM data chunk of a WAVE file straight from the file
+        class WaveDecoder: public Decoder
+        {
+        public:
+            WaveDecoder();
+            virtual ~WaveDecoder();
+
+            virtual bool open(const std::string& filename) override;
+            virtual uint32_t read(uint8_t* output, uint32_t frames) override;
+            virtual bool rewind() override;
+
+        protected:
+            std::ifstream file;
+            uint32_t frameSize = 0;
+            std::streamoff dataOffset = 0;
+            uint32_t dataSize = 0;
+            uint32_t remainingSize = 0;
+        };
+    } // namespace audio
+} // namespace ouzel
@@ -12,6 +12,12 @@
 #include "graphics/Shader.h"
 #include "scene/ParticleDefinition.h"
 #include "scene/SpriteFrame.h"
+#include "scene/SpriteClip.h"
+#include "gui/BMFont.h"
+#include "gui/TTFont.h"
+#include "gui/GlyphAtlas.h"
+#include "audio/Audio.h"
+#include "audio/SoundData.h"
 #include "files/FileSystem.h"
 #include "utils/Utils.h"
 
@@ -23,22 +29,30 @@ namespace ouzel
 
     Cache::~Cache()
     {
+        {
+            std::lock_guard<std::mutex> lock(soundDataMutex);
+            soundDataThreadRunning = false;
+        }
+
+        soundDataCondition.notify_all();
+
+        if (soundDataThread.joinable()) soundDataThread.join();
     }
 
-    void Cache::preloadTexture(const std::string& filename, bool dynamic, bool mipmaps)
+    void Cache::preloadTexture(const std::string& filename, bool dynamic, bool mipmaps, graphics::PixelFormat pixelFormat)
     {
         std::unordered_map<std::string, graphics::TexturePtr>::const_iterator i = textures.find(filename);
 
         if (i == textures.end())
         {
             graphics::TexturePtr texture = sharedEngine->getRenderer()->createTexture();
-            texture->initFromFile(filename, dynamic, mipmaps);
+            texture->initFromFile(filename, dynamic, mipmaps, pixelFormat);
 
             textures[filename] = texture;
         }
     }
 
-    graphics::TexturePtr Cache::getTexture(const std::string& filename, bool dynamic, bool mipmaps) const
+    graphics::TexturePtr Cache::getTexture(const std::string& filename, bool dynamic, bool mipmaps, graphics::PixelFormat pixelFormat) const
     {
         graphics::TexturePtr result;
 
@@ -51,7 +65,7 @@ namespace ouzel
         else
         {
             result = sharedEngine->getRenderer()->createTexture();
-            result->initFromFile(filename, dynamic, mipmaps);
+            result->initFromFile(filename, dynamic, mipmaps, pixelFormat);
 
             textures[filename] = result;
         }
@@ -69,39 +83,45 @@ namespace ouzel
         textures.clear();
     }
 
-    void Cache::preloadSpriteFrames(const std::string& filename, bool mipmaps)
+    size_t Cache::getTextureMemorySize() const
     {
-        std::string extension = sharedApplication->getFileSystem()->getExtensionPart(filename);
+        size_t result = 0;
 
-        std::vector<scene::SpriteFramePtr> frames;
-
-        if (extension == "json")
+        for (const auto& texture : textures)
         {
-            frames = scene::SpriteFrame::loadSpriteFrames(filename, mipmaps);
+            result += texture.second->getMemorySize();
         }
-        else
-        {
-            graphics::TexturePtr texture = sharedEngine->getCache()->getTexture(filename, false, mipmaps);
 
-            if (!texture)
-            {
-                return;
-            }
+        return result;
+    }
 
-            Rectangle rectangle(0, 0, texture->getSize().width, texture->getSize().height);
+    void Cache::preloadSpriteFrames(const std::string& filename, bool mipmaps)
+    {
+        getSpriteClip(filename, mipmaps);
+    }
 
-            scene::SpriteFramePtr frame = std::make_shared<scene::SpriteFrame>(texture, rectangle, false, texture->getSize(), Vector2(), Vector2(0.5f, 0.5f));
-            frames.push_back(frame);
-        }
+    std::vector<scene::SpriteFramePtr> Cache::getSpriteFrames(const std::string& filename, bool mipmaps) const
+    {
+        scene::SpriteClipPtr clip = getSpriteClip(filename, mipmaps);
 
-        spriteFrames[filename] = frames;
+        return clip ? clip->getFrames() : std::vector<scene::SpriteFramePtr>();
     }
 
-    std::vector<scene::SpriteFramePtr> Cache::getSpriteFrames(const std::string& filename, bool mipmaps) const
+    void Cache::setSpriteFrames(const std::string& filename, const std::vector<scene::SpriteFramePtr>& frames)
     {
-        std::unordered_map<std::string, std::vector<scene::SpriteFramePtr>>::const_iterator i = spriteFrames.find(filename);
+        spriteClips[filename] = std::make_shared<scene::SpriteClip>(frames);
+    }
+
+    void Cache::releaseSpriteFrames()
+    {
+        spriteClips.clear();
+    }
 
-        if (i != spriteFrames.end())
+    scene::SpriteClipPtr Cache::getSpriteClip(const std::string& filename, bool mipmaps) const
+    {
+        std::unordered_map<std::string, scene::SpriteClipPtr>::const_iterator i = spriteClips.find(filename);
+
+        if (i != spriteClips.end())
         {
             return i->second;
         }
@@ -121,7 +141,7 @@ namespace ouzel
 
                 if (!texture)
                 {
-                    return frames;
+                    return nullptr;
                 }
 
                 Rectangle rectangle(0.0f, 0.0f, texture->getSize().width, texture->getSize().height);
@@ -130,20 +150,11 @@ namespace ouzel
                 frames.push_back(frame);
             }
 
-            spriteFrames[filename] = frames;
-            
-            return frames;
-        }
-    }
+            scene::SpriteClipPtr clip = std::make_shared<scene::SpriteClip>(frames);
+            spriteClips[filename] = clip;
 
-    void Cache::setSpriteFrames(const std::string& filename, const std::vector<scene::SpriteFramePtr>& frames)
-    {
-        spriteFrames[filename] = frames;
-    }
-
-    void Cache::releaseSpriteFrames()
-    {
-        spriteFrames.clear();
+            return clip;
+        }
     }
 
     graphics::ShaderPtr Cache::getShader(const std::string& shaderName) const
@@ -221,4 +232,235 @@ namespace ouzel
     {
         blendStates[blendStateName] = blendState;
     }
+
+    void Cache::preloadFont(const std::string& filename, uint32_t pixelSize)
+    {
+        getFont(filename, pixelSize);
+    }
+
+    FontPtr Cache::getFont(const std::string& filename, uint32_t pixelSize) const
+    {
+        FontPtr result;
+
+        std::string extension = sharedApplication->getFileSystem()->getExtensionPart(filename);
+        bool trueType = (extension == "ttf" || extension == "otf");
+
+        if (trueType && !pixelSize)
+        {
+            pixelSize = TTFont::DEFAULT_PIXEL_SIZE;
+        }
+
+        // every size of a TrueType font is a separate font
+        std::string key = trueType ? filename + ":" + std::to_string(pixelSize) : filename;
+
+        std::unordered_map<std::string, FontPtr>::const_iterator i = fonts.find(key);
+
+        if (i != fonts.end())
+        {
+            return i->second;
+        }
+        else
+        {
+            if (trueType)
+            {
+                if (!glyphAtlas)
+                {
+                    glyphAtlas = std::make_shared<GlyphAtlas>();
+                }
+
+                result = TTFont::loadFont(filename, pixelSize, glyphAtlas);
+            }
+            else
+            {
+                result = BMFont::loadFont(filename);
+            }
+
+            if (result)
+            {
+                fonts[key] = result;
+            }
+        }
+
+        return result;
+    }
+
+    void Cache::releaseFonts()
+    {
+        fonts.clear();
+        glyphAtlas.reset();
+    }
+
+    void Cache::preloadSoundData(const std::string& filename)
+    {
+        std::lock_guard<std::mutex> lock(soundDataMutex);
+
+        if (soundData.find(filename) != soundData.end() ||
+            loadingSoundData.find(filename) != loadingSoundData.end())
+        {
+            return;
+        }
+
+        // the object is created on this thread, the file is opened and decoded on the loading thread
+        SoundDataRequest request;
+        request.id = ++lastSoundDataRequestId;
+        request.filename = filename;
+        request.soundData = sharedEngine->getAudio()->createSoundData();
+
+        loadingSoundData[filename] = { request.id, request.promise.get_future().share() };
+        soundDataRequests.push_back(std::move(request));
+
+        if (!soundDataThreadRunning)
+        {
+            soundDataThreadRunning = true;
+            soundDataThread = std::thread(&Cache::loadSoundData, this);
+        }
+
+        soundDataCondition.notify_one();
+    }
+
+    audio::SoundDataPtr Cache::getSoundData(const std::string& filename) const
+    {
+        std::shared_future<audio::SoundDataPtr> loading;
+
+        {
+            std::lock_guard<std::mutex> lock(soundDataMutex);
+
+            std::unordered_map<std::string, audio::SoundDataPtr>::const_iterator i = soundData.find(filename);
+
+            if (i != soundData.end())
+            {
+                return i->second;
+            }
+
+            std::unordered_map<std::string, LoadingSoundData>::const_iterator l = loadingSoundData.find(filename);
+
+            if (l != loadingSoundData.end())
+            {
+                loading = l->second.future;
+            }
+        }
+
+        // wait without holding the lock, so that the loading thread can store the result
+        if (loading.valid())
+        {
+            return loading.get();
+        }
+
+        audio::SoundDataPtr result = sharedEngine->getAudio()->createSoundData();
+
+        if (!result->initFromFile(filename))
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(soundDataMutex);
+
+        std::unordered_map<std::string, audio::SoundDataPtr>::const_iterator i = soundData.find(filename);
+
+        // the same file could have been loaded by another thread in the meantime
+        if (i != soundData.end())
+        {
+            return i->second;
+        }
+
+        soundData[filename] = result;
+        soundDataMemorySize += result->getMemorySize();
+
+        return result;
+    }
+
+    void Cache::setSoundData(const std::string& filename, const audio::SoundDataPtr& newSoundData)
+    {
+        std::lock_guard<std::mutex> lock(soundDataMutex);
+
+        std::unordered_map<std::string, audio::SoundDataPtr>::iterator i = soundData.find(filename);
+
+        if (i != soundData.end())
+        {
+            soundDataMemorySize -= i->second->getMemorySize();
+        }
+
+        // a sound data that is still loading is replaced, the result of the loading is discarded
+        loadingSoundData.erase(filename);
+
+        if (newSoundData)
+        {
+            soundData[filename] = newSoundData;
+            soundDataMemorySize += newSoundData->getMemorySize();
+        }
+        else if (i != soundData.end())
+        {
+            soundData.erase(i);
+        }
+    }
+
+    void Cache::releaseSoundData()
+    {
+        std::lock_guard<std::mutex> lock(soundDataMutex);
+
+        // the requests that are already queued are still loaded, but they are not cached
+        soundData.clear();
+        loadingSoundData.clear();
+        soundDataMemorySize = 0;
+    }
+
+    size_t Cache::getSoundDataMemorySize() const
+    {
+        std::lock_guard<std::mutex> lock(soundDataMutex);
+
+        return soundDataMemorySize;
+    }
+
+    void Cache::loadSoundData()
+    {
+        for (;;)
+        {
+            SoundDataRequest request;
+
+            {
+                std::unique_lock<std::mutex> lock(soundDataMutex);
+
+                while (soundDataThreadRunning && soundDataRequests.empty())
+                {
+                    soundDataCondition.wait(lock);
+                }
+
+                if (!soundDataThreadRunning)
+                {
+                    break;
+                }
+
+                request = std::move(soundDataRequests.front());
+                soundDataRequests.pop_front();
+            }
+
+            audio::SoundDataPtr result;
+
+            if (request.soundData->initFromFile(request.filename))
+            {
+                result = request.soundData;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(soundDataMutex);
+
+                std::unordered_map<std::string, LoadingSoundData>::iterator l = loadingSoundData.find(request.filename);
+
+                // only cached if it was not released or replaced while loading, a newer request of the same file
+                // is left for its own loading
+                if (l != loadingSoundData.end() && l->second.requestId == request.id)
+                {
+                    if (result)
+                    {
+                        soundData[request.filename] = result;
+                        soundDataMemorySize += result->getMemorySize();
+                    }
+
+                    loadingSoundData.erase(l);
+                }
+            }
+
+            request.promise.set_value(result);
+        }
+    }
 }
@@ -3,11 +3,17 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
 #include "utils/Types.h"
 #include "utils/Noncopyable.h"
+#include "graphics/PixelFormat.h"
 
 namespace ouzel
 {
@@ -17,16 +23,24 @@ namespace ouzel
         Cache();
         virtual ~Cache();
 
-        void preloadTexture(const std::string& filename, bool dynamic = false, bool mipmaps = true);
-        graphics::TexturePtr getTexture(const std::string& filename, bool dynamic = false, bool mipmaps = true) const;
+        // the pixel format is used for images, cooked, DDS and KTX textures have their own
+        void preloadTexture(const std::string& filename, bool dynamic = false, bool mipmaps = true,
+                            graphics::PixelFormat pixelFormat = graphics::PixelFormat::RGBA8);
+        graphics::TexturePtr getTexture(const std::string& filename, bool dynamic = false, bool mipmaps = true,
+                                        graphics::PixelFormat pixelFormat = graphics::PixelFormat::RGBA8) const;
         void setTexture(const std::string& filename, const graphics::TexturePtr& texture);
         void releaseTextures();
 
+        // bytes of pixel data of the cached textures
+        size_t getTextureMemorySize() const;
+
         void preloadSpriteFrames(const std::string& filename, bool mipmaps = true);
         std::vector<scene::SpriteFramePtr> getSpriteFrames(const std::string& filename, bool mipmaps = true) const;
         void setSpriteFrames(const std::string& filename, const std::vector<scene::SpriteFramePtr>& frames);
         void releaseSpriteFrames();
 
+        scene::SpriteClipPtr getSpriteClip(const std::string& filename, bool mipmaps = true) const;
+
         graphics::ShaderPtr getShader(const std::string& shaderName) const;
         void setShader(const std::string& shaderName, const graphics::ShaderPtr& shader);
 
@@ -36,11 +50,58 @@ namespace ouzel
         graphics::BlendStatePtr getBlendState(const std::string& blendStateName) const;
         void setBlendState(const std::string& blendStateName, const graphics::BlendStatePtr& blendState);
 
+        // TrueType and OpenType fonts are rasterized at the given pixel size into the shared glyph atlas,
+        // the pixel size is ignored for bitmap fonts
+        void preloadFont(const std::string& filename, uint32_t pixelSize = 0);
+        FontPtr getFont(const std::string& filename, uint32_t pixelSize = 0) const;
+        void releaseFonts();
+
+        // the sound data is loaded and decoded on a background thread, getSoundData waits only if it is still loading
+        void preloadSoundData(const std::string& filename);
+        audio::SoundDataPtr getSoundData(const std::string& filename) const;
+        void setSoundData(const std::string& filename, const audio::SoundDataPtr& newSoundData);
+        void releaseSoundData();
+
+        // bytes of decoded samples of the cached sound data
+        size_t getSoundDataMemorySize() const;
+
     protected:
+        void loadSoundData();
+
         mutable std::unordered_map<std::string, graphics::TexturePtr> textures;
         mutable std::unordered_map<std::string, graphics::ShaderPtr> shaders;
         mutable std::unordered_map<std::string, scene::ParticleDefinitionPtr> particleDefinitions;
         mutable std::unordered_map<std::string, graphics::BlendStatePtr> blendStates;
-        mutable std::unordered_map<std::string, std::vector<scene::SpriteFramePtr>> spriteFrames;
+        mutable std::unordered_map<std::string, scene::SpriteClipPtr> spriteClips;
+        mutable std::unordered_map<std::string, FontPtr> fonts;
+        mutable GlyphAtlasPtr glyphAtlas;
+
+        // the sound data is accessed by the loading thread, so it is guarded by the mutex
+        mutable std::mutex soundDataMutex;
+        mutable std::unordered_map<std::string, audio::SoundDataPtr> soundData;
+
+        // the id tells a request apart from later requests of the same file, if the file was released and preloaded again
+        struct LoadingSoundData
+        {
+            uint32_t requestId;
+            std::shared_future<audio::SoundDataPtr> future;
+        };
+
+        mutable std::unordered_map<std::string, LoadingSoundData> loadingSoundData;
+        mutable size_t soundDataMemorySize = 0;
+        uint32_t lastSoundDataRequestId = 0;
+
+        struct SoundDataRequest
+        {
+            uint32_t id = 0;
+            std::string filename;
+            audio::SoundDataPtr soundData;
+            std::promise<audio::SoundDataPtr> promise;
+        };
+
+        std::deque<SoundDataRequest> soundDataRequests;
+        std::condition_variable soundDataCondition;
+        bool soundDataThreadRunning = false;
+        std::thread soundDataThread;
     };
 }
@@ -10,6 +10,8 @@
 #include "graphics/Renderer.h"
 #include "audio/Audio.h"
 #include "scene/SceneManager.h"
+#include "scene/SpriteAnimationSystem.h"
+#include "scene/ParticleWorld.h"
 #include "events/EventDispatcher.h"
 
 #if OUZEL_PLATFORM_MACOS
@@ -88,6 +90,8 @@ namespace ouzel
 
         if (updateThread.joinable()) updateThread.join();
         sceneManager.reset();
+        spriteAnimationSystem.reset();
+        particleWorld.reset();
     }
 
     std::set<graphics::Renderer::Driver> Engine::getAvailableRenderDrivers()
@@ -182,6 +186,8 @@ namespace ouzel
 
         eventDispatcher.reset(new EventDispatcher());
         cache.reset(new Cache());
+        spriteAnimationSystem.reset(new scene::SpriteAnimationSystem());
+        particleWorld.reset(new scene::ParticleWorld());
         sceneManager.reset(new scene::SceneManager());
 
 #if OUZEL_PLATFORM_MACOS || OUZEL_PLATFORM_IOS || OUZEL_PLATFORM_TVOS
@@ -38,6 +38,8 @@ namespace ouzel
         const graphics::RendererPtr& getRenderer() const { return renderer; }
         const audio::AudioPtr& getAudio() const { return audio; }
         const scene::SceneManagerPtr& getSceneManager() const { return sceneManager; }
+        const scene::SpriteAnimationSystemPtr& getSpriteAnimationSystem() const { return spriteAnimationSystem; }
+        const scene::ParticleWorldPtr& getParticleWorld() const { return particleWorld; }
         const input::InputPtr& getInput() const { return input; }
         const LocalizationPtr& getLocalization() const { return localization; }
 
@@ -69,6 +71,8 @@ namespace ouzel
         graphics::RendererPtr renderer;
         audio::AudioPtr audio;
         CachePtr cache;
+        scene::SpriteAnimationSystemPtr spriteAnimationSystem;
+        scene::ParticleWorldPtr particleWorld;
         scene::SceneManagerPtr sceneManager;
 
         std::atomic<float> currentFPS;
@@ -37,8 +37,7 @@ namespace ouzel
             size = newSize;
             sharedEngine->getRenderer()->setSize(size);
 
-            Event event;
-            event.type = Event::Type::WINDOW_SIZE_CHANGE;
+            Event event(Event::Type::WINDOW_SIZE_CHANGE);
 
             event.windowEvent.window = shared_from_this();
             event.windowEvent.size = size;
@@ -57,8 +56,7 @@ namespace ouzel
 
             sharedEngine->getRenderer()->setFullscreen(fullscreen);
 
-            Event event;
-            event.type = Event::Type::WINDOW_FULLSCREEN_CHANGE;
+            Event event(Event::Type::WINDOW_FULLSCREEN_CHANGE);
 
             event.windowEvent.window = shared_from_this();
             event.windowEvent.size = size;
@@ -75,8 +73,7 @@ namespace ouzel
         {
             title = newTitle;
 
-            Event event;
-            event.type = Event::Type::WINDOW_TITLE_CHANGE;
+            Event event(Event::Type::WINDOW_TITLE_CHANGE);
 
             event.windowEvent.window = shared_from_this();
             event.windowEvent.size = size;
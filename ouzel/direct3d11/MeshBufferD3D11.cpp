@@ -171,7 +171,7 @@ namespace ouzel
                 }
 
                 dirty = 0;
-                ready = (indexBuffer && vertexBuffer);
+                ready = ((indexBuffer || uploadData.indexBufferSource) && vertexBuffer);
             }
 
             return true;
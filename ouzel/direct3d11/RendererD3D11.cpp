@@ -186,6 +186,41 @@ namespace ouzel
                 log(LOG_LEVEL_INFO, "Using %s for rendering", deviceName);
             }
 
+            switch (device->GetFeatureLevel())
+            {
+                case D3D_FEATURE_LEVEL_9_1:
+                case D3D_FEATURE_LEVEL_9_2:
+                    maxTextureSize = 2048;
+                    break;
+                case D3D_FEATURE_LEVEL_9_3:
+                    maxTextureSize = 4096;
+                    break;
+                case D3D_FEATURE_LEVEL_10_0:
+                case D3D_FEATURE_LEVEL_10_1:
+                    maxTextureSize = 8192;
+                    break;
+                default:
+                    maxTextureSize = D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION;
+                    break;
+            }
+
+            // BC1-3 are supported by all the feature levels, the 16-bit formats need DXGI 1.2
+            supportedPixelFormats = { PixelFormat::RGBA8, PixelFormat::A8, PixelFormat::BC1, PixelFormat::BC2, PixelFormat::BC3 };
+
+            UINT formatSupport;
+
+            if (SUCCEEDED(device->CheckFormatSupport(DXGI_FORMAT_B5G6R5_UNORM, &formatSupport)) &&
+                (formatSupport & D3D11_FORMAT_SUPPORT_TEXTURE2D))
+            {
+                supportedPixelFormats.insert(PixelFormat::RGB565);
+            }
+
+            if (SUCCEEDED(device->CheckFormatSupport(DXGI_FORMAT_B4G4R4A4_UNORM, &formatSupport)) &&
+                (formatSupport & D3D11_FORMAT_SUPPORT_TEXTURE2D))
+            {
+                supportedPixelFormats.insert(PixelFormat::RGBA4444);
+            }
+
             std::shared_ptr<WindowWin> windowWin = std::static_pointer_cast<WindowWin>(window);
 
             DXGI_SWAP_CHAIN_DESC swapChainDesc;
@@ -403,6 +438,16 @@ namespace ouzel
 
             sharedEngine->getCache()->setBlendState(BLEND_ALPHA, alphaBlendState);
 
+            BlendStatePtr premultipliedAlphaBlendState = createBlendState();
+
+            premultipliedAlphaBlendState->init(true,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::INV_SRC_ALPHA,
+                                               BlendState::BlendOperation::ADD,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::ONE,
+                                               BlendState::BlendOperation::ADD);
+
+            sharedEngine->getCache()->setBlendState(BLEND_PREMULTIPLIED_ALPHA, premultipliedAlphaBlendState);
+
             TexturePtr whitePixelTexture = createTexture();
             whitePixelTexture->initFromBuffer( { 255, 255, 255, 255 }, Size2(1.0f, 1.0f), false, false);
             sharedEngine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
@@ -709,6 +754,15 @@ namespace ouzel
                     continue;
                 }
 
+                // indices can come from a shared index buffer
+                std::shared_ptr<MeshBufferD3D11> indexBufferD3D11 = meshBufferD3D11->uploadData.indexBufferSource ?
+                    std::static_pointer_cast<MeshBufferD3D11>(meshBufferD3D11->uploadData.indexBufferSource) : meshBufferD3D11;
+
+                if (!indexBufferD3D11->getIndexBuffer())
+                {
+                    continue;
+                }
+
                 // draw
                 context->OMSetDepthStencilState(depthStencilState, 0);
 
@@ -716,7 +770,7 @@ namespace ouzel
                 UINT strides[] = { meshBufferD3D11->getVertexSize() };
                 UINT offsets[] = { 0 };
                 context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
-                context->IASetIndexBuffer(meshBufferD3D11->getIndexBuffer(), meshBufferD3D11->getIndexFormat(), 0);
+                context->IASetIndexBuffer(indexBufferD3D11->getIndexBuffer(), indexBufferD3D11->getIndexFormat(), 0);
 
                 D3D_PRIMITIVE_TOPOLOGY topology;
 
@@ -12,6 +12,37 @@ namespace ouzel
 {
     namespace graphics
     {
+        static DXGI_FORMAT getTextureFormat(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8: return DXGI_FORMAT_R8G8B8A8_UNORM;
+                case PixelFormat::RGB565: return DXGI_FORMAT_B5G6R5_UNORM;
+                case PixelFormat::RGBA4444: return DXGI_FORMAT_B4G4R4A4_UNORM;
+                case PixelFormat::A8: return DXGI_FORMAT_A8_UNORM;
+                case PixelFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+                case PixelFormat::BC2: return DXGI_FORMAT_BC2_UNORM;
+                case PixelFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+                default: return DXGI_FORMAT_UNKNOWN;
+            }
+        }
+
+        // B4G4R4A4 has alpha in the highest bits
+        static std::vector<uint8_t> swizzleRGBA4444(const std::vector<uint8_t>& data)
+        {
+            std::vector<uint8_t> swizzled(data.size());
+
+            for (size_t i = 0; i + 1 < data.size(); i += 2)
+            {
+                uint16_t value = static_cast<uint16_t>(data[i] | (data[i + 1] << 8));
+                value = static_cast<uint16_t>((value >> 4) | (value << 12));
+                swizzled[i] = static_cast<uint8_t>(value);
+                swizzled[i + 1] = static_cast<uint8_t>(value >> 8);
+            }
+
+            return swizzled;
+        }
+
         TextureD3D11::TextureD3D11()
         {
         }
@@ -55,14 +86,30 @@ namespace ouzel
                 if (uploadData.size.width > 0 &&
                     uploadData.size.height > 0)
                 {
+                    DXGI_FORMAT newFormat = uploadData.renderTarget ? DXGI_FORMAT_R8G8B8A8_UNORM : getTextureFormat(uploadData.pixelFormat);
+
+                    if (newFormat == DXGI_FORMAT_UNKNOWN)
+                    {
+                        log(LOG_LEVEL_ERROR, "Invalid texture pixel format");
+                        return false;
+                    }
+
                     if (!texture ||
                         static_cast<UINT>(uploadData.size.width) != width ||
-                        static_cast<UINT>(uploadData.size.height) != height)
+                        static_cast<UINT>(uploadData.size.height) != height ||
+                        newFormat != format)
                     {
+                        if (resourceView)
+                        {
+                            resourceView->Release();
+                            resourceView = nullptr;
+                        }
+
                         if (texture) texture->Release();
 
                         width = static_cast<UINT>(uploadData.size.width);
                         height = static_cast<UINT>(uploadData.size.height);
+                        format = newFormat;
 
                         D3D11_TEXTURE2D_DESC textureDesc;
                         memset(&textureDesc, 0, sizeof(textureDesc));
@@ -70,7 +117,7 @@ namespace ouzel
                         textureDesc.Height = height;
                         textureDesc.MipLevels = 0;
                         textureDesc.ArraySize = 1;
-                        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+                        textureDesc.Format = format;
                         textureDesc.Usage = uploadData.dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_DEFAULT;
                         textureDesc.CPUAccessFlags = uploadData.dynamic ? D3D11_CPU_ACCESS_WRITE : 0;
                         textureDesc.SampleDesc.Count = 1;
@@ -87,7 +134,7 @@ namespace ouzel
 
                         D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc;
                         memset(&srvDesc, 0, sizeof(srvDesc));
-                        srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+                        srvDesc.Format = format;
                         srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
                         srvDesc.Texture2D.MostDetailedMip = 0;
                         srvDesc.Texture2D.MipLevels = uploadData.mipmaps ? static_cast<UINT>(uploadData.levels.size()) : 1;
@@ -102,8 +149,44 @@ namespace ouzel
 
                     for (size_t level = 0; level < uploadData.levels.size(); ++level)
                     {
-                        UINT rowPitch = static_cast<UINT>(uploadData.levels[level].size.width) * 4;
-                        rendererD3D11->getContext()->UpdateSubresource(texture, static_cast<UINT>(level), nullptr, uploadData.levels[level].data.data(), rowPitch, 0);
+                        // the row pitch of the block-compressed formats is the size of a row of blocks
+                        UINT rowPitch = static_cast<UINT>(getPixelFormatRowSize(uploadData.pixelFormat,
+                                                                                static_cast<uint32_t>(uploadData.levels[level].size.width)));
+                        const std::vector<uint8_t>& data = uploadData.levels[level].data;
+
+                        if (uploadData.pixelFormat == PixelFormat::RGBA4444)
+                        {
+                            std::vector<uint8_t> swizzled = swizzleRGBA4444(data);
+                            rendererD3D11->getContext()->UpdateSubresource(texture, static_cast<UINT>(level), nullptr, swizzled.data(), rowPitch, 0);
+                        }
+                        else
+                        {
+                            rendererD3D11->getContext()->UpdateSubresource(texture, static_cast<UINT>(level), nullptr, data.data(), rowPitch, 0);
+                        }
+                    }
+
+                    for (const Region& region : uploadData.regions)
+                    {
+                        D3D11_BOX box;
+                        box.left = static_cast<UINT>(region.rectangle.x);
+                        box.top = static_cast<UINT>(region.rectangle.y);
+                        box.front = 0;
+                        box.right = box.left + static_cast<UINT>(region.rectangle.width);
+                        box.bottom = box.top + static_cast<UINT>(region.rectangle.height);
+                        box.back = 1;
+
+                        UINT rowPitch = static_cast<UINT>(getPixelFormatRowSize(uploadData.pixelFormat,
+                                                                                static_cast<uint32_t>(region.rectangle.width)));
+
+                        if (uploadData.pixelFormat == PixelFormat::RGBA4444)
+                        {
+                            std::vector<uint8_t> swizzled = swizzleRGBA4444(region.data);
+                            rendererD3D11->getContext()->UpdateSubresource(texture, 0, &box, swizzled.data(), rowPitch, 0);
+                        }
+                        else
+                        {
+                            rendererD3D11->getContext()->UpdateSubresource(texture, 0, &box, region.data.data(), rowPitch, 0);
+                        }
                     }
                 }
 
@@ -36,6 +36,7 @@ namespace ouzel
 
             UINT width = 0;
             UINT height = 0;
+            DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -0,0 +1,160 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <new>
+#include <utility>
+#include "Event.h"
+
+namespace ouzel
+{
+    Event::Category Event::getCategory(Type type)
+    {
+        switch (type)
+        {
+            case Type::KEY_DOWN:
+            case Type::KEY_UP:
+            case Type::KEY_REPEAT:
+                return CATEGORY_KEYBOARD;
+            case Type::MOUSE_DOWN:
+            case Type::MOUSE_UP:
+            case Type::MOUSE_SCROLL:
+            case Type::MOUSE_MOVE:
+                return CATEGORY_MOUSE;
+            case Type::TOUCH_BEGIN:
+            case Type::TOUCH_MOVE:
+            case Type::TOUCH_END:
+            case Type::TOUCH_CANCEL:
+                return CATEGORY_TOUCH;
+            case Type::GAMEPAD_CONNECT:
+            case Type::GAMEPAD_DISCONNECT:
+            case Type::GAMEPAD_BUTTON_CHANGE:
+                return CATEGORY_GAMEPAD;
+            case Type::WINDOW_SIZE_CHANGE:
+            case Type::WINDOW_TITLE_CHANGE:
+            case Type::WINDOW_FULLSCREEN_CHANGE:
+                return CATEGORY_WINDOW;
+            case Type::ORIENTATION_CHANGE:
+            case Type::LOW_MEMORY:
+            case Type::OPEN_FILE:
+                return CATEGORY_SYSTEM;
+            case Type::UI_ENTER_NODE:
+            case Type::UI_LEAVE_NODE:
+            case Type::UI_PRESS_NODE:
+            case Type::UI_RELEASE_NODE:
+            case Type::UI_CLICK_NODE:
+            case Type::UI_DRAG_NODE:
+            case Type::UI_WIDGET_CHANGE:
+                return CATEGORY_UI;
+            case Type::USER:
+            default:
+                return CATEGORY_USER;
+        }
+    }
+
+    Event::Event(Type newType):
+        type(newType)
+    {
+        construct();
+    }
+
+    Event::Event(const Event& other):
+        type(other.type)
+    {
+        construct(other);
+    }
+
+    Event::Event(Event&& other):
+        type(other.type)
+    {
+        construct(std::move(other));
+    }
+
+    Event::~Event()
+    {
+        destroy();
+    }
+
+    Event& Event::operator=(const Event& other)
+    {
+        if (&other != this)
+        {
+            destroy();
+            type = other.type;
+            construct(other);
+        }
+
+        return *this;
+    }
+
+    Event& Event::operator=(Event&& other)
+    {
+        if (&other != this)
+        {
+            destroy();
+            type = other.type;
+            construct(std::move(other));
+        }
+
+        return *this;
+    }
+
+    void Event::construct()
+    {
+        switch (getCategory(type))
+        {
+            case CATEGORY_KEYBOARD: new (&keyboardEvent) KeyboardEvent(); break;
+            case CATEGORY_MOUSE: new (&mouseEvent) MouseEvent(); break;
+            case CATEGORY_TOUCH: new (&touchEvent) TouchEvent(); break;
+            case CATEGORY_GAMEPAD: new (&gamepadEvent) GamepadEvent(); break;
+            case CATEGORY_WINDOW: new (&windowEvent) WindowEvent(); break;
+            case CATEGORY_SYSTEM: new (&systemEvent) SystemEvent(); break;
+            case CATEGORY_UI: new (&uiEvent) UIEvent(); break;
+            default: new (&userEvent) UserEvent(); break;
+        }
+    }
+
+    void Event::construct(const Event& other)
+    {
+        switch (getCategory(type))
+        {
+            case CATEGORY_KEYBOARD: new (&keyboardEvent) KeyboardEvent(other.keyboardEvent); break;
+            case CATEGORY_MOUSE: new (&mouseEvent) MouseEvent(other.mouseEvent); break;
+            case CATEGORY_TOUCH: new (&touchEvent) TouchEvent(other.touchEvent); break;
+            case CATEGORY_GAMEPAD: new (&gamepadEvent) GamepadEvent(other.gamepadEvent); break;
+            case CATEGORY_WINDOW: new (&windowEvent) WindowEvent(other.windowEvent); break;
+            case CATEGORY_SYSTEM: new (&systemEvent) SystemEvent(other.systemEvent); break;
+            case CATEGORY_UI: new (&uiEvent) UIEvent(other.uiEvent); break;
+            default: new (&userEvent) UserEvent(other.userEvent); break;
+        }
+    }
+
+    void Event::construct(Event&& other)
+    {
+        switch (getCategory(type))
+        {
+            case CATEGORY_KEYBOARD: new (&keyboardEvent) KeyboardEvent(std::move(other.keyboardEvent)); break;
+            case CATEGORY_MOUSE: new (&mouseEvent) MouseEvent(std::move(other.mouseEvent)); break;
+            case CATEGORY_TOUCH: new (&touchEvent) TouchEvent(std::move(other.touchEvent)); break;
+            case CATEGORY_GAMEPAD: new (&gamepadEvent) GamepadEvent(std::move(other.gamepadEvent)); break;
+            case CATEGORY_WINDOW: new (&windowEvent) WindowEvent(std::move(other.windowEvent)); break;
+            case CATEGORY_SYSTEM: new (&systemEvent) SystemEvent(std::move(other.systemEvent)); break;
+            case CATEGORY_UI: new (&uiEvent) UIEvent(std::move(other.uiEvent)); break;
+            default: new (&userEvent) UserEvent(std::move(other.userEvent)); break;
+        }
+    }
+
+    void Event::destroy()
+    {
+        switch (getCategory(type))
+        {
+            case CATEGORY_KEYBOARD: keyboardEvent.~KeyboardEvent(); break;
+            case CATEGORY_MOUSE: mouseEvent.~MouseEvent(); break;
+            case CATEGORY_TOUCH: touchEvent.~TouchEvent(); break;
+            case CATEGORY_GAMEPAD: gamepadEvent.~GamepadEvent(); break;
+            case CATEGORY_WINDOW: windowEvent.~WindowEvent(); break;
+            case CATEGORY_SYSTEM: systemEvent.~SystemEvent(); break;
+            case CATEGORY_UI: uiEvent.~UIEvent(); break;
+            default: userEvent.~UserEvent(); break;
+        }
+    }
+}
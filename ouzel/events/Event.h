@@ -75,7 +75,7 @@ namespace ouzel
             FACE_DOWN
         };
 
-        Orientation orientation;
+        Orientation orientation = Orientation::UNKNOWN;
         std::string filename;
     };
 
@@ -90,6 +90,9 @@ namespace ouzel
         std::vector<std::string> parameters;
     };
 
+    // Tagged union, only the payload of the category of the type is constructed, so events that are posted often do
+    // not carry the strings and shared pointers of the others. The type can only be changed to another type of the same
+    // category after the event is constructed.
     struct Event
     {
         enum class Type
@@ -126,15 +129,47 @@ namespace ouzel
             USER // user defined event
         };
 
+        enum Category
+        {
+            CATEGORY_KEYBOARD,
+            CATEGORY_MOUSE,
+            CATEGORY_TOUCH,
+            CATEGORY_GAMEPAD,
+            CATEGORY_WINDOW,
+            CATEGORY_SYSTEM,
+            CATEGORY_UI,
+            CATEGORY_USER,
+            CATEGORY_COUNT
+        };
+
+        static Category getCategory(Type type);
+
+        Event(Type newType = Type::USER);
+        Event(const Event& other);
+        Event(Event&& other);
+        ~Event();
+
+        Event& operator=(const Event& other);
+        Event& operator=(Event&& other);
+
         Type type;
 
-        KeyboardEvent keyboardEvent;
-        MouseEvent mouseEvent;
-        TouchEvent touchEvent;
-        GamepadEvent gamepadEvent;
-        WindowEvent windowEvent;
-        SystemEvent systemEvent;
-        UIEvent uiEvent;
-        UserEvent userEvent;
+        union
+        {
+            KeyboardEvent keyboardEvent;
+            MouseEvent mouseEvent;
+            TouchEvent touchEvent;
+            GamepadEvent gamepadEvent;
+            WindowEvent windowEvent;
+            SystemEvent systemEvent;
+            UIEvent uiEvent;
+            UserEvent userEvent;
+        };
+
+    private:
+        void construct();
+        void construct(const Event& other);
+        void construct(Event&& other);
+        void destroy();
     };
 }
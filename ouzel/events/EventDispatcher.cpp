@@ -16,155 +16,243 @@ namespace ouzel
 
     void EventDispatcher::dispatchEvents()
     {
-        Event event;
-
         for (;;)
         {
-            {
-                std::lock_guard<std::mutex> lock(queueMutex);
-                if (eventQueue.empty())
-                {
-                    break;
-                }
+            // events posted by the handlers are dispatched in the next pass
+            eventQueue.drain(drainedEvents);
 
-                event = eventQueue.front();
-                eventQueue.pop();
+            if (drainedEvents.empty())
+            {
+                break;
             }
 
-            bool propagate = true;
+            markCoalescedEvents();
 
-            for (eventHandlerIterator = eventHandlers.begin(); eventHandlerIterator != eventHandlers.end();)
+            for (size_t index = 0; index < drainedEvents.size(); ++index)
             {
-                eventHandlerDeleted = false;
+                const Event& event = drainedEvents[index];
+                bool coalesced = coalescedEvents[index] != 0;
 
-                const EventHandler* eventHandler = *eventHandlerIterator;
-                if (eventHandler)
+                // only the handlers that have a callback for the category of the event are visited
+                const std::vector<const EventHandler*>& categoryEventHandlers = eventHandlers[Event::getCategory(event.type)];
+
+                dispatching = true;
+
+                for (size_t i = 0; i < categoryEventHandlers.size(); ++i)
                 {
-                    switch (event.type)
+                    const EventHandler* eventHandler = categoryEventHandlers[i];
+
+                    if (!eventHandler || (coalesced && eventHandler->coalesceMoveEvents))
+                    {
+                        continue;
+                    }
+
+                    if (!callHandler(*eventHandler, event))
                     {
-                        case Event::Type::KEY_DOWN:
-                        case Event::Type::KEY_UP:
-                        case Event::Type::KEY_REPEAT:
-                            if (eventHandler->keyboardHandler)
-                            {
-                                propagate = eventHandler->keyboardHandler(event.type, event.keyboardEvent);
-                            }
-                            break;
-
-                        case Event::Type::MOUSE_DOWN:
-                        case Event::Type::MOUSE_UP:
-                        case Event::Type::MOUSE_SCROLL:
-                        case Event::Type::MOUSE_MOVE:
-                            if (eventHandler->mouseHandler)
-                            {
-                                propagate = eventHandler->mouseHandler(event.type, event.mouseEvent);
-                            }
-                            break;
-                        case Event::Type::TOUCH_BEGIN:
-                        case Event::Type::TOUCH_MOVE:
-                        case Event::Type::TOUCH_END:
-                        case Event::Type::TOUCH_CANCEL:
-                            if (eventHandler->touchHandler)
-                            {
-                                propagate = eventHandler->touchHandler(event.type, event.touchEvent);
-                            }
-                            break;
-                        case Event::Type::GAMEPAD_CONNECT:
-                        case Event::Type::GAMEPAD_DISCONNECT:
-                        case Event::Type::GAMEPAD_BUTTON_CHANGE:
-                            if (eventHandler->gamepadHandler)
-                            {
-                                propagate = eventHandler->gamepadHandler(event.type, event.gamepadEvent);
-                            }
-                            break;
-                        case Event::Type::WINDOW_SIZE_CHANGE:
-                        case Event::Type::WINDOW_TITLE_CHANGE:
-                        case Event::Type::WINDOW_FULLSCREEN_CHANGE:
-                            if (eventHandler->windowHandler)
-                            {
-                                propagate = eventHandler->windowHandler(event.type, event.windowEvent);
-                            }
-                            break;
-                        case Event::Type::ORIENTATION_CHANGE:
-                        case Event::Type::LOW_MEMORY:
-                        case Event::Type::OPEN_FILE:
-                            if (eventHandler->systemHandler)
-                            {
-                                propagate = eventHandler->systemHandler(event.type, event.systemEvent);
-                            }
-                            break;
-                        case Event::Type::UI_ENTER_NODE:
-                        case Event::Type::UI_LEAVE_NODE:
-                        case Event::Type::UI_PRESS_NODE:
-                        case Event::Type::UI_RELEASE_NODE:
-                        case Event::Type::UI_CLICK_NODE:
-                        case Event::Type::UI_DRAG_NODE:
-                        case Event::Type::UI_WIDGET_CHANGE:
-                            if (eventHandler->uiHandler)
-                            {
-                                propagate = eventHandler->uiHandler(event.type, event.uiEvent);
-                            }
-                            break;
-                        case Event::Type::USER:
-                            if (eventHandler->userHandler)
-                            {
-                                propagate = eventHandler->userHandler(event.type, event.userEvent);
-                            }
-                            break;
+                        break;
                     }
                 }
 
-                if (!propagate)
+                dispatching = false;
+
+                if (eventHandlersRemoved)
                 {
-                    break;
+                    compactEventHandlers();
                 }
 
-                // current element wasn't delete from the list
-                if (!eventHandlerDeleted)
+                if (!addedEventHandlers.empty())
                 {
-                    ++eventHandlerIterator;
+                    for (const EventHandler* eventHandler : addedEventHandlers)
+                    {
+                        insertEventHandler(*eventHandler);
+                    }
+
+                    addedEventHandlers.clear();
                 }
             }
+
+            drainedEvents.clear();
+            coalescedEvents.clear();
         }
     }
 
     void EventDispatcher::addEventHandler(const EventHandler& eventHandler)
     {
-        std::list<const EventHandler*>::iterator i = std::find(eventHandlers.begin(), eventHandlers.end(), &eventHandler);
-
-        if (i == eventHandlers.end())
+        if (std::find(addedEventHandlers.begin(), addedEventHandlers.end(), &eventHandler) != addedEventHandlers.end())
         {
-            eventHandlers.push_back(&eventHandler);
+            return;
+        }
 
-            eventHandlers.sort([](const EventHandler* a, const EventHandler* b) {
-                return a->priority < b->priority;
-            });
+        if (dispatching)
+        {
+            // inserting would move the handlers that are being visited
+            addedEventHandlers.push_back(&eventHandler);
+        }
+        else
+        {
+            insertEventHandler(eventHandler);
         }
     }
 
     void EventDispatcher::removeEventHandler(const EventHandler& eventHandler)
     {
-        std::list<const EventHandler*>::iterator i = std::find(eventHandlers.begin(), eventHandlers.end(), &eventHandler);
+        std::vector<const EventHandler*>::iterator added = std::find(addedEventHandlers.begin(), addedEventHandlers.end(), &eventHandler);
+
+        if (added != addedEventHandlers.end())
+        {
+            addedEventHandlers.erase(added);
+        }
 
-        if (i != eventHandlers.end())
+        for (uint32_t category = 0; category < Event::CATEGORY_COUNT; ++category)
         {
-            // increment the iterator if current element is deleted
-            if (i == eventHandlerIterator)
+            std::vector<const EventHandler*>& categoryEventHandlers = eventHandlers[category];
+
+            for (std::vector<const EventHandler*>::iterator i = categoryEventHandlers.begin(); i != categoryEventHandlers.end(); ++i)
             {
-                eventHandlerIterator = eventHandlers.erase(i);
-                eventHandlerDeleted = true;
+                if (*i == &eventHandler)
+                {
+                    if (dispatching)
+                    {
+                        // the slot is erased after the event is handled, so that the indices of the others stay valid
+                        *i = nullptr;
+                        eventHandlersRemoved = true;
+                    }
+                    else
+                    {
+                        categoryEventHandlers.erase(i);
+                    }
+
+                    break;
+                }
             }
-            else
+        }
+    }
+
+    void EventDispatcher::postEvent(const Event& event)
+    {
+        eventQueue.push(event);
+    }
+
+    bool EventDispatcher::hasHandler(const EventHandler& eventHandler, Event::Category category)
+    {
+        switch (category)
+        {
+            case Event::CATEGORY_KEYBOARD: return static_cast<bool>(eventHandler.keyboardHandler);
+            case Event::CATEGORY_MOUSE: return static_cast<bool>(eventHandler.mouseHandler);
+            case Event::CATEGORY_TOUCH: return static_cast<bool>(eventHandler.touchHandler);
+            case Event::CATEGORY_GAMEPAD: return static_cast<bool>(eventHandler.gamepadHandler);
+            case Event::CATEGORY_WINDOW: return static_cast<bool>(eventHandler.windowHandler);
+            case Event::CATEGORY_SYSTEM: return static_cast<bool>(eventHandler.systemHandler);
+            case Event::CATEGORY_UI: return static_cast<bool>(eventHandler.uiHandler);
+            case Event::CATEGORY_USER: return static_cast<bool>(eventHandler.userHandler);
+            default: return false;
+        }
+    }
+
+    // returns false if the event should not be propagated to the rest of the handlers
+    bool EventDispatcher::callHandler(const EventHandler& eventHandler, const Event& event)
+    {
+        switch (Event::getCategory(event.type))
+        {
+            case Event::CATEGORY_KEYBOARD:
+                return eventHandler.keyboardHandler ? eventHandler.keyboardHandler(event.type, event.keyboardEvent) : true;
+            case Event::CATEGORY_MOUSE:
+                return eventHandler.mouseHandler ? eventHandler.mouseHandler(event.type, event.mouseEvent) : true;
+            case Event::CATEGORY_TOUCH:
+                return eventHandler.touchHandler ? eventHandler.touchHandler(event.type, event.touchEvent) : true;
+            case Event::CATEGORY_GAMEPAD:
+                return eventHandler.gamepadHandler ? eventHandler.gamepadHandler(event.type, event.gamepadEvent) : true;
+            case Event::CATEGORY_WINDOW:
+                return eventHandler.windowHandler ? eventHandler.windowHandler(event.type, event.windowEvent) : true;
+            case Event::CATEGORY_SYSTEM:
+                return eventHandler.systemHandler ? eventHandler.systemHandler(event.type, event.systemEvent) : true;
+            case Event::CATEGORY_UI:
+                return eventHandler.uiHandler ? eventHandler.uiHandler(event.type, event.uiEvent) : true;
+            case Event::CATEGORY_USER:
+                return eventHandler.userHandler ? eventHandler.userHandler(event.type, event.userEvent) : true;
+            default:
+                return true;
+        }
+    }
+
+    void EventDispatcher::insertEventHandler(const EventHandler& eventHandler)
+    {
+        for (uint32_t category = 0; category < Event::CATEGORY_COUNT; ++category)
+        {
+            if (!hasHandler(eventHandler, static_cast<Event::Category>(category)))
             {
-                eventHandlers.erase(i);
+                continue;
             }
+
+            std::vector<const EventHandler*>& categoryEventHandlers = eventHandlers[category];
+
+            if (std::find(categoryEventHandlers.begin(), categoryEventHandlers.end(), &eventHandler) != categoryEventHandlers.end())
+            {
+                continue;
+            }
+
+            // after the handlers with the same priority, so that they are called in the order they were added
+            std::vector<const EventHandler*>::iterator i = std::upper_bound(categoryEventHandlers.begin(), categoryEventHandlers.end(), &eventHandler,
+                                                                            [](const EventHandler* a, const EventHandler* b) {
+                return a->priority < b->priority;
+            });
+
+            categoryEventHandlers.insert(i, &eventHandler);
         }
     }
 
-    void EventDispatcher::postEvent(const Event& event)
+    void EventDispatcher::compactEventHandlers()
     {
-        std::lock_guard<std::mutex> lock(queueMutex);
+        for (std::vector<const EventHandler*>& categoryEventHandlers : eventHandlers)
+        {
+            categoryEventHandlers.erase(std::remove(categoryEventHandlers.begin(), categoryEventHandlers.end(), nullptr),
+                                        categoryEventHandlers.end());
+        }
 
-        eventQueue.push(event);
+        eventHandlersRemoved = false;
+    }
+
+    void EventDispatcher::markCoalescedEvents()
+    {
+        coalescedEvents.resize(drainedEvents.size());
+
+        // walking backwards, a move is coalesced if a move of the same pointer was already seen after the last other event
+        bool mouseMoved = false;
+        movedTouches.clear();
+
+        for (size_t index = drainedEvents.size(); index > 0; --index)
+        {
+            const Event& event = drainedEvents[index - 1];
+            bool coalesced = false;
+
+            if (event.type == Event::Type::MOUSE_MOVE)
+            {
+                coalesced = mouseMoved;
+                mouseMoved = true;
+            }
+            else if (event.type == Event::Type::TOUCH_MOVE)
+            {
+                if (std::find(movedTouches.begin(), movedTouches.end(), event.touchEvent.touchId) != movedTouches.end())
+                {
+                    coalesced = true;
+                }
+                else
+                {
+                    movedTouches.push_back(event.touchEvent.touchId);
+                }
+            }
+            else
+            {
+                mouseMoved = false;
+                movedTouches.clear();
+            }
+
+            coalescedEvents[index - 1] = coalesced ? 1 : 0;
+
+            if (coalesced)
+            {
+                ++coalescedEventCount;
+            }
+        }
     }
 }
@@ -3,15 +3,14 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <cstdint>
 #include "utils/Types.h"
 #include "utils/Noncopyable.h"
 #include "events/Event.h"
 #include "events/EventHandler.h"
+#include "events/EventQueue.h"
 
 namespace ouzel
 {
@@ -28,15 +27,40 @@ namespace ouzel
         void addEventHandler(const EventHandler& eventHandler);
         void removeEventHandler(const EventHandler& eventHandler);
 
+        // can be called from any thread
         void postEvent(const Event& event);
 
+        // number of move events that were merged into a later one since the start
+        uint64_t getCoalescedEventCount() const { return coalescedEventCount; }
+
     protected:
         EventDispatcher();
 
-        std::list<const EventHandler*> eventHandlers;
-        std::list<const EventHandler*>::iterator eventHandlerIterator;
-        bool eventHandlerDeleted = false;
-        std::queue<Event> eventQueue;
-        std::mutex queueMutex;
+        static bool hasHandler(const EventHandler& eventHandler, Event::Category category);
+        static bool callHandler(const EventHandler& eventHandler, const Event& event);
+
+        void insertEventHandler(const EventHandler& eventHandler);
+        void compactEventHandlers();
+        void markCoalescedEvents();
+
+        // handlers of every category that have a callback for it, sorted by priority (handlers with the same priority
+        // in the order they were added), handlers removed while dispatching are set to nullptr until the event is handled
+        std::vector<const EventHandler*> eventHandlers[Event::CATEGORY_COUNT];
+
+        // handlers added while dispatching are inserted after the event is handled
+        std::vector<const EventHandler*> addedEventHandlers;
+        bool dispatching = false;
+        bool eventHandlersRemoved = false;
+
+        EventQueue eventQueue;
+
+        // events are drained to this vector and dispatched without holding up the threads that post them
+        std::vector<Event> drainedEvents;
+
+        // for every drained event, whether it is a move event that is followed by a move of the same pointer before any
+        // other event, such events are dispatched only to the handlers that do not coalesce them
+        std::vector<uint8_t> coalescedEvents;
+        std::vector<uint64_t> movedTouches;
+        uint64_t coalescedEventCount = 0;
     };
 }
@@ -11,6 +11,7 @@ namespace ouzel
 {
     class EventDispatcher;
 
+    // the dispatcher indexes the handler by the callbacks that are set when it is added, so they have to be set before
     class EventHandler
     {
         friend EventDispatcher;
@@ -29,6 +30,10 @@ namespace ouzel
         std::function<bool(Event::Type, const UIEvent&)> uiHandler;
         std::function<bool(Event::Type, const UserEvent&)> userHandler;
 
+        // consecutive mouse and touch move events of the same pointer are merged into the last one before they are
+        // dispatched, handlers that need every position (e.g. for drawing strokes) can set this to false
+        bool coalesceMoveEvents = true;
+
     protected:
         int32_t priority;
     };
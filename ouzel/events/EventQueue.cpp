@@ -0,0 +1,154 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <thread>
+#include "EventQueue.h"
+
+namespace ouzel
+{
+    EventQueue::EventQueue(uint32_t newCapacity):
+        writePosition(0), readPosition(0), overflowing(false)
+    {
+        // the capacity is rounded up to a power of two, so that positions are wrapped with a mask
+        size_t capacity = 2;
+
+        while (capacity < newCapacity)
+        {
+            capacity *= 2;
+        }
+
+        slots.reset(new Slot[capacity]);
+        mask = capacity - 1;
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void EventQueue::push(const Event& event)
+    {
+        // once an event has overflowed, the following ones go after it until the consumer drains them
+        if (!overflowing.load(std::memory_order_acquire) && tryPush(event))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(overflowMutex);
+
+        overflowEvents.push_back(event);
+        overflowing.store(true, std::memory_order_release);
+    }
+
+    void EventQueue::drain(std::vector<Event>& events)
+    {
+        Event event;
+
+        while (tryPop(event))
+        {
+            events.push_back(std::move(event));
+        }
+
+        if (overflowing.load(std::memory_order_acquire))
+        {
+            {
+                std::lock_guard<std::mutex> lock(overflowMutex);
+
+                // the events that were written to the ring before the ones that overflowed have to go first, wait for
+                // the slots that are being written by the other producers
+                size_t position = writePosition.load(std::memory_order_acquire);
+
+                while (readPosition.load(std::memory_order_relaxed) != position)
+                {
+                    if (tryPop(event))
+                    {
+                        events.push_back(std::move(event));
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+
+                // swapped, so that the producers are not blocked while the events are moved
+                overflowEvents.swap(drainedOverflowEvents);
+                overflowing.store(false, std::memory_order_release);
+            }
+
+            for (Event& overflowEvent : drainedOverflowEvents)
+            {
+                events.push_back(std::move(overflowEvent));
+            }
+
+            drainedOverflowEvents.clear();
+        }
+    }
+
+    bool EventQueue::tryPush(const Event& event)
+    {
+        size_t position = writePosition.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;)
+        {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                position = writePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->event = event;
+        slot->sequence.store(position + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool EventQueue::tryPop(Event& event)
+    {
+        size_t position = readPosition.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;)
+        {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0)
+            {
+                if (readPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                position = readPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        event = std::move(slot->event);
+        slot->sequence.store(position + mask + 1, std::memory_order_release);
+
+        return true;
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include "utils/Noncopyable.h"
+#include "events/Event.h"
+
+namespace ouzel
+{
+    // Bounded ring buffer of events that any thread can post to without locking, events are consumed by one thread.
+    // When the ring is full the events go to an overflow vector under a mutex until the consumer drains it, so that
+    // no event is lost and the events of one thread stay in order.
+    class EventQueue: public Noncopyable
+    {
+    public:
+        EventQueue(uint32_t newCapacity = 1024);
+
+        void push(const Event& event);
+
+        // moves all queued events to the end of the vector
+        void drain(std::vector<Event>& events);
+
+    protected:
+        bool tryPush(const Event& event);
+        bool tryPop(Event& event);
+
+        struct Slot
+        {
+            // equal to the position when the slot can be written, to the position + 1 when it can be read
+            std::atomic<size_t> sequence;
+            Event event;
+        };
+
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+
+        // the positions are on separate cache lines, so that the producers and the consumer do not share them
+        uint8_t padding0[64];
+        std::atomic<size_t> writePosition;
+        uint8_t padding1[64];
+        std::atomic<size_t> readPosition;
+        uint8_t padding2[64];
+
+        std::atomic<bool> overflowing;
+        std::mutex overflowMutex;
+        std::vector<Event> overflowEvents;
+        std::vector<Event> drainedOverflowEvents;
+    };
+}
@@ -0,0 +1,170 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "Archive.h"
+#include "FileSystem.h"
+#include "utils/Compression.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    uint64_t Archive::hash(const std::string& filename)
+    {
+        uint64_t result = 14695981039346656037ULL;
+
+        for (char c : filename)
+        {
+            result ^= static_cast<uint8_t>(c == '\\' ? '/' : c);
+            result *= 1099511628211ULL;
+        }
+
+        return result;
+    }
+
+    bool Archive::open(const FileSystem& fileSystem, const std::string& newFilename)
+    {
+        filename = newFilename;
+        entries.clear();
+
+        if (!fileSystem.mapFile(filename, file))
+        {
+            return false;
+        }
+
+        const uint8_t* data = file.getData();
+        size_t size = file.getSize();
+
+        if (size < HEADER_SIZE || data[0] != 'O' || data[1] != 'P' || data[2] != 'A' || data[3] != 'K')
+        {
+            log(LOG_LEVEL_ERROR, "Failed to load archive %s, not a pak file", filename.c_str());
+            return false;
+        }
+
+        uint32_t version = readUInt32Little(data + 4);
+
+        if (version != VERSION)
+        {
+            log(LOG_LEVEL_ERROR, "Failed to load archive %s, unsupported version %u", filename.c_str(), version);
+            return false;
+        }
+
+        uint32_t entryCount = readUInt32Little(data + 8);
+        uint32_t namesSize = readUInt32Little(data + 12);
+        uint64_t namesOffset = HEADER_SIZE + static_cast<uint64_t>(entryCount) * ENTRY_SIZE;
+
+        if (size < namesOffset + namesSize)
+        {
+            log(LOG_LEVEL_ERROR, "Failed to load archive %s, table of contents is too short", filename.c_str());
+            return false;
+        }
+
+        entries.resize(entryCount);
+
+        for (uint32_t i = 0; i < entryCount; ++i)
+        {
+            const uint8_t* entryData = data + HEADER_SIZE + i * ENTRY_SIZE;
+            Entry& entry = entries[i];
+
+            entry.hash = readUInt64Little(entryData);
+            entry.offset = readUInt64Little(entryData + 8);
+            entry.size = readUInt32Little(entryData + 16);
+            entry.originalSize = readUInt32Little(entryData + 20);
+
+            uint32_t nameOffset = readUInt32Little(entryData + 24);
+            uint16_t nameLength = readUInt16Little(entryData + 28);
+            uint8_t compression = entryData[30];
+
+            // the offset comes from the file and adding the size to it could wrap, so the size is compared with the
+            // rest of the file instead
+            if (static_cast<uint64_t>(nameOffset) + nameLength > namesSize ||
+                entry.offset > size || entry.size > size - entry.offset ||
+                compression > COMPRESSION_LZ4 ||
+                (compression == COMPRESSION_NONE && entry.size != entry.originalSize) ||
+                (i > 0 && entry.hash < entries[i - 1].hash))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load archive %s, invalid entry %u", filename.c_str(), i);
+                entries.clear();
+                return false;
+            }
+
+            entry.compression = static_cast<Compression>(compression);
+            entry.name.assign(reinterpret_cast<const char*>(data + namesOffset + nameOffset), nameLength);
+        }
+
+        return true;
+    }
+
+    const Archive::Entry* Archive::findEntry(const std::string& name) const
+    {
+        uint64_t nameHash = hash(name);
+
+        std::vector<Entry>::const_iterator i = std::lower_bound(entries.begin(), entries.end(), nameHash,
+                                                                [](const Entry& entry, uint64_t value) {
+            return entry.hash < value;
+        });
+
+        for (; i != entries.end() && i->hash == nameHash; ++i)
+        {
+            if (i->name.size() == name.size() &&
+                std::equal(name.begin(), name.end(), i->name.begin(), [](char a, char b) {
+                    return (a == '\\' ? '/' : a) == b;
+                }))
+            {
+                return &(*i);
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool Archive::mapEntry(const Entry& entry, FileView& view) const
+    {
+        view.release();
+
+        if (entry.compression == COMPRESSION_NONE)
+        {
+            view.data = file.getData() + entry.offset;
+            view.size = entry.size;
+
+            return true;
+        }
+
+        std::vector<uint8_t> data;
+
+        if (!decompressEntry(entry, data))
+        {
+            return false;
+        }
+
+        view.assign(data);
+
+        return true;
+    }
+
+    bool Archive::readEntry(const Entry& entry, std::vector<uint8_t>& data) const
+    {
+        if (entry.compression == COMPRESSION_NONE)
+        {
+            const uint8_t* entryData = file.getData() + entry.offset;
+            data.assign(entryData, entryData + entry.size);
+
+            return true;
+        }
+
+        return decompressEntry(entry, data);
+    }
+
+    bool Archive::decompressEntry(const Entry& entry, std::vector<uint8_t>& data) const
+    {
+        data.resize(entry.originalSize);
+
+        if (!decompressLZ4(file.getData() + entry.offset, entry.size, data.data(), data.size()))
+        {
+            log(LOG_LEVEL_ERROR, "Failed to decompress %s from archive %s", entry.name.c_str(), filename.c_str());
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "files/FileView.h"
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    class FileSystem;
+
+    // .pak archive, that is mapped to memory when it is mounted, so files are looked up in its table of contents and
+    // read without opening them. The archive starts with a header ("OPAK", version, entry count, size of the names),
+    // followed by the entries sorted by the hash of their names and the names. Every file starts at an offset that is
+    // a multiple of ALIGNMENT and can be compressed to an LZ4 block. All the values are little-endian.
+    class Archive: public Noncopyable
+    {
+    public:
+        static const uint32_t VERSION = 1;
+        static const uint32_t ALIGNMENT = 4096;
+        static const uint32_t HEADER_SIZE = 16;
+        static const uint32_t ENTRY_SIZE = 32;
+
+        enum Compression
+        {
+            COMPRESSION_NONE = 0,
+            COMPRESSION_LZ4 = 1
+        };
+
+        struct Entry
+        {
+            uint64_t hash;
+            uint64_t offset;
+            uint32_t size;
+            uint32_t originalSize;
+            Compression compression;
+            std::string name;
+        };
+
+        // FNV-1a hash of the name with forward slashes as separators
+        static uint64_t hash(const std::string& filename);
+
+        bool open(const FileSystem& fileSystem, const std::string& filename);
+
+        const std::string& getFilename() const { return filename; }
+        const std::vector<Entry>& getEntries() const { return entries; }
+
+        const Entry* findEntry(const std::string& name) const;
+
+        // uncompressed files are not copied, the view points to the mapped archive
+        bool mapEntry(const Entry& entry, FileView& view) const;
+        bool readEntry(const Entry& entry, std::vector<uint8_t>& data) const;
+
+    protected:
+        bool decompressEntry(const Entry& entry, std::vector<uint8_t>& data) const;
+
+        std::string filename;
+        FileView file;
+        std::vector<Entry> entries;
+    };
+}
@@ -28,7 +28,10 @@
 namespace ouzel
 {
     static char TEMP_BUFFER[1024];
-    
+
+    // maximum number of files of the same archive read one after another by an I/O thread
+    static const size_t MAX_LOAD_BATCH = 16;
+
 #if OUZEL_PLATFORM_WINDOWS
     const std::string FileSystem::DIRECTORY_SEPARATOR = "\\";
 #else
@@ -82,6 +85,18 @@ namespace ouzel
 
     FileSystem::~FileSystem()
     {
+        {
+            std::lock_guard<std::mutex> lock(loadMutex);
+            loadThreadsRunning = false;
+        }
+
+        loadCondition.notify_all();
+
+        // the requests that were not read yet are dropped without calling their callbacks
+        for (std::thread& thread : loadThreads)
+        {
+            if (thread.joinable()) thread.join();
+        }
     }
 
     std::string FileSystem::getHomeDirectory()
@@ -216,6 +231,17 @@ namespace ouzel
 
     bool FileSystem::loadFile(const std::string& filename, std::vector<uint8_t>& data) const
     {
+        if (!isAbsolutePath(filename))
+        {
+            for (const std::unique_ptr<Archive>& archive : archives)
+            {
+                if (const Archive::Entry* entry = archive->findEntry(filename))
+                {
+                    return archive->readEntry(*entry, data);
+                }
+            }
+        }
+
 #if OUZEL_PLATFORM_ANDROID
         if (!isAbsolutePath(filename))
         {
@@ -227,14 +253,284 @@ namespace ouzel
                 return false;
             }
 
-            int bytesRead = 0;
+            data.resize(static_cast<size_t>(AAsset_getLength(asset)));
+
+            int bytesRead = data.empty() ? 0 : AAsset_read(asset, data.data(), data.size());
+
+            AAsset_close(asset);
 
-            while ((bytesRead = AAsset_read(asset, TEMP_BUFFER, sizeof(TEMP_BUFFER))) > 0)
+            if (bytesRead != static_cast<int>(data.size()))
             {
-                data.insert(data.end(), reinterpret_cast<uint8_t*>(TEMP_BUFFER), reinterpret_cast<uint8_t*>(TEMP_BUFFER + bytesRead));
+                log(LOG_LEVEL_ERROR, "Failed to read file %s", filename.c_str());
+                return false;
             }
 
-            AAsset_close(asset);
+            return true;
+        }
+#endif
+        std::string path = getPath(filename);
+
+        // file does not exist
+        if (path.empty())
+        {
+            log(LOG_LEVEL_ERROR, "Failed to find file %s", filename.c_str());
+            return false;
+        }
+
+        return readFile(path, data);
+    }
+
+    uint64_t FileSystem::loadFileAsync(const std::string& filename, int32_t priority, const LoadCallback& callback)
+    {
+        if (!callback)
+        {
+            return 0;
+        }
+
+        LoadListener listener;
+        listener.callback = callback;
+        listener.time = std::chrono::steady_clock::now();
+
+        const Archive* archive = nullptr;
+        const Archive::Entry* entry = nullptr;
+
+        if (!isAbsolutePath(filename))
+        {
+            for (const std::unique_ptr<Archive>& a : archives)
+            {
+                if ((entry = a->findEntry(filename)))
+                {
+                    archive = a.get();
+                    break;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(loadMutex);
+
+        if (!loadThreadsRunning)
+        {
+            loadThreadsRunning = true;
+
+            // a small pool, the threads mostly wait for the storage
+            uint32_t threadCount = std::min(std::max(std::thread::hardware_concurrency(), 2U) / 2, 4U);
+
+            for (uint32_t i = 0; i < threadCount; ++i)
+            {
+                loadThreads.push_back(std::thread(&FileSystem::loadFiles, this));
+            }
+        }
+
+        listener.id = ++lastLoadRequestId;
+        ++ioStatistics.requests;
+
+        // first request with a lower priority, the new request is queued before it
+        std::list<LoadRequest>::iterator position = std::find_if(loadRequests.begin(), loadRequests.end(),
+                                                                 [priority](const LoadRequest& request) {
+            return request.priority < priority;
+        });
+
+        // a file that is already queued is read once for all of its requests
+        for (std::list<LoadRequest>::iterator i = loadRequests.begin(); i != loadRequests.end(); ++i)
+        {
+            if (i->filename == filename)
+            {
+                i->listeners.push_back(listener);
+                ++ioStatistics.coalesced;
+
+                if (priority > i->priority)
+                {
+                    i->priority = priority;
+                    loadRequests.splice(position, loadRequests, i);
+                }
+
+                return listener.id;
+            }
+        }
+
+        LoadRequest request;
+        request.filename = filename;
+        request.priority = priority;
+        request.archive = archive;
+        request.entry = entry;
+        request.listeners.push_back(listener);
+
+        loadRequests.insert(position, std::move(request));
+        loadCondition.notify_one();
+
+        return listener.id;
+    }
+
+    bool FileSystem::cancelLoad(uint64_t requestId)
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+
+        for (std::list<LoadRequest>::iterator i = loadRequests.begin(); i != loadRequests.end(); ++i)
+        {
+            std::vector<LoadListener>::iterator listener = std::find_if(i->listeners.begin(), i->listeners.end(),
+                                                                        [requestId](const LoadListener& l) {
+                return l.id == requestId;
+            });
+
+            if (listener != i->listeners.end())
+            {
+                i->listeners.erase(listener);
+                ++ioStatistics.cancelled;
+
+                if (i->listeners.empty())
+                {
+                    loadRequests.erase(i);
+                }
+
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    FileSystem::IOStatistics FileSystem::getIOStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(loadMutex);
+
+        return ioStatistics;
+    }
+
+    void FileSystem::loadFiles()
+    {
+        std::vector<LoadRequest> batch;
+        std::vector<uint8_t> data;
+
+        for (;;)
+        {
+            batch.clear();
+
+            {
+                std::unique_lock<std::mutex> lock(loadMutex);
+
+                while (loadThreadsRunning && loadRequests.empty())
+                {
+                    loadCondition.wait(lock);
+                }
+
+                if (!loadThreadsRunning)
+                {
+                    break;
+                }
+
+                batch.push_back(std::move(loadRequests.front()));
+                loadRequests.pop_front();
+
+                // the other files of the same archive with the same priority are read in the order they are stored in,
+                // so the archive is read sequentially instead of seeking back and forth
+                if (batch.front().archive)
+                {
+                    for (std::list<LoadRequest>::iterator i = loadRequests.begin();
+                         i != loadRequests.end() && i->priority == batch.front().priority && batch.size() < MAX_LOAD_BATCH;)
+                    {
+                        if (i->archive == batch.front().archive)
+                        {
+                            batch.push_back(std::move(*i));
+                            i = loadRequests.erase(i);
+                        }
+                        else
+                        {
+                            ++i;
+                        }
+                    }
+
+                    std::sort(batch.begin(), batch.end(), [](const LoadRequest& a, const LoadRequest& b) {
+                        return a.entry->offset < b.entry->offset;
+                    });
+                }
+            }
+
+            for (const LoadRequest& request : batch)
+            {
+                std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+                bool success = request.archive ?
+                    request.archive->readEntry(*request.entry, data) :
+                    loadFile(request.filename, data);
+
+                if (!success)
+                {
+                    data.clear();
+                }
+
+                std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+                {
+                    std::lock_guard<std::mutex> lock(loadMutex);
+
+                    ioStatistics.readTime += std::chrono::duration<float>(endTime - startTime).count();
+                    ioStatistics.bytesRead += data.size();
+
+                    for (const LoadListener& listener : request.listeners)
+                    {
+                        float latency = std::chrono::duration<float>(endTime - listener.time).count();
+
+                        ioStatistics.totalLatency += latency;
+                        ioStatistics.maxLatency = std::max(ioStatistics.maxLatency, latency);
+
+                        if (success)
+                        {
+                            ++ioStatistics.completed;
+                        }
+                        else
+                        {
+                            ++ioStatistics.failed;
+                        }
+                    }
+                }
+
+                for (const LoadListener& listener : request.listeners)
+                {
+                    listener.callback(success, data);
+                }
+            }
+        }
+    }
+
+    bool FileSystem::mapFile(const std::string& filename, FileView& view) const
+    {
+        view.release();
+
+        if (!isAbsolutePath(filename))
+        {
+            for (const std::unique_ptr<Archive>& archive : archives)
+            {
+                if (const Archive::Entry* entry = archive->findEntry(filename))
+                {
+                    return archive->mapEntry(*entry, view);
+                }
+            }
+        }
+
+#if OUZEL_PLATFORM_ANDROID
+        if (!isAbsolutePath(filename))
+        {
+            // uncompressed assets are mapped from the package
+            AAsset* asset = AAssetManager_open(assetManager, filename.c_str(), AASSET_MODE_BUFFER);
+
+            if (!asset)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to open file %s", filename.c_str());
+                return false;
+            }
+
+            const void* buffer = AAsset_getBuffer(asset);
+
+            if (!buffer)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to read file %s", filename.c_str());
+                AAsset_close(asset);
+                return false;
+            }
+
+            view.asset = asset;
+            view.data = static_cast<const uint8_t*>(buffer);
+            view.size = static_cast<size_t>(AAsset_getLength(asset));
 
             return true;
         }
@@ -248,14 +544,50 @@ namespace ouzel
             return false;
         }
 
-        std::ifstream file(path, std::ios::binary);
+        if (view.map(path))
+        {
+            return true;
+        }
+
+        std::vector<uint8_t> data;
+
+        if (!readFile(path, data))
+        {
+            return false;
+        }
+
+        view.assign(data);
+
+        return true;
+    }
+
+    bool FileSystem::readFile(const std::string& path, std::vector<uint8_t>& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
 
         if (!file)
         {
             log(LOG_LEVEL_ERROR, "Failed to open file %s", path.c_str());
+            return false;
+        }
+
+        // the size is known, so the file is read at once instead of byte by byte
+        std::streamoff size = file.tellg();
+
+        if (size < 0)
+        {
+            log(LOG_LEVEL_ERROR, "Failed to read file %s", path.c_str());
+            return false;
         }
 
-        data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data.resize(static_cast<size_t>(size));
+        file.seekg(0, std::ios::beg);
+
+        if (!data.empty() && !file.read(reinterpret_cast<char*>(data.data()), size))
+        {
+            log(LOG_LEVEL_ERROR, "Failed to read file %s", path.c_str());
+            return false;
+        }
 
         return true;
     }
@@ -318,6 +650,26 @@ namespace ouzel
 
     void FileSystem::addResourcePath(const std::string& path)
     {
+        if (getExtensionPart(path) == "pak")
+        {
+            for (const std::unique_ptr<Archive>& archive : archives)
+            {
+                if (archive->getFilename() == path)
+                {
+                    return;
+                }
+            }
+
+            std::unique_ptr<Archive> archive(new Archive());
+
+            if (archive->open(*this, path))
+            {
+                archives.push_back(std::move(archive));
+            }
+
+            return;
+        }
+
         std::vector<std::string>::iterator i = std::find(resourcePaths.begin(), resourcePaths.end(), path);
 
         if (i == resourcePaths.end())
@@ -3,13 +3,22 @@
 
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <cstdint>
 #if OUZEL_PLATFORM_ANDROID
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #endif
+#include "files/Archive.h"
+#include "files/FileView.h"
 #include "utils/Noncopyable.h"
 
 namespace ouzel
@@ -26,6 +35,25 @@ namespace ouzel
     public:
         static const std::string DIRECTORY_SEPARATOR;
 
+        // called on one of the I/O threads, the data is empty if the file could not be read
+        typedef std::function<void(bool success, const std::vector<uint8_t>& data)> LoadCallback;
+
+        struct IOStatistics
+        {
+            uint64_t requests = 0;
+            uint64_t completed = 0;
+            uint64_t failed = 0;
+            uint64_t cancelled = 0;
+            // requests for a file that was already queued, which were served by the same read
+            uint64_t coalesced = 0;
+            uint64_t bytesRead = 0;
+            // seconds the I/O threads spent reading, bytesRead / readTime is the throughput
+            float readTime = 0.0f;
+            // seconds from the request to the callback, summed over the completed and failed requests
+            float totalLatency = 0.0f;
+            float maxLatency = 0.0f;
+        };
+
         virtual ~FileSystem();
 
         static std::string getHomeDirectory();
@@ -34,7 +62,21 @@ namespace ouzel
 
         bool loadFile(const std::string& filename, std::vector<uint8_t>& data) const;
 
+        // queues the file to be read on the I/O threads, files with a higher priority are read first and files with the
+        // same priority in the order they were requested, returns the id of the request (0 if it was not queued)
+        uint64_t loadFileAsync(const std::string& filename, int32_t priority, const LoadCallback& callback);
+        // returns false if the request does not exist or the file is already being read
+        bool cancelLoad(uint64_t requestId);
+        IOStatistics getIOStatistics() const;
+
+        // maps the file to memory instead of copying it, if it can not be mapped, it is read into the buffer of the view
+        bool mapFile(const std::string& filename, FileView& view) const;
+
         std::string getPath(const std::string& filename) const;
+
+        // a path with the pak extension is mounted as an archive, relative filenames are looked up in the mounted
+        // archives (in the order they were added) before the directories, resource paths must not be added while
+        // asynchronous loads are pending
         void addResourcePath(const std::string& path);
 
         static std::string getExtensionPart(const std::string& path);
@@ -48,7 +90,37 @@ namespace ouzel
     protected:
         FileSystem();
 
+        static bool readFile(const std::string& path, std::vector<uint8_t>& data);
+
+        void loadFiles();
+
+        struct LoadListener
+        {
+            uint64_t id;
+            LoadCallback callback;
+            std::chrono::steady_clock::time_point time;
+        };
+
+        struct LoadRequest
+        {
+            std::string filename;
+            int32_t priority;
+            // resolved when the request is queued if the file is in an archive
+            const Archive* archive;
+            const Archive::Entry* entry;
+            std::vector<LoadListener> listeners;
+        };
+
         std::string appPath;
         std::vector<std::string> resourcePaths;
+        std::vector<std::unique_ptr<Archive>> archives;
+
+        mutable std::mutex loadMutex;
+        std::condition_variable loadCondition;
+        std::list<LoadRequest> loadRequests;
+        uint64_t lastLoadRequestId = 0;
+        IOStatistics ioStatistics;
+        bool loadThreadsRunning = false;
+        std::vector<std::thread> loadThreads;
     };
 }
@@ -0,0 +1,159 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "core/CompileConfig.h"
+#if OUZEL_PLATFORM_WINDOWS
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include "FileView.h"
+
+namespace ouzel
+{
+    FileView::FileView()
+    {
+    }
+
+    FileView::~FileView()
+    {
+        release();
+    }
+
+    bool FileView::isMapped() const
+    {
+        // mapped files, Android assets and files in archives are not copied to the buffer
+        return data != nullptr && data != buffer.data();
+    }
+
+    void FileView::release()
+    {
+        if (mapping)
+        {
+#if OUZEL_PLATFORM_WINDOWS
+            UnmapViewOfFile(mapping);
+#else
+            munmap(mapping, size);
+#endif
+            mapping = nullptr;
+        }
+
+#if OUZEL_PLATFORM_ANDROID
+        if (asset)
+        {
+            AAsset_close(asset);
+            asset = nullptr;
+        }
+#endif
+
+        std::vector<uint8_t>().swap(buffer);
+        data = nullptr;
+        size = 0;
+    }
+
+    bool FileView::map(const std::string& path)
+    {
+        release();
+
+#if OUZEL_PLATFORM_WINDOWS
+        WCHAR szBuffer[MAX_PATH];
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, szBuffer, MAX_PATH);
+
+        HANDLE fileHandle = CreateFileW(szBuffer, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        // an empty file can not be mapped, but it is a valid view
+        if (fileSize.QuadPart == 0)
+        {
+            CloseHandle(fileHandle);
+            return true;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(fileHandle);
+
+        if (!mappingHandle)
+        {
+            return false;
+        }
+
+        // the view holds its own reference to the mapping
+        void* address = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mappingHandle);
+
+        if (!address)
+        {
+            return false;
+        }
+
+        mapping = address;
+        data = static_cast<const uint8_t*>(address);
+        size = static_cast<size_t>(fileSize.QuadPart);
+
+        return true;
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+
+        if (fd == -1)
+        {
+            return false;
+        }
+
+        struct stat buf;
+
+        if (fstat(fd, &buf) != 0 || (buf.st_mode & S_IFMT) != S_IFREG)
+        {
+            close(fd);
+            return false;
+        }
+
+        // an empty file can not be mapped, but it is a valid view
+        if (buf.st_size == 0)
+        {
+            close(fd);
+            return true;
+        }
+
+        void* address = mmap(nullptr, static_cast<size_t>(buf.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // the mapping holds its own reference to the file
+        close(fd);
+
+        if (address == MAP_FAILED)
+        {
+            return false;
+        }
+
+        mapping = address;
+        data = static_cast<const uint8_t*>(address);
+        size = static_cast<size_t>(buf.st_size);
+
+        return true;
+#endif
+    }
+
+    void FileView::assign(std::vector<uint8_t>& newBuffer)
+    {
+        release();
+
+        buffer.swap(newBuffer);
+        data = buffer.data();
+        size = buffer.size();
+    }
+}
@@ -0,0 +1,54 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/CompileConfig.h"
+#if OUZEL_PLATFORM_ANDROID
+#include <android/asset_manager.h>
+#endif
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    class Archive;
+    class FileSystem;
+
+    // read-only contents of a file, that are mapped to memory where the platform supports it and read into a buffer
+    // otherwise, the data stays valid until the view is released or destroyed (or the archive it is in is unmounted)
+    class FileView: public Noncopyable
+    {
+        friend Archive;
+        friend FileSystem;
+    public:
+        FileView();
+        ~FileView();
+
+        const uint8_t* getData() const { return data; }
+        size_t getSize() const { return size; }
+        bool isEmpty() const { return size == 0; }
+
+        // whether the data is read from the file on demand by the operating system
+        bool isMapped() const;
+
+        void release();
+
+    protected:
+        bool map(const std::string& path);
+        void assign(std::vector<uint8_t>& newBuffer);
+
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+
+        void* mapping = nullptr;
+        std::vector<uint8_t> buffer;
+
+#if OUZEL_PLATFORM_ANDROID
+        AAsset* asset = nullptr;
+#endif
+    };
+}
@@ -1,6 +1,7 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <cmath>
 #include "Image.h"
 #include "utils/Utils.h"
 #include "core/Application.h"
@@ -26,22 +27,23 @@ namespace ouzel
         {
             filename = newFilename;
 
-            std::vector<uint8_t> newData;
-            if (!sharedApplication->getFileSystem()->loadFile(newFilename, newData))
+            // decoded straight from the mapped file
+            FileView view;
+            if (!sharedApplication->getFileSystem()->mapFile(newFilename, view))
             {
                 return false;
             }
 
-            return initFromBuffer(newData);
+            return initFromBuffer(view.getData(), view.getSize());
         }
 
-        bool Image::initFromBuffer(const std::vector<uint8_t>& newData)
+        bool Image::initFromBuffer(const uint8_t* newData, size_t newSize)
         {
             int width;
             int height;
             int comp;
 
-            stbi_uc* tempData = stbi_load_from_memory(newData.data(), static_cast<int>(newData.size()), &width, &height, &comp, STBI_rgb_alpha);
+            stbi_uc* tempData = stbi_load_from_memory(newData, static_cast<int>(newSize), &width, &height, &comp, STBI_rgb_alpha);
 
             if (!tempData)
             {
@@ -58,5 +60,94 @@ namespace ouzel
 
             return true;
         }
+
+        struct GammaTable
+        {
+            GammaTable()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    toLinear[i] = powf(static_cast<float>(i), 2.2f);
+                }
+            }
+
+            float toLinear[256];
+        };
+
+        void Image::downsample(const std::vector<uint8_t>& data, const Size2& size,
+                               std::vector<uint8_t>& result, Size2& resultSize)
+        {
+            static const GammaTable gamma;
+
+            uint32_t width = static_cast<uint32_t>(size.width);
+            uint32_t height = static_cast<uint32_t>(size.height);
+            uint32_t resultWidth = width > 1 ? width / 2 : 1;
+            uint32_t resultHeight = height > 1 ? height / 2 : 1;
+            uint32_t pitch = width * 4;
+
+            // the second column and row are the first ones if the dimension is 1
+            uint32_t nextColumn = width > 1 ? 4 : 0;
+            uint32_t nextRow = height > 1 ? pitch : 0;
+
+            result.resize(resultWidth * resultHeight * 4);
+            resultSize = Size2(static_cast<float>(resultWidth), static_cast<float>(resultHeight));
+
+            uint8_t* dst = result.data();
+
+            for (uint32_t y = 0; y < resultHeight; ++y)
+            {
+                const uint8_t* src = data.data() + y * 2 * pitch;
+
+                for (uint32_t x = 0; x < resultWidth; ++x, src += nextColumn * 2, dst += 4)
+                {
+                    const uint8_t* pixels[4] = { src, src + nextColumn, src + nextRow, src + nextRow + nextColumn };
+
+                    float r = 0.0f, g = 0.0f, b = 0.0f;
+                    uint32_t a = 0;
+                    uint32_t count = 0;
+
+                    for (const uint8_t* pixel : pixels)
+                    {
+                        if (pixel[3] > 0)
+                        {
+                            r += gamma.toLinear[pixel[0]];
+                            g += gamma.toLinear[pixel[1]];
+                            b += gamma.toLinear[pixel[2]];
+                            ++count;
+                        }
+
+                        a += pixel[3];
+                    }
+
+                    if (count > 0)
+                    {
+                        dst[0] = static_cast<uint8_t>(powf(r / count, 1.0f / 2.2f));
+                        dst[1] = static_cast<uint8_t>(powf(g / count, 1.0f / 2.2f));
+                        dst[2] = static_cast<uint8_t>(powf(b / count, 1.0f / 2.2f));
+                    }
+                    else
+                    {
+                        dst[0] = dst[1] = dst[2] = 0;
+                    }
+
+                    dst[3] = static_cast<uint8_t>(a / 4);
+                }
+            }
+        }
+
+        void Image::premultiplyAlpha(std::vector<uint8_t>& data)
+        {
+            for (size_t i = 0; i + 3 < data.size(); i += 4)
+            {
+                uint32_t alpha = data[i + 3];
+
+                // rounded division by 255
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    uint32_t value = data[i + c] * alpha + 128;
+                    data[i + c] = static_cast<uint8_t>((value + (value >> 8)) >> 8);
+                }
+            }
+        }
     } // namespace graphics
 } // namespace ouzel
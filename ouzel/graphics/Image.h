@@ -23,7 +23,14 @@ namespace ouzel
             const std::vector<uint8_t>& getData() const { return data; }
 
             virtual bool initFromFile(const std::string& newFilename);
-            virtual bool initFromBuffer(const std::vector<uint8_t>& newData);
+            virtual bool initFromBuffer(const uint8_t* newData, size_t newSize);
+            bool initFromBuffer(const std::vector<uint8_t>& newData) { return initFromBuffer(newData.data(), newData.size()); }
+
+            // halves the RGBA8 pixels in both dimensions (a dimension of 1 is kept) with a gamma-correct box filter,
+            // the color of fully transparent pixels is ignored
+            static void downsample(const std::vector<uint8_t>& data, const Size2& size,
+                                   std::vector<uint8_t>& result, Size2& resultSize);
+            static void premultiplyAlpha(std::vector<uint8_t>& data);
 
         protected:
             std::string filename;
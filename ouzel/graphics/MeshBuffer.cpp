@@ -23,6 +23,8 @@ namespace ouzel
             vertexData.clear();
             uploadData.indexData.clear();
             uploadData.vertexData.clear();
+            indexBufferSource.reset();
+            uploadData.indexBufferSource.reset();
             
             ready = false;
         }
@@ -110,6 +112,21 @@ namespace ouzel
             return true;
         }
 
+        bool MeshBuffer::setIndexBufferSource(const MeshBufferPtr& newIndexBufferSource)
+        {
+            if (newIndexBufferSource.get() == this)
+            {
+                log(LOG_LEVEL_ERROR, "Mesh buffer can not be its own index buffer source");
+                return false;
+            }
+
+            indexBufferSource = newIndexBufferSource;
+
+            sharedEngine->getRenderer()->scheduleUpdate(shared_from_this());
+
+            return true;
+        }
+
         bool MeshBuffer::setIndexSize(uint32_t newIndexSize)
         {
             indexSize = newIndexSize;
@@ -170,6 +187,7 @@ namespace ouzel
             uploadData.vertexAttributes = vertexAttributes;
             uploadData.dynamicIndexBuffer = dynamicIndexBuffer;
             uploadData.dynamicVertexBuffer = dynamicVertexBuffer;
+            uploadData.indexBufferSource = indexBufferSource;
 
             if (!indexData.empty())
             {
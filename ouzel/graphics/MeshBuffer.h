@@ -7,6 +7,7 @@
 #include <atomic>
 #include <mutex>
 #include "utils/Noncopyable.h"
+#include "utils/Types.h"
 #include "graphics/Resource.h"
 #include "graphics/Vertex.h"
 
@@ -42,6 +43,10 @@ namespace ouzel
             virtual bool setIndices(const void* newIndices, uint32_t newIndexCount);
             virtual bool setVertices(const void* newVertices, uint32_t newVertexCount);
 
+            // draw with the indices of another mesh buffer (e.g. Renderer::getQuadIndexBuffer) instead of own ones
+            virtual bool setIndexBufferSource(const MeshBufferPtr& newIndexBufferSource);
+            const MeshBufferPtr& getIndexBufferSource() const { return indexBufferSource; }
+
             bool isReady() const { return ready; }
 
         protected:
@@ -61,6 +66,8 @@ namespace ouzel
             std::vector<uint8_t> indexData;
             std::vector<uint8_t> vertexData;
 
+            MeshBufferPtr indexBufferSource;
+
             struct Data
             {
                 uint32_t indexSize = 0;
@@ -70,6 +77,7 @@ namespace ouzel
                 bool dynamicVertexBuffer = true;
                 std::vector<uint8_t> indexData;
                 std::vector<uint8_t> vertexData;
+                MeshBufferPtr indexBufferSource;
             };
 
             Data uploadData;
@@ -0,0 +1,336 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "PixelFormat.h"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // 4x4 ordered dither matrix
+        static const uint32_t BAYER[16] = {
+            0, 8, 2, 10,
+            12, 4, 14, 6,
+            3, 11, 1, 9,
+            15, 7, 13, 5
+        };
+
+        // reduces an 8-bit value to the given number of bits, the threshold (0-15) offsets the rounding
+        static inline uint32_t quantize(uint8_t value, uint32_t bits, uint32_t threshold)
+        {
+            uint32_t maximum = (1U << bits) - 1;
+            return (value * maximum * 32 + (threshold * 2 + 1) * 255) / (255 * 32);
+        }
+
+        static inline uint8_t expand(uint32_t value, uint32_t bits)
+        {
+            uint32_t maximum = (1U << bits) - 1;
+            return static_cast<uint8_t>((value * 255 + maximum / 2) / maximum);
+        }
+
+        bool isCompressedPixelFormat(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8:
+                case PixelFormat::RGB565:
+                case PixelFormat::RGBA4444:
+                case PixelFormat::A8:
+                    return false;
+                default:
+                    return true;
+            }
+        }
+
+        uint32_t getPixelFormatElementSize(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8: return 4;
+                case PixelFormat::RGB565: return 2;
+                case PixelFormat::RGBA4444: return 2;
+                case PixelFormat::A8: return 1;
+                case PixelFormat::BC1: return 8;
+                case PixelFormat::BC2: return 16;
+                case PixelFormat::BC3: return 16;
+                case PixelFormat::ETC2_RGB8: return 8;
+                case PixelFormat::ETC2_RGBA8: return 16;
+                case PixelFormat::ASTC_4X4: return 16;
+            }
+
+            return 0;
+        }
+
+        size_t getPixelFormatRowSize(PixelFormat pixelFormat, uint32_t width)
+        {
+            if (isCompressedPixelFormat(pixelFormat))
+            {
+                return static_cast<size_t>((width + 3) / 4) * getPixelFormatElementSize(pixelFormat);
+            }
+
+            return static_cast<size_t>(width) * getPixelFormatElementSize(pixelFormat);
+        }
+
+        size_t getPixelFormatDataSize(PixelFormat pixelFormat, uint32_t width, uint32_t height)
+        {
+            if (isCompressedPixelFormat(pixelFormat))
+            {
+                return getPixelFormatRowSize(pixelFormat, width) * ((height + 3) / 4);
+            }
+
+            return getPixelFormatRowSize(pixelFormat, width) * height;
+        }
+
+        bool encodePixels(const uint8_t* data, uint32_t width, uint32_t height,
+                          PixelFormat pixelFormat, std::vector<uint8_t>& result)
+        {
+            size_t pixelCount = static_cast<size_t>(width) * height;
+
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8:
+                    result.assign(data, data + pixelCount * 4);
+                    return true;
+                case PixelFormat::RGB565:
+                case PixelFormat::RGBA4444:
+                {
+                    result.resize(pixelCount * 2);
+
+                    for (uint32_t y = 0; y < height; ++y)
+                    {
+                        for (uint32_t x = 0; x < width; ++x)
+                        {
+                            size_t pixel = static_cast<size_t>(y) * width + x;
+                            const uint8_t* src = data + pixel * 4;
+                            uint32_t threshold = BAYER[(y & 3) * 4 + (x & 3)];
+                            uint32_t value;
+
+                            if (pixelFormat == PixelFormat::RGB565)
+                            {
+                                value = (quantize(src[0], 5, threshold) << 11) |
+                                        (quantize(src[1], 6, threshold) << 5) |
+                                        quantize(src[2], 5, threshold);
+                            }
+                            else
+                            {
+                                value = (quantize(src[0], 4, threshold) << 12) |
+                                        (quantize(src[1], 4, threshold) << 8) |
+                                        (quantize(src[2], 4, threshold) << 4) |
+                                        quantize(src[3], 4, threshold);
+                            }
+
+                            result[pixel * 2] = static_cast<uint8_t>(value);
+                            result[pixel * 2 + 1] = static_cast<uint8_t>(value >> 8);
+                        }
+                    }
+
+                    return true;
+                }
+                case PixelFormat::A8:
+                    result.resize(pixelCount);
+
+                    for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+                    {
+                        result[pixel] = data[pixel * 4 + 3];
+                    }
+
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        static void decodeColorBlock(const uint8_t* block, bool fourColors, uint8_t colors[4][4], uint32_t& indices)
+        {
+            uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+            uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+            for (uint32_t i = 0; i < 2; ++i)
+            {
+                uint16_t color = (i == 0) ? color0 : color1;
+                colors[i][0] = expand((color >> 11) & 0x1F, 5);
+                colors[i][1] = expand((color >> 5) & 0x3F, 6);
+                colors[i][2] = expand(color & 0x1F, 5);
+                colors[i][3] = 255;
+            }
+
+            if (fourColors || color0 > color1)
+            {
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    colors[2][c] = static_cast<uint8_t>((2 * colors[0][c] + colors[1][c]) / 3);
+                    colors[3][c] = static_cast<uint8_t>((colors[0][c] + 2 * colors[1][c]) / 3);
+                }
+
+                colors[2][3] = 255;
+                colors[3][3] = 255;
+            }
+            else
+            {
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    colors[2][c] = static_cast<uint8_t>((colors[0][c] + colors[1][c]) / 2);
+                    colors[3][c] = 0;
+                }
+
+                colors[2][3] = 255;
+                colors[3][3] = 0;
+            }
+
+            indices = static_cast<uint32_t>(block[4]) | (static_cast<uint32_t>(block[5]) << 8) |
+                      (static_cast<uint32_t>(block[6]) << 16) | (static_cast<uint32_t>(block[7]) << 24);
+        }
+
+        static void decodeBlock(const uint8_t* block, PixelFormat pixelFormat, uint8_t pixels[16][4])
+        {
+            uint8_t colors[4][4];
+            uint32_t indices;
+
+            decodeColorBlock((pixelFormat == PixelFormat::BC1) ? block : block + 8,
+                             pixelFormat != PixelFormat::BC1, colors, indices);
+
+            for (uint32_t i = 0; i < 16; ++i)
+            {
+                const uint8_t* color = colors[(indices >> (i * 2)) & 0x03];
+                pixels[i][0] = color[0];
+                pixels[i][1] = color[1];
+                pixels[i][2] = color[2];
+                pixels[i][3] = color[3];
+            }
+
+            if (pixelFormat == PixelFormat::BC2)
+            {
+                // explicit 4-bit alpha values
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    pixels[i][3] = expand((block[i / 2] >> ((i % 2) * 4)) & 0x0F, 4);
+                }
+            }
+            else if (pixelFormat == PixelFormat::BC3)
+            {
+                // two alpha end points and a 3-bit index for every pixel
+                uint8_t alphas[8];
+                alphas[0] = block[0];
+                alphas[1] = block[1];
+
+                if (alphas[0] > alphas[1])
+                {
+                    for (uint32_t i = 2; i < 8; ++i)
+                    {
+                        alphas[i] = static_cast<uint8_t>(((8 - i) * alphas[0] + (i - 1) * alphas[1]) / 7);
+                    }
+                }
+                else
+                {
+                    for (uint32_t i = 2; i < 6; ++i)
+                    {
+                        alphas[i] = static_cast<uint8_t>(((6 - i) * alphas[0] + (i - 1) * alphas[1]) / 5);
+                    }
+
+                    alphas[6] = 0;
+                    alphas[7] = 255;
+                }
+
+                uint64_t alphaIndices = 0;
+
+                for (uint32_t i = 0; i < 6; ++i)
+                {
+                    alphaIndices |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+                }
+
+                for (uint32_t i = 0; i < 16; ++i)
+                {
+                    pixels[i][3] = alphas[(alphaIndices >> (i * 3)) & 0x07];
+                }
+            }
+        }
+
+        bool decodePixels(const uint8_t* data, uint32_t width, uint32_t height,
+                          PixelFormat pixelFormat, std::vector<uint8_t>& result)
+        {
+            size_t pixelCount = static_cast<size_t>(width) * height;
+
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8:
+                    result.assign(data, data + pixelCount * 4);
+                    return true;
+                case PixelFormat::RGB565:
+                case PixelFormat::RGBA4444:
+                    result.resize(pixelCount * 4);
+
+                    for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+                    {
+                        uint32_t value = data[pixel * 2] | (data[pixel * 2 + 1] << 8);
+                        uint8_t* dst = result.data() + pixel * 4;
+
+                        if (pixelFormat == PixelFormat::RGB565)
+                        {
+                            dst[0] = expand((value >> 11) & 0x1F, 5);
+                            dst[1] = expand((value >> 5) & 0x3F, 6);
+                            dst[2] = expand(value & 0x1F, 5);
+                            dst[3] = 255;
+                        }
+                        else
+                        {
+                            dst[0] = expand((value >> 12) & 0x0F, 4);
+                            dst[1] = expand((value >> 8) & 0x0F, 4);
+                            dst[2] = expand((value >> 4) & 0x0F, 4);
+                            dst[3] = expand(value & 0x0F, 4);
+                        }
+                    }
+
+                    return true;
+                case PixelFormat::A8:
+                    result.resize(pixelCount * 4);
+
+                    for (size_t pixel = 0; pixel < pixelCount; ++pixel)
+                    {
+                        uint8_t* dst = result.data() + pixel * 4;
+                        dst[0] = 0;
+                        dst[1] = 0;
+                        dst[2] = 0;
+                        dst[3] = data[pixel];
+                    }
+
+                    return true;
+                case PixelFormat::BC1:
+                case PixelFormat::BC2:
+                case PixelFormat::BC3:
+                {
+                    result.resize(pixelCount * 4);
+
+                    uint32_t blockSize = getPixelFormatElementSize(pixelFormat);
+                    uint8_t pixels[16][4];
+
+                    for (uint32_t blockY = 0; blockY < height; blockY += 4)
+                    {
+                        for (uint32_t blockX = 0; blockX < width; blockX += 4)
+                        {
+                            decodeBlock(data, pixelFormat, pixels);
+                            data += blockSize;
+
+                            // the blocks on the right and bottom edge can be partially outside of the image
+                            for (uint32_t y = 0; y < 4 && blockY + y < height; ++y)
+                            {
+                                for (uint32_t x = 0; x < 4 && blockX + x < width; ++x)
+                                {
+                                    uint8_t* dst = result.data() + ((static_cast<size_t>(blockY + y) * width) + blockX + x) * 4;
+                                    const uint8_t* src = pixels[y * 4 + x];
+                                    dst[0] = src[0];
+                                    dst[1] = src[1];
+                                    dst[2] = src[2];
+                                    dst[3] = src[3];
+                                }
+                            }
+                        }
+                    }
+
+                    return true;
+                }
+                default:
+                    return false;
+            }
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,48 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        // the values are stored in cooked textures, so they must not change
+        enum class PixelFormat
+        {
+            RGBA8 = 0,
+            RGB565 = 1, // 16-bit values with red in the highest bits
+            RGBA4444 = 2, // 16-bit values with red in the highest and alpha in the lowest bits
+            A8 = 3, // sampled as (0, 0, 0, a)
+            BC1 = 4, // DXT1, 4x4 blocks of 8 bytes
+            BC2 = 5, // DXT3, 4x4 blocks of 16 bytes
+            BC3 = 6, // DXT5, 4x4 blocks of 16 bytes
+            ETC2_RGB8 = 7, // 4x4 blocks of 8 bytes
+            ETC2_RGBA8 = 8, // 4x4 blocks of 16 bytes
+            ASTC_4X4 = 9 // 4x4 blocks of 16 bytes
+        };
+
+        const uint32_t PIXEL_FORMAT_COUNT = 10;
+
+        bool isCompressedPixelFormat(PixelFormat pixelFormat);
+
+        // size of a pixel or of a 4x4 block for the compressed formats
+        uint32_t getPixelFormatElementSize(PixelFormat pixelFormat);
+
+        // bytes in a row of pixels or in a row of blocks
+        size_t getPixelFormatRowSize(PixelFormat pixelFormat, uint32_t width);
+        size_t getPixelFormatDataSize(PixelFormat pixelFormat, uint32_t width, uint32_t height);
+
+        // converts RGBA8 pixels to RGB565, RGBA4444 (with ordered dithering) or A8, fails for the compressed formats
+        bool encodePixels(const uint8_t* data, uint32_t width, uint32_t height,
+                          PixelFormat pixelFormat, std::vector<uint8_t>& result);
+
+        // expands the pixels to RGBA8, the BC formats are decoded, ETC2 and ASTC are not supported
+        bool decodePixels(const uint8_t* data, uint32_t width, uint32_t height,
+                          PixelFormat pixelFormat, std::vector<uint8_t>& result);
+    } // namespace graphics
+} // namespace ouzel
@@ -1,6 +1,7 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
 #include "Renderer.h"
 #include "core/Engine.h"
 #include "Texture.h"
@@ -18,7 +19,8 @@ namespace ouzel
     namespace graphics
     {
         Renderer::Renderer(Driver pDriver):
-            driver(pDriver), clearColor(0, 0, 0, 255), clear(true), activeDrawQueueFinished(false), refillDrawQueue(true)
+            driver(pDriver), clearColor(0, 0, 0, 255), clear(true), activeDrawQueueFinished(false), refillDrawQueue(true),
+            supportedPixelFormats({ PixelFormat::RGBA8, PixelFormat::RGB565, PixelFormat::RGBA4444, PixelFormat::A8 })
         {
         }
 
@@ -29,6 +31,8 @@ namespace ouzel
         void Renderer::free()
         {
             activeDrawQueue.clear();
+            quadIndexBuffer.reset();
+            quadIndexBufferCapacity = 0;
             ready = false;
         }
 
@@ -100,6 +104,73 @@ namespace ouzel
             return std::vector<Size2>();
         }
 
+        const MeshBufferPtr& Renderer::getQuadIndexBuffer(uint32_t quadCount)
+        {
+            if (!quadIndexBuffer || quadCount > quadIndexBufferCapacity)
+            {
+                // grow in powers of two, so that emitters of slightly different sizes don't rebuild the buffer
+                uint32_t newCapacity = std::max(quadIndexBufferCapacity, 256u);
+
+                while (newCapacity < quadCount)
+                {
+                    newCapacity *= 2;
+                }
+
+                if (!quadIndexBuffer)
+                {
+                    quadIndexBuffer = createMeshBuffer();
+                }
+
+                // 16-bit indices can address 16384 quads
+                if (newCapacity * 4 <= 65536)
+                {
+                    std::vector<uint16_t> indices;
+                    indices.reserve(newCapacity * 6);
+
+                    for (uint32_t i = 0; i < newCapacity; ++i)
+                    {
+                        uint16_t startVertex = static_cast<uint16_t>(i * 4);
+
+                        indices.push_back(startVertex + 0);
+                        indices.push_back(startVertex + 1);
+                        indices.push_back(startVertex + 2);
+                        indices.push_back(startVertex + 1);
+                        indices.push_back(startVertex + 3);
+                        indices.push_back(startVertex + 2);
+                    }
+
+                    quadIndexBuffer->initFromBuffer(indices.data(), sizeof(uint16_t),
+                                                    static_cast<uint32_t>(indices.size()), false,
+                                                    nullptr, 0, 0, false);
+                }
+                else
+                {
+                    std::vector<uint32_t> indices;
+                    indices.reserve(newCapacity * 6);
+
+                    for (uint32_t i = 0; i < newCapacity; ++i)
+                    {
+                        uint32_t startVertex = i * 4;
+
+                        indices.push_back(startVertex + 0);
+                        indices.push_back(startVertex + 1);
+                        indices.push_back(startVertex + 2);
+                        indices.push_back(startVertex + 1);
+                        indices.push_back(startVertex + 3);
+                        indices.push_back(startVertex + 2);
+                    }
+
+                    quadIndexBuffer->initFromBuffer(indices.data(), sizeof(uint32_t),
+                                                    static_cast<uint32_t>(indices.size()), false,
+                                                    nullptr, 0, 0, false);
+                }
+
+                quadIndexBufferCapacity = newCapacity;
+            }
+
+            return quadIndexBuffer;
+        }
+
         BlendStatePtr Renderer::createBlendState()
         {
             BlendStatePtr blendState(new BlendState());
@@ -20,6 +20,7 @@
 #include "graphics/Vertex.h"
 #include "graphics/Shader.h"
 #include "graphics/BlendState.h"
+#include "graphics/PixelFormat.h"
 
 namespace ouzel
 {
@@ -34,6 +35,8 @@ namespace ouzel
         const std::string BLEND_ADD = "blendAdd";
         const std::string BLEND_MULTIPLY = "blendMultiply";
         const std::string BLEND_ALPHA = "blendAlpha";
+        // for textures with premultiplied alpha
+        const std::string BLEND_PREMULTIPLIED_ALPHA = "blendPremultipliedAlpha";
 
         const std::string TEXTURE_WHITE_PIXEL = "textureWhitePixel";
 
@@ -95,6 +98,9 @@ namespace ouzel
             virtual ShaderPtr createShader();
             virtual MeshBufferPtr createMeshBuffer();
 
+            // static index buffer shared by all quad batches, every four vertices form two triangles (0, 1, 2 and 1, 3, 2)
+            const MeshBufferPtr& getQuadIndexBuffer(uint32_t quadCount);
+
             bool getRefillDrawQueue() const { return refillDrawQueue; }
             bool addDrawCommand(const std::vector<TexturePtr>& textures,
                                 const ShaderPtr& shader,
@@ -127,6 +133,10 @@ namespace ouzel
             void scheduleUpdate(const ResourcePtr& resource);
 
             virtual bool isNPOTTexturesSupported() const { return npotTexturesSupported; }
+            // largest width and height of a texture
+            uint32_t getMaxTextureSize() const { return maxTextureSize; }
+            // whether textures of the format can be sampled, the other formats are expanded to RGBA8 when loaded
+            virtual bool isPixelFormatSupported(PixelFormat pixelFormat) const { return supportedPixelFormats.find(pixelFormat) != supportedPixelFormats.end(); }
 
         protected:
             Renderer(Driver pDriver = Driver::NONE);
@@ -178,6 +188,11 @@ namespace ouzel
             bool verticalSync = true;
             bool ready = false;
             bool npotTexturesSupported = true;
+            uint32_t maxTextureSize = 16384;
+            std::set<PixelFormat> supportedPixelFormats;
+
+            MeshBufferPtr quadIndexBuffer;
+            uint32_t quadIndexBufferCapacity = 0;
 
             std::vector<DrawCommand> activeDrawQueue;
             std::vector<DrawCommand> drawQueue;
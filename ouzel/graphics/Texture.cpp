@@ -1,12 +1,16 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
-#include <cstring>
+#include <algorithm>
+#include <iterator>
 #include "core/CompileConfig.h"
 #include "Texture.h"
+#include "core/Application.h"
 #include "core/Engine.h"
 #include "Renderer.h"
 #include "Image.h"
+#include "files/FileSystem.h"
+#include "utils/Compression.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 
@@ -25,8 +29,11 @@ namespace ouzel
         void Texture::free()
         {
             levels.clear();
+            regions.clear();
             uploadData.levels.clear();
-            
+            uploadData.regions.clear();
+            memorySize = 0;
+
             ready = false;
         }
 
@@ -38,7 +45,10 @@ namespace ouzel
             dynamic = newDynamic;
             mipmaps = newMipmaps;
             renderTarget = newRenderTarget;
+            premultipliedAlpha = false;
             mipMapsGenerated = false;
+            pixelFormat = PixelFormat::RGBA8;
+            memorySize = getPixelFormatDataSize(pixelFormat, static_cast<uint32_t>(size.width), static_cast<uint32_t>(size.height));
 
             dirty = true;
 
@@ -47,30 +57,115 @@ namespace ouzel
             return true;
         }
 
-        bool Texture::initFromFile(const std::string& newFilename, bool newDynamic, bool newMipmaps)
+        bool Texture::isCookedData(const uint8_t* data, size_t size)
+        {
+            return size >= COOKED_HEADER_SIZE && data[0] == 'O' && data[1] == 'T' && data[2] == 'E' && data[3] == 'X';
+        }
+
+        static const size_t DDS_HEADER_SIZE = 128;
+        static const size_t DDS_DX10_HEADER_SIZE = 20;
+        static const uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+        static const uint32_t DDPF_ALPHA = 0x02;
+        static const uint32_t DDPF_FOURCC = 0x04;
+        static const uint32_t DDPF_RGB = 0x40;
+
+        static bool isDDSData(const uint8_t* data, size_t size)
+        {
+            return size >= 4 && data[0] == 'D' && data[1] == 'D' && data[2] == 'S' && data[3] == ' ';
+        }
+
+        static inline uint32_t fourCC(char a, char b, char c, char d)
+        {
+            return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+                   (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+                   (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+                   (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+        }
+
+        static const size_t KTX_HEADER_SIZE = 64;
+        static const uint8_t KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        static bool isKTXData(const uint8_t* data, size_t size)
+        {
+            return size >= sizeof(KTX_IDENTIFIER) && std::equal(std::begin(KTX_IDENTIFIER), std::end(KTX_IDENTIFIER), data);
+        }
+
+        // the size read from a file is checked before the levels are allocated
+        static bool checkTextureSize(const std::string& filename, uint32_t width, uint32_t height)
+        {
+            uint32_t maxTextureSize = sharedEngine->getRenderer()->getMaxTextureSize();
+
+            if (width > maxTextureSize || height > maxTextureSize)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, size %ux%u is larger than the maximum texture size %u",
+                    filename.c_str(), width, height, maxTextureSize);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool Texture::initFromFile(const std::string& newFilename, bool newDynamic, bool newMipmaps, PixelFormat newPixelFormat)
         {
             free();
 
             filename = newFilename;
 
+            {
+                FileView view;
+                if (!sharedApplication->getFileSystem()->mapFile(filename, view))
+                {
+                    return false;
+                }
+
+                if (isCookedData(view.getData(), view.getSize()))
+                {
+                    return initFromCookedData(view.getData(), view.getSize(), newDynamic, newMipmaps);
+                }
+
+                bool dds = isDDSData(view.getData(), view.getSize());
+
+                if (dds || isKTXData(view.getData(), view.getSize()))
+                {
+                    dynamic = newDynamic;
+                    mipmaps = newMipmaps;
+                    renderTarget = false;
+                    premultipliedAlpha = false;
+
+                    if (dds ? !initFromDDS(view.getData(), view.getSize()) : !initFromKTX(view.getData(), view.getSize()))
+                    {
+                        return false;
+                    }
+
+                    dirty = true;
+
+                    sharedEngine->getRenderer()->scheduleUpdate(shared_from_this());
+
+                    return true;
+                }
+            }
+
             Image image;
             if (!image.initFromFile(filename))
             {
                 return false;
             }
-            
-            return initFromBuffer(image.getData(), image.getSize(), newDynamic, newMipmaps);
+
+            return initFromBuffer(image.getData(), image.getSize(), newDynamic, newMipmaps, newPixelFormat);
         }
 
-        bool Texture::initFromBuffer(const std::vector<uint8_t>& newData, const Size2& newSize, bool newDynamic, bool newMipmaps)
+        bool Texture::initFromBuffer(const std::vector<uint8_t>& newData, const Size2& newSize, bool newDynamic, bool newMipmaps,
+                                     PixelFormat newPixelFormat)
         {
             free();
 
             dynamic = newDynamic;
             mipmaps = newMipmaps;
             renderTarget = false;
+            premultipliedAlpha = false;
 
-            if (!calculateData(newData, newSize))
+            if (!calculateData(newData, newSize) ||
+                !encodeData(newPixelFormat))
             {
                 return false;
             }
@@ -82,19 +177,101 @@ namespace ouzel
             return true;
         }
 
-        bool Texture::setData(const std::vector<uint8_t>& newData, const Size2& newSize)
+        bool Texture::initFromCookedData(const uint8_t* newData, size_t newSize, bool newDynamic, bool newMipmaps)
         {
-            if (!dynamic)
+            free();
+
+            dynamic = newDynamic;
+            mipmaps = newMipmaps;
+            renderTarget = false;
+
+            if (!isCookedData(newData, newSize))
             {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, not a cooked texture", filename.c_str());
                 return false;
             }
 
-            if (newSize.width <= 0.0f || newSize.height <= 0.0f)
+            uint32_t version = readUInt32Little(newData + 4);
+
+            if (version != COOKED_VERSION)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, unsupported version %u", filename.c_str(), version);
+                return false;
+            }
+
+            uint32_t width = readUInt32Little(newData + 8);
+            uint32_t height = readUInt32Little(newData + 12);
+            uint32_t levelCount = readUInt32Little(newData + 16);
+            uint32_t flags = readUInt32Little(newData + 20);
+            uint32_t compression = readUInt32Little(newData + 24);
+            uint32_t format = readUInt32Little(newData + 28);
+
+            if (width == 0 || height == 0 || levelCount == 0 || levelCount > 32 ||
+                compression > Archive::COMPRESSION_LZ4 ||
+                format >= PIXEL_FORMAT_COUNT ||
+                newSize < COOKED_HEADER_SIZE + levelCount * COOKED_LEVEL_SIZE)
             {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid header", filename.c_str());
                 return false;
             }
 
-            if (!calculateData(newData, newSize))
+            if (!checkTextureSize(filename, width, height))
+            {
+                return false;
+            }
+
+            PixelFormat newPixelFormat = static_cast<PixelFormat>(format);
+
+            // the mip maps are dropped if the renderer can not use them
+            uint32_t usedLevels = useMipMaps(width, height) ? levelCount : 1;
+
+            std::vector<Level> newLevels;
+            newLevels.reserve(usedLevels);
+
+            size_t offset = COOKED_HEADER_SIZE + levelCount * COOKED_LEVEL_SIZE;
+
+            for (uint32_t i = 0; i < usedLevels; ++i)
+            {
+                const uint8_t* levelData = newData + COOKED_HEADER_SIZE + i * COOKED_LEVEL_SIZE;
+
+                uint32_t levelWidth = readUInt32Little(levelData);
+                uint32_t levelHeight = readUInt32Little(levelData + 4);
+                uint32_t storedSize = readUInt32Little(levelData + 8);
+                size_t dataSize = getPixelFormatDataSize(newPixelFormat, levelWidth, levelHeight);
+
+                if (levelWidth != std::max(width >> i, 1U) || levelHeight != std::max(height >> i, 1U) ||
+                    offset + storedSize > newSize ||
+                    (compression == Archive::COMPRESSION_NONE && storedSize != dataSize))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid level %u", filename.c_str(), i);
+                    return false;
+                }
+
+                Level level;
+                level.size = Size2(static_cast<float>(levelWidth), static_cast<float>(levelHeight));
+
+                if (compression == Archive::COMPRESSION_NONE)
+                {
+                    level.data.assign(newData + offset, newData + offset + dataSize);
+                }
+                else
+                {
+                    level.data.resize(dataSize);
+
+                    if (!decompressLZ4(newData + offset, storedSize, level.data.data(), dataSize))
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid level %u", filename.c_str(), i);
+                        return false;
+                    }
+                }
+
+                newLevels.push_back(std::move(level));
+                offset += storedSize;
+            }
+
+            premultipliedAlpha = (flags & COOKED_PREMULTIPLIED_ALPHA) != 0;
+
+            if (!setLevels(newLevels, newPixelFormat))
             {
                 return false;
             }
@@ -102,91 +279,345 @@ namespace ouzel
             dirty = true;
 
             sharedEngine->getRenderer()->scheduleUpdate(shared_from_this());
-            
+
             return true;
         }
 
-        static void imageRgba8Downsample2x2(uint32_t width, uint32_t height, uint32_t pitch, const uint8_t* src, uint8_t* dst)
+        bool Texture::initFromDDS(const uint8_t* newData, size_t newSize)
         {
-            const uint32_t dstwidth  = width / 2;
-            const uint32_t dstheight = height / 2;
-
-            if (dstwidth == 0 ||  dstheight == 0)
+            if (newSize < DDS_HEADER_SIZE || readUInt32Little(newData + 4) != 124)
             {
-                return;
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid DDS header", filename.c_str());
+                return false;
             }
 
-            for (uint32_t y = 0, ystep = pitch * 2; y < dstheight; ++y, src += ystep)
+            uint32_t flags = readUInt32Little(newData + 8);
+            uint32_t height = readUInt32Little(newData + 12);
+            uint32_t width = readUInt32Little(newData + 16);
+            uint32_t mipMapCount = readUInt32Little(newData + 28);
+            uint32_t formatFlags = readUInt32Little(newData + 80);
+            uint32_t formatFourCC = readUInt32Little(newData + 84);
+            uint32_t bitCount = readUInt32Little(newData + 88);
+            uint32_t redMask = readUInt32Little(newData + 92);
+            uint32_t greenMask = readUInt32Little(newData + 96);
+            uint32_t blueMask = readUInt32Little(newData + 100);
+            uint32_t alphaMask = readUInt32Little(newData + 104);
+
+            size_t offset = DDS_HEADER_SIZE;
+            PixelFormat newPixelFormat = PixelFormat::RGBA8;
+            // A4R4G4B4 and B4G4R4A4 have alpha in the highest bits
+            bool alphaFirst = false;
+            bool supported = true;
+
+            if (formatFlags & DDPF_FOURCC)
             {
-                const uint8_t* rgba = src;
-                for (uint32_t x = 0; x < dstwidth; ++x, rgba += 8, dst += 4)
+                if (formatFourCC == fourCC('D', 'X', 'T', '1'))
+                {
+                    newPixelFormat = PixelFormat::BC1;
+                }
+                else if (formatFourCC == fourCC('D', 'X', 'T', '3'))
+                {
+                    newPixelFormat = PixelFormat::BC2;
+                }
+                else if (formatFourCC == fourCC('D', 'X', 'T', '5'))
                 {
-                    float pixels = 0.0f;
+                    newPixelFormat = PixelFormat::BC3;
+                }
+                else if (formatFourCC == fourCC('D', 'X', '1', '0') && newSize >= DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE)
+                {
+                    offset += DDS_DX10_HEADER_SIZE;
 
-                    float r = 0, g = 0, b = 0, a = 0;
+                    uint32_t dxgiFormat = readUInt32Little(newData + 128);
+                    uint32_t resourceDimension = readUInt32Little(newData + 132);
+                    uint32_t arraySize = readUInt32Little(newData + 140);
 
-                    if (rgba[3] > 0)
+                    switch (dxgiFormat)
                     {
-                        r += powf(rgba[0], 2.2f);
-                        g += powf(rgba[1], 2.2f);
-                        b += powf(rgba[2], 2.2f);
-                        pixels += 1.0f;
+                        case 28: case 29: newPixelFormat = PixelFormat::RGBA8; break; // R8G8B8A8_UNORM(_SRGB)
+                        case 71: case 72: newPixelFormat = PixelFormat::BC1; break;
+                        case 74: case 75: newPixelFormat = PixelFormat::BC2; break;
+                        case 77: case 78: newPixelFormat = PixelFormat::BC3; break;
+                        case 85: newPixelFormat = PixelFormat::RGB565; break; // B5G6R5_UNORM
+                        case 115: newPixelFormat = PixelFormat::RGBA4444; alphaFirst = true; break; // B4G4R4A4_UNORM
+                        case 65: newPixelFormat = PixelFormat::A8; break; // A8_UNORM
+                        default: supported = false; break;
                     }
-                    a = rgba[3];
 
-                    if (rgba[7] > 0)
+                    // only 2D textures that are not arrays
+                    if (resourceDimension != 3 || arraySize > 1)
                     {
-                        r += powf(rgba[4], 2.2f);
-                        g += powf(rgba[5], 2.2f);
-                        b += powf(rgba[6], 2.2f);
-                        pixels += 1.0f;
+                        supported = false;
                     }
-                    a += rgba[7];
+                }
+                else
+                {
+                    supported = false;
+                }
+            }
+            else if ((formatFlags & DDPF_RGB) && bitCount == 32 &&
+                     redMask == 0x000000FF && greenMask == 0x0000FF00 && blueMask == 0x00FF0000 && alphaMask == 0xFF000000)
+            {
+                newPixelFormat = PixelFormat::RGBA8;
+            }
+            else if ((formatFlags & DDPF_RGB) && bitCount == 16 &&
+                     redMask == 0xF800 && greenMask == 0x07E0 && blueMask == 0x001F && alphaMask == 0)
+            {
+                newPixelFormat = PixelFormat::RGB565;
+            }
+            else if ((formatFlags & DDPF_RGB) && bitCount == 16 &&
+                     redMask == 0x0F00 && greenMask == 0x00F0 && blueMask == 0x000F && alphaMask == 0xF000)
+            {
+                newPixelFormat = PixelFormat::RGBA4444;
+                alphaFirst = true;
+            }
+            else if ((formatFlags & DDPF_ALPHA) && !(formatFlags & DDPF_RGB) && bitCount == 8 && alphaMask == 0xFF)
+            {
+                newPixelFormat = PixelFormat::A8;
+            }
+            else
+            {
+                supported = false;
+            }
 
-                    if (rgba[pitch+3])
-                    {
-                        r += powf(rgba[pitch+0], 2.2f);
-                        g += powf(rgba[pitch+1], 2.2f);
-                        b += powf(rgba[pitch+2], 2.2f);
-                        pixels += 1.0f;
-                    }
-                    a += rgba[pitch+3];
+            if (!supported)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, unsupported DDS pixel format", filename.c_str());
+                return false;
+            }
 
-                    if (rgba[pitch+7] > 0)
-                    {
-                        r += powf(rgba[pitch+4], 2.2f);
-                        g += powf(rgba[pitch+5], 2.2f);
-                        b += powf(rgba[pitch+6], 2.2f);
-                        pixels += 1.0f;
-                    }
-                    a += rgba[pitch+7];
+            uint32_t levelCount = ((flags & DDSD_MIPMAPCOUNT) && mipMapCount > 0) ? mipMapCount : 1;
+
+            if (width == 0 || height == 0 || levelCount > 32)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid DDS header", filename.c_str());
+                return false;
+            }
+
+            if (!checkTextureSize(filename, width, height))
+            {
+                return false;
+            }
+
+            uint32_t usedLevels = useMipMaps(width, height) ? levelCount : 1;
+
+            std::vector<Level> newLevels;
+            newLevels.reserve(usedLevels);
 
-                    if (pixels > 0.0f)
+            for (uint32_t i = 0; i < usedLevels; ++i)
+            {
+                uint32_t levelWidth = std::max(width >> i, 1U);
+                uint32_t levelHeight = std::max(height >> i, 1U);
+                size_t dataSize = getPixelFormatDataSize(newPixelFormat, levelWidth, levelHeight);
+
+                if (offset + dataSize > newSize)
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid level %u", filename.c_str(), i);
+                    return false;
+                }
+
+                Level level;
+                level.size = Size2(static_cast<float>(levelWidth), static_cast<float>(levelHeight));
+                level.data.assign(newData + offset, newData + offset + dataSize);
+
+                if (alphaFirst)
+                {
+                    for (size_t p = 0; p < dataSize; p += 2)
                     {
-                        r /= pixels;
-                        g /= pixels;
-                        b /= pixels;
+                        uint16_t value = static_cast<uint16_t>(level.data[p] | (level.data[p + 1] << 8));
+                        value = static_cast<uint16_t>((value << 4) | (value >> 12));
+                        level.data[p] = static_cast<uint8_t>(value);
+                        level.data[p + 1] = static_cast<uint8_t>(value >> 8);
                     }
-                    else
+                }
+
+                newLevels.push_back(std::move(level));
+                offset += dataSize;
+            }
+
+            return setLevels(newLevels, newPixelFormat);
+        }
+
+        bool Texture::initFromKTX(const uint8_t* newData, size_t newSize)
+        {
+            if (newSize < KTX_HEADER_SIZE || readUInt32Little(newData + 12) != 0x04030201)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid or big-endian KTX header", filename.c_str());
+                return false;
+            }
+
+            uint32_t glType = readUInt32Little(newData + 16);
+            uint32_t glInternalFormat = readUInt32Little(newData + 28);
+            uint32_t width = readUInt32Little(newData + 36);
+            uint32_t height = readUInt32Little(newData + 40);
+            uint32_t depth = readUInt32Little(newData + 44);
+            uint32_t arrayElements = readUInt32Little(newData + 48);
+            uint32_t faces = readUInt32Little(newData + 52);
+            uint32_t mipLevels = readUInt32Little(newData + 56);
+            uint32_t keyValueDataSize = readUInt32Little(newData + 60);
+
+            PixelFormat newPixelFormat = PixelFormat::RGBA8;
+            bool supported = true;
+
+            // the uncompressed formats must also have the matching data type
+            switch (glInternalFormat)
+            {
+                case 0x8058: newPixelFormat = PixelFormat::RGBA8; supported = (glType == 0x1401); break; // GL_RGBA8, GL_UNSIGNED_BYTE
+                case 0x8D62: newPixelFormat = PixelFormat::RGB565; supported = (glType == 0x8363); break; // GL_RGB565, GL_UNSIGNED_SHORT_5_6_5
+                case 0x8056: newPixelFormat = PixelFormat::RGBA4444; supported = (glType == 0x8033); break; // GL_RGBA4, GL_UNSIGNED_SHORT_4_4_4_4
+                case 0x803C: case 0x1906: newPixelFormat = PixelFormat::A8; supported = (glType == 0x1401); break; // GL_ALPHA8, GL_ALPHA
+                case 0x83F1: newPixelFormat = PixelFormat::BC1; break; // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+                case 0x83F2: newPixelFormat = PixelFormat::BC2; break; // GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+                case 0x83F3: newPixelFormat = PixelFormat::BC3; break; // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+                case 0x9274: newPixelFormat = PixelFormat::ETC2_RGB8; break; // GL_COMPRESSED_RGB8_ETC2
+                case 0x9278: newPixelFormat = PixelFormat::ETC2_RGBA8; break; // GL_COMPRESSED_RGBA8_ETC2_EAC
+                case 0x93B0: newPixelFormat = PixelFormat::ASTC_4X4; break; // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+                default: supported = false; break;
+            }
+
+            if (!supported)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, unsupported KTX format 0x%04X", filename.c_str(), glInternalFormat);
+                return false;
+            }
+
+            uint32_t levelCount = (mipLevels > 0) ? mipLevels : 1;
+
+            // only 2D textures that are not arrays or cube maps
+            if (width == 0 || height == 0 || depth > 1 || arrayElements > 0 || faces != 1 || levelCount > 32 ||
+                KTX_HEADER_SIZE + static_cast<uint64_t>(keyValueDataSize) > newSize)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid KTX header", filename.c_str());
+                return false;
+            }
+
+            if (!checkTextureSize(filename, width, height))
+            {
+                return false;
+            }
+
+            uint32_t usedLevels = useMipMaps(width, height) ? levelCount : 1;
+
+            std::vector<Level> newLevels;
+            newLevels.reserve(usedLevels);
+
+            size_t offset = KTX_HEADER_SIZE + keyValueDataSize;
+
+            for (uint32_t i = 0; i < usedLevels; ++i)
+            {
+                uint32_t levelWidth = std::max(width >> i, 1U);
+                uint32_t levelHeight = std::max(height >> i, 1U);
+                size_t rowSize = getPixelFormatRowSize(newPixelFormat, levelWidth);
+                size_t dataSize = getPixelFormatDataSize(newPixelFormat, levelWidth, levelHeight);
+                // the rows of uncompressed formats are padded to 4 bytes
+                size_t storedRowSize = isCompressedPixelFormat(newPixelFormat) ? rowSize : (rowSize + 3) & ~static_cast<size_t>(3);
+                size_t storedSize = isCompressedPixelFormat(newPixelFormat) ? dataSize : storedRowSize * levelHeight;
+
+                if (offset + 4 > newSize ||
+                    readUInt32Little(newData + offset) != storedSize ||
+                    offset + 4 + storedSize > newSize)
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load texture %s, invalid level %u", filename.c_str(), i);
+                    return false;
+                }
+
+                offset += 4;
+
+                Level level;
+                level.size = Size2(static_cast<float>(levelWidth), static_cast<float>(levelHeight));
+
+                if (storedRowSize == rowSize)
+                {
+                    level.data.assign(newData + offset, newData + offset + dataSize);
+                }
+                else
+                {
+                    level.data.reserve(dataSize);
+
+                    for (uint32_t row = 0; row < levelHeight; ++row)
                     {
-                        r = g = b = 0;
+                        const uint8_t* rowData = newData + offset + row * storedRowSize;
+                        level.data.insert(level.data.end(), rowData, rowData + rowSize);
                     }
-
-                    a *= 0.25f;
-                    r = powf(r, 1.0f / 2.2f);
-                    g = powf(g, 1.0f / 2.2f);
-                    b = powf(b, 1.0f / 2.2f);
-                    dst[0] = (uint8_t)r;
-                    dst[1] = (uint8_t)g;
-                    dst[2] = (uint8_t)b;
-                    dst[3] = (uint8_t)a;
                 }
+
+                newLevels.push_back(std::move(level));
+                offset += (storedSize + 3) & ~static_cast<size_t>(3);
+            }
+
+            return setLevels(newLevels, newPixelFormat);
+        }
+
+        bool Texture::setData(const std::vector<uint8_t>& newData, const Size2& newSize)
+        {
+            if (!dynamic)
+            {
+                return false;
+            }
+
+            if (newSize.width <= 0.0f || newSize.height <= 0.0f)
+            {
+                return false;
             }
+
+            if (!calculateData(newData, newSize) ||
+                !encodeData(pixelFormat))
+            {
+                return false;
+            }
+
+            dirty = true;
+
+            sharedEngine->getRenderer()->scheduleUpdate(shared_from_this());
+
+            return true;
+        }
+
+        bool Texture::setSubData(const std::vector<uint8_t>& newData, const Rectangle& newRectangle)
+        {
+            if (!dynamic || mipMapsGenerated || isCompressedPixelFormat(pixelFormat))
+            {
+                return false;
+            }
+
+            uint32_t x = static_cast<uint32_t>(newRectangle.x);
+            uint32_t y = static_cast<uint32_t>(newRectangle.y);
+            uint32_t width = static_cast<uint32_t>(newRectangle.width);
+            uint32_t height = static_cast<uint32_t>(newRectangle.height);
+
+            if (newRectangle.x < 0.0f || newRectangle.y < 0.0f || width == 0 || height == 0 ||
+                x + width > static_cast<uint32_t>(size.width) || y + height > static_cast<uint32_t>(size.height) ||
+                newData.size() < static_cast<size_t>(width) * height * 4)
+            {
+                return false;
+            }
+
+            Region region;
+            region.rectangle = newRectangle;
+
+            if (!encodePixels(newData.data(), width, height, pixelFormat, region.data))
+            {
+                return false;
+            }
+
+            regions.push_back(std::move(region));
+
+            dirty = true;
+
+            sharedEngine->getRenderer()->scheduleUpdate(shared_from_this());
+
+            return true;
+        }
+
+        bool Texture::useMipMaps(uint32_t width, uint32_t height) const
+        {
+            return mipmaps && (sharedEngine->getRenderer()->isNPOTTexturesSupported() || (isPOT(width) && isPOT(height)));
         }
 
         bool Texture::calculateData(const std::vector<uint8_t>& newData, const Size2& newSize)
         {
             levels.clear();
+            // the regions that were set before are replaced by the new data
+            regions.clear();
             size = newSize;
 
             levels.push_back({ newSize, newData });
@@ -194,74 +625,134 @@ namespace ouzel
             uint32_t newWidth = static_cast<uint32_t>(newSize.width);
             uint32_t newHeight = static_cast<uint32_t>(newSize.height);
 
-            mipMapsGenerated = mipmaps && (sharedEngine->getRenderer()->isNPOTTexturesSupported() || (isPOT(newWidth) && isPOT(newHeight)));
+            mipMapsGenerated = useMipMaps(newWidth, newHeight);
 
             if (mipMapsGenerated)
             {
-                uint32_t pitch = newWidth * 4;
+                // every level is half the size of the previous one down to 1x1
+                while (newWidth > 1 || newHeight > 1)
+                {
+                    Level level;
+                    Image::downsample(levels.back().data, levels.back().size, level.data, level.size);
+                    levels.push_back(std::move(level));
 
-                uint32_t bufferSize = newWidth * newHeight * 4;
+                    newWidth = static_cast<uint32_t>(levels.back().size.width);
+                    newHeight = static_cast<uint32_t>(levels.back().size.height);
+                }
+            }
 
-                if (newWidth == 1)
+            return true;
+        }
+
+        bool Texture::encodeData(PixelFormat newPixelFormat)
+        {
+            // the levels calculated from RGBA8 data are converted if the renderer can use the format, otherwise they stay RGBA8
+            pixelFormat = PixelFormat::RGBA8;
+
+            if (newPixelFormat != PixelFormat::RGBA8)
+            {
+                if (isCompressedPixelFormat(newPixelFormat))
                 {
-                    bufferSize *= 2;
+                    log(LOG_LEVEL_ERROR, "Failed to encode texture data, block-compressed formats can only be loaded from files");
+                    return false;
                 }
-                if (newHeight == 1)
+
+                if (sharedEngine->getRenderer()->isPixelFormatSupported(newPixelFormat))
                 {
-                    bufferSize *= 2;
+                    for (Level& level : levels)
+                    {
+                        std::vector<uint8_t> data;
+                        encodePixels(level.data.data(), static_cast<uint32_t>(level.size.width), static_cast<uint32_t>(level.size.height),
+                                     newPixelFormat, data);
+                        level.data.swap(data);
+                    }
+
+                    pixelFormat = newPixelFormat;
                 }
+            }
 
-                std::vector<uint8_t> mipMapData(bufferSize);
-                memcpy(mipMapData.data(), newData.data(), newWidth * newHeight * 4);
+            memorySize = 0;
 
-                while (newWidth >= 2 && newHeight >= 2)
-                {
-                    imageRgba8Downsample2x2(newWidth, newHeight, pitch, mipMapData.data(), mipMapData.data());
+            for (const Level& level : levels)
+            {
+                memorySize += level.data.size();
+            }
 
-                    newWidth >>= 1;
-                    newHeight >>= 1;
+            return true;
+        }
 
-                    Size2 mipMapSize = Size2(static_cast<float>(newWidth), static_cast<float>(newHeight));
-                    levels.push_back({ mipMapSize, mipMapData });
+        bool Texture::setLevels(std::vector<Level>& newLevels, PixelFormat newPixelFormat)
+        {
+            uint32_t width = static_cast<uint32_t>(newLevels.front().size.width);
+            uint32_t height = static_cast<uint32_t>(newLevels.front().size.height);
+            bool mipMapsUsed = useMipMaps(width, height);
 
-                    pitch = newWidth * 4;
-                }
+            if (!mipMapsUsed)
+            {
+                newLevels.resize(1);
+            }
 
-                if (newWidth > newHeight)
+            if (!sharedEngine->getRenderer()->isPixelFormatSupported(newPixelFormat))
+            {
+                // the formats that the renderer can not sample are expanded to RGBA8
+                for (Level& level : newLevels)
                 {
-                    for (; newWidth >= 2;)
+                    std::vector<uint8_t> data;
+
+                    if (!decodePixels(level.data.data(), static_cast<uint32_t>(level.size.width), static_cast<uint32_t>(level.size.height),
+                                      newPixelFormat, data))
                     {
-                        memcpy(&mipMapData.data()[newWidth*4], mipMapData.data(), newWidth * 4);
+                        log(LOG_LEVEL_ERROR, "Failed to load texture %s, pixel format is not supported by the renderer", filename.c_str());
+                        return false;
+                    }
+
+                    level.data.swap(data);
+                }
 
-                        imageRgba8Downsample2x2(newWidth, 2, pitch, mipMapData.data(), mipMapData.data());
+                newPixelFormat = PixelFormat::RGBA8;
+            }
 
-                        newWidth >>= 1;
+            const Size2& lastSize = newLevels.back().size;
 
-                        Size2 mipMapSize = Size2(static_cast<float>(newWidth), static_cast<float>(newHeight));
-                        levels.push_back({ mipMapSize, mipMapData });
+            if (newLevels.size() > 1 && (lastSize.width > 1.0f || lastSize.height > 1.0f))
+            {
+                log(LOG_LEVEL_WARNING, "Mip map chain of texture %s is incomplete, the levels after the base level are ignored", filename.c_str());
+                newLevels.resize(1);
+            }
 
-                        pitch = newWidth * 4;
-                    }
+            if (mipMapsUsed && newLevels.size() == 1 && !isCompressedPixelFormat(newPixelFormat))
+            {
+                // stored without mip maps, the base level is kept as it is
+                std::vector<uint8_t> data;
+
+                if (!decodePixels(newLevels.front().data.data(), width, height, newPixelFormat, data))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load texture %s, failed to decode the base level", filename.c_str());
+                    return false;
                 }
-                else
+
+                if (!calculateData(data, newLevels.front().size) ||
+                    !encodeData(newPixelFormat))
                 {
-                    for (; newHeight >= 2;)
-                    {
-                        uint32_t* src = reinterpret_cast<uint32_t*>(mipMapData.data());
-                        for (int32_t i = static_cast<int32_t>(newHeight) - 1; i >= 0; --i)
-                        {
-                            src[i * 2] = src[i];
-                            src[i * 2 + 1] = src[i];
-                        }
-                        
-                        imageRgba8Downsample2x2(2, newHeight, 8, mipMapData.data(), mipMapData.data());
-                        
-                        newHeight >>= 1;
-                        
-                        Size2 mipMapSize = Size2(static_cast<float>(newWidth), static_cast<float>(newHeight));
-                        levels.push_back({ mipMapSize, mipMapData });
-                    }
+                    return false;
                 }
+
+                levels.front().data = std::move(newLevels.front().data);
+
+                return true;
+            }
+
+            // block-compressed mip maps are not generated at runtime
+            size = newLevels.front().size;
+            levels = std::move(newLevels);
+            pixelFormat = newPixelFormat;
+            mipMapsGenerated = levels.size() > 1;
+
+            memorySize = 0;
+
+            for (const Level& level : levels)
+            {
+                memorySize += level.data.size();
             }
 
             return true;
@@ -270,6 +761,7 @@ namespace ouzel
         bool Texture::update()
         {
             uploadData.size = size;
+            uploadData.pixelFormat = pixelFormat;
             uploadData.dynamic = dynamic;
             uploadData.mipmaps = mipmaps;
 
@@ -281,6 +773,14 @@ namespace ouzel
             {
                 uploadData.levels = std::move(levels);
             }
+            else
+            {
+                // the levels that were uploaded before are not uploaded again
+                uploadData.levels.clear();
+            }
+
+            uploadData.regions = std::move(regions);
+            regions.clear();
 
             return true;
         }
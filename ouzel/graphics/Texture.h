@@ -8,6 +8,8 @@
 #include <vector>
 #include "utils/Noncopyable.h"
 #include "graphics/Resource.h"
+#include "graphics/PixelFormat.h"
+#include "math/Rectangle.h"
 #include "math/Size2.h"
 
 namespace ouzel
@@ -22,20 +24,44 @@ namespace ouzel
         public:
             static const uint32_t LAYERS = 4;
 
+            // textures written by the cooker tool start with "OTEX", version, width, height, level count, flags,
+            // compression (Archive::COMPRESSION_NONE or Archive::COMPRESSION_LZ4) and pixel format, followed by the width,
+            // height and stored size of every level and then the data of the levels, all the values are little-endian
+            static const uint32_t COOKED_VERSION = 2;
+            static const uint32_t COOKED_HEADER_SIZE = 32;
+            static const uint32_t COOKED_LEVEL_SIZE = 12;
+            static const uint32_t COOKED_PREMULTIPLIED_ALPHA = 0x01;
+
+            static bool isCookedData(const uint8_t* data, size_t size);
+
             virtual ~Texture();
             virtual void free() override;
 
             virtual bool init(const Size2& newSize, bool newDynamic, bool newMipmaps = true, bool newRenderTarget = false);
-            virtual bool initFromFile(const std::string& newFilename, bool newDynamic, bool newMipmaps = true);
-            virtual bool initFromBuffer(const std::vector<uint8_t>& newData, const Size2& newSize, bool newDynamic, bool newMipmaps = true);
+            // images are converted to the pixel format if the renderer supports it, cooked, DDS and KTX textures keep
+            // their own pixel format
+            virtual bool initFromFile(const std::string& newFilename, bool newDynamic, bool newMipmaps = true,
+                                      PixelFormat newPixelFormat = PixelFormat::RGBA8);
+            virtual bool initFromBuffer(const std::vector<uint8_t>& newData, const Size2& newSize, bool newDynamic, bool newMipmaps = true,
+                                        PixelFormat newPixelFormat = PixelFormat::RGBA8);
+            // the levels are used as they are, the mip maps are generated only if the cooked texture does not have them
+            virtual bool initFromCookedData(const uint8_t* newData, size_t newSize, bool newDynamic, bool newMipmaps = true);
 
             const std::string& getFilename() const { return filename; }
 
+            // the data is RGBA8 and is converted to the pixel format of the texture
             virtual bool setData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            // replaces a rectangle of the base level with RGBA8 data, only this rectangle is uploaded to the GPU,
+            // so textures with mip maps can not be updated this way
+            virtual bool setSubData(const std::vector<uint8_t>& newData, const Rectangle& newRectangle);
 
             const Size2& getSize() const { return size; }
+            PixelFormat getPixelFormat() const { return pixelFormat; }
+            // size of the pixel data of all the levels
+            size_t getMemorySize() const { return memorySize; }
 
             bool isDynamic() const { return dynamic; }
+            bool isPremultipliedAlpha() const { return premultipliedAlpha; }
             bool isFlipped() const { return flipped; }
             void setFlipped(bool newFlipped) { flipped = newFlipped; }
 
@@ -46,6 +72,24 @@ namespace ouzel
             virtual bool update() override;
 
             bool calculateData(const std::vector<uint8_t>& newData, const Size2& newSize);
+            bool encodeData(PixelFormat newPixelFormat);
+            bool useMipMaps(uint32_t width, uint32_t height) const;
+
+            struct Level
+            {
+                Size2 size;
+                std::vector<uint8_t> data;
+            };
+
+            struct Region
+            {
+                Rectangle rectangle;
+                std::vector<uint8_t> data;
+            };
+
+            bool setLevels(std::vector<Level>& newLevels, PixelFormat newPixelFormat);
+            bool initFromDDS(const uint8_t* newData, size_t newSize);
+            bool initFromKTX(const uint8_t* newData, size_t newSize);
 
             std::string filename;
 
@@ -54,25 +98,25 @@ namespace ouzel
             bool mipmaps = false;
             bool renderTarget = false;
             bool flipped = false;
+            bool premultipliedAlpha = false;
             bool dirty = false;
             bool ready = false;
             bool mipMapsGenerated = false;
-
-            struct Level
-            {
-                Size2 size;
-                std::vector<uint8_t> data;
-            };
+            PixelFormat pixelFormat = PixelFormat::RGBA8;
+            size_t memorySize = 0;
 
             std::vector<Level> levels;
+            std::vector<Region> regions;
 
             struct Data
             {
                 Size2 size;
+                PixelFormat pixelFormat = PixelFormat::RGBA8;
                 bool dynamic = false;
                 bool mipmaps = false;
                 bool renderTarget = false;
                 std::vector<Level> levels;
+                std::vector<Region> regions;
             };
 
             Data uploadData;
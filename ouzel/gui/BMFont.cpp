@@ -1,10 +1,9 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
-#include <iostream>
-#include <fstream>
+#include <cstdlib>
+#include <algorithm>
 #include <string>
-#include <sstream>
 #include "BMFont.h"
 #include "core/Engine.h"
 #include "core/Application.h"
@@ -15,291 +14,287 @@
 
 namespace ouzel
 {
-    template<typename CharT, typename TraitsT = std::char_traits<CharT>>
-    class VectorBuffer: public std::basic_streambuf<CharT, TraitsT>
+    static const uint32_t MAX_INDEXED_CHAR = 0xFFFF;
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static bool readToken(const char*& position, const char* end, std::string& token)
+    {
+        while (position < end && isSpace(*position)) ++position;
+
+        const char* start = position;
+
+        while (position < end && !isSpace(*position)) ++position;
+
+        token.assign(start, position);
+
+        return !token.empty();
+    }
+
+    // reads a key=value pair, values can be quoted
+    static bool readPair(const char*& position, const char* end, std::string& key, std::string& value)
     {
-    public:
-        VectorBuffer(std::vector<uint8_t>& vec)
+        while (position < end && isSpace(*position)) ++position;
+
+        const char* start = position;
+
+        while (position < end && *position != '=' && !isSpace(*position)) ++position;
+
+        key.assign(start, position);
+        value.clear();
+
+        if (position < end && *position == '=')
         {
-            std::basic_streambuf<CharT, TraitsT>::setg(reinterpret_cast<CharT*>(vec.data()),
-                                                       reinterpret_cast<CharT*>(vec.data()),
-                                                       reinterpret_cast<CharT*>(vec.data() + vec.size()));
+            ++position;
+
+            if (position < end && *position == '"')
+            {
+                start = ++position;
+
+                while (position < end && *position != '"') ++position;
+
+                value.assign(start, position);
+
+                if (position < end) ++position;
+            }
+            else
+            {
+                start = position;
+
+                while (position < end && !isSpace(*position)) ++position;
+
+                value.assign(start, position);
+            }
         }
-    };
 
-    BMFont::BMFont()
+        return !key.empty();
+    }
+
+    static int32_t toInt(const std::string& value)
     {
+        return static_cast<int32_t>(strtol(value.c_str(), nullptr, 10));
     }
 
-    BMFont::BMFont(const std::string& filename)
+    BMFontPtr BMFont::loadFont(const std::string& filename)
     {
-        if (!parseFont(filename))
+        BMFontPtr result = std::make_shared<BMFont>();
+
+        if (!result->parseFont(filename))
         {
-            log(LOG_LEVEL_ERROR, "Failed to parse font %s",filename.c_str());
+            log(LOG_LEVEL_ERROR, "Failed to parse font %s", filename.c_str());
+            result.reset();
         }
 
-        kernCount = static_cast<uint16_t>(kern.size());
+        return result;
     }
-    
-    BMFont::~BMFont()
+
+    BMFont::BMFont()
     {
     }
 
-    bool BMFont::parseFont(const std::string& filename)
+    BMFont::BMFont(const std::string& filename)
     {
-        std::vector<uint8_t> data;
-        if (!sharedApplication->getFileSystem()->loadFile(filename, data))
+        if (!parseFont(filename))
         {
-            return false;
+            log(LOG_LEVEL_ERROR, "Failed to parse font %s", filename.c_str());
         }
+    }
 
-        VectorBuffer<char> databuf(data);
-        std::istream stream(&databuf);
-
-        std::string line;
-        std::string read, key, value;
-        std::size_t i;
+    BMFont::~BMFont()
+    {
+    }
 
-        if (!stream)
+    bool BMFont::parseFont(const std::string& filename)
+    {
+        FileView data;
+        if (!sharedApplication->getFileSystem()->mapFile(filename, data))
         {
             log(LOG_LEVEL_ERROR, "Failed to open font file %s", filename.c_str());
             return false;
         }
 
-        KerningInfo k;
-        CharDescriptor c;
-
-        while (!stream.eof())
-        {
-            std::getline(stream, line);
+        const char* position = reinterpret_cast<const char*>(data.getData());
+        const char* end = position + data.getSize();
 
-            std::stringstream lineStream;
-            lineStream << line;
+        std::string tag, key, value;
 
-            lineStream >> read;
+        while (position < end)
+        {
+            const char* lineEnd = std::find(position, end, '\n');
 
-            if (read == "page")
+            if (readToken(position, lineEnd, tag))
             {
-                while (!lineStream.eof())
+                if (tag == "page")
                 {
-                    std::stringstream converter;
-                    lineStream >> read;
-                    i = read.find('=');
-                    key = read.substr(0, i);
-                    value = read.substr(i + 1);
-
-                    //assign the correct value
-                    converter << value;
-                    if (key == "file")
+                    while (readPair(position, lineEnd, key, value))
                     {
-                        // trim quotes
-                        if (value.length() && value[0] == '"' && value[value.length() - 1] == '"')
+                        if (key == "file")
                         {
-                            value = value.substr(1, value.length() - 2);
+                            texture = sharedEngine->getCache()->getTexture(value, false, true);
                         }
-
-                        texture = sharedEngine->getCache()->getTexture(value, false, true);
                     }
                 }
-            }
-            else if (read == "common")
-            {
-                //this holds common data
-                while (!lineStream.eof())
+                else if (tag == "common")
                 {
-                    std::stringstream converter;
-                    lineStream >> read;
-                    i = read.find('=');
-                    key = read.substr(0, i);
-                    value = read.substr(i + 1);
-
-                    //assign the correct value
-                    converter << value;
-                    if (key == "lineHeight") converter >> lineHeight;
-                    else if (key == "base") converter >> base;
-                    else if (key == "scaleW") converter >> width;
-                    else if (key == "scaleH") converter >> height;
-                    else if (key == "pages") converter >> pages;
-                    else if (key == "outline") converter >> outline;
+                    while (readPair(position, lineEnd, key, value))
+                    {
+                        if (key == "lineHeight") lineHeight = static_cast<int16_t>(toInt(value));
+                        else if (key == "base") base = static_cast<int16_t>(toInt(value));
+                        else if (key == "scaleW") width = static_cast<int16_t>(toInt(value));
+                        else if (key == "scaleH") height = static_cast<int16_t>(toInt(value));
+                        else if (key == "pages") pages = static_cast<int16_t>(toInt(value));
+                        else if (key == "outline") outline = static_cast<int16_t>(toInt(value));
+                    }
                 }
-            }
-            else if (read == "char")
-            {
-                //This is data for each specific character.
-                int32_t charId = 0;
-
-                while (!lineStream.eof())
+                else if (tag == "char")
                 {
-                    std::stringstream converter;
-                    lineStream >> read;
-                    i = read.find('=');
-                    key = read.substr(0, i);
-                    value = read.substr(i + 1);
-
-                    //Assign the correct value
-                    converter << value;
-                    if (key == "id") converter >> charId;
-                    else if (key == "x") converter >> c.x;
-                    else if (key == "y") converter >> c.y;
-                    else if (key == "width") converter >> c.width;
-                    else if (key == "height") converter >> c.height;
-                    else if (key == "xoffset") converter >> c.xOffset;
-                    else if (key == "yoffset") converter >> c.yOffset;
-                    else if (key == "xadvance") converter >> c.xAdvance;
-                    else if (key == "page") converter >> c.page;
-                }
+                    uint32_t charId = 0;
+                    CharDescriptor c;
+                    c.valid = true;
 
-                chars.insert(std::map<int32_t, CharDescriptor>::value_type(charId, c));
-            }
-            else if (read == "kernings")
-            {
-                while (!lineStream.eof())
+                    while (readPair(position, lineEnd, key, value))
+                    {
+                        if (key == "id") charId = static_cast<uint32_t>(toInt(value));
+                        else if (key == "x") c.x = static_cast<int16_t>(toInt(value));
+                        else if (key == "y") c.y = static_cast<int16_t>(toInt(value));
+                        else if (key == "width") c.width = static_cast<int16_t>(toInt(value));
+                        else if (key == "height") c.height = static_cast<int16_t>(toInt(value));
+                        else if (key == "xoffset") c.xOffset = static_cast<int16_t>(toInt(value));
+                        else if (key == "yoffset") c.yOffset = static_cast<int16_t>(toInt(value));
+                        else if (key == "xadvance") c.xAdvance = static_cast<int16_t>(toInt(value));
+                        else if (key == "page") c.page = static_cast<int16_t>(toInt(value));
+                    }
+
+                    if (charId <= MAX_INDEXED_CHAR)
+                    {
+                        if (charId >= chars.size())
+                        {
+                            chars.resize(charId + 1);
+                        }
+
+                        chars[charId] = c;
+                    }
+                    else
+                    {
+                        extraChars[charId] = c;
+                    }
+                }
+                else if (tag == "kernings")
                 {
-                    std::stringstream converter;
-                    lineStream >> read;
-                    i = read.find('=');
-                    key = read.substr(0, i);
-                    value = read.substr(i + 1);
-
-                    //assign the correct value
-                    converter << value;
-                    if (key == "count") converter >> kernCount;
+                    while (readPair(position, lineEnd, key, value))
+                    {
+                        if (key == "count") kern.reserve(static_cast<size_t>(toInt(value)));
+                    }
                 }
-            }
-            else if (read == "kerning")
-            {
-                while (!lineStream.eof())
+                else if (tag == "kerning")
                 {
-                    std::stringstream converter;
-                    lineStream >> read;
-                    i = read.find('=');
-                    key = read.substr(0, i);
-                    value = read.substr(i + 1);
-
-                    //assign the correct value
-                    converter << value;
-                    if (key == "first") converter >> k.first;
-                    else if (key == "second") converter >> k.second;
-                    else if (key == "amount") converter >> k.amount;
+                    KerningInfo k;
+
+                    while (readPair(position, lineEnd, key, value))
+                    {
+                        if (key == "first") k.first = static_cast<uint32_t>(toInt(value));
+                        else if (key == "second") k.second = static_cast<uint32_t>(toInt(value));
+                        else if (key == "amount") k.amount = static_cast<int16_t>(toInt(value));
+                    }
+
+                    kern[(static_cast<uint64_t>(k.first) << 32) | k.second] = k.amount;
                 }
-                kern[std::make_pair(k.first, k.second)] = k;
             }
+
+            position = (lineEnd < end) ? lineEnd + 1 : end;
         }
 
         return true;
     }
 
-    int32_t BMFont::getKerningPair(int32_t first, int32_t second)
+    int16_t BMFont::getKerningPair(uint32_t first, uint32_t second) const
     {
-        std::map<std::pair<int32_t, int32_t>, KerningInfo>::iterator i = kern.find(std::make_pair(first, second));
+        if (kern.empty())
+        {
+            return 0;
+        }
+
+        std::unordered_map<uint64_t, int16_t>::const_iterator i = kern.find((static_cast<uint64_t>(first) << 32) | second);
 
         if (i != kern.end())
         {
-            return i->second.amount;
+            return i->second;
         }
 
         return 0;
     }
 
-    float BMFont::getStringWidth(const std::string& text)
+    float BMFont::getStringWidth(const std::string& text) const
     {
         float total = 0;
-        CharDescriptor* f;
+        uint32_t length = static_cast<uint32_t>(text.length());
 
-        for (uint32_t i = 0; i < static_cast<uint32_t>(text.length()); ++i)
+        for (uint32_t offset = 0; offset < length;)
         {
-            std::map<int32_t, CharDescriptor>::iterator iter = chars.find(text[i]);
-
-            if (iter == chars.end())
+            if (const CharDescriptor* f = findChar(decodeUTF8(text, offset)))
             {
-                continue;
+                total += f->xAdvance;
             }
-
-            f = &iter->second;
-            total += f->xAdvance;
         }
 
         return total;
     }
 
-    void BMFont::getVertices(const std::string& text, const graphics::Color& color, const Vector2& anchor, std::vector<uint16_t>& indices, std::vector<graphics::VertexPCT>& vertices)
+    void BMFont::getVertices(const std::string& text, const graphics::Color& color, const Vector2& anchor, std::vector<uint16_t>& indices, std::vector<graphics::VertexPCT>& vertices) const
     {
-        uint32_t flen;
-
-        CharDescriptor  *f;
-
-        float x = 0.0f;
-        float y = lineHeight * (1.0f - anchor.y);
-
-        flen = static_cast<uint32_t>(text.length());
-
         indices.clear();
         vertices.clear();
 
-        indices.reserve(flen * 6);
-        vertices.reserve(flen * 4);
-
-        Vector2 textCoords[4];
-
-        for (uint32_t i = 0; i != flen; ++i)
+        if (!texture)
         {
-            std::map<int32_t, CharDescriptor>::iterator iter = chars.find(text[i]);
-
-            if (iter == chars.end())
-            {
-                continue;
-            }
-            else
-            {
-                f = &iter->second;
-            }
+            return;
+        }
 
-            uint16_t startIndex = static_cast<uint16_t>(vertices.size());
-            indices.push_back(startIndex + 0);
-            indices.push_back(startIndex + 1);
-            indices.push_back(startIndex + 2);
+        uint32_t length = static_cast<uint32_t>(text.length());
 
-            indices.push_back(startIndex + 1);
-            indices.push_back(startIndex + 3);
-            indices.push_back(startIndex + 2);
+        // every character takes at least one byte, so the length is an upper bound of the character count
+        indices.reserve(length * 6);
+        vertices.reserve(length * 4);
 
-            Vector2 leftTop(f->x / static_cast<float>(width),
-                            f->y / static_cast<float>(height));
+        float x = 0.0f;
+        float y = lineHeight * (1.0f - anchor.y);
 
-            Vector2 rightBottom((f->x + f->width) / static_cast<float>(width),
-                                (f->y + f->height) / static_cast<float>(height));
+        uint32_t offset = 0;
+        bool hasCurrent = offset < length;
+        uint32_t current = hasCurrent ? decodeUTF8(text, offset) : 0;
 
-            textCoords[0] = Vector2(leftTop.x, leftTop.y);
-            textCoords[1] = Vector2(rightBottom.x, leftTop.y);
-            textCoords[2] = Vector2(leftTop.x, rightBottom.y);
-            textCoords[3] = Vector2(rightBottom.x, rightBottom.y);
+        while (hasCurrent)
+        {
+            bool hasNext = offset < length;
+            uint32_t next = hasNext ? decodeUTF8(text, offset) : 0;
 
-            if (texture->isFlipped())
+            if (const CharDescriptor* f = findChar(current))
             {
-                leftTop.y = 1.0f - leftTop.y;
-                rightBottom.y = 1.0f - rightBottom.y;
-            }
-
-            vertices.push_back(graphics::VertexPCT(Vector3(x + f->xOffset, y - f->yOffset, 0.0f),
-                                         color, textCoords[0]));
+                uint16_t startIndex = static_cast<uint16_t>(vertices.size());
+                indices.push_back(startIndex + 0);
+                indices.push_back(startIndex + 1);
+                indices.push_back(startIndex + 2);
 
-            vertices.push_back(graphics::VertexPCT(Vector3(x + f->xOffset + f->width, y - f->yOffset, 0.0f),
-                                         color, textCoords[1]));
+                indices.push_back(startIndex + 1);
+                indices.push_back(startIndex + 3);
+                indices.push_back(startIndex + 2);
 
-            vertices.push_back(graphics::VertexPCT(Vector3(x + f->xOffset, y - f->yOffset - f->height, 0.0f),
-                                         color, textCoords[2]));
+                addGlyph(*f, x, y, color, vertices);
 
-            vertices.push_back(graphics::VertexPCT(Vector3(x + f->xOffset + f->width, y - f->yOffset - f->height, 0.0f),
-                                         color, textCoords[3]));
+                // kerning applies only between this and the following character
+                if (hasNext)
+                {
+                    x += getKerningPair(current, next);
+                }
 
-            // Only check kerning if there is greater then 1 character and
-            // if the check character is 1 less then the end of the string.
-            if (flen > 1 && i < flen)
-            {
-                x += getKerningPair(text[i], text[i+1]);
+                x += f->xAdvance;
             }
 
-            x +=  f->xAdvance;
+            current = next;
+            hasCurrent = hasNext;
         }
 
         float totalWidth = x;
@@ -4,62 +4,63 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
-#include <map>
+#include <unordered_map>
 #include "utils/Types.h"
+#include "gui/Font.h"
 #include "graphics/Color.h"
 #include "graphics/Texture.h"
-#include "graphics/MeshBuffer.h"
+#include "graphics/Vertex.h"
+#include "math/Vector2.h"
 
 namespace ouzel
 {
-    class KerningInfo
+    // fonts are not modified after loading, so Cache::getFont shares one instance between all text drawables
+    class BMFont: public Font
     {
     public:
-        int16_t first = 0;
-        int16_t second = 0;
-        int16_t amount = 0;
-    };
+        static BMFontPtr loadFont(const std::string& filename);
 
-    class CharDescriptor
-    {
-    public:
-        int16_t x = 0, y = 0;
-        int16_t width = 0;
-        int16_t height = 0;
-        int16_t xOffset = 0;
-        int16_t yOffset = 0;
-        int16_t xAdvance = 0;
-        int16_t page = 0;
-    };
-
-    class BMFont
-    {
-    public:
         BMFont();
         BMFont(const std::string& filename);
-        ~BMFont();
+        virtual ~BMFont();
 
-        float getHeight() { return lineHeight; }
+        void getVertices(const std::string& text, const graphics::Color& color, const Vector2& anchor, std::vector<uint16_t>& indices, std::vector<graphics::VertexPCT>& vertices) const;
+        float getStringWidth(const std::string& text) const;
 
-        void getVertices(const std::string& text, const graphics::Color& color, const Vector2& anchor, std::vector<uint16_t>& indices, std::vector<graphics::VertexPCT>& vertices);
+        virtual const CharDescriptor* getChar(uint32_t charId) override { return findChar(charId); }
 
-        const graphics::TexturePtr& getTexture() const { return texture; }
+        const CharDescriptor* findChar(uint32_t charId) const
+        {
+            if (charId < chars.size())
+            {
+                return chars[charId].valid ? &chars[charId] : nullptr;
+            }
+
+            std::unordered_map<uint32_t, CharDescriptor>::const_iterator i = extraChars.find(charId);
+
+            return (i != extraChars.end()) ? &i->second : nullptr;
+        }
+
+        virtual int16_t getKerningPair(uint32_t first, uint32_t second) const override;
+
+        virtual const graphics::TexturePtr& getTexture() override { return texture; }
 
     protected:
         bool parseFont(const std::string& filename);
-        int32_t getKerningPair(int32_t, int32_t);
-        float getStringWidth(const std::string& text);
 
-        int16_t lineHeight = 0;
         int16_t base = 0;
-        int16_t width = 0;
-        int16_t height = 0;
         int16_t pages = 0;
         int16_t outline = 0;
-        uint16_t kernCount = 0;
-        std::map<int32_t, CharDescriptor> chars;
-        std::map<std::pair<int32_t, int32_t>, KerningInfo> kern;
+
+        // characters of the Basic Multilingual Plane are indexed by their code point, the rest are looked up
+        std::vector<CharDescriptor> chars;
+        std::unordered_map<uint32_t, CharDescriptor> extraChars;
+
+        // amounts keyed by the first character in the upper and the second character in the lower 32 bits
+        std::unordered_map<uint64_t, int16_t> kern;
+
         graphics::TexturePtr texture;
     };
 }
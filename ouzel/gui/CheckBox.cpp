@@ -123,8 +123,7 @@ namespace ouzel
                     checked = !checked;
                     updateSprite();
 
-                    Event changeEvent;
-                    changeEvent.type = Event::Type::UI_WIDGET_CHANGE;
+                    Event changeEvent(Event::Type::UI_WIDGET_CHANGE);
                     changeEvent.uiEvent.node = std::static_pointer_cast<Node>(shared_from_this());
                     sharedEngine->getEventDispatcher()->postEvent(changeEvent);
                 }
@@ -0,0 +1,43 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "Font.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    Font::~Font()
+    {
+    }
+
+    void Font::retainChar(uint32_t charId)
+    {
+        OUZEL_UNUSED(charId);
+    }
+
+    void Font::releaseChar(uint32_t charId)
+    {
+        OUZEL_UNUSED(charId);
+    }
+
+    void Font::addGlyph(const CharDescriptor& f, float x, float y, const graphics::Color& color, std::vector<graphics::VertexPCT>& vertices) const
+    {
+        Vector2 leftTop(f.x / static_cast<float>(width),
+                        f.y / static_cast<float>(height));
+
+        Vector2 rightBottom((f.x + f.width) / static_cast<float>(width),
+                            (f.y + f.height) / static_cast<float>(height));
+
+        vertices.push_back(graphics::VertexPCT(Vector3(x + f.xOffset, y - f.yOffset, 0.0f),
+                                               color, Vector2(leftTop.x, leftTop.y)));
+
+        vertices.push_back(graphics::VertexPCT(Vector3(x + f.xOffset + f.width, y - f.yOffset, 0.0f),
+                                               color, Vector2(rightBottom.x, leftTop.y)));
+
+        vertices.push_back(graphics::VertexPCT(Vector3(x + f.xOffset, y - f.yOffset - f.height, 0.0f),
+                                               color, Vector2(leftTop.x, rightBottom.y)));
+
+        vertices.push_back(graphics::VertexPCT(Vector3(x + f.xOffset + f.width, y - f.yOffset - f.height, 0.0f),
+                                               color, Vector2(rightBottom.x, rightBottom.y)));
+    }
+}
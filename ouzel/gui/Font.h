@@ -0,0 +1,64 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+#include "graphics/Color.h"
+#include "graphics/Vertex.h"
+
+namespace ouzel
+{
+    class KerningInfo
+    {
+    public:
+        uint32_t first = 0;
+        uint32_t second = 0;
+        int16_t amount = 0;
+    };
+
+    class CharDescriptor
+    {
+    public:
+        int16_t x = 0, y = 0;
+        int16_t width = 0;
+        int16_t height = 0;
+        int16_t xOffset = 0;
+        int16_t yOffset = 0;
+        int16_t xAdvance = 0;
+        int16_t page = 0;
+        bool valid = false;
+    };
+
+    // Glyph source used by text layouts. Character rectangles are in pixels of the font texture.
+    class Font: public Noncopyable
+    {
+    public:
+        virtual ~Font();
+
+        float getHeight() const { return lineHeight; }
+
+        // returns nullptr if the font has no glyph for the character
+        virtual const CharDescriptor* getChar(uint32_t charId) = 0;
+        virtual int16_t getKerningPair(uint32_t first, uint32_t second) const = 0;
+
+        virtual const graphics::TexturePtr& getTexture() = 0;
+
+        // layouts retain the characters they display, fonts with a glyph cache never evict retained glyphs
+        virtual void retainChar(uint32_t charId);
+        virtual void releaseChar(uint32_t charId);
+
+        // appends the quad of the character with its pen position at x on the line starting at y
+        void addGlyph(const CharDescriptor& f, float x, float y, const graphics::Color& color, std::vector<graphics::VertexPCT>& vertices) const;
+
+    protected:
+        int16_t lineHeight = 0;
+
+        // size of the font texture
+        int16_t width = 0;
+        int16_t height = 0;
+    };
+}
@@ -0,0 +1,331 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "GlyphAtlas.h"
+#include "TTFont.h"
+#include "core/Engine.h"
+#include "graphics/Renderer.h"
+#include "graphics/Texture.h"
+#include "math/Rectangle.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    GlyphAtlas::GlyphAtlas(uint32_t newSize):
+        size(std::max(newSize, BLOCK_SIZE) / BLOCK_SIZE * BLOCK_SIZE)
+    {
+        blocksPerRow = size / BLOCK_SIZE;
+
+        blocks.resize(blocksPerRow * blocksPerRow);
+        cells.resize(blocks.size() * CELLS_PER_BLOCK);
+
+        for (uint32_t cellSize = MIN_CELL_SIZE; cellSize <= BLOCK_SIZE; cellSize *= 2)
+        {
+            sizeClasses.push_back(SizeClass());
+        }
+
+        data.resize(size * size);
+
+        // the texture is white with the coverage in the alpha channel, so that filtering at glyph edges does not darken
+        // the text, the texture shader takes the color of text from the texture, so an A8 texture would draw it black
+        std::vector<uint8_t> textureData(size * size * 4);
+
+        for (uint32_t i = 0; i < size * size; ++i)
+        {
+            textureData[i * 4 + 0] = 255;
+            textureData[i * 4 + 1] = 255;
+            textureData[i * 4 + 2] = 255;
+            textureData[i * 4 + 3] = 0;
+        }
+
+        texture = sharedEngine->getRenderer()->createTexture();
+        texture->initFromBuffer(textureData, Size2(static_cast<float>(size), static_cast<float>(size)), true, false);
+    }
+
+    GlyphAtlas::~GlyphAtlas()
+    {
+    }
+
+    const graphics::TexturePtr& GlyphAtlas::getTexture()
+    {
+        if (dirty)
+        {
+            uint32_t width = dirtyMaxX - dirtyMinX;
+            uint32_t height = dirtyMaxY - dirtyMinY;
+            std::vector<uint8_t> textureData(width * height * 4);
+
+            for (uint32_t row = 0; row < height; ++row)
+            {
+                const uint8_t* source = &data[(dirtyMinY + row) * size + dirtyMinX];
+                uint8_t* destination = &textureData[row * width * 4];
+
+                for (uint32_t column = 0; column < width; ++column)
+                {
+                    destination[column * 4 + 0] = 255;
+                    destination[column * 4 + 1] = 255;
+                    destination[column * 4 + 2] = 255;
+                    destination[column * 4 + 3] = source[column];
+                }
+            }
+
+            texture->setSubData(textureData, Rectangle(static_cast<float>(dirtyMinX), static_cast<float>(dirtyMinY),
+                                                       static_cast<float>(width), static_cast<float>(height)));
+            dirty = false;
+        }
+
+        return texture;
+    }
+
+    uint32_t GlyphAtlas::getSizeClass(uint32_t cellSize) const
+    {
+        uint32_t result = 0;
+
+        for (uint32_t currentSize = MIN_CELL_SIZE; currentSize < cellSize; currentSize *= 2)
+        {
+            ++result;
+        }
+
+        return result;
+    }
+
+    uint32_t GlyphAtlas::allocateCell(uint32_t glyphWidth, uint32_t glyphHeight, TTFont* font, uint32_t charId)
+    {
+        // one pixel of padding on every side
+        uint32_t cellSize = MIN_CELL_SIZE;
+
+        while (cellSize < std::max(glyphWidth, glyphHeight) + 2)
+        {
+            cellSize *= 2;
+        }
+
+        if (cellSize > BLOCK_SIZE)
+        {
+            log(LOG_LEVEL_WARNING, "Glyph of size %ux%u does not fit in a glyph atlas block", glyphWidth, glyphHeight);
+            return INVALID_CELL;
+        }
+
+        SizeClass& sizeClass = sizeClasses[getSizeClass(cellSize)];
+
+        if (sizeClass.freeCells.empty() && !assignBlock(cellSize, false))
+        {
+            if (!sizeClass.unusedCells.empty())
+            {
+                evictCell(sizeClass.unusedCells.front());
+            }
+            else
+            {
+                assignBlock(cellSize, true);
+            }
+        }
+
+        if (sizeClass.freeCells.empty())
+        {
+            return INVALID_CELL;
+        }
+
+        uint32_t cell = sizeClass.freeCells.back();
+        sizeClass.freeCells.pop_back();
+
+        // new glyphs are not retained until a layout displays them
+        Cell& newCell = cells[cell];
+        newCell.font = font;
+        newCell.charId = charId;
+        newCell.references = 0;
+        newCell.unusedPosition = sizeClass.unusedCells.insert(sizeClass.unusedCells.end(), cell);
+
+        ++blocks[cell / CELLS_PER_BLOCK].usedCells;
+        ++glyphCount;
+
+        return cell;
+    }
+
+    void GlyphAtlas::freeCell(uint32_t cell)
+    {
+        Cell& currentCell = cells[cell];
+
+        if (!currentCell.font)
+        {
+            return;
+        }
+
+        Block& block = blocks[cell / CELLS_PER_BLOCK];
+        SizeClass& sizeClass = sizeClasses[getSizeClass(block.cellSize)];
+
+        if (currentCell.references == 0)
+        {
+            sizeClass.unusedCells.erase(currentCell.unusedPosition);
+        }
+
+        currentCell.font = nullptr;
+        currentCell.references = 0;
+        sizeClass.freeCells.push_back(cell);
+
+        --block.usedCells;
+        --glyphCount;
+    }
+
+    void GlyphAtlas::evictCell(uint32_t cell)
+    {
+        TTFont* font = cells[cell].font;
+        uint32_t charId = cells[cell].charId;
+
+        freeCell(cell);
+        font->evictChar(charId);
+
+        ++evictionCount;
+    }
+
+    void GlyphAtlas::retainCell(uint32_t cell)
+    {
+        Cell& currentCell = cells[cell];
+
+        if (currentCell.references++ == 0)
+        {
+            SizeClass& sizeClass = sizeClasses[getSizeClass(blocks[cell / CELLS_PER_BLOCK].cellSize)];
+            sizeClass.unusedCells.erase(currentCell.unusedPosition);
+        }
+    }
+
+    void GlyphAtlas::releaseCell(uint32_t cell)
+    {
+        Cell& currentCell = cells[cell];
+
+        if (currentCell.references > 0 && --currentCell.references == 0)
+        {
+            SizeClass& sizeClass = sizeClasses[getSizeClass(blocks[cell / CELLS_PER_BLOCK].cellSize)];
+            currentCell.unusedPosition = sizeClass.unusedCells.insert(sizeClass.unusedCells.end(), cell);
+        }
+    }
+
+    bool GlyphAtlas::assignBlock(uint32_t cellSize, bool evict)
+    {
+        uint32_t blockIndex = INVALID_CELL;
+
+        for (uint32_t i = 0; i < blocks.size(); ++i)
+        {
+            if (blocks[i].cellSize == 0)
+            {
+                blockIndex = i;
+                break;
+            }
+        }
+
+        if (blockIndex == INVALID_CELL && evict)
+        {
+            // a block of another size class can be taken over if none of its glyphs are retained,
+            // the one with the fewest cached glyphs loses the least
+            for (uint32_t i = 0; i < blocks.size(); ++i)
+            {
+                if (blocks[i].cellSize == cellSize ||
+                    (blockIndex != INVALID_CELL && blocks[i].usedCells >= blocks[blockIndex].usedCells))
+                {
+                    continue;
+                }
+
+                bool retained = false;
+
+                for (uint32_t cell = i * CELLS_PER_BLOCK; cell < (i + 1) * CELLS_PER_BLOCK; ++cell)
+                {
+                    if (cells[cell].font && cells[cell].references > 0)
+                    {
+                        retained = true;
+                        break;
+                    }
+                }
+
+                if (!retained)
+                {
+                    blockIndex = i;
+                }
+            }
+
+            if (blockIndex != INVALID_CELL)
+            {
+                Block& block = blocks[blockIndex];
+                uint32_t firstCell = blockIndex * CELLS_PER_BLOCK;
+                uint32_t lastCell = firstCell + CELLS_PER_BLOCK;
+
+                for (uint32_t cell = firstCell; cell < lastCell; ++cell)
+                {
+                    if (cells[cell].font)
+                    {
+                        evictCell(cell);
+                    }
+                }
+
+                std::vector<uint32_t>& oldFreeCells = sizeClasses[getSizeClass(block.cellSize)].freeCells;
+                oldFreeCells.erase(std::remove_if(oldFreeCells.begin(), oldFreeCells.end(), [firstCell, lastCell](uint32_t cell) {
+                    return cell >= firstCell && cell < lastCell;
+                }), oldFreeCells.end());
+            }
+        }
+
+        if (blockIndex == INVALID_CELL)
+        {
+            return false;
+        }
+
+        blocks[blockIndex].cellSize = cellSize;
+
+        uint32_t cellsPerRow = BLOCK_SIZE / cellSize;
+        uint32_t cellCount = cellsPerRow * cellsPerRow;
+        std::vector<uint32_t>& freeCells = sizeClasses[getSizeClass(cellSize)].freeCells;
+
+        // reversed, so that the cells are taken from the top left corner of the block
+        for (uint32_t i = cellCount; i > 0; --i)
+        {
+            freeCells.push_back(blockIndex * CELLS_PER_BLOCK + i - 1);
+        }
+
+        return true;
+    }
+
+    void GlyphAtlas::getCellPosition(uint32_t cell, uint32_t& x, uint32_t& y) const
+    {
+        uint32_t blockIndex = cell / CELLS_PER_BLOCK;
+        uint32_t localIndex = cell % CELLS_PER_BLOCK;
+        uint32_t cellSize = blocks[blockIndex].cellSize;
+        uint32_t cellsPerRow = BLOCK_SIZE / cellSize;
+
+        x = (blockIndex % blocksPerRow) * BLOCK_SIZE + (localIndex % cellsPerRow) * cellSize + 1;
+        y = (blockIndex / blocksPerRow) * BLOCK_SIZE + (localIndex / cellsPerRow) * cellSize + 1;
+    }
+
+    void GlyphAtlas::setCellPixels(uint32_t cell, const uint8_t* pixels, uint32_t pixelsWidth, uint32_t pixelsHeight)
+    {
+        uint32_t x, y;
+        getCellPosition(cell, x, y);
+
+        uint32_t cellSize = blocks[cell / CELLS_PER_BLOCK].cellSize;
+
+        // clear the whole cell, a previous glyph might have been larger
+        for (uint32_t row = 0; row < cellSize; ++row)
+        {
+            std::fill_n(&data[(y - 1 + row) * size + x - 1], cellSize, 0);
+        }
+
+        for (uint32_t row = 0; row < pixelsHeight; ++row)
+        {
+            std::copy(pixels + row * pixelsWidth, pixels + (row + 1) * pixelsWidth, &data[(y + row) * size + x]);
+        }
+
+        // only the cells that changed since the last upload are uploaded again
+        if (dirty)
+        {
+            dirtyMinX = std::min(dirtyMinX, x - 1);
+            dirtyMinY = std::min(dirtyMinY, y - 1);
+            dirtyMaxX = std::max(dirtyMaxX, x - 1 + cellSize);
+            dirtyMaxY = std::max(dirtyMaxY, y - 1 + cellSize);
+        }
+        else
+        {
+            dirtyMinX = x - 1;
+            dirtyMinY = y - 1;
+            dirtyMaxX = x - 1 + cellSize;
+            dirtyMaxY = y - 1 + cellSize;
+        }
+
+        dirty = true;
+    }
+}
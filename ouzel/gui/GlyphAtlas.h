@@ -0,0 +1,93 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include <list>
+#include <cstdint>
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    class TTFont;
+
+    // Dynamic texture shared by all TrueType fonts. The atlas is split into blocks of BLOCK_SIZE pixels, every block
+    // is split into square cells of one size class (16, 32, 64 or 128 pixels) when a glyph of that size first needs it.
+    // Glyphs that no text layout retains stay cached and are evicted least recently released first when their size
+    // class runs out of cells and there are no empty blocks left.
+    class GlyphAtlas: public Noncopyable
+    {
+        friend TTFont;
+    public:
+        static const uint32_t INVALID_CELL = 0xFFFFFFFF;
+        static const uint32_t BLOCK_SIZE = 128;
+        static const uint32_t MIN_CELL_SIZE = 16;
+        static const uint32_t CELLS_PER_BLOCK = (BLOCK_SIZE / MIN_CELL_SIZE) * (BLOCK_SIZE / MIN_CELL_SIZE);
+
+        GlyphAtlas(uint32_t newSize = 1024);
+        virtual ~GlyphAtlas();
+
+        // uploads the rectangle of the atlas that holds the glyphs that were rasterized since the last call
+        const graphics::TexturePtr& getTexture();
+
+        uint32_t getSize() const { return size; }
+        uint32_t getGlyphCount() const { return glyphCount; }
+        uint32_t getEvictionCount() const { return evictionCount; }
+
+    protected:
+        // returns INVALID_CELL if the glyph is too large or all the space is taken by retained glyphs
+        uint32_t allocateCell(uint32_t glyphWidth, uint32_t glyphHeight, TTFont* font, uint32_t charId);
+        void freeCell(uint32_t cell);
+        void retainCell(uint32_t cell);
+        void releaseCell(uint32_t cell);
+
+        // glyphs are written one pixel from the top left corner of the cell, so that filtering never reads other glyphs
+        void getCellPosition(uint32_t cell, uint32_t& x, uint32_t& y) const;
+        void setCellPixels(uint32_t cell, const uint8_t* pixels, uint32_t pixelsWidth, uint32_t pixelsHeight);
+
+        struct Cell
+        {
+            TTFont* font = nullptr; // nullptr if the cell is free
+            uint32_t charId = 0;
+            uint32_t references = 0;
+            std::list<uint32_t>::iterator unusedPosition;
+        };
+
+        struct Block
+        {
+            uint32_t cellSize = 0; // 0 if the block is empty
+            uint32_t usedCells = 0;
+        };
+
+        struct SizeClass
+        {
+            std::vector<uint32_t> freeCells;
+            std::list<uint32_t> unusedCells; // cached glyphs that are not retained, least recently released first
+        };
+
+        uint32_t getSizeClass(uint32_t cellSize) const;
+        void evictCell(uint32_t cell);
+        bool assignBlock(uint32_t cellSize, bool evict);
+
+        uint32_t size;
+        uint32_t blocksPerRow;
+
+        std::vector<Block> blocks;
+        std::vector<Cell> cells;
+        std::vector<SizeClass> sizeClasses;
+
+        // coverage of the glyphs, one byte per pixel
+        std::vector<uint8_t> data;
+        graphics::TexturePtr texture;
+        bool dirty = false;
+        uint32_t dirtyMinX = 0;
+        uint32_t dirtyMinY = 0;
+        uint32_t dirtyMaxX = 0;
+        uint32_t dirtyMaxY = 0;
+
+        uint32_t glyphCount = 0;
+        uint32_t evictionCount = 0;
+    };
+}
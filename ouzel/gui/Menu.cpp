@@ -124,8 +124,7 @@ namespace ouzel
                 {
                     if (selectedWidget)
                     {
-                        Event clickEvent;
-                        clickEvent.type = Event::Type::UI_CLICK_NODE;
+                        Event clickEvent(Event::Type::UI_CLICK_NODE);
 
                         clickEvent.uiEvent.node = selectedWidget;
                         clickEvent.uiEvent.position = selectedWidget->getPosition();
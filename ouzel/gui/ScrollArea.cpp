@@ -1,11 +1,376 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <cmath>
 #include "ScrollArea.h"
+#include "core/Engine.h"
+#include "events/EventDispatcher.h"
+#include "scene/SceneManager.h"
+#include "scene/Scene.h"
+#include "scene/Layer.h"
+#include "scene/Camera.h"
 
 namespace ouzel
 {
     namespace gui
     {
+        // distance scrolled by one step of the mouse wheel if there are no items
+        static const float SCROLL_STEP = 20.0f;
+
+        ScrollArea::ScrollArea(const Size2& newSize):
+            size(newSize)
+        {
+            eventHandler.mouseHandler = std::bind(&ScrollArea::handleMouse, this, std::placeholders::_1, std::placeholders::_2);
+            eventHandler.touchHandler = std::bind(&ScrollArea::handleTouch, this, std::placeholders::_1, std::placeholders::_2);
+            eventHandler.uiHandler = std::bind(&ScrollArea::handleUI, this, std::placeholders::_1, std::placeholders::_2);
+            sharedEngine->getEventDispatcher()->addEventHandler(eventHandler);
+
+            content = std::make_shared<scene::Node>();
+            addChild(content);
+
+            updateContentPosition();
+        }
+
+        ScrollArea::~ScrollArea()
+        {
+        }
+
+        void ScrollArea::setSize(const Size2& newSize)
+        {
+            size = newSize;
+
+            setScrollPosition(scrollPosition);
+        }
+
+        void ScrollArea::setContentSize(const Size2& newContentSize)
+        {
+            contentSize = newContentSize;
+
+            setScrollPosition(scrollPosition);
+        }
+
+        Size2 ScrollArea::getContentSize() const
+        {
+            if (createItem)
+            {
+                return Size2(contentSize.width, itemCount * itemHeight);
+            }
+
+            return contentSize;
+        }
+
+        void ScrollArea::setScrollPosition(const Vector2& newScrollPosition)
+        {
+            Size2 currentContentSize = getContentSize();
+
+            scrollPosition.x = std::max(0.0f, std::min(newScrollPosition.x, currentContentSize.width - size.width));
+            scrollPosition.y = std::max(0.0f, std::min(newScrollPosition.y, currentContentSize.height - size.height));
+
+            updateContentPosition();
+        }
+
+        void ScrollArea::scrollBy(const Vector2& delta)
+        {
+            setScrollPosition(scrollPosition + delta);
+        }
+
+        void ScrollArea::setItems(uint32_t newItemCount, float newItemHeight,
+                                  const std::function<scene::NodePtr()>& newCreateItem,
+                                  const std::function<void(const scene::NodePtr&, uint32_t)>& newBindItem)
+        {
+            // nodes created by the previous factory might not fit the new items
+            clearItems();
+
+            itemCount = newItemCount;
+            itemHeight = newItemHeight;
+            createItem = newCreateItem;
+            bindItem = newBindItem;
+
+            setScrollPosition(scrollPosition);
+        }
+
+        void ScrollArea::setItemCount(uint32_t newItemCount)
+        {
+            itemCount = newItemCount;
+            itemsDirty = true;
+
+            setScrollPosition(scrollPosition);
+        }
+
+        void ScrollArea::reloadItems()
+        {
+            itemsDirty = true;
+        }
+
+        scene::NodePtr ScrollArea::getItemNode(uint32_t index) const
+        {
+            for (const Item& item : items)
+            {
+                if (item.index == index)
+                {
+                    return item.node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void ScrollArea::visit(const Matrix4& newParentTransform, bool parentTransformDirty, const scene::LayerPtr& currentLayer, float depth)
+        {
+            if (parentTransformDirty)
+            {
+                updateTransform(newParentTransform);
+            }
+
+            layer = currentLayer;
+
+            updateItems();
+
+            const Matrix4& currentTransform = getTransform();
+
+            Vector3 corners[4] = {
+                Vector3(0.0f, 0.0f, 0.0f),
+                Vector3(size.width, 0.0f, 0.0f),
+                Vector3(0.0f, size.height, 0.0f),
+                Vector3(size.width, size.height, 0.0f)
+            };
+
+            AABB2 viewportBounds;
+
+            for (Vector3& corner : corners)
+            {
+                currentTransform.transformPoint(corner);
+                viewportBounds.insertPoint(Vector2(corner.x, corner.y));
+            }
+
+            // a scroll area inside of another one is clipped by both
+            if (scissorTestEnabled)
+            {
+                viewportBounds.min.x = std::max(viewportBounds.min.x, clipBounds.min.x);
+                viewportBounds.min.y = std::max(viewportBounds.min.y, clipBounds.min.y);
+                viewportBounds.max.x = std::max(viewportBounds.min.x, std::min(viewportBounds.max.x, clipBounds.max.x));
+                viewportBounds.max.y = std::max(viewportBounds.min.y, std::min(viewportBounds.max.y, clipBounds.max.y));
+            }
+
+            clipBounds = viewportBounds;
+
+            if (currentLayer && currentLayer->getCamera())
+            {
+                const scene::CameraPtr& camera = currentLayer->getCamera();
+
+                Vector2 first = camera->projectPoint(Vector3(clipBounds.min.x, clipBounds.min.y, 0.0f));
+                Vector2 second = camera->projectPoint(Vector3(clipBounds.max.x, clipBounds.max.y, 0.0f));
+
+                float left = floorf(std::min(first.x, second.x));
+                float bottom = floorf(std::min(first.y, second.y));
+                float right = ceilf(std::max(first.x, second.x));
+                float top = ceilf(std::max(first.y, second.y));
+
+                scissorTest = Rectangle(left, bottom, right - left, top - bottom);
+                scissorTestEnabled = true;
+            }
+
+            Node::visit(newParentTransform, false, currentLayer, depth);
+        }
+
+        // only the items that intersect the viewport get nodes, the nodes of the items that scrolled out of it are
+        // hidden and bound to the items that scrolled in
+        void ScrollArea::updateItems()
+        {
+            if (!createItem || itemHeight <= 0.0f)
+            {
+                return;
+            }
+
+            uint32_t firstItem = std::min(itemCount, static_cast<uint32_t>(scrollPosition.y / itemHeight));
+            uint32_t lastItem = std::min(itemCount, static_cast<uint32_t>(ceilf((scrollPosition.y + size.height) / itemHeight)));
+
+            if (!itemsDirty && firstItem == firstBoundItem && lastItem == lastBoundItem)
+            {
+                return;
+            }
+
+            for (Item& item : items)
+            {
+                if (item.index == INVALID_INDEX)
+                {
+                    continue;
+                }
+
+                if (item.index < firstItem || item.index >= lastItem)
+                {
+                    item.index = INVALID_INDEX;
+                    item.node->setHidden(true);
+                }
+                else if (itemsDirty)
+                {
+                    if (bindItem) bindItem(item.node, item.index);
+                }
+            }
+
+            uint32_t freeItem = 0;
+
+            for (uint32_t index = firstItem; index < lastItem; ++index)
+            {
+                // items that were visible before keep their nodes
+                if (index >= firstBoundItem && index < lastBoundItem)
+                {
+                    continue;
+                }
+
+                while (freeItem < items.size() && items[freeItem].index != INVALID_INDEX)
+                {
+                    ++freeItem;
+                }
+
+                if (freeItem == items.size())
+                {
+                    Item item;
+                    item.index = INVALID_INDEX;
+                    item.node = createItem();
+
+                    if (!item.node)
+                    {
+                        break;
+                    }
+
+                    content->addChild(item.node);
+                    items.push_back(item);
+                }
+
+                Item& item = items[freeItem];
+                item.index = index;
+                item.node->setPosition(Vector2(0.0f, -(index + 1) * itemHeight));
+                item.node->setHidden(false);
+
+                if (bindItem) bindItem(item.node, index);
+            }
+
+            firstBoundItem = firstItem;
+            lastBoundItem = lastItem;
+            itemsDirty = false;
+        }
+
+        void ScrollArea::clearItems()
+        {
+            for (const Item& item : items)
+            {
+                content->removeChild(item.node);
+            }
+
+            items.clear();
+            firstBoundItem = 0;
+            lastBoundItem = 0;
+            itemsDirty = false;
+        }
+
+        void ScrollArea::updateContentPosition()
+        {
+            content->setPosition(Vector2(-scrollPosition.x, size.height + scrollPosition.y));
+        }
+
+        bool ScrollArea::isContentNode(const scene::NodePtr& node) const
+        {
+            return node && (node.get() == this || hasChild(node, true));
+        }
+
+        bool ScrollArea::convertScreenToLocal(const Vector2& screenPosition, Vector2& localPosition) const
+        {
+            scene::LayerPtr currentLayer = layer.lock();
+
+            if (!currentLayer || !currentLayer->getCamera())
+            {
+                return false;
+            }
+
+            localPosition = convertWorldToLocal(currentLayer->getCamera()->convertScreenToWorld(screenPosition));
+
+            return true;
+        }
+
+        void ScrollArea::drag(const Vector2& screenPosition)
+        {
+            Vector2 dragPosition;
+
+            if (convertScreenToLocal(screenPosition, dragPosition))
+            {
+                // the content follows the pointer
+                scrollBy(Vector2(lastDragPosition.x - dragPosition.x, dragPosition.y - lastDragPosition.y));
+
+                lastDragPosition = dragPosition;
+            }
+        }
+
+        bool ScrollArea::handleMouse(Event::Type type, const MouseEvent& event)
+        {
+            if (!enabled) return true;
+
+            if (type == Event::Type::MOUSE_DOWN)
+            {
+                pointerDownPosition = event.position;
+            }
+            else if (type == Event::Type::MOUSE_MOVE)
+            {
+                if (dragging)
+                {
+                    drag(event.position);
+                }
+            }
+            else if (type == Event::Type::MOUSE_UP)
+            {
+                dragging = false;
+            }
+            else if (type == Event::Type::MOUSE_SCROLL)
+            {
+                const scene::ScenePtr& scene = sharedEngine->getSceneManager()->getScene();
+
+                if (scene && isContentNode(scene->pickNode(event.position)))
+                {
+                    float step = (itemHeight > 0.0f) ? itemHeight : SCROLL_STEP;
+
+                    scrollBy(Vector2(-event.scroll.x * step, -event.scroll.y * step));
+                }
+            }
+
+            return true;
+        }
+
+        bool ScrollArea::handleTouch(Event::Type type, const TouchEvent& event)
+        {
+            if (!enabled) return true;
+
+            if (type == Event::Type::TOUCH_BEGIN)
+            {
+                pointerDownPosition = event.position;
+            }
+            else if (type == Event::Type::TOUCH_MOVE)
+            {
+                if (dragging)
+                {
+                    drag(event.position);
+                }
+            }
+            else if (type == Event::Type::TOUCH_END ||
+                     type == Event::Type::TOUCH_CANCEL)
+            {
+                dragging = false;
+            }
+
+            return true;
+        }
+
+        bool ScrollArea::handleUI(Event::Type type, const UIEvent& event)
+        {
+            if (!enabled) return true;
+
+            // the press event is posted while the pointer down event is handled, so the position is already known
+            if (type == Event::Type::UI_PRESS_NODE && isContentNode(event.node))
+            {
+                dragging = convertScreenToLocal(pointerDownPosition, lastDragPosition);
+            }
+
+            return true;
+        }
     } // namespace gui
 } // namespace ouzel
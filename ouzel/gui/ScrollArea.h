@@ -3,14 +3,106 @@
 
 #pragma once
 
+#include <vector>
+#include <functional>
+#include "utils/Types.h"
 #include "gui/Widget.h"
+#include "math/Size2.h"
+#include "events/EventHandler.h"
 
 namespace ouzel
 {
     namespace gui
     {
+        // Clips its content to a viewport of the given size with the bottom left corner at the origin of the node.
+        // The origin of the content is at the top left corner of the viewport and the content extends downward.
+        // Nodes that are entirely outside of the viewport are not drawn. A list of items can be virtualized, so that
+        // only the items in the viewport have nodes, which are recycled for other items while scrolling.
         class ScrollArea: public Widget
         {
+        public:
+            static const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+            ScrollArea(const Size2& newSize = Size2());
+            virtual ~ScrollArea();
+
+            virtual void setSize(const Size2& newSize);
+            const Size2& getSize() const { return size; }
+
+            // scrollable size of content that is added to the content node, the height of a virtualized list is
+            // the item count multiplied by the item height
+            virtual void setContentSize(const Size2& newContentSize);
+            Size2 getContentSize() const;
+
+            const scene::NodePtr& getContent() const { return content; }
+
+            virtual void setScrollPosition(const Vector2& newScrollPosition);
+            const Vector2& getScrollPosition() const { return scrollPosition; }
+            void scrollBy(const Vector2& delta);
+
+            // createItem creates a node for an item row, bindItem sets up the node for the item with the given index,
+            // rows are itemHeight high and their origin is at the bottom left corner of the row
+            void setItems(uint32_t newItemCount, float newItemHeight,
+                          const std::function<scene::NodePtr()>& newCreateItem,
+                          const std::function<void(const scene::NodePtr&, uint32_t)>& newBindItem);
+            void setItemCount(uint32_t newItemCount);
+            uint32_t getItemCount() const { return itemCount; }
+            float getItemHeight() const { return itemHeight; }
+
+            // binds all the visible items again, e.g. after the data they show has changed
+            void reloadItems();
+
+            // returns nullptr if the item is not in the viewport
+            scene::NodePtr getItemNode(uint32_t index) const;
+            uint32_t getItemNodeCount() const { return static_cast<uint32_t>(items.size()); }
+
+        protected:
+            virtual void visit(const Matrix4& newParentTransform, bool parentTransformDirty, const scene::LayerPtr& currentLayer, float depth) override;
+
+            void updateItems();
+            void clearItems();
+            void updateContentPosition();
+
+            bool isContentNode(const scene::NodePtr& node) const;
+            void drag(const Vector2& screenPosition);
+            bool convertScreenToLocal(const Vector2& screenPosition, Vector2& localPosition) const;
+
+            bool handleMouse(Event::Type type, const MouseEvent& event);
+            bool handleTouch(Event::Type type, const TouchEvent& event);
+            bool handleUI(Event::Type type, const UIEvent& event);
+
+            Size2 size;
+            Size2 contentSize;
+            Vector2 scrollPosition;
+
+            scene::NodePtr content;
+
+            struct Item
+            {
+                uint32_t index; // INVALID_INDEX if the node is not bound to any item
+                scene::NodePtr node;
+            };
+
+            uint32_t itemCount = 0;
+            float itemHeight = 0.0f;
+            std::function<scene::NodePtr()> createItem;
+            std::function<void(const scene::NodePtr&, uint32_t)> bindItem;
+
+            std::vector<Item> items;
+            uint32_t firstBoundItem = 0;
+            uint32_t lastBoundItem = 0;
+            bool itemsDirty = false;
+
+            // layer of the last visit, pointer positions are converted to world space with its camera
+            scene::LayerWeakPtr layer;
+
+            // drags are tracked with the pointer events, because the positions of UI events are relative to nodes
+            // of the content, which moves while it is dragged
+            Vector2 pointerDownPosition;
+            bool dragging = false;
+            Vector2 lastDragPosition;
+
+            EventHandler eventHandler;
         };
     } // namespace gui
 } // namespace ouzel
@@ -0,0 +1,175 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cmath>
+#include "TTFont.h"
+#include "GlyphAtlas.h"
+#include "core/Application.h"
+#include "files/FileSystem.h"
+#include "utils/Utils.h"
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+
+namespace ouzel
+{
+    FontPtr TTFont::loadFont(const std::string& filename, uint32_t pixelSize, const GlyphAtlasPtr& glyphAtlas)
+    {
+        std::shared_ptr<TTFont> result = std::make_shared<TTFont>();
+
+        if (!result->init(filename, pixelSize, glyphAtlas))
+        {
+            result.reset();
+        }
+
+        return result;
+    }
+
+    TTFont::TTFont()
+    {
+    }
+
+    TTFont::~TTFont()
+    {
+        if (glyphAtlas)
+        {
+            for (const auto& glyph : glyphs)
+            {
+                if (glyph.second.cell != GlyphAtlas::INVALID_CELL)
+                {
+                    glyphAtlas->freeCell(glyph.second.cell);
+                }
+            }
+        }
+    }
+
+    bool TTFont::init(const std::string& filename, uint32_t newPixelSize, const GlyphAtlasPtr& newGlyphAtlas)
+    {
+        pixelSize = newPixelSize ? newPixelSize : DEFAULT_PIXEL_SIZE;
+        glyphAtlas = newGlyphAtlas;
+
+        if (!sharedApplication->getFileSystem()->mapFile(filename, fontData))
+        {
+            return false;
+        }
+
+        fontInfo.reset(new stbtt_fontinfo());
+
+        int offset = stbtt_GetFontOffsetForIndex(fontData.getData(), 0);
+
+        if (offset < 0 || !stbtt_InitFont(fontInfo.get(), fontData.getData(), offset))
+        {
+            log(LOG_LEVEL_ERROR, "Failed to parse font %s", filename.c_str());
+            return false;
+        }
+
+        scale = stbtt_ScaleForPixelHeight(fontInfo.get(), static_cast<float>(pixelSize));
+
+        int ascent, descent, lineGap;
+        stbtt_GetFontVMetrics(fontInfo.get(), &ascent, &descent, &lineGap);
+
+        baseline = static_cast<int16_t>(roundf(ascent * scale));
+        lineHeight = static_cast<int16_t>(roundf((ascent - descent + lineGap) * scale));
+
+        width = static_cast<int16_t>(glyphAtlas->getSize());
+        height = static_cast<int16_t>(glyphAtlas->getSize());
+
+        return true;
+    }
+
+    const CharDescriptor* TTFont::getChar(uint32_t charId)
+    {
+        std::unordered_map<uint32_t, Glyph>::iterator i = glyphs.find(charId);
+
+        if (i != glyphs.end())
+        {
+            return &i->second.descriptor;
+        }
+
+        int glyphIndex = stbtt_FindGlyphIndex(fontInfo.get(), static_cast<int>(charId));
+
+        if (glyphIndex == 0)
+        {
+            return nullptr;
+        }
+
+        int advance, leftSideBearing;
+        stbtt_GetGlyphHMetrics(fontInfo.get(), glyphIndex, &advance, &leftSideBearing);
+
+        int x0, y0, x1, y1;
+        stbtt_GetGlyphBitmapBox(fontInfo.get(), glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+        Glyph glyph;
+        glyph.descriptor.width = static_cast<int16_t>(x1 - x0);
+        glyph.descriptor.height = static_cast<int16_t>(y1 - y0);
+        glyph.descriptor.xOffset = static_cast<int16_t>(x0);
+        glyph.descriptor.yOffset = static_cast<int16_t>(baseline + y0);
+        glyph.descriptor.xAdvance = static_cast<int16_t>(roundf(advance * scale));
+        glyph.descriptor.valid = true;
+        glyph.cell = GlyphAtlas::INVALID_CELL;
+
+        // blank glyphs like space only advance the pen and take no space in the atlas
+        if (glyph.descriptor.width > 0 && glyph.descriptor.height > 0)
+        {
+            uint32_t glyphWidth = static_cast<uint32_t>(glyph.descriptor.width);
+            uint32_t glyphHeight = static_cast<uint32_t>(glyph.descriptor.height);
+
+            glyph.cell = glyphAtlas->allocateCell(glyphWidth, glyphHeight, this, charId);
+
+            if (glyph.cell == GlyphAtlas::INVALID_CELL)
+            {
+                log(LOG_LEVEL_WARNING, "No space in the glyph atlas for character %u", charId);
+                return nullptr;
+            }
+
+            bitmap.resize(glyphWidth * glyphHeight);
+            stbtt_MakeGlyphBitmap(fontInfo.get(), bitmap.data(), glyph.descriptor.width, glyph.descriptor.height,
+                                  glyph.descriptor.width, scale, scale, glyphIndex);
+
+            glyphAtlas->setCellPixels(glyph.cell, bitmap.data(), glyphWidth, glyphHeight);
+
+            uint32_t x, y;
+            glyphAtlas->getCellPosition(glyph.cell, x, y);
+            glyph.descriptor.x = static_cast<int16_t>(x);
+            glyph.descriptor.y = static_cast<int16_t>(y);
+        }
+
+        return &glyphs.insert(std::make_pair(charId, glyph)).first->second.descriptor;
+    }
+
+    int16_t TTFont::getKerningPair(uint32_t first, uint32_t second) const
+    {
+        int advance = stbtt_GetCodepointKernAdvance(fontInfo.get(), static_cast<int>(first), static_cast<int>(second));
+
+        return static_cast<int16_t>(roundf(advance * scale));
+    }
+
+    const graphics::TexturePtr& TTFont::getTexture()
+    {
+        return glyphAtlas->getTexture();
+    }
+
+    void TTFont::retainChar(uint32_t charId)
+    {
+        std::unordered_map<uint32_t, Glyph>::iterator i = glyphs.find(charId);
+
+        if (i != glyphs.end() && i->second.cell != GlyphAtlas::INVALID_CELL)
+        {
+            glyphAtlas->retainCell(i->second.cell);
+        }
+    }
+
+    void TTFont::releaseChar(uint32_t charId)
+    {
+        std::unordered_map<uint32_t, Glyph>::iterator i = glyphs.find(charId);
+
+        if (i != glyphs.end() && i->second.cell != GlyphAtlas::INVALID_CELL)
+        {
+            glyphAtlas->releaseCell(i->second.cell);
+        }
+    }
+
+    void TTFont::evictChar(uint32_t charId)
+    {
+        glyphs.erase(charId);
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "utils/Types.h"
+#include "files/FileView.h"
+#include "gui/Font.h"
+
+struct stbtt_fontinfo;
+
+namespace ouzel
+{
+    // TrueType and OpenType font, glyphs are rasterized at one pixel size the first time a layout needs them and
+    // cached in a glyph atlas that can be shared by all fonts
+    class TTFont: public Font
+    {
+        friend GlyphAtlas;
+    public:
+        static const uint32_t DEFAULT_PIXEL_SIZE = 32;
+
+        static FontPtr loadFont(const std::string& filename, uint32_t pixelSize, const GlyphAtlasPtr& glyphAtlas);
+
+        TTFont();
+        virtual ~TTFont();
+
+        bool init(const std::string& filename, uint32_t newPixelSize, const GlyphAtlasPtr& newGlyphAtlas);
+
+        uint32_t getPixelSize() const { return pixelSize; }
+        const GlyphAtlasPtr& getGlyphAtlas() const { return glyphAtlas; }
+
+        virtual const CharDescriptor* getChar(uint32_t charId) override;
+        virtual int16_t getKerningPair(uint32_t first, uint32_t second) const override;
+
+        virtual const graphics::TexturePtr& getTexture() override;
+
+        virtual void retainChar(uint32_t charId) override;
+        virtual void releaseChar(uint32_t charId) override;
+
+    protected:
+        // called by the glyph atlas when it reuses the cell of the character
+        void evictChar(uint32_t charId);
+
+        struct Glyph
+        {
+            CharDescriptor descriptor;
+            uint32_t cell;
+        };
+
+        uint32_t pixelSize = 0;
+        GlyphAtlasPtr glyphAtlas;
+
+        // stb_truetype reads the font from the mapped file, so it is kept for the lifetime of the font
+        FileView fontData;
+        std::unique_ptr<stbtt_fontinfo> fontInfo;
+
+        float scale = 0.0f;
+        int16_t baseline = 0;
+
+        std::unordered_map<uint32_t, Glyph> glyphs;
+        std::vector<uint8_t> bitmap;
+    };
+}
@@ -0,0 +1,205 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "TextLayout.h"
+#include "Font.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    TextLayout::TextLayout()
+    {
+    }
+
+    TextLayout::TextLayout(const TextLayout& other):
+        font(other.font),
+        text(other.text),
+        color(other.color),
+        characters(other.characters),
+        characterQuads(other.characterQuads),
+        characterPositions(other.characterPositions),
+        vertices(other.vertices),
+        width(other.width),
+        firstChangedQuad(other.firstChangedQuad)
+    {
+        retainCharacters();
+    }
+
+    TextLayout::~TextLayout()
+    {
+        releaseCharacters(0);
+    }
+
+    TextLayout& TextLayout::operator=(const TextLayout& other)
+    {
+        if (&other != this)
+        {
+            releaseCharacters(0);
+
+            font = other.font;
+            text = other.text;
+            color = other.color;
+            characters = other.characters;
+            characterQuads = other.characterQuads;
+            characterPositions = other.characterPositions;
+            vertices = other.vertices;
+            width = other.width;
+            firstChangedQuad = other.firstChangedQuad;
+
+            retainCharacters();
+        }
+
+        return *this;
+    }
+
+    void TextLayout::setFont(const FontPtr& newFont)
+    {
+        if (font != newFont)
+        {
+            releaseCharacters(0);
+
+            font = newFont;
+
+            update(0);
+        }
+    }
+
+    void TextLayout::setText(const std::string& newText)
+    {
+        if (text == newText)
+        {
+            return;
+        }
+
+        text = newText;
+
+        newCharacters.clear();
+
+        uint32_t length = static_cast<uint32_t>(text.length());
+
+        for (uint32_t offset = 0; offset < length;)
+        {
+            newCharacters.push_back(decodeUTF8(text, offset));
+        }
+
+        uint32_t commonLength = static_cast<uint32_t>(std::min(characters.size(), newCharacters.size()));
+        uint32_t firstCharacter = 0;
+
+        while (firstCharacter < commonLength && characters[firstCharacter] == newCharacters[firstCharacter])
+        {
+            ++firstCharacter;
+        }
+
+        // the position after the last unchanged character depends on its kerning with the first changed one
+        if (firstCharacter > 0)
+        {
+            --firstCharacter;
+        }
+
+        releaseCharacters(firstCharacter);
+
+        characters.swap(newCharacters);
+
+        update(firstCharacter);
+    }
+
+    void TextLayout::setColor(const graphics::Color& newColor)
+    {
+        color = newColor;
+
+        for (graphics::VertexPCT& vertex : vertices)
+        {
+            vertex.color = color;
+        }
+
+        firstChangedQuad = 0;
+    }
+
+    void TextLayout::reserve(uint32_t characterCount)
+    {
+        text.reserve(characterCount);
+        characters.reserve(characterCount);
+        newCharacters.reserve(characterCount);
+        characterQuads.reserve(characterCount + 1);
+        characterPositions.reserve(characterCount + 1);
+        vertices.reserve(characterCount * 4);
+    }
+
+    float TextLayout::getHeight() const
+    {
+        return font ? font->getHeight() : 0.0f;
+    }
+
+    void TextLayout::update(uint32_t firstCharacter)
+    {
+        uint32_t count = static_cast<uint32_t>(characters.size());
+
+        // the first character always starts at the first quad and at the origin
+        uint32_t quad = characterQuads[firstCharacter];
+        float x = characterPositions[firstCharacter];
+
+        characterQuads.resize(count + 1);
+        characterPositions.resize(count + 1);
+        vertices.resize(quad * 4);
+
+        float y = getHeight();
+
+        for (uint32_t i = firstCharacter; i < count; ++i)
+        {
+            characterQuads[i] = quad;
+            characterPositions[i] = x;
+
+            const CharDescriptor* f = font ? font->getChar(characters[i]) : nullptr;
+
+            if (f)
+            {
+                font->retainChar(characters[i]);
+                font->addGlyph(*f, x, y, color, vertices);
+                ++quad;
+
+                if (i + 1 < count)
+                {
+                    x += font->getKerningPair(characters[i], characters[i + 1]);
+                }
+
+                x += f->xAdvance;
+            }
+        }
+
+        characterQuads[count] = quad;
+        characterPositions[count] = x;
+        width = x;
+
+        firstChangedQuad = std::min(firstChangedQuad, characterQuads[firstCharacter]);
+    }
+
+    void TextLayout::retainCharacters()
+    {
+        if (font)
+        {
+            for (uint32_t i = 0; i < characters.size(); ++i)
+            {
+                if (characterQuads[i + 1] > characterQuads[i])
+                {
+                    font->retainChar(characters[i]);
+                }
+            }
+        }
+    }
+
+    // only the characters that got a quad were retained
+    void TextLayout::releaseCharacters(uint32_t firstCharacter)
+    {
+        if (font)
+        {
+            for (uint32_t i = firstCharacter; i < characters.size(); ++i)
+            {
+                if (characterQuads[i + 1] > characterQuads[i])
+                {
+                    font->releaseChar(characters[i]);
+                }
+            }
+        }
+    }
+}
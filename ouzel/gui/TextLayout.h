@@ -0,0 +1,73 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "utils/Types.h"
+#include "graphics/Color.h"
+#include "graphics/Vertex.h"
+
+namespace ouzel
+{
+    // Glyph quads of a single line of text. The quads start at the origin and are not anchored, so that a change of the
+    // text only lays out the characters from the first changed one onward and the quads before it stay untouched.
+    // The layout retains the glyphs it displays, so that the font can not evict them from its glyph cache.
+    class TextLayout
+    {
+    public:
+        static const uint32_t NO_CHANGES = 0xFFFFFFFF;
+
+        TextLayout();
+        TextLayout(const TextLayout& other);
+        ~TextLayout();
+
+        TextLayout& operator=(const TextLayout& other);
+
+        void setFont(const FontPtr& newFont);
+        const FontPtr& getFont() const { return font; }
+
+        void setText(const std::string& newText);
+        const std::string& getText() const { return text; }
+
+        void setColor(const graphics::Color& newColor);
+        const graphics::Color& getColor() const { return color; }
+
+        // reserves space for the given number of characters, so that text up to that length does not reallocate
+        void reserve(uint32_t characterCount);
+
+        const std::vector<graphics::VertexPCT>& getVertices() const { return vertices; }
+        uint32_t getQuadCount() const { return static_cast<uint32_t>(vertices.size() / 4); }
+
+        float getWidth() const { return width; }
+        float getHeight() const;
+
+        // quads before the first changed quad are the same as they were at the last call of clearChanges
+        uint32_t getFirstChangedQuad() const { return firstChangedQuad; }
+        void clearChanges() { firstChangedQuad = NO_CHANGES; }
+
+    protected:
+        void update(uint32_t firstCharacter);
+
+        void retainCharacters();
+        void releaseCharacters(uint32_t firstCharacter);
+
+        FontPtr font;
+        std::string text;
+        graphics::Color color = graphics::Color(255, 255, 255, 255);
+
+        std::vector<uint32_t> characters;
+        std::vector<uint32_t> newCharacters;
+
+        // index of the first quad and the pen position of every character, the last element is the end of the line
+        std::vector<uint32_t> characterQuads = { 0 };
+        std::vector<float> characterPositions = { 0.0f };
+
+        std::vector<graphics::VertexPCT> vertices;
+        float width = 0.0f;
+
+        uint32_t firstChangedQuad = NO_CHANGES;
+    };
+}
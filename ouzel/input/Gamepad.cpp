@@ -47,8 +47,7 @@ namespace ouzel
 
         void Gamepad::handleButtonValueChange(GamepadButton button, bool pressed, float value)
         {
-            Event event;
-            event.type = Event::Type::GAMEPAD_BUTTON_CHANGE;
+            Event event(Event::Type::GAMEPAD_BUTTON_CHANGE);
 
             event.gamepadEvent.gamepad = shared_from_this();
             event.gamepadEvent.button = button;
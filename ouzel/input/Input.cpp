@@ -40,31 +40,21 @@ namespace ouzel
 
         void Input::keyDown(KeyboardKey key, uint32_t modifiers)
         {
-            Event event;
+            Event event(keyboardKeyStates[static_cast<uint32_t>(key)] ? Event::Type::KEY_REPEAT : Event::Type::KEY_DOWN);
 
             event.keyboardEvent.key = key;
             event.keyboardEvent.modifiers = modifiers;
 
-            if (!keyboardKeyStates[static_cast<uint32_t>(key)])
-            {
-                keyboardKeyStates[static_cast<uint32_t>(key)] = true;
+            keyboardKeyStates[static_cast<uint32_t>(key)] = true;
 
-                event.type = Event::Type::KEY_DOWN;
-                sharedEngine->getEventDispatcher()->postEvent(event);
-            }
-            else
-            {
-                event.type = Event::Type::KEY_REPEAT;
-                sharedEngine->getEventDispatcher()->postEvent(event);
-            }
+            sharedEngine->getEventDispatcher()->postEvent(event);
         }
 
         void Input::keyUp(KeyboardKey key, uint32_t modifiers)
         {
             keyboardKeyStates[static_cast<uint32_t>(key)] = false;
 
-            Event event;
-            event.type = Event::Type::KEY_UP;
+            Event event(Event::Type::KEY_UP);
 
             event.keyboardEvent.key = key;
             event.keyboardEvent.modifiers = modifiers;
@@ -76,8 +66,7 @@ namespace ouzel
         {
             mouseButtonStates[static_cast<uint32_t>(button)] = true;
 
-            Event event;
-            event.type = Event::Type::MOUSE_DOWN;
+            Event event(Event::Type::MOUSE_DOWN);
 
             event.mouseEvent.button = button;
             event.mouseEvent.position = position;
@@ -90,8 +79,7 @@ namespace ouzel
         {
             mouseButtonStates[static_cast<uint32_t>(button)] = false;
 
-            Event event;
-            event.type = Event::Type::MOUSE_UP;
+            Event event(Event::Type::MOUSE_UP);
 
             event.mouseEvent.button = button;
             event.mouseEvent.position = position;
@@ -104,8 +92,7 @@ namespace ouzel
         {
             cursorPosition = position;
 
-            Event event;
-            event.type = Event::Type::MOUSE_MOVE;
+            Event event(Event::Type::MOUSE_MOVE);
 
             event.mouseEvent.position = position;
             event.mouseEvent.modifiers = modifiers;
@@ -125,8 +112,7 @@ namespace ouzel
 
         void Input::mouseScroll(const Vector2& scroll, const Vector2& position, uint32_t modifiers)
         {
-            Event event;
-            event.type = Event::Type::MOUSE_SCROLL;
+            Event event(Event::Type::MOUSE_SCROLL);
 
             event.mouseEvent.position = position;
             event.mouseEvent.scroll = scroll;
@@ -137,8 +123,7 @@ namespace ouzel
 
         void Input::touchBegin(uint64_t touchId, const Vector2& position)
         {
-            Event event;
-            event.type = Event::Type::TOUCH_BEGIN;
+            Event event(Event::Type::TOUCH_BEGIN);
 
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
@@ -148,8 +133,7 @@ namespace ouzel
 
         void Input::touchEnd(uint64_t touchId, const Vector2& position)
         {
-            Event event;
-            event.type = Event::Type::TOUCH_END;
+            Event event(Event::Type::TOUCH_END);
 
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
@@ -159,8 +143,7 @@ namespace ouzel
 
         void Input::touchMove(uint64_t touchId, const Vector2& position)
         {
-            Event event;
-            event.type = Event::Type::TOUCH_MOVE;
+            Event event(Event::Type::TOUCH_MOVE);
 
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
@@ -170,8 +153,7 @@ namespace ouzel
 
         void Input::touchCancel(uint64_t touchId, const Vector2& position)
         {
-            Event event;
-            event.type = Event::Type::TOUCH_CANCEL;
+            Event event(Event::Type::TOUCH_CANCEL);
 
             event.touchEvent.touchId = touchId;
             event.touchEvent.position = position;
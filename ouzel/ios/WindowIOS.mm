@@ -42,8 +42,7 @@
     UIDevice* device = note.object;
     UIDeviceOrientation orientation = device.orientation;
 
-    ouzel::Event event;
-    event.type = ouzel::Event::Type::ORIENTATION_CHANGE;
+    ouzel::Event event(ouzel::Event::Type::ORIENTATION_CHANGE);
 
     switch (orientation)
     {
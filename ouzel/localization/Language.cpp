@@ -35,21 +35,21 @@ namespace ouzel
         const unsigned long MAGIC_BIG = 0xde120495;
         const unsigned long MAGIC_LITTLE = 0x950412de;
 
-        std::vector<uint8_t> data;
+        FileView data;
 
-        if (!sharedApplication->getFileSystem()->loadFile(filename, data))
+        if (!sharedApplication->getFileSystem()->mapFile(filename, data))
         {
             return false;
         }
 
         uint32_t offset = 0;
 
-        if (data.size() < 5 * sizeof(uint32_t))
+        if (data.getSize() < 5 * sizeof(uint32_t))
         {
             return false;
         }
 
-        uint32_t magic = *reinterpret_cast<uint32_t*>(data.data() + offset);
+        uint32_t magic = *reinterpret_cast<const uint32_t*>(data.getData() + offset);
         offset += sizeof(magic);
 
         uint32_t (*readUInt32)(const uint8_t*) = nullptr;
@@ -68,7 +68,7 @@ namespace ouzel
             return false;
         }
 
-        uint32_t revision = readUInt32(data.data() + offset);
+        uint32_t revision = readUInt32(data.getData() + offset);
         offset += sizeof(revision);
 
         if (revision != 0)
@@ -77,59 +77,59 @@ namespace ouzel
             return false;
         }
 
-        uint32_t stringCount = readUInt32(data.data() + offset);
+        uint32_t stringCount = readUInt32(data.getData() + offset);
         offset += sizeof(stringCount);
 
         std::vector<TranslationInfo> translations(stringCount);
 
-        uint32_t stringsOffset = readUInt32(data.data() + offset);
+        uint32_t stringsOffset = readUInt32(data.getData() + offset);
         offset += sizeof(stringsOffset);
 
-        uint32_t translationsOffset = readUInt32(data.data() + offset);
+        uint32_t translationsOffset = readUInt32(data.getData() + offset);
         offset += sizeof(translationsOffset);
 
         offset = stringsOffset;
 
-        if (data.size() < offset + 2 * sizeof(uint32_t) * stringCount)
+        if (data.getSize() < offset + 2 * sizeof(uint32_t) * stringCount)
         {
             return false;
         }
 
         for (uint32_t i = 0; i < stringCount; ++i)
         {
-            translations[i].stringLength = readUInt32(data.data() + offset);
+            translations[i].stringLength = readUInt32(data.getData() + offset);
             offset += sizeof(translations[i].stringLength);
 
-            translations[i].stringOffset = readUInt32(data.data() + offset);
+            translations[i].stringOffset = readUInt32(data.getData() + offset);
             offset += sizeof(translations[i].stringOffset);
         }
 
         offset = translationsOffset;
 
-        if (data.size() < offset + 2 * sizeof(uint32_t) * stringCount)
+        if (data.getSize() < offset + 2 * sizeof(uint32_t) * stringCount)
         {
             return false;
         }
 
         for (uint32_t i = 0; i < stringCount; ++i)
         {
-            translations[i].translationLength = readUInt32(data.data() + offset);
+            translations[i].translationLength = readUInt32(data.getData() + offset);
             offset += sizeof(translations[i].translationLength);
 
-            translations[i].translationOffset = readUInt32(data.data() + offset);
+            translations[i].translationOffset = readUInt32(data.getData() + offset);
             offset += sizeof(translations[i].translationOffset);
         }
 
         for (uint32_t i = 0; i < stringCount; ++i)
         {
-            if (data.size() < translations[i].stringOffset + translations[i].stringLength ||
-                data.size() < translations[i].translationOffset + translations[i].translationLength)
+            if (data.getSize() < translations[i].stringOffset + translations[i].stringLength ||
+                data.getSize() < translations[i].translationOffset + translations[i].translationLength)
             {
                 return false;
             }
 
-            std::string str(reinterpret_cast<char*>(data.data() + translations[i].stringOffset), translations[i].stringLength);
-            std::string translation(reinterpret_cast<char*>(data.data() + translations[i].translationOffset), translations[i].translationLength);
+            std::string str(reinterpret_cast<const char*>(data.getData() + translations[i].stringOffset), translations[i].stringLength);
+            std::string translation(reinterpret_cast<const char*>(data.getData() + translations[i].translationOffset), translations[i].translationLength);
 
             strings[str] = translation;
         }
@@ -44,8 +44,7 @@
 {
     if (ouzel::sharedEngine)
     {
-        ouzel::Event event;
-        event.type = ouzel::Event::Type::OPEN_FILE;
+        ouzel::Event event(ouzel::Event::Type::OPEN_FILE);
 
         event.systemEvent.filename = [filename cStringUsingEncoding:NSUTF8StringEncoding];
 
@@ -193,6 +193,29 @@ namespace ouzel
                 log(LOG_LEVEL_INFO, "Using %s for rendering", [device.name cStringUsingEncoding:NSUTF8StringEncoding]);
             }
 
+#if OUZEL_PLATFORM_MACOS
+            maxTextureSize = 16384;
+#elif OUZEL_PLATFORM_IOS
+            maxTextureSize = [device supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily3_v1] ? 16384 : 8192;
+#else
+            maxTextureSize = 8192;
+#endif
+
+#if OUZEL_PLATFORM_MACOS
+            // macOS GPUs have BC, but no 16-bit formats
+            supportedPixelFormats = { PixelFormat::RGBA8, PixelFormat::A8, PixelFormat::BC1, PixelFormat::BC2, PixelFormat::BC3 };
+#else
+            supportedPixelFormats = { PixelFormat::RGBA8, PixelFormat::RGB565, PixelFormat::RGBA4444, PixelFormat::A8,
+                PixelFormat::ETC2_RGB8, PixelFormat::ETC2_RGBA8 };
+
+#if OUZEL_PLATFORM_IOS
+            if ([device supportsFeatureSet:MTLFeatureSet_iOS_GPUFamily2_v1])
+#endif
+            {
+                supportedPixelFormats.insert(PixelFormat::ASTC_4X4);
+            }
+#endif
+
 #if OUZEL_PLATFORM_MACOS
             view = (MTKViewPtr)std::static_pointer_cast<WindowMacOS>(window)->getNativeView();
 #elif OUZEL_PLATFORM_TVOS
@@ -320,6 +343,16 @@ namespace ouzel
 
             sharedEngine->getCache()->setBlendState(BLEND_ALPHA, alphaBlendState);
 
+            BlendStatePtr premultipliedAlphaBlendState = createBlendState();
+
+            premultipliedAlphaBlendState->init(true,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::INV_SRC_ALPHA,
+                                               BlendState::BlendOperation::ADD,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::ONE,
+                                               BlendState::BlendOperation::ADD);
+
+            sharedEngine->getCache()->setBlendState(BLEND_PREMULTIPLIED_ALPHA, premultipliedAlphaBlendState);
+
             TexturePtr whitePixelTexture = createTexture();
             whitePixelTexture->initFromBuffer( { 255, 255, 255, 255 }, Size2(1.0f, 1.0f), false, false);
             sharedEngine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
@@ -656,6 +689,15 @@ namespace ouzel
                     continue;
                 }
 
+                // indices can come from a shared index buffer
+                std::shared_ptr<MeshBufferMetal> indexBufferMetal = meshBufferMetal->uploadData.indexBufferSource ?
+                    std::static_pointer_cast<MeshBufferMetal>(meshBufferMetal->uploadData.indexBufferSource) : meshBufferMetal;
+
+                if (!indexBufferMetal->getIndexBuffer())
+                {
+                    continue;
+                }
+
                 [currentRenderCommandEncoder setVertexBuffer:meshBufferMetal->getVertexBuffer() offset:0 atIndex:0];
 
                 // draw
@@ -673,9 +715,9 @@ namespace ouzel
 
                 [currentRenderCommandEncoder drawIndexedPrimitives:primitiveType
                                                         indexCount:drawCommand.indexCount
-                                                         indexType:meshBufferMetal->getIndexFormat()
-                                                       indexBuffer:meshBufferMetal->getIndexBuffer()
-                                                 indexBufferOffset:drawCommand.startIndex * meshBufferMetal->getBytesPerIndex()];
+                                                         indexType:indexBufferMetal->getIndexFormat()
+                                                       indexBuffer:indexBufferMetal->getIndexBuffer()
+                                                 indexBufferOffset:drawCommand.startIndex * indexBufferMetal->getBytesPerIndex()];
             }
 
             if (currentRenderCommandEncoder)
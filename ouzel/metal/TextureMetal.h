@@ -43,6 +43,7 @@ namespace ouzel
 
             NSUInteger width = 0;
             NSUInteger height = 0;
+            NSUInteger metalPixelFormat = 0; // MTLPixelFormatInvalid
         };
     } // namespace graphics
 } // namespace ouzel
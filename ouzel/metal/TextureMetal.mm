@@ -6,11 +6,33 @@
 #include "RendererMetal.h"
 #include "graphics/Image.h"
 #include "math/MathUtils.h"
+#include "utils/Utils.h"
 
 namespace ouzel
 {
     namespace graphics
     {
+        static MTLPixelFormat getTextureFormat(PixelFormat pixelFormat)
+        {
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8: return MTLPixelFormatRGBA8Unorm;
+                case PixelFormat::A8: return MTLPixelFormatA8Unorm;
+#if OUZEL_PLATFORM_MACOS
+                case PixelFormat::BC1: return MTLPixelFormatBC1_RGBA;
+                case PixelFormat::BC2: return MTLPixelFormatBC2_RGBA;
+                case PixelFormat::BC3: return MTLPixelFormatBC3_RGBA;
+#else
+                case PixelFormat::RGB565: return MTLPixelFormatB5G6R5Unorm;
+                case PixelFormat::RGBA4444: return MTLPixelFormatABGR4Unorm;
+                case PixelFormat::ETC2_RGB8: return MTLPixelFormatETC2_RGB8;
+                case PixelFormat::ETC2_RGBA8: return MTLPixelFormatEAC_RGBA8;
+                case PixelFormat::ASTC_4X4: return MTLPixelFormatASTC_4x4_LDR;
+#endif
+                default: return MTLPixelFormatInvalid;
+            }
+        }
+
         TextureMetal::TextureMetal()
         {
         }
@@ -43,18 +65,28 @@ namespace ouzel
                 if (uploadData.size.width > 0 &&
                     uploadData.size.height > 0)
                 {
+                    MTLPixelFormat newPixelFormat = uploadData.renderTarget ? rendererMetal->getMetalView().colorPixelFormat : getTextureFormat(uploadData.pixelFormat);
+
+                    if (newPixelFormat == MTLPixelFormatInvalid)
+                    {
+                        log(LOG_LEVEL_ERROR, "Invalid texture pixel format");
+                        return false;
+                    }
+
                     if (!texture ||
                         static_cast<NSUInteger>(uploadData.size.width) != width ||
-                        static_cast<NSUInteger>(uploadData.size.height) != height)
+                        static_cast<NSUInteger>(uploadData.size.height) != height ||
+                        newPixelFormat != metalPixelFormat)
                     {
                         if (texture) [texture release];
 
                         width = static_cast<NSUInteger>(uploadData.size.width);
                         height = static_cast<NSUInteger>(uploadData.size.height);
+                        metalPixelFormat = newPixelFormat;
 
                         if (width > 0 && height > 0)
                         {
-                            MTLTextureDescriptor* textureDescriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:uploadData.renderTarget ? rendererMetal->getMetalView().colorPixelFormat : MTLPixelFormatRGBA8Unorm
+                            MTLTextureDescriptor* textureDescriptor = [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:newPixelFormat
                                                                                                                          width:width
                                                                                                                         height:height
                                                                                                                      mipmapped:uploadData.mipmaps ? YES : NO];
@@ -72,13 +104,27 @@ namespace ouzel
 
                     for (size_t level = 0; level < uploadData.levels.size(); ++level)
                     {
-                        NSUInteger bytesPerRow = static_cast<NSUInteger>(uploadData.levels[level].size.width) * 4;
+                        // the bytes per row of the block-compressed formats is the size of a row of blocks
+                        NSUInteger bytesPerRow = static_cast<NSUInteger>(getPixelFormatRowSize(uploadData.pixelFormat,
+                                                                                               static_cast<uint32_t>(uploadData.levels[level].size.width)));
                         [texture replaceRegion:MTLRegionMake2D(0, 0,
                                                                static_cast<NSUInteger>(uploadData.levels[level].size.width),
                                                                static_cast<NSUInteger>(uploadData.levels[level].size.height))
                                    mipmapLevel:level withBytes:uploadData.levels[level].data.data()
                                    bytesPerRow:bytesPerRow];
                     }
+
+                    for (const Region& region : uploadData.regions)
+                    {
+                        NSUInteger bytesPerRow = static_cast<NSUInteger>(getPixelFormatRowSize(uploadData.pixelFormat,
+                                                                                               static_cast<uint32_t>(region.rectangle.width)));
+                        [texture replaceRegion:MTLRegionMake2D(static_cast<NSUInteger>(region.rectangle.x),
+                                                               static_cast<NSUInteger>(region.rectangle.y),
+                                                               static_cast<NSUInteger>(region.rectangle.width),
+                                                               static_cast<NSUInteger>(region.rectangle.height))
+                                   mipmapLevel:0 withBytes:region.data.data()
+                                   bytesPerRow:bytesPerRow];
+                    }
                 }
 
                 ready = (texture != Nil);
@@ -1,11 +1,12 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <chrono>
 #include "core/CompileConfig.h"
 
 #include "AudioAL.h"
 #include "SoundDataAL.h"
-#include "SoundAL.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -69,12 +70,27 @@ namespace ouzel
         }
 
         AudioAL::AudioAL():
-            Audio(Driver::OPENAL)
+            Audio(Driver::OPENAL), running(false)
         {
+            std::fill(std::begin(buffers), std::end(buffers), 0);
         }
 
         AudioAL::~AudioAL()
         {
+            running = false;
+            if (audioThread.joinable()) audioThread.join();
+
+            if (sourceId)
+            {
+                alSourceStop(sourceId);
+                alDeleteSources(1, &sourceId);
+            }
+
+            if (buffers[0])
+            {
+                alDeleteBuffers(BUFFER_COUNT, buffers);
+            }
+
             if (context)
             {
                 alcDestroyContext(context);
@@ -90,6 +106,32 @@ namespace ouzel
         {
             Audio::free();
 
+            running = false;
+            if (audioThread.joinable()) audioThread.join();
+
+            if (sourceId)
+            {
+                alSourceStop(sourceId);
+                alDeleteSources(1, &sourceId);
+                sourceId = 0;
+
+                if (checkOpenALError())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to delete OpenAL source");
+                }
+            }
+
+            if (buffers[0])
+            {
+                alDeleteBuffers(BUFFER_COUNT, buffers);
+                std::fill(std::begin(buffers), std::end(buffers), 0);
+
+                if (checkOpenALError())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to delete OpenAL buffers");
+                }
+            }
+
             if (context)
             {
                 alcDestroyContext(context);
@@ -153,6 +195,42 @@ namespace ouzel
                 return false;
             }
 
+            alGenSources(1, &sourceId);
+
+            if (checkOpenALError())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to create OpenAL source");
+                return false;
+            }
+
+            alGenBuffers(BUFFER_COUNT, buffers);
+
+            if (checkOpenALError())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to create OpenAL buffers");
+                return false;
+            }
+
+            for (ALuint buffer : buffers)
+            {
+                if (!fillBuffer(buffer))
+                {
+                    return false;
+                }
+            }
+
+            alSourceQueueBuffers(sourceId, BUFFER_COUNT, buffers);
+            alSourcePlay(sourceId);
+
+            if (checkOpenALError())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to play OpenAL source");
+                return false;
+            }
+
+            running = true;
+            audioThread = std::thread(&AudioAL::run, this);
+
             ready = true;
 
             return true;
@@ -164,10 +242,59 @@ namespace ouzel
             return soundData;
         }
 
-        SoundPtr AudioAL::createSound()
+        void AudioAL::run()
         {
-            SoundPtr sound(new SoundAL());
-            return sound;
+            while (running)
+            {
+                ALint processed = 0;
+                alGetSourcei(sourceId, AL_BUFFERS_PROCESSED, &processed);
+
+                for (ALint i = 0; i < processed; ++i)
+                {
+                    ALuint buffer;
+                    alSourceUnqueueBuffers(sourceId, 1, &buffer);
+
+                    if (fillBuffer(buffer))
+                    {
+                        alSourceQueueBuffers(sourceId, 1, &buffer);
+                    }
+                }
+
+                ALint state;
+                alGetSourcei(sourceId, AL_SOURCE_STATE, &state);
+
+                // the source stops if all the buffers were played before they were refilled
+                if (state != AL_PLAYING)
+                {
+                    alSourcePlay(sourceId);
+                }
+
+                if (checkOpenALError())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to stream OpenAL data");
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+
+        bool AudioAL::fillBuffer(ALuint buffer)
+        {
+            samples.resize(BUFFER_FRAMES * Mixer::CHANNELS);
+            mixer.mix(samples.data(), BUFFER_FRAMES);
+
+            alBufferData(buffer, AL_FORMAT_STEREO16,
+                         samples.data(),
+                         static_cast<ALsizei>(samples.size() * sizeof(int16_t)),
+                         static_cast<ALsizei>(mixer.getSampleRate()));
+
+            if (checkOpenALError())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to upload OpenAL data");
+                return false;
+            }
+
+            return true;
         }
     } // namespace audio
 } // namespace ouzel
@@ -13,6 +13,9 @@
 #include <AL/alc.h>
 #endif
 
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "audio/Audio.h"
 
 namespace ouzel
@@ -32,7 +35,6 @@ namespace ouzel
             virtual bool init() override;
 
             virtual SoundDataPtr createSoundData() override;
-            virtual SoundPtr createSound() override;
 
             ALCdevice* getDevice() const { return device; }
             ALCcontext* getContext() const { return context; }
@@ -40,8 +42,22 @@ namespace ouzel
         protected:
             AudioAL();
 
+            void run();
+            bool fillBuffer(ALuint buffer);
+
             ALCdevice* device = nullptr;
             ALCcontext* context = nullptr;
+
+            // the output of the mixer is streamed through one source, the processed buffers are refilled by the audio thread
+            static const uint32_t BUFFER_COUNT = 3;
+            static const uint32_t BUFFER_FRAMES = 1024;
+
+            ALuint sourceId = 0;
+            ALuint buffers[BUFFER_COUNT];
+            std::vector<int16_t> samples;
+
+            std::atomic<bool> running;
+            std::thread audioThread;
         };
     } // namespace audio
 } // namespace ouzel
@@ -15,9 +15,9 @@ namespace ouzel
         {
         }
 
-        bool SoundDataAL::initFromBuffer(const std::vector<uint8_t>& newData)
+        bool SoundDataAL::initFromBuffer(const uint8_t* newData, size_t newSize)
         {
-            if (!SoundData::initFromBuffer(newData))
+            if (!SoundData::initFromBuffer(newData, newSize))
             {
                 return false;
             }
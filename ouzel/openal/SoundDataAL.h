@@ -17,7 +17,7 @@ namespace ouzel
         public:
             virtual ~SoundDataAL();
 
-            virtual bool initFromBuffer(const std::vector<uint8_t>& newData);
+            virtual bool initFromBuffer(const uint8_t* newData, size_t newSize);
 
         protected:
             SoundDataAL();
@@ -105,31 +105,94 @@ namespace ouzel
                 log(LOG_LEVEL_INFO, "Using %s for rendering", reinterpret_cast<const char*>(deviceName));
             }
 
-#if OUZEL_SUPPORTS_OPENGLES
-            npotTexturesSupported = (apiVersion >= 3);
+            std::vector<std::string> extensions;
 
-            const GLubyte* extensionPtr = glGetString(GL_EXTENSIONS);
-
-            if (checkOpenGLError() || !extensionPtr)
+#if OUZEL_SUPPORTS_OPENGL
+            if (apiVersion >= 3)
             {
-                log(LOG_LEVEL_WARNING, "Failed to get OpenGL extensions");
+                // the extension string is not available in core profiles
+                GLint extensionCount = 0;
+                glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+                for (GLint i = 0; i < extensionCount; ++i)
+                {
+                    const GLubyte* extensionPtr = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+
+                    if (extensionPtr)
+                    {
+                        extensions.push_back(reinterpret_cast<const char*>(extensionPtr));
+                    }
+                }
+
+                if (checkOpenGLError())
+                {
+                    log(LOG_LEVEL_WARNING, "Failed to get OpenGL extensions");
+                }
             }
             else
+#endif
             {
-                std::string extensions(reinterpret_cast<const char*>(extensionPtr));
+                const GLubyte* extensionPtr = glGetString(GL_EXTENSIONS);
 
-                std::istringstream extensionStringStream(extensions);
-
-                for (std::string extension; extensionStringStream >> extensions;)
+                if (checkOpenGLError() || !extensionPtr)
+                {
+                    log(LOG_LEVEL_WARNING, "Failed to get OpenGL extensions");
+                }
+                else
                 {
-                    if (extension == "GL_OES_texture_npot")
+                    std::istringstream extensionStringStream(reinterpret_cast<const char*>(extensionPtr));
+
+                    for (std::string extension; extensionStringStream >> extension;)
                     {
-                        npotTexturesSupported = true;
+                        extensions.push_back(extension);
                     }
                 }
             }
+
+#if OUZEL_SUPPORTS_OPENGLES
+            npotTexturesSupported = (apiVersion >= 3);
+
+            // ETC2 is a part of OpenGL ES 3
+            if (apiVersion >= 3)
+            {
+                supportedPixelFormats.insert(PixelFormat::ETC2_RGB8);
+                supportedPixelFormats.insert(PixelFormat::ETC2_RGBA8);
+            }
 #endif
 
+            for (const std::string& extension : extensions)
+            {
+#if OUZEL_SUPPORTS_OPENGLES
+                if (extension == "GL_OES_texture_npot")
+                {
+                    npotTexturesSupported = true;
+                }
+#endif
+                if (extension == "GL_EXT_texture_compression_s3tc")
+                {
+                    supportedPixelFormats.insert(PixelFormat::BC1);
+                    supportedPixelFormats.insert(PixelFormat::BC2);
+                    supportedPixelFormats.insert(PixelFormat::BC3);
+                }
+                else if (extension == "GL_ARB_ES3_compatibility")
+                {
+                    supportedPixelFormats.insert(PixelFormat::ETC2_RGB8);
+                    supportedPixelFormats.insert(PixelFormat::ETC2_RGBA8);
+                }
+                else if (extension == "GL_KHR_texture_compression_astc_ldr")
+                {
+                    supportedPixelFormats.insert(PixelFormat::ASTC_4X4);
+                }
+            }
+
+            GLint textureSize = 0;
+            glGetIntegerv(GL_MAX_TEXTURE_SIZE, &textureSize);
+
+            if (textureSize > 0)
+            {
+                maxTextureSize = static_cast<uint32_t>(textureSize);
+            }
+
             frameBufferWidth = static_cast<GLsizei>(size.width);
             frameBufferHeight = static_cast<GLsizei>(size.height);
             viewport = Rectangle(0.0f, 0.0f, size.width, size.height);
@@ -250,6 +313,16 @@ namespace ouzel
 
             sharedEngine->getCache()->setBlendState(BLEND_ALPHA, alphaBlendState);
 
+            BlendStatePtr premultipliedAlphaBlendState = createBlendState();
+
+            premultipliedAlphaBlendState->init(true,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::INV_SRC_ALPHA,
+                                               BlendState::BlendOperation::ADD,
+                                               BlendState::BlendFactor::ONE, BlendState::BlendFactor::ONE,
+                                               BlendState::BlendOperation::ADD);
+
+            sharedEngine->getCache()->setBlendState(BLEND_PREMULTIPLIED_ALPHA, premultipliedAlphaBlendState);
+
             TexturePtr whitePixelTexture = createTexture();
             whitePixelTexture->initFromBuffer( { 255, 255, 255, 255 }, Size2(1.0f, 1.0f), false, false);
             sharedEngine->getCache()->setTexture(TEXTURE_WHITE_PIXEL, whitePixelTexture);
@@ -631,6 +704,15 @@ namespace ouzel
                     continue;
                 }
 
+                // indices can come from a shared index buffer
+                std::shared_ptr<MeshBufferOGL> indexBufferOGL = meshBufferOGL->uploadData.indexBufferSource ?
+                    std::static_pointer_cast<MeshBufferOGL>(meshBufferOGL->uploadData.indexBufferSource) : meshBufferOGL;
+
+                if (!indexBufferOGL->isReady())
+                {
+                    continue;
+                }
+
                 // draw
                 GLenum mode;
 
@@ -649,10 +731,19 @@ namespace ouzel
                     return false;
                 }
 
+                if (indexBufferOGL != meshBufferOGL)
+                {
+                    // element array buffer binding is a part of the vertex array state
+                    if (!bindElementArrayBuffer(indexBufferOGL->getIndexBufferId()))
+                    {
+                        return false;
+                    }
+                }
+
                 glDrawElements(mode,
                                static_cast<GLsizei>(drawCommand.indexCount),
-                               meshBufferOGL->getIndexFormat(),
-                               static_cast<const char*>(nullptr) + (drawCommand.startIndex * meshBufferOGL->getBytesPerIndex()));
+                               indexBufferOGL->getIndexFormat(),
+                               static_cast<const char*>(nullptr) + (drawCommand.startIndex * indexBufferOGL->getBytesPerIndex()));
 
                 if (checkOpenGLError())
                 {
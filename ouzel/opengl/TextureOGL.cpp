@@ -8,10 +8,64 @@
 #include "graphics/Image.h"
 #include "utils/Utils.h"
 
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+
 namespace ouzel
 {
     namespace graphics
     {
+        static bool getTextureFormat(PixelFormat pixelFormat, GLint& internalFormat, GLenum& format, GLenum& type)
+        {
+            format = GL_RGBA;
+            type = GL_UNSIGNED_BYTE;
+
+            switch (pixelFormat)
+            {
+                case PixelFormat::RGBA8: internalFormat = GL_RGBA; break;
+                case PixelFormat::RGB565: internalFormat = GL_RGB; format = GL_RGB; type = GL_UNSIGNED_SHORT_5_6_5; break;
+                case PixelFormat::RGBA4444: internalFormat = GL_RGBA; type = GL_UNSIGNED_SHORT_4_4_4_4; break;
+                case PixelFormat::A8:
+#if OUZEL_SUPPORTS_OPENGL
+                    // core profiles do not have alpha textures, the red channel is swizzled to alpha instead
+                    if (sharedEngine->getRenderer()->getAPIVersion() >= 3)
+                    {
+                        internalFormat = GL_R8;
+                        format = GL_RED;
+                        break;
+                    }
+#endif
+                    internalFormat = GL_ALPHA;
+                    format = GL_ALPHA;
+                    break;
+                case PixelFormat::BC1: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+                case PixelFormat::BC2: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+                case PixelFormat::BC3: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+                case PixelFormat::ETC2_RGB8: internalFormat = GL_COMPRESSED_RGB8_ETC2; break;
+                case PixelFormat::ETC2_RGBA8: internalFormat = GL_COMPRESSED_RGBA8_ETC2_EAC; break;
+                case PixelFormat::ASTC_4X4: internalFormat = GL_COMPRESSED_RGBA_ASTC_4x4_KHR; break;
+                default: return false;
+            }
+
+            return true;
+        }
+
         TextureOGL::TextureOGL()
         {
         }
@@ -89,12 +143,46 @@ namespace ouzel
                         return false;
                     }
 
+                    GLint internalFormat;
+                    GLenum format;
+                    GLenum type;
+
+                    if (!getTextureFormat(uploadData.pixelFormat, internalFormat, format, type))
+                    {
+                        log(LOG_LEVEL_ERROR, "Invalid texture pixel format");
+                        return false;
+                    }
+
+#if OUZEL_SUPPORTS_OPENGL
+                    if (format == GL_RED)
+                    {
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO);
+                        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED);
+                    }
+#endif
+
+                    // the rows of the 8 and 16-bit formats are not padded
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
                     for (size_t level = 0; level < uploadData.levels.size(); ++level)
                     {
-                        glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA,
-                                     static_cast<GLsizei>(uploadData.levels[level].size.width),
-                                     static_cast<GLsizei>(uploadData.levels[level].size.height), 0,
-                                     GL_RGBA, GL_UNSIGNED_BYTE, uploadData.levels[level].data.data());
+                        if (isCompressedPixelFormat(uploadData.pixelFormat))
+                        {
+                            glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), static_cast<GLenum>(internalFormat),
+                                                   static_cast<GLsizei>(uploadData.levels[level].size.width),
+                                                   static_cast<GLsizei>(uploadData.levels[level].size.height), 0,
+                                                   static_cast<GLsizei>(uploadData.levels[level].data.size()),
+                                                   uploadData.levels[level].data.data());
+                        }
+                        else
+                        {
+                            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat,
+                                         static_cast<GLsizei>(uploadData.levels[level].size.width),
+                                         static_cast<GLsizei>(uploadData.levels[level].size.height), 0,
+                                         format, type, uploadData.levels[level].data.data());
+                        }
 
                         if (RendererOGL::checkOpenGLError())
                         {
@@ -102,7 +190,37 @@ namespace ouzel
                             return false;
                         }
                     }
+                }
+
+                if (!uploadData.regions.empty())
+                {
+                    RendererOGL::bindTexture(textureId, 0);
+
+                    GLint internalFormat;
+                    GLenum format;
+                    GLenum type;
+
+                    if (!getTextureFormat(uploadData.pixelFormat, internalFormat, format, type))
+                    {
+                        log(LOG_LEVEL_ERROR, "Invalid texture pixel format");
+                        return false;
+                    }
+
+                    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+                    for (const Region& region : uploadData.regions)
+                    {
+                        glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                        static_cast<GLint>(region.rectangle.x), static_cast<GLint>(region.rectangle.y),
+                                        static_cast<GLsizei>(region.rectangle.width), static_cast<GLsizei>(region.rectangle.height),
+                                        format, type, region.data.data());
 
+                        if (RendererOGL::checkOpenGLError())
+                        {
+                            log(LOG_LEVEL_ERROR, "Failed to upload texture region");
+                            return false;
+                        }
+                    }
                 }
 
                 ready = true;
@@ -3,7 +3,6 @@
 
 #include "AudioSL.h"
 #include "SoundDataSL.h"
-#include "SoundSL.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -17,6 +16,11 @@ namespace ouzel
 
         AudioSL::~AudioSL()
         {
+            if (playerObject)
+            {
+                (*playerObject)->Destroy(playerObject);
+            }
+
             if (outputMixObject)
             {
                 (*outputMixObject)->Destroy(outputMixObject);
@@ -32,6 +36,14 @@ namespace ouzel
         {
             Audio::free();
 
+            if (playerObject)
+            {
+                (*playerObject)->Destroy(playerObject);
+                playerObject = nullptr;
+                player = nullptr;
+                bufferQueue = nullptr;
+            }
+
             if (outputMixObject)
             {
                 (*outputMixObject)->Destroy(outputMixObject);
@@ -89,6 +101,75 @@ namespace ouzel
                 return false;
             }
 
+            SLDataLocator_AndroidSimpleBufferQueue location = { SL_DATALOCATOR_ANDROIDSIMPLEBUFFERQUEUE, BUFFER_COUNT };
+
+            SLDataFormat_PCM format;
+            format.formatType = SL_DATAFORMAT_PCM;
+            format.numChannels = Mixer::CHANNELS;
+            format.samplesPerSec = mixer.getSampleRate() * 1000; //mHz
+            format.bitsPerSample = SL_PCMSAMPLEFORMAT_FIXED_16;
+            format.containerSize = SL_PCMSAMPLEFORMAT_FIXED_16;
+            format.channelMask = SL_SPEAKER_FRONT_LEFT | SL_SPEAKER_FRONT_RIGHT;
+            format.endianness = SL_BYTEORDER_LITTLEENDIAN;
+
+            SLDataSource dataSource = { &location, &format };
+
+            SLDataLocator_OutputMix dataLocatorOut;
+            dataLocatorOut.locatorType = SL_DATALOCATOR_OUTPUTMIX;
+            dataLocatorOut.outputMix = outputMixObject;
+
+            SLDataSink dataSink;
+            dataSink.pLocator = &dataLocatorOut;
+            dataSink.pFormat = NULL;
+
+            const SLuint32 playerIIDCount = 2;
+            const SLInterfaceID playerIIDs[] = { SL_IID_BUFFERQUEUE, SL_IID_PLAY };
+            const SLboolean playerReqs[] = { SL_BOOLEAN_TRUE, SL_BOOLEAN_TRUE };
+
+            if ((*engine)->CreateAudioPlayer(engine, &playerObject, &dataSource, &dataSink, playerIIDCount, playerIIDs, playerReqs) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to create OpenSL player object");
+                return false;
+            }
+
+            if ((*playerObject)->Realize(playerObject, SL_BOOLEAN_FALSE) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to create OpenSL player object");
+                return false;
+            }
+
+            if ((*playerObject)->GetInterface(playerObject, SL_IID_PLAY, &player) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to get OpenSL player");
+                return false;
+            }
+
+            if ((*playerObject)->GetInterface(playerObject, SL_IID_BUFFERQUEUE, &bufferQueue) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to get OpenSL buffer queue");
+                return false;
+            }
+
+            if ((*bufferQueue)->RegisterCallback(bufferQueue, playerCallback, this) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to register OpenSL buffer queue callback");
+                return false;
+            }
+
+            for (uint32_t i = 0; i < BUFFER_COUNT; ++i)
+            {
+                if (!enqueueBuffer())
+                {
+                    return false;
+                }
+            }
+
+            if ((*player)->SetPlayState(player, SL_PLAYSTATE_PLAYING) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to play sound");
+                return false;
+            }
+
             ready = true;
 
             return true;
@@ -100,10 +181,28 @@ namespace ouzel
             return soundData;
         }
 
-        SoundPtr AudioSL::createSound()
+        void AudioSL::playerCallback(SLAndroidSimpleBufferQueueItf, void* context)
+        {
+            AudioSL* audioSL = reinterpret_cast<AudioSL*>(context);
+
+            audioSL->enqueueBuffer();
+        }
+
+        bool AudioSL::enqueueBuffer()
         {
-            SoundPtr sound(new SoundSL());
-            return sound;
+            std::vector<int16_t>& buffer = buffers[currentBuffer];
+            currentBuffer = (currentBuffer + 1) % BUFFER_COUNT;
+
+            buffer.resize(BUFFER_FRAMES * Mixer::CHANNELS);
+            mixer.mix(buffer.data(), BUFFER_FRAMES);
+
+            if ((*bufferQueue)->Enqueue(bufferQueue, buffer.data(), buffer.size() * sizeof(int16_t)) != SL_RESULT_SUCCESS)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to enqueue OpenSL data");
+                return false;
+            }
+
+            return true;
         }
     } // namespace audio
 } // namespace ouzel
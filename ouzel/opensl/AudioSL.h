@@ -7,6 +7,7 @@
 #include <SLES/OpenSLES_Android.h>
 #include <SLES/OpenSLES_AndroidConfiguration.h>
 
+#include <vector>
 #include "audio/Audio.h"
 
 namespace ouzel
@@ -23,7 +24,6 @@ namespace ouzel
             virtual bool init() override;
 
             virtual SoundDataPtr createSoundData() override;
-            virtual SoundPtr createSound() override;
 
             SLEngineItf getEngine() const { return engine; }
             SLObjectItf getOutputMix() const { return outputMixObject; }
@@ -31,9 +31,22 @@ namespace ouzel
         protected:
             AudioSL();
 
+            static void playerCallback(SLAndroidSimpleBufferQueueItf bufferQueue, void* context);
+            bool enqueueBuffer();
+
             SLObjectItf engineObject = nullptr;
             SLEngineItf engine = nullptr;
             SLObjectItf outputMixObject = nullptr;
+
+            // the output of the mixer is streamed through one player, every buffer is refilled when it is played
+            static const uint32_t BUFFER_COUNT = 2;
+            static const uint32_t BUFFER_FRAMES = 1024;
+
+            SLObjectItf playerObject = nullptr;
+            SLPlayItf player = nullptr;
+            SLAndroidSimpleBufferQueueItf bufferQueue = nullptr;
+            std::vector<int16_t> buffers[BUFFER_COUNT];
+            uint32_t currentBuffer = 0;
         };
     } // namespace audio
 } // namespace ouzel
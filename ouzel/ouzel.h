@@ -14,8 +14,13 @@
 #include "animators/Sequence.h"
 #include "animators/Shake.h"
 #include "audio/Audio.h"
+#include "audio/Convert.h"
+#include "audio/Decoder.h"
+#include "audio/FileSink.h"
+#include "audio/Mixer.h"
 #include "audio/Sound.h"
 #include "audio/SoundData.h"
+#include "audio/WaveDecoder.h"
 #include "core/Application.h"
 #include "core/Cache.h"
 #include "core/CompileConfig.h"
@@ -25,11 +30,14 @@
 #include "core/Window.h"
 #include "events/EventDispatcher.h"
 #include "events/EventHandler.h"
+#include "files/Archive.h"
 #include "files/FileSystem.h"
+#include "files/FileView.h"
 #include "graphics/BlendState.h"
 #include "graphics/Color.h"
 #include "graphics/Image.h"
 #include "graphics/MeshBuffer.h"
+#include "graphics/PixelFormat.h"
 #include "graphics/Renderer.h"
 #include "graphics/RenderTarget.h"
 #include "graphics/Shader.h"
@@ -37,8 +45,12 @@
 #include "graphics/Vertex.h"
 #include "gui/Button.h"
 #include "gui/CheckBox.h"
+#include "gui/Font.h"
+#include "gui/GlyphAtlas.h"
 #include "gui/Label.h"
 #include "gui/Menu.h"
+#include "gui/ScrollArea.h"
+#include "gui/TTFont.h"
 #include "gui/Widget.h"
 #include "input/Gamepad.h"
 #include "input/Input.h"
@@ -55,10 +67,17 @@
 #include "scene/Component.h"
 #include "scene/Layer.h"
 #include "scene/Node.h"
+#include "scene/ObjectPool.h"
 #include "scene/ParticleSystem.h"
+#include "scene/ParticleWorld.h"
 #include "scene/Scene.h"
 #include "scene/SceneManager.h"
 #include "scene/ShapeDrawable.h"
 #include "scene/Sprite.h"
+#include "scene/SpriteAnimationSystem.h"
+#include "scene/SpriteClip.h"
+#include "scene/TextBatch.h"
+#include "scene/TileMap.h"
 #include "utils/Utils.h"
 #include "utils/Types.h"
+#include "utils/Compression.h"
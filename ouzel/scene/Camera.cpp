@@ -2,7 +2,14 @@
 // This file is part of the Ouzel engine.
 
 #include <cassert>
+#include <cmath>
 #include <algorithm>
+#include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#endif
 #include "Camera.h"
 #include "core/Engine.h"
 #include "graphics/Renderer.h"
@@ -102,11 +109,43 @@ namespace ouzel
             if (viewProjectionDirty || transformDirty)
             {
                 viewProjection = projection * getTransform();
+                viewProjectionDirty = false;
+                viewBoundsDirty = true;
             }
 
             return viewProjection;
         }
 
+        const AABB2& Camera::getViewBounds() const
+        {
+            const Matrix4& currentViewProjection = getViewProjection();
+
+            if (viewBoundsDirty)
+            {
+                Matrix4 inverseViewProjection = currentViewProjection;
+                inverseViewProjection.invert();
+
+                Vector3 corners[4] = {
+                    Vector3(-1.0f, -1.0f, 0.0f),
+                    Vector3(1.0f, -1.0f, 0.0f),
+                    Vector3(-1.0f, 1.0f, 0.0f),
+                    Vector3(1.0f, 1.0f, 0.0f)
+                };
+
+                viewBounds.reset();
+
+                for (Vector3& corner : corners)
+                {
+                    inverseViewProjection.transformPoint(corner);
+                    viewBounds.insertPoint(Vector2(corner.x, corner.y));
+                }
+
+                viewBoundsDirty = false;
+            }
+
+            return viewBounds;
+        }
+
         void Camera::calculateLocalTransform() const
         {
             Matrix4 translationMatrix = Matrix4::IDENTITY;
@@ -145,38 +184,94 @@ namespace ouzel
             return Vector2(result.x, result.y);
         }
 
-        bool Camera::checkVisibility(const Matrix4& transform, const AABB2& boundingBox)
+        bool Camera::checkVisibility(const Matrix4& transform, const AABB2& boundingBox) const
         {
-            Size2 size = sharedEngine->getRenderer()->getSize();
-            Rectangle visibleRect(0.0f, 0.0f, size.width, size.height);
+            // transform the center and the half size of the box to world space
+            Vector3 center((boundingBox.min.x + boundingBox.max.x) / 2.0f, (boundingBox.min.y + boundingBox.max.y) / 2.0f, 0.0f);
+            Vector2 halfSize = (boundingBox.max - boundingBox.min) / 2.0f;
 
-            // transform center point to screen space
-            Vector2 diff = boundingBox.max - boundingBox.min;
+            transform.transformPoint(center);
 
-            Vector3 v3p(boundingBox.min.x + diff.x / 2.0f, boundingBox.min.y + diff.y / 2.0f, 0.0f);
-            diff *= zoom;
-            diff.x *= contentScale.x;
-            diff.y *= contentScale.y;
+            Vector2 halfWorldSize(fabsf(halfSize.x * transform.m[0]) + fabsf(halfSize.y * transform.m[4]),
+                                  fabsf(halfSize.x * transform.m[1]) + fabsf(halfSize.y * transform.m[5]));
 
-            transform.transformPoint(v3p);
+            AABB2 worldBoundingBox(Vector2(center.x - halfWorldSize.x, center.y - halfWorldSize.y),
+                                   Vector2(center.x + halfWorldSize.x, center.y + halfWorldSize.y));
 
-            Vector2 v2p = projectPoint(v3p);
+            return checkVisibility(worldBoundingBox);
+        }
 
-            Size2 halfSize(diff.x / 2.0f, diff.y / 2.0f);
+        bool Camera::checkVisibility(const AABB2& worldBoundingBox) const
+        {
+            const AABB2& bounds = getViewBounds();
+
+            return worldBoundingBox.max.x >= bounds.min.x && worldBoundingBox.min.x <= bounds.max.x &&
+                   worldBoundingBox.max.y >= bounds.min.y && worldBoundingBox.min.y <= bounds.max.y;
+        }
 
-            // convert content size to world coordinates
-            Size2 halfWorldSize;
+        void Camera::checkVisibility(const float* minX, const float* minY,
+                                     const float* maxX, const float* maxY,
+                                     uint32_t count, uint32_t* visibilityMask) const
+        {
+            const AABB2& bounds = getViewBounds();
 
-            halfWorldSize.width = std::max(fabsf(halfSize.width * transform.m[0] + halfSize.height * transform.m[4]), fabsf(halfSize.width * transform.m[0] - halfSize.height * transform.m[4]));
-            halfWorldSize.height = std::max(fabsf(halfSize.width * transform.m[1] + halfSize.height * transform.m[5]), fabsf(halfSize.width * transform.m[1] - halfSize.height * transform.m[5]));
+            std::fill(visibilityMask, visibilityMask + (count + 31) / 32, 0);
 
-            // enlarge visible rect half size in screen coord
-            visibleRect.x -= halfWorldSize.width;
-            visibleRect.y -= halfWorldSize.height;
-            visibleRect.width += halfWorldSize.width * 2.0f;
-            visibleRect.height += halfWorldSize.height * 2.0f;
+            uint32_t i = 0;
 
-            return visibleRect.containsPoint(v2p);
+            // four boxes are tested at once, groups of four never cross a mask word boundary
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                static const uint32_t BITS[4] = { 1, 2, 4, 8 };
+
+                uint32x4_t bits = vld1q_u32(BITS);
+                float32x4_t boundsMinX = vdupq_n_f32(bounds.min.x);
+                float32x4_t boundsMinY = vdupq_n_f32(bounds.min.y);
+                float32x4_t boundsMaxX = vdupq_n_f32(bounds.max.x);
+                float32x4_t boundsMaxY = vdupq_n_f32(bounds.max.y);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    uint32x4_t visibleX = vandq_u32(vcgeq_f32(vld1q_f32(maxX + i), boundsMinX),
+                                                    vcleq_f32(vld1q_f32(minX + i), boundsMaxX));
+                    uint32x4_t visibleY = vandq_u32(vcgeq_f32(vld1q_f32(maxY + i), boundsMinY),
+                                                    vcleq_f32(vld1q_f32(minY + i), boundsMaxY));
+
+                    uint32x4_t visibleBits = vandq_u32(vandq_u32(visibleX, visibleY), bits);
+                    uint32x2_t sum = vadd_u32(vget_low_u32(visibleBits), vget_high_u32(visibleBits));
+                    sum = vpadd_u32(sum, sum);
+
+                    visibilityMask[i / 32] |= vget_lane_u32(sum, 0) << (i % 32);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 boundsMinX = _mm_set1_ps(bounds.min.x);
+            __m128 boundsMinY = _mm_set1_ps(bounds.min.y);
+            __m128 boundsMaxX = _mm_set1_ps(bounds.max.x);
+            __m128 boundsMaxY = _mm_set1_ps(bounds.max.y);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 visibleX = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(maxX + i), boundsMinX),
+                                             _mm_cmple_ps(_mm_loadu_ps(minX + i), boundsMaxX));
+                __m128 visibleY = _mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(maxY + i), boundsMinY),
+                                             _mm_cmple_ps(_mm_loadu_ps(minY + i), boundsMaxY));
+
+                visibilityMask[i / 32] |= static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(visibleX, visibleY))) << (i % 32);
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                if (maxX[i] >= bounds.min.x && minX[i] <= bounds.max.x &&
+                    maxY[i] >= bounds.min.y && minY[i] <= bounds.max.y)
+                {
+                    visibilityMask[i / 32] |= 1u << (i % 32);
+                }
+            }
         }
 
         Vector2 Camera::projectPoint(const Vector3& src) const
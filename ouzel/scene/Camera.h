@@ -33,10 +33,20 @@ namespace ouzel
 
             const Matrix4& getViewProjection() const;
 
+            // world space bounding box of the area that is visible through the camera
+            const AABB2& getViewBounds() const;
+
             Vector2 convertScreenToWorld(const Vector2& position);
             Vector2 convertWorldToScreen(const Vector2& position);
 
-            bool checkVisibility(const Matrix4& transform, const AABB2& boundingBox);
+            bool checkVisibility(const Matrix4& transform, const AABB2& boundingBox) const;
+            bool checkVisibility(const AABB2& worldBoundingBox) const;
+
+            // tests count world space bounding boxes (stored as separate arrays of their coordinates) against the view bounds,
+            // sets a bit in visibilityMask (which must have room for (count + 31) / 32 words) for every visible box
+            void checkVisibility(const float* minX, const float* minY,
+                                 const float* maxX, const float* maxY,
+                                 uint32_t count, uint32_t* visibilityMask) const;
 
             Vector2 projectPoint(const Vector3& src) const;
 
@@ -66,9 +76,12 @@ namespace ouzel
             Size2 contentSize;
             Vector2 contentScale;
 
-            bool viewProjectionDirty = false;
+            mutable bool viewProjectionDirty = false;
             mutable Matrix4 viewProjection = Matrix4::IDENTITY;
 
+            mutable bool viewBoundsDirty = true;
+            mutable AABB2 viewBounds;
+
             LayerWeakPtr layer;
         };
     } // namespace scene
@@ -2,6 +2,7 @@
 // This file is part of the Ouzel engine.
 
 #include "Component.h"
+#include "Node.h"
 #include "utils/Utils.h"
 #include "math/MathUtils.h"
 
@@ -16,14 +17,18 @@ namespace ouzel
         void Component::draw(const Matrix4&,
                             const Matrix4&,
                             const graphics::Color&,
-                            const graphics::RenderTargetPtr&)
+                            const graphics::RenderTargetPtr&,
+                            bool,
+                            const Rectangle&)
         {
         }
 
         void Component::drawWireframe(const Matrix4&,
                                       const Matrix4&,
                                       const graphics::Color&,
-                                      const graphics::RenderTargetPtr&)
+                                      const graphics::RenderTargetPtr&,
+                                      bool,
+                                      const Rectangle&)
         {
         }
 
@@ -80,5 +85,13 @@ namespace ouzel
 
             return false;
         }
+
+        void Component::markDirty()
+        {
+            if (node)
+            {
+                node->markDirty();
+            }
+        }
     } // namespace scene
 } // namespace ouzel
@@ -8,6 +8,7 @@
 #include "utils/Types.h"
 #include "math/AABB2.h"
 #include "math/Matrix4.h"
+#include "math/Rectangle.h"
 #include "graphics/Color.h"
 
 namespace ouzel
@@ -23,24 +24,30 @@ namespace ouzel
             virtual void draw(const Matrix4& projectionMatrix,
                               const Matrix4& transformMatrix,
                               const graphics::Color& drawColor,
-                              const graphics::RenderTargetPtr& renderTarget);
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest);
 
             virtual void drawWireframe(const Matrix4& projectionMatrix,
                                        const Matrix4& transformMatrix,
                                        const graphics::Color& drawColor,
-                                       const graphics::RenderTargetPtr& renderTarget);
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest);
 
             virtual const AABB2& getBoundingBox() const { return boundingBox; }
             bool isAddedToNode() { return node != nullptr; }
+            Node* getNode() const { return node; }
 
             virtual bool pointOn(const Vector2& position) const;
             virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
 
             bool isHidden() const { return hidden; }
-            virtual void setHidden(bool newHidden) { hidden = newHidden; }
+            virtual void setHidden(bool newHidden) { hidden = newHidden; markDirty(); }
 
         protected:
             void setNode(Node* newNode) { node = newNode; }
+            void markDirty();
 
             AABB2 boundingBox;
             bool hidden = false;
@@ -1,11 +1,17 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <algorithm>
+#include <cmath>
 #include "Layer.h"
 #include "core/Engine.h"
 #include "Node.h"
 #include "Camera.h"
+#include "core/Cache.h"
 #include "graphics/Renderer.h"
+#include "graphics/RenderTarget.h"
+#include "graphics/Texture.h"
+#include "graphics/MeshBuffer.h"
 #include "Scene.h"
 #include "math/Matrix4.h"
 #include "Component.h"
@@ -23,37 +29,158 @@ namespace ouzel
         }
 
         void Layer::draw()
+        {
+            // render only if there is an active camera
+            if (!camera)
+            {
+                drawQueue.clear();
+                return;
+            }
+
+            if (cached)
+            {
+                if (updateCache())
+                {
+                    ++cacheHits;
+                }
+                else
+                {
+                    ++cacheMisses;
+
+                    drawNodes();
+
+                    cacheViewProjection = camera->getViewProjection();
+                    cacheDirty = false;
+                }
+
+                drawCache();
+            }
+            else
+            {
+                drawNodes();
+            }
+        }
+
+        void Layer::drawNodes()
         {
             drawQueue.clear();
+            cullQueue.clear();
+            cullMinX.clear();
+            cullMinY.clear();
+            cullMaxX.clear();
+            cullMaxY.clear();
 
-            // render only if there is an active camera
-            if (camera)
+            for (const NodePtr& child : children)
             {
-                for (const NodePtr& child : children)
+                if (!child->isHidden())
                 {
-                    if (!child->isHidden())
-                    {
-                        child->visit(Matrix4::IDENTITY, false, std::static_pointer_cast<Layer>(shared_from_this()), 0.0f);
-                    }
+                    child->scissorTestEnabled = false;
+                    child->visit(Matrix4::IDENTITY, false, std::static_pointer_cast<Layer>(shared_from_this()), 0.0f);
                 }
+            }
+
+            uint32_t count = static_cast<uint32_t>(cullQueue.size());
+            visibilityMask.resize((count + 31) / 32);
 
-                drawQueue.sort([](const std::pair<NodePtr, float>& a, const std::pair<NodePtr, float>& b) {
-                    return a.second > b.second;
-                });
+            camera->checkVisibility(cullMinX.data(), cullMinY.data(), cullMaxX.data(), cullMaxY.data(), count, visibilityMask.data());
 
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (visibilityMask[i / 32] & (1u << (i % 32)))
+                {
+                    drawQueue.push_back(cullQueue[i]);
+                }
+            }
+
+            std::stable_sort(drawQueue.begin(), drawQueue.end(), [](const std::pair<NodePtr, float>& a, const std::pair<NodePtr, float>& b) {
+                return a.second > b.second;
+            });
+
+            for (const auto& node : drawQueue)
+            {
+                node.first->draw(std::static_pointer_cast<Layer>(shared_from_this()));
+            }
+
+            if (wireframe)
+            {
                 for (const auto& node : drawQueue)
                 {
-                    node.first->draw(std::static_pointer_cast<Layer>(shared_from_this()));
+                    node.first->drawWireframe(std::static_pointer_cast<Layer>(shared_from_this()));
                 }
+            }
+        }
+
+        // returns true if the contents of the cache render target can be reused
+        bool Layer::updateCache()
+        {
+            Size2 size = renderTarget ? renderTarget->getTexture()->getSize() : sharedEngine->getRenderer()->getSize();
 
-                if (wireframe)
+            if (!cacheRenderTarget || cacheRenderTarget->getTexture()->getSize() != size)
+            {
+                cacheRenderTarget = sharedEngine->getRenderer()->createRenderTarget();
+
+                if (!cacheRenderTarget->init(size, false))
                 {
-                    for (const auto& node : drawQueue)
-                    {
-                        node.first->drawWireframe(std::static_pointer_cast<Layer>(shared_from_this()));
-                    }
+                    cacheRenderTarget.reset();
+                    return false;
                 }
+
+                cacheRenderTarget->setClearColor(graphics::Color(0, 0, 0, 0));
+
+                // quad covering the whole viewport in clip space
+                float top = cacheRenderTarget->getTexture()->isFlipped() ? 1.0f : 0.0f;
+                float bottom = 1.0f - top;
+
+                std::vector<uint16_t> indices = {0, 1, 2, 1, 3, 2};
+
+                std::vector<graphics::VertexPCT> vertices = {
+                    graphics::VertexPCT(Vector3(-1.0f, -1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(0.0f, bottom)),
+                    graphics::VertexPCT(Vector3(1.0f, -1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(1.0f, bottom)),
+                    graphics::VertexPCT(Vector3(-1.0f, 1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(0.0f, top)),
+                    graphics::VertexPCT(Vector3(1.0f, 1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(1.0f, top))
+                };
+
+                cacheMeshBuffer = sharedEngine->getRenderer()->createMeshBuffer();
+                cacheMeshBuffer->initFromBuffer(indices.data(), sizeof(uint16_t),
+                                                static_cast<uint32_t>(indices.size()), false,
+                                                vertices.data(), graphics::VertexPCT::ATTRIBUTES,
+                                                static_cast<uint32_t>(vertices.size()), false);
+
+                cacheShader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+                // the nodes are alpha blended onto a transparent target, so the cached colors are premultiplied
+                cacheBlendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_PREMULTIPLIED_ALPHA);
+
+                return false;
+            }
+
+            return !cacheDirty && cacheViewProjection == camera->getViewProjection();
+        }
+
+        void Layer::drawCache()
+        {
+            if (!cacheRenderTarget)
+            {
+                return;
             }
+
+            float colorVector[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = { std::begin(colorVector), std::end(colorVector) };
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = { std::begin(Matrix4::IDENTITY.m), std::end(Matrix4::IDENTITY.m) };
+
+            sharedEngine->getRenderer()->addDrawCommand({ cacheRenderTarget->getTexture() },
+                                                        cacheShader,
+                                                        pixelShaderConstants,
+                                                        vertexShaderConstants,
+                                                        cacheBlendState,
+                                                        cacheMeshBuffer,
+                                                        0,
+                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                        0,
+                                                        renderTarget);
         }
 
         bool Layer::addChild(const NodePtr& node)
@@ -72,7 +199,45 @@ namespace ouzel
 
         void Layer::addToDrawQueue(const NodePtr& node, float depth)
         {
-            drawQueue.push_back({ node, depth });
+            AABB2 boundingBox;
+
+            for (const ComponentPtr& component : node->getComponents())
+            {
+                if (!component->isHidden())
+                {
+                    boundingBox.merge(component->getBoundingBox());
+                }
+            }
+
+            if (boundingBox.isEmpty())
+            {
+                return;
+            }
+
+            // transform the center and the half size of the box to world space
+            const Matrix4& transform = node->getTransform();
+
+            Vector3 center((boundingBox.min.x + boundingBox.max.x) / 2.0f, (boundingBox.min.y + boundingBox.max.y) / 2.0f, 0.0f);
+            Vector2 halfSize = (boundingBox.max - boundingBox.min) / 2.0f;
+
+            transform.transformPoint(center);
+
+            float halfWidth = fabsf(halfSize.x * transform.m[0]) + fabsf(halfSize.y * transform.m[4]);
+            float halfHeight = fabsf(halfSize.x * transform.m[1]) + fabsf(halfSize.y * transform.m[5]);
+
+            // nodes that are clipped away entirely are not drawn even if the camera sees them
+            if (node->scissorTestEnabled &&
+                (center.x + halfWidth < node->clipBounds.min.x || center.x - halfWidth > node->clipBounds.max.x ||
+                 center.y + halfHeight < node->clipBounds.min.y || center.y - halfHeight > node->clipBounds.max.y))
+            {
+                return;
+            }
+
+            cullQueue.push_back({ node, depth });
+            cullMinX.push_back(center.x - halfWidth);
+            cullMinY.push_back(center.y - halfHeight);
+            cullMaxX.push_back(center.x + halfWidth);
+            cullMaxY.push_back(center.y + halfHeight);
         }
 
         void Layer::setCamera(const CameraPtr& newCamera)
@@ -83,6 +248,7 @@ namespace ouzel
             }
 
             camera = newCamera;
+            cacheDirty = true;
 
             if (camera)
             {
@@ -93,10 +259,15 @@ namespace ouzel
 
         NodePtr Layer::pickNode(const Vector2& position) const
         {
-            for (std::list<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
+            for (std::vector<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
             {
                 const NodePtr& node = i->first;
 
+                if (node->scissorTestEnabled && !node->clipBounds.containsPoint(position))
+                {
+                    continue;
+                }
+
                 if (!node->isHidden() && node->isPickable() && node->pointOn(position))
                 {
                     return node;
@@ -110,10 +281,15 @@ namespace ouzel
         {
             std::vector<NodePtr> result;
 
-            for (std::list<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
+            for (std::vector<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
             {
                 const NodePtr& node = i->first;
 
+                if (node->scissorTestEnabled && !node->clipBounds.containsPoint(position))
+                {
+                    continue;
+                }
+
                 if (!node->isHidden() && node->isPickable() && node->pointOn(position))
                 {
                     result.push_back(node);
@@ -127,7 +303,7 @@ namespace ouzel
         {
             std::set<NodePtr> result;
 
-            for (std::list<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
+            for (std::vector<std::pair<NodePtr, float>>::const_reverse_iterator i = drawQueue.rbegin(); i != drawQueue.rend(); ++i)
             {
                 const NodePtr& node = i->first;
 
@@ -148,6 +324,7 @@ namespace ouzel
         void Layer::setRenderTarget(const graphics::RenderTargetPtr& newRenderTarget)
         {
             renderTarget = newRenderTarget;
+            cacheDirty = true;
 
             if (camera)
             {
@@ -155,27 +332,27 @@ namespace ouzel
             }
         }
 
-        bool Layer::checkVisibility(const NodePtr& node) const
+        void Layer::setWireframe(bool newWireframe)
         {
-            if (camera)
-            {
-                AABB2 boundingBox;
+            wireframe = newWireframe;
+            cacheDirty = true;
+        }
 
-                for (const ComponentPtr& component : node->getComponents())
-                {
-                    if (!component->isHidden())
-                    {
-                        boundingBox.merge(component->getBoundingBox());
-                    }
-                }
+        void Layer::setCached(bool newCached)
+        {
+            cached = newCached;
+            cacheDirty = true;
 
-                if (!boundingBox.isEmpty() && camera->checkVisibility(node->getTransform(), boundingBox))
-                {
-                    return true;
-                }
+            if (!cached)
+            {
+                cacheRenderTarget.reset();
+                cacheMeshBuffer.reset();
             }
+        }
 
-            return false;
+        void Layer::markDirty()
+        {
+            cacheDirty = true;
         }
     } // namespace scene
 } // namespace ouzel
@@ -31,6 +31,7 @@ namespace ouzel
 
             virtual bool addChild(const NodePtr& node) override;
 
+            // nodes are culled against the camera in one batch before the draw queue is drawn
             void addToDrawQueue(const NodePtr& node, float depth);
 
             const CameraPtr& getCamera() const { return camera; }
@@ -46,19 +47,51 @@ namespace ouzel
             void setRenderTarget(const graphics::RenderTargetPtr& newRenderTarget);
             const graphics::RenderTargetPtr& getRenderTarget() const { return renderTarget; }
 
-            bool checkVisibility(const NodePtr& node) const;
+            // render target that nodes of this layer are drawn to (the cache render target if the layer is cached)
+            const graphics::RenderTargetPtr& getDrawRenderTarget() const { return cacheRenderTarget ? cacheRenderTarget : renderTarget; }
 
             bool getWireframe() const { return wireframe; }
-            void setWireframe(bool newWireframe) { wireframe = newWireframe; }
+            void setWireframe(bool newWireframe);
+
+            void setCached(bool newCached);
+            bool isCached() const { return cached; }
+
+            virtual void markDirty() override;
+
+            uint32_t getCacheHits() const { return cacheHits; }
+            uint32_t getCacheMisses() const { return cacheMisses; }
+            void resetCacheStats() { cacheHits = cacheMisses = 0; }
 
         protected:
+            void drawNodes();
+            bool updateCache();
+            void drawCache();
+
             CameraPtr camera;
-            std::list<std::pair<NodePtr, float>> drawQueue;
+            std::vector<std::pair<NodePtr, float>> drawQueue;
+
+            std::vector<std::pair<NodePtr, float>> cullQueue;
+            std::vector<float> cullMinX;
+            std::vector<float> cullMinY;
+            std::vector<float> cullMaxX;
+            std::vector<float> cullMaxY;
+            std::vector<uint32_t> visibilityMask;
 
             int32_t order = 0;
             bool wireframe = false;
 
             graphics::RenderTargetPtr renderTarget;
+
+            bool cached = false;
+            bool cacheDirty = true;
+            uint32_t cacheHits = 0;
+            uint32_t cacheMisses = 0;
+            Matrix4 cacheViewProjection;
+
+            graphics::RenderTargetPtr cacheRenderTarget;
+            graphics::MeshBufferPtr cacheMeshBuffer;
+            graphics::ShaderPtr cacheShader;
+            graphics::BlendStatePtr cacheBlendState;
         };
     } // namespace scene
 } // namespace ouzel
@@ -41,15 +41,16 @@ namespace ouzel
 
             if (currentLayer)
             {
-                if (currentLayer->checkVisibility(std::static_pointer_cast<Node>(shared_from_this())))
-                {
-                    currentLayer->addToDrawQueue(std::static_pointer_cast<Node>(shared_from_this()), depth + z);
-                }
+                currentLayer->addToDrawQueue(std::static_pointer_cast<Node>(shared_from_this()), depth + z);
 
                 for (const NodePtr& child : children)
                 {
                     if (!child->isHidden())
                     {
+                        child->scissorTestEnabled = scissorTestEnabled;
+                        child->scissorTest = scissorTest;
+                        child->clipBounds = clipBounds;
+
                         child->visit(transform, updateChildrenTransform, currentLayer, depth + z);
                     }
                 }
@@ -78,7 +79,9 @@ namespace ouzel
                             component->draw(currentLayer->getCamera()->getViewProjection(),
                                             transform,
                                             drawColor,
-                                            currentLayer->getRenderTarget());
+                                            currentLayer->getDrawRenderTarget(),
+                                            scissorTestEnabled,
+                                            scissorTest);
                         }
                     }
                 }
@@ -105,7 +108,9 @@ namespace ouzel
                             component->drawWireframe(currentLayer->getCamera()->getViewProjection(),
                                                      transform,
                                                      drawColor,
-                                                     currentLayer->getRenderTarget());
+                                                     currentLayer->getDrawRenderTarget(),
+                                                     scissorTestEnabled,
+                                                     scissorTest);
                         }
                     }
                 }
@@ -126,12 +131,24 @@ namespace ouzel
             }
         }
 
+        bool Node::removeFromParent()
+        {
+            if (parent)
+            {
+                return parent->removeChild(std::static_pointer_cast<Node>(shared_from_this()));
+            }
+
+            return false;
+        }
+
         void Node::setZ(float newZ)
         {
             z = newZ;
 
             // Currently z does not affect transformation
             //localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setPosition(const Vector2& newPosition)
@@ -139,6 +156,8 @@ namespace ouzel
             position = newPosition;
 
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setRotation(float newRotation)
@@ -146,6 +165,8 @@ namespace ouzel
             rotation = newRotation;
 
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setScale(const Vector2& newScale)
@@ -153,16 +174,22 @@ namespace ouzel
             scale = newScale;
 
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setColor(const graphics::Color& newColor)
         {
             color = newColor;
+
+            markDirty();
         }
 
         void Node::setOpacity(float newOpacity)
         {
             opacity = clamp(newOpacity, 0.0f, 1.0f);
+
+            markDirty();
         }
 
         void Node::setFlipX(bool newFlipX)
@@ -170,6 +197,8 @@ namespace ouzel
             flipX = newFlipX;
 
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setFlipY(bool newFlipY)
@@ -177,11 +206,15 @@ namespace ouzel
             flipY = newFlipY;
 
             localTransformDirty = transformDirty = inverseTransformDirty = true;
+
+            markDirty();
         }
 
         void Node::setHidden(bool newHidden)
         {
             hidden = newHidden;
+
+            markDirty();
         }
 
         bool Node::pointOn(const Vector2& worldPosition) const
@@ -256,6 +289,14 @@ namespace ouzel
             transformDirty = inverseTransformDirty = true;
         }
 
+        void Node::markDirty()
+        {
+            if (parent)
+            {
+                parent->markDirty();
+            }
+        }
+
         Vector2 Node::convertWorldToLocal(const Vector2& worldPosition) const
         {
             Vector3 localPosition = worldPosition;
@@ -285,6 +326,8 @@ namespace ouzel
             {
                 currentAnimator->start(std::static_pointer_cast<Node>(shared_from_this()));
             }
+
+            markDirty();
         }
 
         void Node::stopAnimation()
@@ -299,6 +342,8 @@ namespace ouzel
         void Node::removeAnimation()
         {
             currentAnimator.reset();
+
+            markDirty();
         }
 
         void Node::calculateLocalTransform() const
@@ -351,6 +396,8 @@ namespace ouzel
             components.push_back(component);
             component->setNode(this);
 
+            markDirty();
+
             return true;
         }
 
@@ -366,6 +413,8 @@ namespace ouzel
 
             components.erase(components.begin() + static_cast<int>(index));
 
+            markDirty();
+
             return true;
         }
 
@@ -377,6 +426,7 @@ namespace ouzel
                 {
                     component->setNode(nullptr);
                     components.erase(i);
+                    markDirty();
                     return true;
                 }
                 else
@@ -391,6 +441,8 @@ namespace ouzel
         void Node::removeAllComponents()
         {
             components.clear();
+
+            markDirty();
         }
 
     } // namespace scene
@@ -31,6 +31,9 @@ namespace ouzel
 
             virtual bool addChild(const NodePtr& node) override;
             virtual bool hasParent() const { return (parent != nullptr); }
+            bool removeFromParent();
+
+            virtual void markDirty() override;
 
             virtual void setName(const std::string& newName) { name = newName; }
             virtual const std::string& getName() const { return name; }
@@ -131,6 +134,12 @@ namespace ouzel
             AnimatorPtr currentAnimator;
             std::vector<ComponentPtr> components;
 
+            // clipping inherited from the closest clipping ancestor (e.g. a scroll area) when the node is visited,
+            // the scissor rectangle is in render target pixels and the clip bounds in world space
+            bool scissorTestEnabled = false;
+            Rectangle scissorTest;
+            AABB2 clipBounds;
+
             NodeContainer* parent = nullptr;
         };
     } // namespace scene
@@ -28,6 +28,8 @@ namespace ouzel
                 node->setParent(this);
                 children.push_back(node);
 
+                markDirty();
+
                 return true;
             }
             else
@@ -45,6 +47,8 @@ namespace ouzel
                 node->setParent(nullptr);
                 children.erase(i);
 
+                markDirty();
+
                 return true;
             }
             else
@@ -63,6 +67,8 @@ namespace ouzel
             }
 
             children.clear();
+
+            markDirty();
         }
 
         bool NodeContainer::hasChild(const NodePtr& node, bool recursive) const
@@ -79,5 +85,9 @@ namespace ouzel
 
             return false;
         }
+
+        void NodeContainer::markDirty()
+        {
+        }
     } // namespace scene
 } // namespace ouzel
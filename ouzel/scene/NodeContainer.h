@@ -27,6 +27,8 @@ namespace ouzel
             virtual bool hasChild(const NodePtr& node, bool recursive = false) const;
             virtual const std::list<NodePtr>& getChildren() const { return children; }
 
+            virtual void markDirty();
+
         protected:
             std::list<NodePtr> children;
         };
@@ -0,0 +1,269 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include "utils/Noncopyable.h"
+#include "utils/Utils.h"
+#include "scene/Node.h"
+#include "scene/Component.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Bump allocator that hands out memory from large blocks, memory is freed when all the allocators that share it are destroyed
+        class PoolSlabs: public Noncopyable
+        {
+        public:
+            PoolSlabs(size_t pSlabSize): slabSize(pSlabSize) {}
+
+            void* allocate(size_t size, size_t alignment)
+            {
+                offset = (offset + alignment - 1) & ~(alignment - 1);
+
+                if (slabs.empty() || offset + size > currentSlabSize)
+                {
+                    currentSlabSize = std::max(slabSize, size);
+                    slabs.push_back(std::unique_ptr<uint8_t[]>(new uint8_t[currentSlabSize]));
+                    offset = 0;
+                }
+
+                void* result = slabs.back().get() + offset;
+                offset += size;
+
+                return result;
+            }
+
+            uint32_t getSlabCount() const { return static_cast<uint32_t>(slabs.size()); }
+
+        protected:
+            size_t slabSize;
+            size_t currentSlabSize = 0;
+            size_t offset = 0;
+            std::vector<std::unique_ptr<uint8_t[]>> slabs;
+        };
+
+        template<class T> class PoolAllocator
+        {
+        public:
+            typedef T value_type;
+
+            PoolAllocator(const std::shared_ptr<PoolSlabs>& pSlabs): slabs(pSlabs) {}
+            template<class U> PoolAllocator(const PoolAllocator<U>& other): slabs(other.slabs) {}
+
+            T* allocate(size_t count)
+            {
+                return static_cast<T*>(slabs->allocate(count * sizeof(T), alignof(T)));
+            }
+
+            void deallocate(T*, size_t)
+            {
+                // pooled objects are never freed one by one, the memory is released together with the slabs
+            }
+
+            template<class U> bool operator==(const PoolAllocator<U>& other) const { return slabs == other.slabs; }
+            template<class U> bool operator!=(const PoolAllocator<U>& other) const { return slabs != other.slabs; }
+
+            std::shared_ptr<PoolSlabs> slabs;
+        };
+
+        // Pool of reusable objects of the type T, objects are allocated in slabs of slabSize objects together with their
+        // shared pointer control blocks. Acquiring and releasing objects does not allocate once the pool has grown to the
+        // needed size.
+        template<class T> class ObjectPool: public Noncopyable
+        {
+        public:
+            ObjectPool(uint32_t pSlabSize = 64):
+                slabSize(pSlabSize ? pSlabSize : 1),
+                slabs(std::make_shared<PoolSlabs>(slabSize * (sizeof(T) + CONTROL_BLOCK_SIZE)))
+            {
+            }
+
+            virtual ~ObjectPool()
+            {
+            }
+
+            // called once for every new object, e.g. to add components to a pooled node
+            std::function<void(const std::shared_ptr<T>&)> createCallback;
+            // called for every released object to bring it back to its initial state
+            std::function<void(const std::shared_ptr<T>&)> resetCallback;
+
+            std::shared_ptr<T> acquire()
+            {
+                if (freeIndices.empty())
+                {
+                    grow(slabSize);
+                }
+
+                uint32_t index = freeIndices.back();
+                freeIndices.pop_back();
+                freeFlags[index] = false;
+
+                peakUsedCount = std::max(peakUsedCount, getUsedCount());
+
+                return objects[index];
+            }
+
+            bool release(const std::shared_ptr<T>& object)
+            {
+                typename std::unordered_map<const T*, uint32_t>::const_iterator i = indices.find(object.get());
+
+                if (i == indices.end())
+                {
+                    log(LOG_LEVEL_ERROR, "Object does not belong to the pool");
+                    return false;
+                }
+
+                if (freeFlags[i->second])
+                {
+                    log(LOG_LEVEL_WARNING, "Object was already released");
+                    return false;
+                }
+
+                releaseIndex(i->second);
+
+                return true;
+            }
+
+            // releases all the acquired objects that are not referenced outside of the pool anymore
+            uint32_t reclaim()
+            {
+                uint32_t count = 0;
+
+                for (uint32_t index = 0; index < objects.size(); ++index)
+                {
+                    if (!freeFlags[index] && objects[index].use_count() == 1)
+                    {
+                        releaseIndex(index);
+                        ++count;
+                    }
+                }
+
+                return count;
+            }
+
+            void reserve(uint32_t count)
+            {
+                if (count > objects.size())
+                {
+                    grow(count - static_cast<uint32_t>(objects.size()));
+                }
+            }
+
+            uint32_t getCapacity() const { return static_cast<uint32_t>(objects.size()); }
+            uint32_t getFreeCount() const { return static_cast<uint32_t>(freeIndices.size()); }
+            uint32_t getUsedCount() const { return getCapacity() - getFreeCount(); }
+            uint32_t getPeakUsedCount() const { return peakUsedCount; }
+            uint32_t getSlabCount() const { return slabs->getSlabCount(); }
+
+        protected:
+            // rough size of the control block that std::allocate_shared places next to the object
+            static const size_t CONTROL_BLOCK_SIZE = 64;
+
+            void grow(uint32_t count)
+            {
+                objects.reserve(objects.size() + count);
+                freeFlags.reserve(objects.size() + count);
+                freeIndices.reserve(objects.size() + count);
+                indices.reserve(objects.size() + count);
+
+                PoolAllocator<T> allocator(slabs);
+
+                for (uint32_t i = 0; i < count; ++i)
+                {
+                    std::shared_ptr<T> object = std::allocate_shared<T>(allocator);
+
+                    if (createCallback)
+                    {
+                        createCallback(object);
+                    }
+
+                    uint32_t index = static_cast<uint32_t>(objects.size());
+
+                    indices[object.get()] = index;
+                    objects.push_back(object);
+                    freeFlags.push_back(true);
+                    freeIndices.push_back(index);
+                }
+            }
+
+            void releaseIndex(uint32_t index)
+            {
+                if (resetCallback)
+                {
+                    resetCallback(objects[index]);
+                }
+
+                freeFlags[index] = true;
+                freeIndices.push_back(index);
+            }
+
+            uint32_t slabSize;
+            std::shared_ptr<PoolSlabs> slabs;
+
+            std::vector<std::shared_ptr<T>> objects;
+            std::vector<bool> freeFlags;
+            std::vector<uint32_t> freeIndices;
+            std::unordered_map<const T*, uint32_t> indices;
+
+            uint32_t peakUsedCount = 0;
+        };
+
+        // Pool of nodes, released nodes are detached from their parent, their animation is stopped and their
+        // transformation and color are reset. Children and components are kept, so that pooled nodes can be prefabs.
+        template<class T = Node> class NodePool: public ObjectPool<T>
+        {
+        public:
+            NodePool(uint32_t pSlabSize = 64):
+                ObjectPool<T>(pSlabSize)
+            {
+                this->resetCallback = resetNode;
+            }
+
+            static void resetNode(const std::shared_ptr<T>& node)
+            {
+                node->removeFromParent();
+                node->stopAnimation();
+
+                node->setPosition(Vector2());
+                node->setRotation(0.0f);
+                node->setScale(Vector2(1.0f, 1.0f));
+                node->setFlipX(false);
+                node->setFlipY(false);
+                node->setZ(0.0f);
+                node->setColor(graphics::Color(255, 255, 255, 255));
+                node->setOpacity(1.0f);
+                node->setHidden(false);
+            }
+        };
+
+        // Pool of components, released components are removed from their node and shown again
+        template<class T> class ComponentPool: public ObjectPool<T>
+        {
+        public:
+            ComponentPool(uint32_t pSlabSize = 64):
+                ObjectPool<T>(pSlabSize)
+            {
+                this->resetCallback = resetComponent;
+            }
+
+            static void resetComponent(const std::shared_ptr<T>& component)
+            {
+                if (Node* node = component->getNode())
+                {
+                    node->removeComponent(component);
+                }
+
+                component->setHidden(false);
+            }
+        };
+    } // namespace scene
+} // namespace ouzel
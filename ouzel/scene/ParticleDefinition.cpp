@@ -1,8 +1,9 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <cstring>
 #include <rapidjson/rapidjson.h>
-#include <rapidjson/filereadstream.h>
+#include <rapidjson/memorystream.h>
 #include <rapidjson/document.h>
 #include "ParticleDefinition.h"
 #include "core/Application.h"
@@ -13,17 +14,180 @@ namespace ouzel
 {
     namespace scene
     {
+        class CookedReader
+        {
+        public:
+            CookedReader(const uint8_t* pData, size_t pSize):
+                data(pData), size(pSize)
+            {
+            }
+
+            bool isValid() const { return valid; }
+
+            uint32_t readUInt32()
+            {
+                if (!check(4)) return 0;
+
+                uint32_t result = readUInt32Little(data + offset);
+                offset += 4;
+                return result;
+            }
+
+            float readFloat()
+            {
+                if (!check(4)) return 0.0f;
+
+                float result = readFloatLittle(data + offset);
+                offset += 4;
+                return result;
+            }
+
+            std::string readString()
+            {
+                if (!check(2)) return std::string();
+
+                uint16_t length = readUInt16Little(data + offset);
+                offset += 2;
+
+                if (!check(length)) return std::string();
+
+                std::string result(reinterpret_cast<const char*>(data + offset), length);
+                offset += length;
+                return result;
+            }
+
+        private:
+            bool check(size_t count)
+            {
+                valid = valid && offset + count <= size;
+                return valid;
+            }
+
+            const uint8_t* data;
+            size_t size;
+            size_t offset = 0;
+            bool valid = true;
+        };
+
+        static bool loadCookedParticleDefinition(const std::string& filename, const FileView& data, ParticleDefinition& definition)
+        {
+            CookedReader reader(data.getData() + 4, data.getSize() - 4);
+
+            uint32_t version = reader.readUInt32();
+
+            if (version != ParticleDefinition::COOKED_VERSION)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load %s, unsupported version %u", filename.c_str(), version);
+                return false;
+            }
+
+            ParticleDefinition result;
+
+            result.blendFuncSource = reader.readUInt32();
+            result.blendFuncDestination = reader.readUInt32();
+            result.emitterType = reader.readUInt32() == 1 ? ParticleDefinition::EmitterType::RADIUS : ParticleDefinition::EmitterType::GRAVITY;
+            result.maxParticles = reader.readUInt32();
+            result.duration = reader.readFloat();
+            result.particleLifespan = reader.readFloat();
+            result.particleLifespanVariance = reader.readFloat();
+
+            result.speed = reader.readFloat();
+            result.speedVariance = reader.readFloat();
+
+            result.sourcePosition.x = reader.readFloat();
+            result.sourcePosition.y = reader.readFloat();
+            result.sourcePositionVariance.x = reader.readFloat();
+            result.sourcePositionVariance.y = reader.readFloat();
+
+            switch (reader.readUInt32())
+            {
+                case 1: result.positionType = ParticleDefinition::PositionType::RELATIVE; break;
+                case 2: result.positionType = ParticleDefinition::PositionType::GROUPED; break;
+                default: result.positionType = ParticleDefinition::PositionType::FREE; break;
+            }
+
+            result.startParticleSize = reader.readFloat();
+            result.startParticleSizeVariance = reader.readFloat();
+            result.finishParticleSize = reader.readFloat();
+            result.finishParticleSizeVariance = reader.readFloat();
+            result.angle = reader.readFloat();
+            result.angleVariance = reader.readFloat();
+            result.startRotation = reader.readFloat();
+            result.startRotationVariance = reader.readFloat();
+            result.finishRotation = reader.readFloat();
+            result.finishRotationVariance = reader.readFloat();
+            result.rotatePerSecond = reader.readFloat();
+            result.rotatePerSecondVariance = reader.readFloat();
+            result.minRadius = reader.readFloat();
+            result.minRadiusVariance = reader.readFloat();
+            result.maxRadius = reader.readFloat();
+            result.maxRadiusVariance = reader.readFloat();
+
+            result.radialAcceleration = reader.readFloat();
+            result.radialAccelVariance = reader.readFloat();
+            result.tangentialAcceleration = reader.readFloat();
+            result.tangentialAccelVariance = reader.readFloat();
+
+            uint32_t flags = reader.readUInt32();
+            result.absolutePosition = (flags & ParticleDefinition::COOKED_ABSOLUTE_POSITION) != 0;
+            result.yCoordFlipped = (flags & ParticleDefinition::COOKED_Y_COORD_FLIPPED) != 0;
+            result.rotationIsDir = (flags & ParticleDefinition::COOKED_ROTATION_IS_DIR) != 0;
+
+            result.gravity.x = reader.readFloat();
+            result.gravity.y = reader.readFloat();
+
+            result.startColorRed = reader.readFloat();
+            result.startColorGreen = reader.readFloat();
+            result.startColorBlue = reader.readFloat();
+            result.startColorAlpha = reader.readFloat();
+
+            result.startColorRedVariance = reader.readFloat();
+            result.startColorGreenVariance = reader.readFloat();
+            result.startColorBlueVariance = reader.readFloat();
+            result.startColorAlphaVariance = reader.readFloat();
+
+            result.finishColorRed = reader.readFloat();
+            result.finishColorGreen = reader.readFloat();
+            result.finishColorBlue = reader.readFloat();
+            result.finishColorAlpha = reader.readFloat();
+
+            result.finishColorRedVariance = reader.readFloat();
+            result.finishColorGreenVariance = reader.readFloat();
+            result.finishColorBlueVariance = reader.readFloat();
+            result.finishColorAlphaVariance = reader.readFloat();
+
+            result.emissionRate = reader.readFloat();
+
+            result.textureFilename = reader.readString();
+
+            if (!reader.isValid())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                return false;
+            }
+
+            definition = result;
+
+            return true;
+        }
+
         ParticleDefinitionPtr ParticleDefinition::loadParticleDefinition(const std::string& filename)
         {
             ParticleDefinitionPtr result = std::make_shared<scene::ParticleDefinition>();
 
-            std::vector<uint8_t> data;
-            if (!sharedApplication->getFileSystem()->loadFile(filename, data))
+            FileView data;
+            if (!sharedApplication->getFileSystem()->mapFile(filename, data))
+            {
+                return result;
+            }
+
+            if (data.getSize() >= 4 && memcmp(data.getData(), "OPAR", 4) == 0)
             {
+                loadCookedParticleDefinition(filename, data, *result);
                 return result;
             }
 
-            rapidjson::MemoryStream is(reinterpret_cast<char*>(data.data()), data.size());
+            rapidjson::MemoryStream is(reinterpret_cast<const char*>(data.getData()), data.getSize());
 
             rapidjson::Document document;
             document.ParseStream<0>(is);
@@ -13,6 +13,16 @@ namespace ouzel
     {
         struct ParticleDefinition
         {
+            // particle definitions written by the cooker tool start with "OPAR" and version, followed by the members
+            // in the order they are declared in: enums and unsigned integers as 32-bit integers, floats, the booleans
+            // as a 32-bit mask of COOKED_* flags after tangentialAccelVariance and the length (16-bit) and the
+            // characters of textureFilename, all the values are little-endian
+            static const uint32_t COOKED_VERSION = 1;
+            static const uint32_t COOKED_ABSOLUTE_POSITION = 0x01;
+            static const uint32_t COOKED_Y_COORD_FLIPPED = 0x02;
+            static const uint32_t COOKED_ROTATION_IS_DIR = 0x04;
+
+            // loads Particle Designer JSON or cooked particle definitions
             static ParticleDefinitionPtr loadParticleDefinition(const std::string& filename);
 
             enum class EmitterType
@@ -2,8 +2,17 @@
 // This file is part of the Ouzel engine.
 
 #include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
 #include "core/CompileConfig.h"
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+#include <arm_neon.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <emmintrin.h>
+#endif
 #include "ParticleSystem.h"
+#include "ParticleWorld.h"
 #include "core/Engine.h"
 #include "SceneManager.h"
 #include "files/FileSystem.h"
@@ -18,13 +27,526 @@ namespace ouzel
 {
     namespace scene
     {
+        // parabolic sine approximation with an absolute error below 0.001, good enough for particle motion and rotation
+        static const float SIN_B = 4.0f / PI;
+        static const float SIN_C = -4.0f / (PI * PI);
+        static const float SIN_P = 0.225f;
+
+        static inline void sinCos(float x, float& s, float& c)
+        {
+            // wrap to [-pi, pi]
+            x -= PIX2 * floorf(x * (1.0f / PIX2) + 0.5f);
+            float xc = x + PI_2;
+            if (xc > PI) xc -= PIX2;
+
+            float y = SIN_B * x + SIN_C * x * fabsf(x);
+            s = SIN_P * (y * fabsf(y) - y) + y;
+
+            y = SIN_B * xc + SIN_C * xc * fabsf(xc);
+            c = SIN_P * (y * fabsf(y) - y) + y;
+        }
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+        static inline float32x4_t sin4(float32x4_t x)
+        {
+            float32x4_t y = vmlaq_f32(vmulq_n_f32(x, SIN_B), vmulq_n_f32(x, SIN_C), vabsq_f32(x));
+            return vmlaq_n_f32(y, vsubq_f32(vmulq_f32(y, vabsq_f32(y)), y), SIN_P);
+        }
+
+        static inline void sinCos4(float32x4_t x, float32x4_t& s, float32x4_t& c)
+        {
+            uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+            float32x4_t pi = vdupq_n_f32(PI);
+            float32x4_t twoPi = vdupq_n_f32(PIX2);
+
+            // wrap to [-pi, pi], conversion truncates, so floor is computed by hand
+            float32x4_t turns = vmlaq_n_f32(vdupq_n_f32(0.5f), x, 1.0f / PIX2);
+            float32x4_t truncated = vcvtq_f32_s32(vcvtq_s32_f32(turns));
+            truncated = vsubq_f32(truncated, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(truncated, turns), one)));
+            x = vmlsq_n_f32(x, truncated, PIX2);
+
+            float32x4_t xc = vaddq_f32(x, vdupq_n_f32(PI_2));
+            xc = vsubq_f32(xc, vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(xc, pi), vreinterpretq_u32_f32(twoPi))));
+
+            s = sin4(x);
+            c = sin4(xc);
+        }
+#elif OUZEL_SUPPORTS_SSE
+        static inline __m128 abs4(__m128 x)
+        {
+            return _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+        }
+
+        static inline __m128 sin4(__m128 x)
+        {
+            __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_B), x), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(SIN_C), x), abs4(x)));
+            return _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_P), _mm_sub_ps(_mm_mul_ps(y, abs4(y)), y)), y);
+        }
+
+        static inline void sinCos4(__m128 x, __m128& s, __m128& c)
+        {
+            // wrap to [-pi, pi]
+            __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.0f / PIX2))));
+            x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(PIX2)));
+
+            __m128 xc = _mm_add_ps(x, _mm_set1_ps(PI_2));
+            xc = _mm_sub_ps(xc, _mm_and_ps(_mm_cmpgt_ps(xc, _mm_set1_ps(PI)), _mm_set1_ps(PIX2)));
+
+            s = sin4(x);
+            c = sin4(xc);
+        }
+#endif
+
+        // values += deltas * delta, results are clamped to minimum
+        static void integrate(float* values, const float* deltas, float delta, uint32_t count, float minimum = -FLT_MAX)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t minimum4 = vdupq_n_f32(minimum);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t result = vmlaq_n_f32(vld1q_f32(values + i), vld1q_f32(deltas + i), delta);
+                    vst1q_f32(values + i, vmaxq_f32(result, minimum4));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 delta4 = _mm_set1_ps(delta);
+            __m128 minimum4 = _mm_set1_ps(minimum);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 result = _mm_add_ps(_mm_loadu_ps(values + i), _mm_mul_ps(_mm_loadu_ps(deltas + i), delta4));
+                _mm_storeu_ps(values + i, _mm_max_ps(result, minimum4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                values[i] = std::max(values[i] + deltas[i] * delta, minimum);
+            }
+        }
+
+        static void integrateGravity(ParticleData& particles, uint32_t first, uint32_t count, float delta, const Vector2& gravity, float yFlip)
+        {
+            float* positionX = particles.positionX.data() + first;
+            float* positionY = particles.positionY.data() + first;
+            float* directionX = particles.directionX.data() + first;
+            float* directionY = particles.directionY.data() + first;
+            const float* radialAcceleration = particles.radialAcceleration.data() + first;
+            const float* tangentialAcceleration = particles.tangentialAcceleration.data() + first;
+
+            float moveScale = delta * yFlip;
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                float32x4_t gravityX = vdupq_n_f32(gravity.x);
+                float32x4_t gravityY = vdupq_n_f32(gravity.y);
+                float32x4_t zero = vdupq_n_f32(0.0f);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t x = vld1q_f32(positionX + i);
+                    float32x4_t y = vld1q_f32(positionY + i);
+
+                    // normalized position, zero for particles in the origin
+                    float32x4_t lengthSquared = vmlaq_f32(vmulq_f32(x, x), y, y);
+                    float32x4_t invLength = vrsqrteq_f32(lengthSquared);
+                    invLength = vmulq_f32(invLength, vrsqrtsq_f32(vmulq_f32(lengthSquared, invLength), invLength));
+                    uint32x4_t nonZero = vcgtq_f32(lengthSquared, zero);
+                    float32x4_t radialX = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(x, invLength)), nonZero));
+                    float32x4_t radialY = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(vmulq_f32(y, invLength)), nonZero));
+
+                    float32x4_t radial = vld1q_f32(radialAcceleration + i);
+                    float32x4_t tangential = vld1q_f32(tangentialAcceleration + i);
+
+                    // (gravity + radial + tangential) * delta
+                    float32x4_t accelerationX = vmlsq_f32(vmlaq_f32(gravityX, radialX, radial), radialY, tangential);
+                    float32x4_t accelerationY = vmlaq_f32(vmlaq_f32(gravityY, radialY, radial), radialX, tangential);
+
+                    float32x4_t dirX = vmlaq_n_f32(vld1q_f32(directionX + i), accelerationX, delta);
+                    float32x4_t dirY = vmlaq_n_f32(vld1q_f32(directionY + i), accelerationY, delta);
+
+                    vst1q_f32(directionX + i, dirX);
+                    vst1q_f32(directionY + i, dirY);
+                    vst1q_f32(positionX + i, vmlaq_n_f32(x, dirX, moveScale));
+                    vst1q_f32(positionY + i, vmlaq_n_f32(y, dirY, moveScale));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 gravityX = _mm_set1_ps(gravity.x);
+            __m128 gravityY = _mm_set1_ps(gravity.y);
+            __m128 delta4 = _mm_set1_ps(delta);
+            __m128 moveScale4 = _mm_set1_ps(moveScale);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 x = _mm_loadu_ps(positionX + i);
+                __m128 y = _mm_loadu_ps(positionY + i);
+
+                // normalized position, zero for particles in the origin
+                __m128 lengthSquared = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+                __m128 nonZero = _mm_cmpgt_ps(lengthSquared, _mm_setzero_ps());
+                __m128 invLength = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared)), nonZero);
+                __m128 radialX = _mm_mul_ps(x, invLength);
+                __m128 radialY = _mm_mul_ps(y, invLength);
+
+                __m128 radial = _mm_loadu_ps(radialAcceleration + i);
+                __m128 tangential = _mm_loadu_ps(tangentialAcceleration + i);
+
+                // (gravity + radial + tangential) * delta
+                __m128 accelerationX = _mm_sub_ps(_mm_add_ps(gravityX, _mm_mul_ps(radialX, radial)), _mm_mul_ps(radialY, tangential));
+                __m128 accelerationY = _mm_add_ps(_mm_add_ps(gravityY, _mm_mul_ps(radialY, radial)), _mm_mul_ps(radialX, tangential));
+
+                __m128 dirX = _mm_add_ps(_mm_loadu_ps(directionX + i), _mm_mul_ps(accelerationX, delta4));
+                __m128 dirY = _mm_add_ps(_mm_loadu_ps(directionY + i), _mm_mul_ps(accelerationY, delta4));
+
+                _mm_storeu_ps(directionX + i, dirX);
+                _mm_storeu_ps(directionY + i, dirY);
+                _mm_storeu_ps(positionX + i, _mm_add_ps(x, _mm_mul_ps(dirX, moveScale4)));
+                _mm_storeu_ps(positionY + i, _mm_add_ps(y, _mm_mul_ps(dirY, moveScale4)));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                float x = positionX[i];
+                float y = positionY[i];
+
+                float radialX = 0.0f;
+                float radialY = 0.0f;
+                float lengthSquared = x * x + y * y;
+
+                if (lengthSquared > 0.0f)
+                {
+                    float invLength = 1.0f / sqrtf(lengthSquared);
+                    radialX = x * invLength;
+                    radialY = y * invLength;
+                }
+
+                // (gravity + radial + tangential) * delta
+                float accelerationX = gravity.x + radialX * radialAcceleration[i] - radialY * tangentialAcceleration[i];
+                float accelerationY = gravity.y + radialY * radialAcceleration[i] + radialX * tangentialAcceleration[i];
+
+                directionX[i] += accelerationX * delta;
+                directionY[i] += accelerationY * delta;
+                positionX[i] = x + directionX[i] * moveScale;
+                positionY[i] = y + directionY[i] * moveScale;
+            }
+        }
+
+        static void integrateRadius(ParticleData& particles, uint32_t first, uint32_t count, float delta, float yFlip)
+        {
+            integrate(particles.angle.data() + first, particles.degreesPerSecond.data() + first, delta, count);
+            integrate(particles.radius.data() + first, particles.deltaRadius.data() + first, delta, count);
+
+            float* positionX = particles.positionX.data() + first;
+            float* positionY = particles.positionY.data() + first;
+            const float* angle = particles.angle.data() + first;
+            const float* radius = particles.radius.data() + first;
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                for (; i + 4 <= count; i += 4)
+                {
+                    float32x4_t s, c;
+                    sinCos4(vld1q_f32(angle + i), s, c);
+                    float32x4_t r = vnegq_f32(vld1q_f32(radius + i));
+
+                    vst1q_f32(positionX + i, vmulq_f32(c, r));
+                    vst1q_f32(positionY + i, vmulq_n_f32(vmulq_f32(s, r), yFlip));
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            __m128 yFlip4 = _mm_set1_ps(yFlip);
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 s, c;
+                sinCos4(_mm_loadu_ps(angle + i), s, c);
+                __m128 r = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+                _mm_storeu_ps(positionX + i, _mm_mul_ps(c, r));
+                _mm_storeu_ps(positionY + i, _mm_mul_ps(_mm_mul_ps(s, r), yFlip4));
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                float s, c;
+                sinCos(angle[i], s, c);
+
+                positionX[i] = -c * radius[i];
+                positionY[i] = -s * radius[i] * yFlip;
+            }
+        }
+
+        static void reduceMinMax(const float* values, uint32_t count, float& minimum, float& maximum)
+        {
+            minimum = FLT_MAX;
+            maximum = -FLT_MAX;
+
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+            if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+            {
+                if (count >= 4)
+                {
+                    float32x4_t minimum4 = vdupq_n_f32(FLT_MAX);
+                    float32x4_t maximum4 = vdupq_n_f32(-FLT_MAX);
+
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        float32x4_t value = vld1q_f32(values + i);
+                        minimum4 = vminq_f32(minimum4, value);
+                        maximum4 = vmaxq_f32(maximum4, value);
+                    }
+
+                    float32x2_t minimum2 = vpmin_f32(vget_low_f32(minimum4), vget_high_f32(minimum4));
+                    float32x2_t maximum2 = vpmax_f32(vget_low_f32(maximum4), vget_high_f32(maximum4));
+                    minimum = vget_lane_f32(vpmin_f32(minimum2, minimum2), 0);
+                    maximum = vget_lane_f32(vpmax_f32(maximum2, maximum2), 0);
+                }
+            }
+#elif OUZEL_SUPPORTS_SSE
+            if (count >= 4)
+            {
+                __m128 minimum4 = _mm_set1_ps(FLT_MAX);
+                __m128 maximum4 = _mm_set1_ps(-FLT_MAX);
+
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m128 value = _mm_loadu_ps(values + i);
+                    minimum4 = _mm_min_ps(minimum4, value);
+                    maximum4 = _mm_max_ps(maximum4, value);
+                }
+
+                minimum4 = _mm_min_ps(minimum4, _mm_movehl_ps(minimum4, minimum4));
+                minimum4 = _mm_min_ss(minimum4, _mm_shuffle_ps(minimum4, minimum4, _MM_SHUFFLE(1, 1, 1, 1)));
+                maximum4 = _mm_max_ps(maximum4, _mm_movehl_ps(maximum4, maximum4));
+                maximum4 = _mm_max_ss(maximum4, _mm_shuffle_ps(maximum4, maximum4, _MM_SHUFFLE(1, 1, 1, 1)));
+                minimum = _mm_cvtss_f32(minimum4);
+                maximum = _mm_cvtss_f32(maximum4);
+            }
+#endif
+
+            for (; i < count; ++i)
+            {
+                minimum = std::min(minimum, values[i]);
+                maximum = std::max(maximum, values[i]);
+            }
+        }
+
+        void expandParticleQuads(const ParticleData& particles, uint32_t first, uint32_t count, const Vector2& offset, graphics::VertexPCT* vertices)
+        {
+            const float* positionX = particles.positionX.data() + first;
+            const float* positionY = particles.positionY.data() + first;
+            const float* size = particles.size.data() + first;
+            const float* rotation = particles.rotation.data() + first;
+            const float* colorRed = particles.colorRed.data() + first;
+            const float* colorGreen = particles.colorGreen.data() + first;
+            const float* colorBlue = particles.colorBlue.data() + first;
+            const float* colorAlpha = particles.colorAlpha.data() + first;
+            vertices += first * 4;
+
+            // corners of a quad with half size h rotated by angle r are a = (u, -w), b = (w, u), c = -a and d = -b,
+            // where u = h * (sin(r) - cos(r)) and w = h * (sin(r) + cos(r))
+            float u[4];
+            float w[4];
+            float x[4];
+            float y[4];
+
+            uint32_t i = 0;
+            uint32_t batch = 0;
+
+            for (;;)
+            {
+                batch = 0;
+
+#if OUZEL_SUPPORTS_NEON || OUZEL_SUPPORTS_NEON64
+    #if OUZEL_SUPPORTS_NEON_CHECK
+                if (anrdoidNEONChecker.isNEONAvailable())
+    #endif
+                {
+                    if (i + 4 <= count)
+                    {
+                        float32x4_t s, c;
+                        sinCos4(vmulq_n_f32(vld1q_f32(rotation + i), -PI / 180.0f), s, c);
+                        float32x4_t halfSize = vmulq_n_f32(vld1q_f32(size + i), 0.5f);
+
+                        vst1q_f32(u, vmulq_f32(vsubq_f32(s, c), halfSize));
+                        vst1q_f32(w, vmulq_f32(vaddq_f32(s, c), halfSize));
+                        vst1q_f32(x, vaddq_f32(vld1q_f32(positionX + i), vdupq_n_f32(offset.x)));
+                        vst1q_f32(y, vaddq_f32(vld1q_f32(positionY + i), vdupq_n_f32(offset.y)));
+
+                        batch = 4;
+                    }
+                }
+#elif OUZEL_SUPPORTS_SSE
+                if (i + 4 <= count)
+                {
+                    __m128 s, c;
+                    sinCos4(_mm_mul_ps(_mm_loadu_ps(rotation + i), _mm_set1_ps(-PI / 180.0f)), s, c);
+                    __m128 halfSize = _mm_mul_ps(_mm_loadu_ps(size + i), _mm_set1_ps(0.5f));
+
+                    _mm_storeu_ps(u, _mm_mul_ps(_mm_sub_ps(s, c), halfSize));
+                    _mm_storeu_ps(w, _mm_mul_ps(_mm_add_ps(s, c), halfSize));
+                    _mm_storeu_ps(x, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_set1_ps(offset.x)));
+                    _mm_storeu_ps(y, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_set1_ps(offset.y)));
+
+                    batch = 4;
+                }
+#endif
+
+                if (!batch)
+                {
+                    if (i >= count) break;
+
+                    float s, c;
+                    sinCos(-degToRad(rotation[i]), s, c);
+                    float halfSize = size[i] * 0.5f;
+
+                    u[0] = (s - c) * halfSize;
+                    w[0] = (s + c) * halfSize;
+                    x[0] = positionX[i] + offset.x;
+                    y[0] = positionY[i] + offset.y;
+
+                    batch = 1;
+                }
+
+                for (uint32_t j = 0; j < batch; ++j, ++i)
+                {
+                    graphics::Color color(static_cast<uint8_t>(colorRed[i] * 255),
+                                          static_cast<uint8_t>(colorGreen[i] * 255),
+                                          static_cast<uint8_t>(colorBlue[i] * 255),
+                                          static_cast<uint8_t>(colorAlpha[i] * 255));
+
+                    graphics::VertexPCT* quad = vertices + i * 4;
+
+                    quad[0].position.x = x[j] + u[j];
+                    quad[0].position.y = y[j] - w[j];
+                    quad[0].color = color;
+
+                    quad[1].position.x = x[j] + w[j];
+                    quad[1].position.y = y[j] + u[j];
+                    quad[1].color = color;
+
+                    quad[2].position.x = x[j] - w[j];
+                    quad[2].position.y = y[j] - u[j];
+                    quad[2].color = color;
+
+                    quad[3].position.x = x[j] - u[j];
+                    quad[3].position.y = y[j] + w[j];
+                    quad[3].color = color;
+                }
+            }
+        }
+
+        void integrateParticleData(ParticleData& particles, const ParticleDefinition& particleDefinition, uint32_t first, uint32_t count, float delta)
+        {
+            float yFlip = static_cast<float>(particleDefinition.yCoordFlipped);
+
+            for (uint32_t i = first; i < first + count; ++i)
+            {
+                particles.life[i] -= delta;
+            }
+
+            if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
+            {
+                integrateGravity(particles, first, count, delta, particleDefinition.gravity, yFlip);
+            }
+            else
+            {
+                integrateRadius(particles, first, count, delta, yFlip);
+            }
+
+            integrate(particles.colorRed.data() + first, particles.deltaColorRed.data() + first, delta, count);
+            integrate(particles.colorGreen.data() + first, particles.deltaColorGreen.data() + first, delta, count);
+            integrate(particles.colorBlue.data() + first, particles.deltaColorBlue.data() + first, delta, count);
+            integrate(particles.colorAlpha.data() + first, particles.deltaColorAlpha.data() + first, delta, count);
+            integrate(particles.size.data() + first, particles.deltaSize.data() + first, delta, count, 0.0f);
+            integrate(particles.rotation.data() + first, particles.deltaRotation.data() + first, delta, count);
+        }
+
+        void ParticleData::resize(uint32_t newSize)
+        {
+            life.resize(newSize);
+            positionX.resize(newSize);
+            positionY.resize(newSize);
+            colorRed.resize(newSize);
+            colorGreen.resize(newSize);
+            colorBlue.resize(newSize);
+            colorAlpha.resize(newSize);
+            deltaColorRed.resize(newSize);
+            deltaColorGreen.resize(newSize);
+            deltaColorBlue.resize(newSize);
+            deltaColorAlpha.resize(newSize);
+            size.resize(newSize);
+            deltaSize.resize(newSize);
+            rotation.resize(newSize);
+            deltaRotation.resize(newSize);
+            radialAcceleration.resize(newSize);
+            tangentialAcceleration.resize(newSize);
+            directionX.resize(newSize);
+            directionY.resize(newSize);
+            angle.resize(newSize);
+            degreesPerSecond.resize(newSize);
+            radius.resize(newSize);
+            deltaRadius.resize(newSize);
+        }
+
+        void ParticleData::move(uint32_t from, uint32_t to)
+        {
+            life[to] = life[from];
+            positionX[to] = positionX[from];
+            positionY[to] = positionY[from];
+            colorRed[to] = colorRed[from];
+            colorGreen[to] = colorGreen[from];
+            colorBlue[to] = colorBlue[from];
+            colorAlpha[to] = colorAlpha[from];
+            deltaColorRed[to] = deltaColorRed[from];
+            deltaColorGreen[to] = deltaColorGreen[from];
+            deltaColorBlue[to] = deltaColorBlue[from];
+            deltaColorAlpha[to] = deltaColorAlpha[from];
+            size[to] = size[from];
+            deltaSize[to] = deltaSize[from];
+            rotation[to] = rotation[from];
+            deltaRotation[to] = deltaRotation[from];
+            radialAcceleration[to] = radialAcceleration[from];
+            tangentialAcceleration[to] = tangentialAcceleration[from];
+            directionX[to] = directionX[from];
+            directionY[to] = directionY[from];
+            angle[to] = angle[from];
+            degreesPerSecond[to] = degreesPerSecond[from];
+            radius[to] = radius[from];
+            deltaRadius[to] = deltaRadius[from];
+        }
+
         ParticleSystem::ParticleSystem()
         {
             shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
             blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
             whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
 
-            updateCallback.callback = std::bind(&ParticleSystem::update, this, std::placeholders::_1);
+            randomGenerator.setSeed((static_cast<uint64_t>(random()) << 32) | random());
         }
 
         ParticleSystem::ParticleSystem(const std::string& filename):
@@ -35,15 +557,20 @@ namespace ouzel
 
         ParticleSystem::~ParticleSystem()
         {
-            sharedEngine->unscheduleUpdate(updateCallback);
+            if (worldIndex != ParticleWorld::INVALID_INDEX)
+            {
+                sharedEngine->getParticleWorld()->removeParticleSystem(this);
+            }
         }
 
         void ParticleSystem::draw(const Matrix4& projectionMatrix,
                                   const Matrix4& transformMatrix,
                                   const graphics::Color& drawColor,
-                                  const graphics::RenderTargetPtr& renderTarget)
+                                  const graphics::RenderTargetPtr& renderTarget,
+                                  bool scissorTestEnabled,
+                                  const Rectangle& scissorTest)
         {
-            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
             if (particleCount)
             {
@@ -81,16 +608,21 @@ namespace ouzel
                                                             particleCount * 6,
                                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                             0,
-                                                            renderTarget);
+                                                            renderTarget,
+                                                            false,
+                                                            scissorTestEnabled,
+                                                            scissorTest);
             }
         }
 
         void ParticleSystem::drawWireframe(const Matrix4& projectionMatrix,
                                            const Matrix4& transformMatrix,
                                            const graphics::Color& drawColor,
-                                           const graphics::RenderTargetPtr& renderTarget)
+                                           const graphics::RenderTargetPtr& renderTarget,
+                                           bool scissorTestEnabled,
+                                           const Rectangle& scissorTest)
         {
-            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
             if (particleCount)
             {
@@ -123,12 +655,30 @@ namespace ouzel
                                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                             0,
                                                             renderTarget,
-                                                            true);
+                                                            true,
+                                                            scissorTestEnabled,
+                                                            scissorTest);
             }
         }
 
         void ParticleSystem::update(float delta)
         {
+            if (prepareUpdate(delta))
+            {
+                integrateParticles(delta, 0, particleCount);
+                compactParticles();
+                generateVertices(0, particleCount);
+                finishUpdate();
+            }
+        }
+
+        bool ParticleSystem::prepareUpdate(float delta)
+        {
+            if (sleeping)
+            {
+                wakeUp();
+            }
+
             if (running && particleDefinition.emissionRate > 0.0f)
             {
                 float rate = 1.0f / particleDefinition.emissionRate;
@@ -156,112 +706,185 @@ namespace ouzel
             else if (active && !particleCount)
             {
                 active = false;
-                sharedEngine->unscheduleUpdate(updateCallback);
+                sharedEngine->getParticleWorld()->removeParticleSystem(this);
                 if (finishHandler) finishHandler();
             }
 
             if (active)
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
+                meshOffset = Vector2();
+
+                if (node && positionType == ParticleDefinition::PositionType::RELATIVE)
                 {
-                    size_t i = counter - 1;
+                    meshOffset = node->getPosition();
+                }
+            }
 
-                    particles[i].life -= delta;
+            return active;
+        }
 
-                    if (particles[i].life >= 0.0f)
-                    {
-                        if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
-                        {
-                            Vector2 tmp, radial, tangential;
+        void ParticleSystem::integrateParticles(float delta, uint32_t first, uint32_t count)
+        {
+            integrateParticleData(particles, particleDefinition, first, count, delta);
+        }
 
-                            // radial acceleration
-                            if (particles[i].position.x == 0.0f || particles[i].position.y == 0.0f)
-                            {
-                                radial = particles[i].position;
-                                radial.normalize();
-                            }
-                            tangential = radial;
-                            radial.x *= particles[i].radialAcceleration;
-                            radial.y *= particles[i].radialAcceleration;
-
-                            // tangential acceleration
-                            std::swap(tangential.x, tangential.y);
-                            tangential.x *= - particles[i].tangentialAcceleration;
-                            tangential.y *= particles[i].tangentialAcceleration;
-
-                            // (gravity + radial + tangential) * delta
-                            tmp.x = radial.x + tangential.x + particleDefinition.gravity.x;
-                            tmp.y = radial.y + tangential.y + particleDefinition.gravity.y;
-                            tmp.x *= delta;
-                            tmp.y *= delta;
-
-                            particles[i].direction.x += tmp.x;
-                            particles[i].direction.y += tmp.y;
-
-                            // this is cocos2d-x v3.0
-                            // if (configName.length()>0 && yCoordFlipped != -1)
-
-                            // this is cocos2d-x v3.0
-                            tmp.x = particles[i].direction.x * delta * particleDefinition.yCoordFlipped;
-                            tmp.y = particles[i].direction.y * delta * particleDefinition.yCoordFlipped;
-                            particles[i].position.x += tmp.x;
-                            particles[i].position.y += tmp.y;
-                        }
-                        else
-                        {
-                            particles[i].angle += particles[i].degreesPerSecond * delta;
-                            particles[i].radius += particles[i].deltaRadius * delta;
-                            particles[i].position.x = -cosf(particles[i].angle) * particles[i].radius;
-                            particles[i].position.y = -sinf(particles[i].angle) * particles[i].radius * particleDefinition.yCoordFlipped;
-                        }
+        void ParticleSystem::compactParticles()
+        {
+            // dead particles are replaced by the last particle
+            for (uint32_t counter = particleCount; counter > 0; --counter)
+            {
+                uint32_t i = counter - 1;
 
-                        //color r,g,b,a
-                        particles[i].colorRed += particles[i].deltaColorRed * delta;
-                        particles[i].colorGreen += particles[i].deltaColorGreen * delta;
-                        particles[i].colorBlue += particles[i].deltaColorBlue * delta;
-                        particles[i].colorAlpha += particles[i].deltaColorAlpha * delta;
+                if (particles.life[i] < 0.0f)
+                {
+                    particles.move(particleCount - 1, i);
+                    particleCount--;
+                }
+            }
 
-                        //size
-                        particles[i].size += (particles[i].deltaSize * delta);
-                        particles[i].size = std::max(0.0f, particles[i].size);
+            if (particleCount)
+            {
+                float minSize, maxSize;
 
-                        //angle
-                        particles[i].rotation += particles[i].deltaRotation * delta;
-                    }
-                    else
-                    {
-                        particles[i] = particles[particleCount - 1];
-                        particleCount--;
-                    }
+                reduceMinMax(particles.positionX.data(), particleCount, particlesMin.x, particlesMax.x);
+                reduceMinMax(particles.positionY.data(), particleCount, particlesMin.y, particlesMax.y);
+                reduceMinMax(particles.size.data(), particleCount, minSize, maxSize);
+
+                // rotated quads reach up to half of their diagonal from the particle position
+                float extent = maxSize * 0.5f * 1.41421356f;
+
+                particlesMin.x -= extent;
+                particlesMin.y -= extent;
+                particlesMax.x += extent;
+                particlesMax.y += extent;
+            }
+        }
+
+        void ParticleSystem::generateVertices(uint32_t first, uint32_t count)
+        {
+            expandParticleQuads(particles, first, count, meshOffset, vertices.data());
+        }
+
+        void ParticleSystem::finishUpdate()
+        {
+            updateBoundingBox();
+
+            needsMeshUpdate = true;
+
+            markDirty();
+        }
+
+        bool ParticleSystem::isInView(const std::vector<AABB2>& viewBounds) const
+        {
+            if (!node)
+            {
+                return false;
+            }
+
+            AABB2 localBox = boundingBox;
+            localBox.insertPoint(particleDefinition.sourcePosition);
+
+            // transform the center and the half size of the box to world space
+            const Matrix4& transform = node->getTransform();
+
+            Vector3 center((localBox.min.x + localBox.max.x) / 2.0f, (localBox.min.y + localBox.max.y) / 2.0f, 0.0f);
+            Vector2 halfSize = (localBox.max - localBox.min) / 2.0f;
+
+            transform.transformPoint(center);
+
+            float halfWidth = fabsf(halfSize.x * transform.m[0]) + fabsf(halfSize.y * transform.m[4]) + sleepMargin;
+            float halfHeight = fabsf(halfSize.x * transform.m[1]) + fabsf(halfSize.y * transform.m[5]) + sleepMargin;
+
+            AABB2 worldBox(Vector2(center.x - halfWidth, center.y - halfHeight),
+                           Vector2(center.x + halfWidth, center.y + halfHeight));
+
+            for (const AABB2& bounds : viewBounds)
+            {
+                if (worldBox.intersects(bounds))
+                {
+                    return true;
                 }
+            }
 
-                // Update bounding box
-                boundingBox.reset();
+            return false;
+        }
 
-                if (positionType == ParticleDefinition::PositionType::FREE || positionType == ParticleDefinition::PositionType::RELATIVE)
+        // returns false if the system has nothing left to simulate and has to be updated to finish
+        bool ParticleSystem::sleep(float delta)
+        {
+            if (sleepMode == SleepMode::CATCH_UP)
+            {
+                sleepTime += delta;
+
+                // only the emission timeline is advanced, particles are advanced when the system wakes up
+                if (running && particleDefinition.emissionRate > 0.0f)
                 {
-                    if (node)
-                    {
-                        const Matrix4& inverseTransform = node->getInverseTransform();
+                    sleepEmitTime += delta;
 
-                        for (uint32_t i = 0; i < particleCount; i++)
-                        {
-                            Vector3 position = particles[i].position;
-                            inverseTransform.transformPoint(position);
-                            boundingBox.insertPoint(Vector2(position.x, position.y));
-                        }
+                    elapsed += delta;
+                    if (particleDefinition.duration >= 0.0f && particleDefinition.duration < elapsed)
+                    {
+                        finished = true;
+                        stop();
                     }
                 }
-                else if (particleDefinition.positionType == ParticleDefinition::PositionType::GROUPED)
+                else
+                {
+                    sleepStopTime += delta;
+                }
+
+                // every particle has outlived the longest lifespan since the emission stopped
+                if (!running && sleepStopTime >= particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance)
+                {
+                    particleCount = 0;
+                    sleepTime = sleepEmitTime = sleepStopTime = 0.0f;
+                }
+            }
+
+            if (!running && !particleCount)
+            {
+                sleeping = false;
+                return false;
+            }
+
+            sleeping = true;
+            return true;
+        }
+
+        void ParticleSystem::wakeUp()
+        {
+            sleeping = false;
+
+            if (sleepMode == SleepMode::CATCH_UP && sleepTime > 0.0f)
+            {
+                // particles that were alive when the system fell asleep are advanced in one step
+                if (particleCount)
                 {
-                    for (uint32_t i = 0; i < particleCount; i++)
+                    integrateParticles(sleepTime, 0, particleCount);
+                    compactParticles();
+                }
+
+                // only particles emitted within the longest lifespan can still be alive, their ages are spread evenly
+                // over the time they were emitted in
+                float maxLife = particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance;
+                float emitWindow = std::min(sleepStopTime + sleepEmitTime, maxLife) - sleepStopTime;
+
+                if (emitWindow > 0.0f)
+                {
+                    uint32_t first = particleCount;
+                    emitParticles(static_cast<uint32_t>(emitWindow * particleDefinition.emissionRate));
+                    uint32_t count = particleCount - first;
+
+                    for (uint32_t i = 0; i < count; ++i)
                     {
-                        boundingBox.insertPoint(particles[i].position);
+                        integrateParticles(sleepStopTime + emitWindow * (i + 0.5f) / count, first + i, 1);
                     }
-                }
 
-                needsMeshUpdate = true;
+                    compactParticles();
+                }
             }
+
+            sleepTime = sleepEmitTime = sleepStopTime = 0.0f;
         }
 
         bool ParticleSystem::initFromFile(const std::string& filename)
@@ -298,7 +921,7 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    sharedEngine->scheduleUpdate(updateCallback);
+                    sharedEngine->getParticleWorld()->addParticleSystem(this);
                 }
             }
         }
@@ -314,97 +937,90 @@ namespace ouzel
             elapsed = 0.0f;
             particleCount = 0;
             finished = false;
+            sleepTime = sleepEmitTime = sleepStopTime = 0.0f;
         }
 
         bool ParticleSystem::createParticleMesh()
         {
-            indices.reserve(particleDefinition.maxParticles * 6);
+            vertices.clear();
             vertices.reserve(particleDefinition.maxParticles * 4);
 
-            for (uint16_t i = 0; i < particleDefinition.maxParticles; ++i)
+            for (uint32_t i = 0; i < particleDefinition.maxParticles; ++i)
             {
-                indices.push_back(i * 4 + 0);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 2);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 3);
-                indices.push_back(i * 4 + 2);
-
                 vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, -1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(0.0f, 1.0f)));
                 vertices.push_back(graphics::VertexPCT(Vector3(1.0f, -1.0f, 0.0f), graphics::Color(255, 255, 255, 255), Vector2(1.0f, 1.0f)));
                 vertices.push_back(graphics::VertexPCT(Vector3(-1.0f, 1.0f, 0.0f),  graphics::Color(255, 255, 255, 255), Vector2(0.0f, 0.0f)));
                 vertices.push_back(graphics::VertexPCT(Vector3(1.0f, 1.0f, 0.0f),  graphics::Color(255, 255, 255, 255), Vector2(1.0f, 0.0f)));
             }
 
+            // indices come from the shared quad index buffer and vertices are uploaded only for the live particles
+            const graphics::MeshBufferPtr& quadIndexBuffer = sharedEngine->getRenderer()->getQuadIndexBuffer(particleDefinition.maxParticles);
+
             mesh = sharedEngine->getRenderer()->createMeshBuffer();
 
-            mesh->initFromBuffer(indices.data(), sizeof(uint16_t),
-                                 static_cast<uint32_t>(indices.size()), false,
-                                 vertices.data(), graphics::VertexPCT::ATTRIBUTES,
-                                 static_cast<uint32_t>(vertices.size()), true);
+            if (!mesh->initFromBuffer(nullptr, quadIndexBuffer->getIndexSize(), 0, false,
+                                      nullptr, graphics::VertexPCT::ATTRIBUTES, 0, true))
+            {
+                return false;
+            }
+
+            if (!mesh->setIndexBufferSource(quadIndexBuffer))
+            {
+                return false;
+            }
 
             particles.resize(particleDefinition.maxParticles);
 
             return true;
         }
 
+
         bool ParticleSystem::updateParticleMesh()
         {
-            if (node)
+            // vertices are generated while updating
+            if (!mesh->setVertices(vertices.data(), particleCount * 4))
             {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
-                {
-                    size_t i = counter - 1;
-
-                    Vector2 position;
-
-                    if (positionType == ParticleDefinition::PositionType::FREE)
-                    {
-                        position = particles[i].position;
-                    }
-                    else if (positionType == ParticleDefinition::PositionType::RELATIVE)
-                    {
-                        position = node->getPosition() + particles[i].position;
-                    }
-
-                    float size_2 = particles[i].size / 2.0f;
-                    Vector2 v1(-size_2, -size_2);
-                    Vector2 v2(size_2, size_2);
-
-                    float r = -degToRad(particles[i].rotation);
-                    float cr = cosf(r);
-                    float sr = sinf(r);
+                return false;
+            }
 
-                    Vector2 a(v1.x * cr - v1.y * sr, v1.x * sr + v1.y * cr);
-                    Vector2 b(v2.x * cr - v1.y * sr, v2.x * sr + v1.y * cr);
-                    Vector2 c(v2.x * cr - v2.y * sr, v2.x * sr + v2.y * cr);
-                    Vector2 d(v1.x * cr - v2.y * sr, v1.x * sr + v2.y * cr);
+            return true;
+        }
 
-                    graphics::Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                       static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                       static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                       static_cast<uint8_t>(particles[i].colorAlpha * 255));
+        void ParticleSystem::updateBoundingBox()
+        {
+            boundingBox.reset();
 
-                    vertices[i * 4 + 0].position = a + position;
-                    vertices[i * 4 + 0].color = color;
+            if (particleCount)
+            {
+                const Vector2& boxMin = particlesMin;
+                const Vector2& boxMax = particlesMax;
 
-                    vertices[i * 4 + 1].position = b + position;
-                    vertices[i * 4 + 1].color = color;
+                if (positionType == ParticleDefinition::PositionType::FREE || positionType == ParticleDefinition::PositionType::RELATIVE)
+                {
+                    if (node)
+                    {
+                        const Matrix4& inverseTransform = node->getInverseTransform();
 
-                    vertices[i * 4 + 2].position = d + position;
-                    vertices[i * 4 + 2].color = color;
+                        Vector3 corners[4] = {
+                            Vector3(boxMin.x, boxMin.y, 0.0f),
+                            Vector3(boxMax.x, boxMin.y, 0.0f),
+                            Vector3(boxMin.x, boxMax.y, 0.0f),
+                            Vector3(boxMax.x, boxMax.y, 0.0f)
+                        };
 
-                    vertices[i * 4 + 3].position = c + position;
-                    vertices[i * 4 + 3].color = color;
+                        for (Vector3& corner : corners)
+                        {
+                            inverseTransform.transformPoint(corner);
+                            boundingBox.insertPoint(Vector2(corner.x, corner.y));
+                        }
+                    }
                 }
-
-                if (!mesh->setVertices(vertices.data(), static_cast<uint32_t>(vertices.size())))
+                else if (positionType == ParticleDefinition::PositionType::GROUPED)
                 {
-                    return false;
+                    boundingBox.insertPoint(boxMin);
+                    boundingBox.insertPoint(boxMax);
                 }
             }
-
-            return true;
         }
 
         void ParticleSystem::emitParticles(uint32_t count)
@@ -431,69 +1047,61 @@ namespace ouzel
 
                     for (uint32_t i = particleCount; i < particleCount + count; ++i)
                     {
-                        if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
-                        {
-                            particles[i].life = fmaxf(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * randomf(-1.0f, 1.0f), 0.0f);
+                        float life = fmaxf(particleDefinition.particleLifespan + particleDefinition.particleLifespanVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f);
+                        particles.life[i] = life;
 
-                            particles[i].position = particleDefinition.sourcePosition + position + Vector2(particleDefinition.sourcePositionVariance.x * randomf(-1.0f, 1.0f),
-                                                                                                             particleDefinition.sourcePositionVariance.y * randomf(-1.0f, 1.0f));
+                        particles.positionX[i] = particleDefinition.sourcePosition.x + position.x + particleDefinition.sourcePositionVariance.x * randomGenerator.nextFloat(-1.0f, 1.0f);
+                        particles.positionY[i] = particleDefinition.sourcePosition.y + position.y + particleDefinition.sourcePositionVariance.y * randomGenerator.nextFloat(-1.0f, 1.0f);
 
-                            particles[i].size = fmaxf(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * randomf(-1.0f, 1.0f), 0.0f);
+                        particles.size[i] = fmaxf(particleDefinition.startParticleSize + particleDefinition.startParticleSizeVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f);
 
-                            float finishSize = fmaxf(particleDefinition.finishParticleSize + particleDefinition.finishParticleSizeVariance * randomf(-1.0f, 1.0f), 0.0f);
-                            particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
+                        float finishSize = fmaxf(particleDefinition.finishParticleSize + particleDefinition.finishParticleSizeVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f);
+                        particles.deltaSize[i] = (finishSize - particles.size[i]) / life;
 
-                            particles[i].colorRed = clamp(particleDefinition.startColorRed + particleDefinition.startColorRedVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            particles[i].colorGreen = clamp(particleDefinition.startColorGreen + particleDefinition.startColorGreenVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            particles[i].colorBlue = clamp(particleDefinition.startColorBlue + particleDefinition.startColorBlueVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            particles[i].colorAlpha = clamp(particleDefinition.startColorAlpha + particleDefinition.startColorAlphaVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
+                        particles.colorRed[i] = clamp(particleDefinition.startColorRed + particleDefinition.startColorRedVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        particles.colorGreen[i] = clamp(particleDefinition.startColorGreen + particleDefinition.startColorGreenVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        particles.colorBlue[i] = clamp(particleDefinition.startColorBlue + particleDefinition.startColorBlueVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        particles.colorAlpha[i] = clamp(particleDefinition.startColorAlpha + particleDefinition.startColorAlphaVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
 
-                            float finishColorRed = clamp(particleDefinition.finishColorRed + particleDefinition.finishColorRedVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            float finishColorGreen = clamp(particleDefinition.finishColorGreen + particleDefinition.finishColorGreenVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            float finishColorBlue = clamp(particleDefinition.finishColorBlue + particleDefinition.finishColorBlueVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
-                            float finishColorAlpha = clamp(particleDefinition.finishColorAlpha + particleDefinition.finishColorAlphaVariance * randomf(-1.0f, 1.0f), 0.0f, 1.0f);
+                        float finishColorRed = clamp(particleDefinition.finishColorRed + particleDefinition.finishColorRedVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        float finishColorGreen = clamp(particleDefinition.finishColorGreen + particleDefinition.finishColorGreenVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        float finishColorBlue = clamp(particleDefinition.finishColorBlue + particleDefinition.finishColorBlueVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
+                        float finishColorAlpha = clamp(particleDefinition.finishColorAlpha + particleDefinition.finishColorAlphaVariance * randomGenerator.nextFloat(-1.0f, 1.0f), 0.0f, 1.0f);
 
-                            particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                            particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                            particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                            particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
+                        particles.deltaColorRed[i] = (finishColorRed - particles.colorRed[i]) / life;
+                        particles.deltaColorGreen[i] = (finishColorGreen - particles.colorGreen[i]) / life;
+                        particles.deltaColorBlue[i] = (finishColorBlue - particles.colorBlue[i]) / life;
+                        particles.deltaColorAlpha[i] = (finishColorAlpha - particles.colorAlpha[i]) / life;
 
-                            //_particles[i].finishColor = finishColor;
+                        particles.rotation[i] = particleDefinition.startRotation + particleDefinition.startRotationVariance * randomGenerator.nextFloat(-1.0f, 1.0f);
 
-                            particles[i].rotation = particleDefinition.startRotation + particleDefinition.startRotationVariance * randomf(-1.0f, 1.0f);
+                        float finishRotation = particleDefinition.finishRotation + particleDefinition.finishRotationVariance * randomGenerator.nextFloat(-1.0f, 1.0f);
+                        particles.deltaRotation[i] = (finishRotation - particles.rotation[i]) / life;
 
-                            float finishRotation = particleDefinition.finishRotation + particleDefinition.finishRotationVariance * randomf(-1.0f, 1.0f);
-                            particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
+                        if (particleDefinition.emitterType == ParticleDefinition::EmitterType::GRAVITY)
+                        {
+                            particles.radialAcceleration[i] = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * randomGenerator.nextFloat(-1.0f, 1.0f);
+                            particles.tangentialAcceleration[i] = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * randomGenerator.nextFloat(-1.0f, 1.0f);
 
-                            particles[i].radialAcceleration = particleDefinition.radialAcceleration + particleDefinition.radialAcceleration * randomf(-1.0f, 1.0f);
-                            particles[i].tangentialAcceleration = particleDefinition.tangentialAcceleration + particleDefinition.tangentialAcceleration * randomf(-1.0f, 1.0f);
+                            float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * randomGenerator.nextFloat(-1.0f, 1.0f));
+                            float s = particleDefinition.speed + particleDefinition.speedVariance * randomGenerator.nextFloat(-1.0f, 1.0f);
+                            Vector2 dir(cosf(a) * s, sinf(a) * s);
+                            particles.directionX[i] = dir.x;
+                            particles.directionY[i] = dir.y;
 
                             if (particleDefinition.rotationIsDir)
                             {
-                                float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * randomf(-1.0f, 1.0f));
-                                Vector2 v(cosf(a), sinf(a));
-                                float s = particleDefinition.speed + particleDefinition.speedVariance * randomf(-1.0f, 1.0f);
-                                Vector2 dir = v * s;
-                                particles[i].direction = dir;
-                                particles[i].rotation = -radToDeg(dir.getAngle());
-                            }
-                            else
-                            {
-                                float a = degToRad(particleDefinition.angle + particleDefinition.angleVariance * randomf(-1.0f, 1.0f));
-                                Vector2 v(cosf(a), sinf(a));
-                                float s = particleDefinition.speed + particleDefinition.speedVariance * randomf(-1.0f, 1.0f);
-                                Vector2 dir = v * s;
-                                particles[i].direction = dir;
+                                particles.rotation[i] = -radToDeg(dir.getAngle());
                             }
                         }
                         else
                         {
-                            particles[i].radius = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * randomf(-1.0f, 1.0f);
-                            particles[i].angle = degToRad(particleDefinition.angle + particleDefinition.angleVariance * randomf(-1.0f, 1.0f));
-                            particles[i].degreesPerSecond = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * randomf(-1.0f, 1.0f));
+                            particles.radius[i] = particleDefinition.maxRadius + particleDefinition.maxRadiusVariance * randomGenerator.nextFloat(-1.0f, 1.0f);
+                            particles.angle[i] = degToRad(particleDefinition.angle + particleDefinition.angleVariance * randomGenerator.nextFloat(-1.0f, 1.0f));
+                            particles.degreesPerSecond[i] = degToRad(particleDefinition.rotatePerSecond + particleDefinition.rotatePerSecondVariance * randomGenerator.nextFloat(-1.0f, 1.0f));
 
-                            float endRadius = particleDefinition.minRadius + particleDefinition.minRadiusVariance * randomf(-1.0f, 1.0f);
-                            particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
+                            float endRadius = particleDefinition.minRadius + particleDefinition.minRadiusVariance * randomGenerator.nextFloat(-1.0f, 1.0f);
+                            particles.deltaRadius[i] = (endRadius - particles.radius[i]) / life;
                         }
                     }
 
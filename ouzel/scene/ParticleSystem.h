@@ -13,7 +13,8 @@
 #include "math/Vector2.h"
 #include "graphics/Color.h"
 #include "graphics/Vertex.h"
-#include "core/UpdateCallback.h"
+#include "utils/Utils.h"
+#include "scene/ParticleWorld.h"
 
 namespace ouzel
 {
@@ -21,43 +22,63 @@ namespace ouzel
     {
         class SceneManager;
 
-        struct Particle
+        // particle attributes are kept in separate arrays, so that they can be processed four particles at a time
+        struct ParticleData
         {
-            float life = 0.0f;
+            void resize(uint32_t size);
+            void move(uint32_t from, uint32_t to);
 
-            Vector2 position;
+            std::vector<float> life;
 
-            float colorRed = 0.0f;
-            float colorGreen = 0.0f;
-            float colorBlue = 0.0f;
-            float colorAlpha = 0.0f;
+            std::vector<float> positionX;
+            std::vector<float> positionY;
 
-            float deltaColorRed = 0.0f;
-            float deltaColorGreen = 0.0f;
-            float deltaColorBlue = 0.0f;
-            float deltaColorAlpha = 0.0f;
+            std::vector<float> colorRed;
+            std::vector<float> colorGreen;
+            std::vector<float> colorBlue;
+            std::vector<float> colorAlpha;
 
-            float angle = 0.0f;
-            float speed = 0.0f;
+            std::vector<float> deltaColorRed;
+            std::vector<float> deltaColorGreen;
+            std::vector<float> deltaColorBlue;
+            std::vector<float> deltaColorAlpha;
 
-            float size = 0.0f;
-            float deltaSize = 0.0f;
+            std::vector<float> size;
+            std::vector<float> deltaSize;
 
-            float rotation = 0.0f;
-            float deltaRotation = 0.0f;
+            std::vector<float> rotation;
+            std::vector<float> deltaRotation;
 
-            float radialAcceleration = 0.0f;
-            float tangentialAcceleration = 0.0f;
+            // gravity emitter
+            std::vector<float> radialAcceleration;
+            std::vector<float> tangentialAcceleration;
+            std::vector<float> directionX;
+            std::vector<float> directionY;
 
-            Vector2 direction;
-            float radius = 0.0f;
-            float degreesPerSecond = 0.0f;
-            float deltaRadius = 0.0f;
+            // radius emitter
+            std::vector<float> angle;
+            std::vector<float> degreesPerSecond;
+            std::vector<float> radius;
+            std::vector<float> deltaRadius;
         };
 
+        // kernels of the particle simulation, they process four particles at a time with SSE or NEON
+        void integrateParticleData(ParticleData& particles, const ParticleDefinition& particleDefinition, uint32_t first, uint32_t count, float delta);
+        // writes four vertices for every particle, the quad is rotated by the particle's rotation and moved by offset
+        void expandParticleQuads(const ParticleData& particles, uint32_t first, uint32_t count, const Vector2& offset, graphics::VertexPCT* vertices);
+
         class ParticleSystem: public Component
         {
+            friend ParticleWorld;
         public:
+            // what happens to the system while it is outside of the view of all cameras
+            enum class SleepMode
+            {
+                NONE, // always simulated
+                FREEZE, // simulation is paused and continues where it stopped
+                CATCH_UP // simulation is skipped and advanced in one step when the system becomes visible
+            };
+
             ParticleSystem();
             ParticleSystem(const std::string& filename);
             virtual ~ParticleSystem();
@@ -65,13 +86,18 @@ namespace ouzel
             virtual void draw(const Matrix4& projectionMatrix,
                               const Matrix4& transformMatrix,
                               const graphics::Color& drawColor,
-                              const graphics::RenderTargetPtr& renderTarget) override;
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
 
             virtual void drawWireframe(const Matrix4& projectionMatrix,
                                        const Matrix4& transformMatrix,
                                        const graphics::Color& drawColor,
-                                       const graphics::RenderTargetPtr& renderTarget) override;
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest) override;
 
+            // active systems are updated by the ParticleWorld, this simulates the system on the calling thread
             virtual void update(float delta);
 
             virtual bool initFromFile(const std::string& filename);
@@ -88,11 +114,32 @@ namespace ouzel
 
             void setFinishHandler(const std::function<void()>& handler) { finishHandler = handler; }
 
+            void setSleepMode(SleepMode newSleepMode) { sleepMode = newSleepMode; }
+            SleepMode getSleepMode() const { return sleepMode; }
+
+            // distance outside of the view bounds at which the system is still simulated
+            void setSleepMargin(float newSleepMargin) { sleepMargin = newSleepMargin; }
+            float getSleepMargin() const { return sleepMargin; }
+
+            bool isSleeping() const { return sleeping; }
+
         protected:
             bool createParticleMesh();
             bool updateParticleMesh();
 
             void emitParticles(uint32_t count);
+            void updateBoundingBox();
+
+            // update stages, prepareUpdate and finishUpdate run on the update thread, the others can run on any thread
+            bool prepareUpdate(float delta);
+            void integrateParticles(float delta, uint32_t first, uint32_t count);
+            void compactParticles();
+            void generateVertices(uint32_t first, uint32_t count);
+            void finishUpdate();
+
+            bool isInView(const std::vector<AABB2>& viewBounds) const;
+            bool sleep(float delta);
+            void wakeUp();
 
             ParticleDefinition particleDefinition;
             ParticleDefinition::PositionType positionType;
@@ -102,11 +149,11 @@ namespace ouzel
             graphics::TexturePtr texture;
             graphics::TexturePtr whitePixelTexture;
 
-            std::vector<Particle> particles;
+            ParticleData particles;
+            FastRandom randomGenerator;
 
             graphics::MeshBufferPtr mesh;
 
-            std::vector<uint16_t> indices;
             std::vector<graphics::VertexPCT> vertices;
 
             uint32_t particleCount = 0;
@@ -119,7 +166,17 @@ namespace ouzel
 
             bool needsMeshUpdate = false;
 
-            UpdateCallback updateCallback;
+            uint32_t worldIndex = ParticleWorld::INVALID_INDEX;
+            Vector2 meshOffset;
+            Vector2 particlesMin;
+            Vector2 particlesMax;
+
+            SleepMode sleepMode = SleepMode::NONE;
+            float sleepMargin = 0.0f;
+            bool sleeping = false;
+            float sleepTime = 0.0f;
+            float sleepEmitTime = 0.0f;
+            float sleepStopTime = 0.0f;
 
             std::function<void()> finishHandler;
         };
@@ -0,0 +1,282 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include "ParticleWorld.h"
+#include "ParticleSystem.h"
+#include "core/Engine.h"
+#include "SceneManager.h"
+#include "Scene.h"
+#include "Layer.h"
+#include "Camera.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ParticleWorld::ParticleWorld():
+            nextTask(0), finishedTasks(0), busyWorkers(0)
+        {
+            updateCallback.callback = std::bind(&ParticleWorld::update, this, std::placeholders::_1);
+
+            // the update thread works on the tasks too
+            uint32_t cpuCount = std::thread::hardware_concurrency();
+            uint32_t workerCount = cpuCount > 1 ? cpuCount - 1 : 0;
+
+            for (uint32_t i = 0; i < workerCount; ++i)
+            {
+                workers.push_back(std::thread(&ParticleWorld::runWorker, this));
+            }
+        }
+
+        ParticleWorld::~ParticleWorld()
+        {
+            {
+                std::lock_guard<std::mutex> lock(workerMutex);
+                exiting = true;
+            }
+
+            workerCondition.notify_all();
+
+            for (std::thread& worker : workers)
+            {
+                worker.join();
+            }
+
+            for (ParticleSystem* particleSystem : particleSystems)
+            {
+                particleSystem->worldIndex = INVALID_INDEX;
+            }
+
+            sharedEngine->unscheduleUpdate(updateCallback);
+        }
+
+        void ParticleWorld::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            if (particleSystem->worldIndex == INVALID_INDEX)
+            {
+                particleSystem->worldIndex = static_cast<uint32_t>(particleSystems.size());
+                particleSystems.push_back(particleSystem);
+
+                if (particleSystems.size() == 1)
+                {
+                    sharedEngine->scheduleUpdate(updateCallback);
+                }
+            }
+        }
+
+        void ParticleWorld::removeParticleSystem(ParticleSystem* particleSystem)
+        {
+            uint32_t index = particleSystem->worldIndex;
+
+            if (index == INVALID_INDEX)
+            {
+                return;
+            }
+
+            particleSystem->worldIndex = INVALID_INDEX;
+
+            uint32_t last = static_cast<uint32_t>(particleSystems.size() - 1);
+
+            if (index != last)
+            {
+                particleSystems[index] = particleSystems[last];
+                particleSystems[index]->worldIndex = index;
+            }
+
+            particleSystems.pop_back();
+
+            // finish handlers can remove systems in the middle of an update
+            if (updating)
+            {
+                std::replace(updatedSystems.begin(), updatedSystems.end(), particleSystem, static_cast<ParticleSystem*>(nullptr));
+                std::replace(simulatedSystems.begin(), simulatedSystems.end(), particleSystem, static_cast<ParticleSystem*>(nullptr));
+            }
+
+            if (particleSystems.empty())
+            {
+                sharedEngine->unscheduleUpdate(updateCallback);
+            }
+        }
+
+        void ParticleWorld::update(float delta)
+        {
+            updating = true;
+            updatedSystems = particleSystems;
+            simulatedSystems.clear();
+            skippedSystemCount = 0;
+
+            updateViewBounds();
+
+            // emission runs on the update thread, because it reads node transformations and calls finish handlers
+            for (ParticleSystem* particleSystem : updatedSystems)
+            {
+                if (!particleSystem)
+                {
+                    continue;
+                }
+
+                // systems outside of the view keep their mesh and bounding box, so the layer keeps culling them
+                if (particleSystem->sleepMode != ParticleSystem::SleepMode::NONE &&
+                    !viewBounds.empty() &&
+                    !particleSystem->isInView(viewBounds) &&
+                    particleSystem->sleep(delta))
+                {
+                    ++skippedSystemCount;
+                }
+                else if (particleSystem->prepareUpdate(delta))
+                {
+                    simulatedSystems.push_back(particleSystem);
+                }
+            }
+
+            simulatedSystems.erase(std::remove(simulatedSystems.begin(), simulatedSystems.end(), static_cast<ParticleSystem*>(nullptr)),
+                                   simulatedSystems.end());
+
+            updating = false;
+
+            if (!simulatedSystems.empty())
+            {
+                stageDelta = delta;
+
+                runStage(Stage::INTEGRATE);
+                runStage(Stage::COMPACT);
+                runStage(Stage::GENERATE_VERTICES);
+
+                for (ParticleSystem* particleSystem : simulatedSystems)
+                {
+                    particleSystem->finishUpdate();
+                }
+            }
+        }
+
+        void ParticleWorld::updateViewBounds()
+        {
+            viewBounds.clear();
+
+            if (const ScenePtr& scene = sharedEngine->getSceneManager()->getScene())
+            {
+                for (const LayerPtr& layer : scene->getLayers())
+                {
+                    if (const CameraPtr& camera = layer->getCamera())
+                    {
+                        viewBounds.push_back(camera->getViewBounds());
+                    }
+                }
+            }
+        }
+
+        void ParticleWorld::runStage(Stage newStage)
+        {
+            {
+                std::lock_guard<std::mutex> lock(workerMutex);
+
+                // workers join a batch only while holding the mutex, so once they have all left the previous one
+                // nobody can read the task list while it is being rebuilt
+                while (busyWorkers.load(std::memory_order_acquire) > 0)
+                {
+                    std::this_thread::yield();
+                }
+
+                stage = newStage;
+                tasks.clear();
+
+                uint32_t chunkSize = CHUNK_SIZE;
+
+                for (ParticleSystem* particleSystem : simulatedSystems)
+                {
+                    if (stage == Stage::COMPACT)
+                    {
+                        tasks.push_back({ particleSystem, 0, particleSystem->particleCount });
+                    }
+                    else
+                    {
+                        for (uint32_t first = 0; first < particleSystem->particleCount; first += chunkSize)
+                        {
+                            tasks.push_back({ particleSystem, first, std::min(chunkSize, particleSystem->particleCount - first) });
+                        }
+                    }
+                }
+
+                if (tasks.empty())
+                {
+                    return;
+                }
+
+                nextTask = 0;
+                finishedTasks = 0;
+                ++batch;
+            }
+
+            if (!workers.empty() && tasks.size() > 1)
+            {
+                workerCondition.notify_all();
+            }
+
+            runTasks();
+
+            // wait for the tasks that workers are still running
+            while (finishedTasks.load(std::memory_order_acquire) < tasks.size())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void ParticleWorld::runTasks()
+        {
+            uint32_t taskCount = static_cast<uint32_t>(tasks.size());
+
+            for (;;)
+            {
+                uint32_t index = nextTask.fetch_add(1);
+
+                if (index >= taskCount)
+                {
+                    break;
+                }
+
+                const Task& task = tasks[index];
+
+                switch (stage)
+                {
+                    case Stage::INTEGRATE:
+                        task.particleSystem->integrateParticles(stageDelta, task.first, task.count);
+                        break;
+                    case Stage::COMPACT:
+                        task.particleSystem->compactParticles();
+                        break;
+                    case Stage::GENERATE_VERTICES:
+                        task.particleSystem->generateVertices(task.first, task.count);
+                        break;
+                }
+
+                finishedTasks.fetch_add(1, std::memory_order_release);
+            }
+        }
+
+        void ParticleWorld::runWorker()
+        {
+            uint32_t currentBatch = 0;
+
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(workerMutex);
+                    workerCondition.wait(lock, [this, currentBatch] { return exiting || batch != currentBatch; });
+
+                    if (exiting)
+                    {
+                        break;
+                    }
+
+                    currentBatch = batch;
+                    busyWorkers.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                runTasks();
+
+                busyWorkers.fetch_sub(1, std::memory_order_release);
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,96 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+#include "core/UpdateCallback.h"
+#include "math/AABB2.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    namespace scene
+    {
+        class ParticleSystem;
+
+        // Simulates all active particle systems on worker threads. Emission and everything that touches the scene graph
+        // runs on the update thread, integration and vertex generation are split into tasks (one per system, large
+        // systems are split into chunks of CHUNK_SIZE particles) that the workers and the update thread take from a
+        // shared list with an atomic counter. Results are complete when update returns, so draw never waits on a lock.
+        class ParticleWorld: public Noncopyable
+        {
+            friend Engine;
+        public:
+            static const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+            static const uint32_t CHUNK_SIZE = 4096;
+
+            virtual ~ParticleWorld();
+
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(ParticleSystem* particleSystem);
+
+            uint32_t getParticleSystemCount() const { return static_cast<uint32_t>(particleSystems.size()); }
+            uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+            // number of systems that were outside of the view and were not simulated in the last update
+            uint32_t getSkippedSystemCount() const { return skippedSystemCount; }
+
+        protected:
+            ParticleWorld();
+
+            void update(float delta);
+
+            enum class Stage
+            {
+                INTEGRATE,
+                COMPACT,
+                GENERATE_VERTICES
+            };
+
+            struct Task
+            {
+                ParticleSystem* particleSystem;
+                uint32_t first;
+                uint32_t count;
+            };
+
+            void updateViewBounds();
+            void runStage(Stage stage);
+            void runTasks();
+            void runWorker();
+
+            std::vector<ParticleSystem*> particleSystems;
+
+            bool updating = false;
+            std::vector<ParticleSystem*> updatedSystems;
+            std::vector<ParticleSystem*> simulatedSystems;
+
+            std::vector<AABB2> viewBounds;
+            uint32_t skippedSystemCount = 0;
+
+            float stageDelta = 0.0f;
+            Stage stage = Stage::INTEGRATE;
+            std::vector<Task> tasks;
+            std::atomic<uint32_t> nextTask;
+            std::atomic<uint32_t> finishedTasks;
+            std::atomic<uint32_t> busyWorkers;
+
+            std::vector<std::thread> workers;
+            std::mutex workerMutex;
+            std::condition_variable workerCondition;
+            uint32_t batch = 0;
+            bool exiting = false;
+
+            UpdateCallback updateCallback;
+        };
+    } // namespace scene
+} // namespace ouzel
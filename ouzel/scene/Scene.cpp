@@ -14,10 +14,10 @@ namespace ouzel
     {
         Scene::Scene()
         {
-            sharedEngine->getEventDispatcher()->addEventHandler(eventHandler);
             eventHandler.windowHandler = std::bind(&Scene::handleWindow, this, std::placeholders::_1, std::placeholders::_2);
             eventHandler.mouseHandler = std::bind(&Scene::handleMouse, this, std::placeholders::_1, std::placeholders::_2);
             eventHandler.touchHandler = std::bind(&Scene::handleTouch, this, std::placeholders::_1, std::placeholders::_2);
+            sharedEngine->getEventDispatcher()->addEventHandler(eventHandler);
         }
 
         Scene::~Scene()
@@ -250,8 +250,7 @@ namespace ouzel
 
             if (node && node->isReceivingInput())
             {
-                Event event;
-                event.type = Event::Type::UI_ENTER_NODE;
+                Event event(Event::Type::UI_ENTER_NODE);
 
                 event.uiEvent.node = node;
                 event.uiEvent.position = node->convertWorldToLocal(position);
@@ -264,8 +263,7 @@ namespace ouzel
         {
             if (node && node->isReceivingInput())
             {
-                Event event;
-                event.type = Event::Type::UI_LEAVE_NODE;
+                Event event(Event::Type::UI_LEAVE_NODE);
 
                 event.uiEvent.node = node;
                 event.uiEvent.position = node->convertWorldToLocal(position);
@@ -282,8 +280,7 @@ namespace ouzel
 
             if (node && node->isReceivingInput())
             {
-                Event event;
-                event.type = Event::Type::UI_PRESS_NODE;
+                Event event(Event::Type::UI_PRESS_NODE);
 
                 event.uiEvent.node = node;
                 event.uiEvent.position = node->convertWorldToLocal(position);
@@ -298,8 +295,7 @@ namespace ouzel
 
             if (pointerDownOnNode && pointerDownOnNode->isReceivingInput())
             {
-                Event releaseEvent;
-                releaseEvent.type = Event::Type::UI_RELEASE_NODE;
+                Event releaseEvent(Event::Type::UI_RELEASE_NODE);
 
                 releaseEvent.uiEvent.node = pointerDownOnNode;
                 releaseEvent.uiEvent.position = pointerDownOnNode->convertWorldToLocal(position);
@@ -308,8 +304,7 @@ namespace ouzel
 
                 if (pointerDownOnNode == node)
                 {
-                    Event clickEvent;
-                    clickEvent.type = Event::Type::UI_CLICK_NODE;
+                    Event clickEvent(Event::Type::UI_CLICK_NODE);
 
                     clickEvent.uiEvent.node = pointerDownOnNode;
                     clickEvent.uiEvent.position = pointerDownOnNode->convertWorldToLocal(position);
@@ -325,8 +320,7 @@ namespace ouzel
         {
             if (node && node->isReceivingInput())
             {
-                Event event;
-                event.type = Event::Type::UI_DRAG_NODE;
+                Event event(Event::Type::UI_DRAG_NODE);
                 
                 event.uiEvent.node = node;
                 event.uiEvent.position = node->convertWorldToLocal(position);
@@ -29,9 +29,11 @@ namespace ouzel
         void ShapeDrawable::draw(const Matrix4& projectionMatrix,
                                  const Matrix4& transformMatrix,
                                  const graphics::Color& drawColor,
-                                 const graphics::RenderTargetPtr& renderTarget)
+                                 const graphics::RenderTargetPtr& renderTarget,
+                                 bool scissorTestEnabled,
+                                 const Rectangle& scissorTest)
         {
-            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
             meshBuffer->setIndices(indices.data(), static_cast<uint32_t>(indices.size()));
             meshBuffer->setVertices(vertices.data(), static_cast<uint32_t>(vertices.size()));
@@ -56,7 +58,10 @@ namespace ouzel
                                                             drawCommand.indexCount,
                                                             drawCommand.mode,
                                                             drawCommand.startIndex,
-                                                            renderTarget);
+                                                            renderTarget,
+                                                            false,
+                                                            scissorTestEnabled,
+                                                            scissorTest);
             }
         }
 
@@ -67,6 +72,8 @@ namespace ouzel
             drawCommands.clear();
             indices.clear();
             vertices.clear();
+
+            markDirty();
         }
 
         void ShapeDrawable::point(const Vector2& position, const graphics::Color& color)
@@ -85,6 +92,8 @@ namespace ouzel
             drawCommands.push_back(command);
 
             boundingBox.insertPoint(position);
+
+            markDirty();
         }
 
         void ShapeDrawable::line(const Vector2& start, const Vector2& finish, const graphics::Color& color)
@@ -107,6 +116,8 @@ namespace ouzel
 
             boundingBox.insertPoint(start);
             boundingBox.insertPoint(finish);
+
+            markDirty();
         }
 
         void ShapeDrawable::circle(const Vector2& position, float radius, const graphics::Color& color, bool fill, uint32_t segments)
@@ -169,6 +180,8 @@ namespace ouzel
 
             boundingBox.insertPoint(Vector2(position.x - radius, position.y - radius));
             boundingBox.insertPoint(Vector2(position.x + radius, position.y + radius));
+
+            markDirty();
         }
 
         void ShapeDrawable::rectangle(const Rectangle& rectangle, const graphics::Color& color, bool fill)
@@ -210,6 +223,8 @@ namespace ouzel
 
             boundingBox.insertPoint(Vector2(rectangle.x, rectangle.y));
             boundingBox.insertPoint(Vector2(rectangle.x + rectangle.width, rectangle.y + rectangle.height));
+
+            markDirty();
         }
 
         void ShapeDrawable::triangle(const Vector2 (&positions)[3], const graphics::Color& color, bool fill)
@@ -239,6 +254,8 @@ namespace ouzel
             }
 
             drawCommands.push_back(command);
+
+            markDirty();
         }
 
     } // namespace scene
@@ -21,7 +21,9 @@ namespace ouzel
             virtual void draw(const Matrix4& projectionMatrix,
                               const Matrix4& transformMatrix,
                               const graphics::Color& drawColor,
-                              const graphics::RenderTargetPtr& renderTarget) override;
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
 
             void clear();
 
@@ -16,17 +16,31 @@
 #include "files/FileSystem.h"
 #include "Layer.h"
 #include "core/Cache.h"
+#include "SpriteAnimationSystem.h"
 
 namespace ouzel
 {
     namespace scene
     {
+        static const std::string& getBlendStateName(const SpriteClipPtr& clip)
+        {
+            if (clip && !clip->getFrames().empty())
+            {
+                const graphics::TexturePtr& texture = clip->getFrames().front()->getTexture();
+
+                if (texture && texture->isPremultipliedAlpha())
+                {
+                    return graphics::BLEND_PREMULTIPLIED_ALPHA;
+                }
+            }
+
+            return graphics::BLEND_ALPHA;
+        }
+
         Sprite::Sprite()
         {
             shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
             whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
-            
-            updateCallback.callback = std::bind(&Sprite::update, this, std::placeholders::_1);
         }
 
         Sprite::Sprite(const std::vector<SpriteFramePtr>& spriteFrames):
@@ -35,6 +49,12 @@ namespace ouzel
             initFromSpriteFrames(spriteFrames);
         }
 
+        Sprite::Sprite(const SpriteClipPtr& spriteClip):
+            Sprite()
+        {
+            initFromSpriteClip(spriteClip);
+        }
+
         Sprite::Sprite(const std::string& filename, bool mipmaps):
             Sprite()
         {
@@ -43,16 +63,25 @@ namespace ouzel
 
         Sprite::~Sprite()
         {
-            sharedEngine->unscheduleUpdate(updateCallback);
+            if (animationIndex != SpriteAnimationSystem::INVALID_INDEX)
+            {
+                sharedEngine->getSpriteAnimationSystem()->removeSprite(this);
+            }
         }
 
         bool Sprite::initFromSpriteFrames(const std::vector<SpriteFramePtr>& spriteFrames)
         {
-            frames = spriteFrames;
+            return initFromSpriteClip(std::make_shared<SpriteClip>(spriteFrames));
+        }
 
+        bool Sprite::initFromSpriteClip(const SpriteClipPtr& spriteClip)
+        {
+            clip = spriteClip;
+
+            updateAnimation();
             updateBoundingBox();
 
-            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            blendState = sharedEngine->getCache()->getBlendState(getBlendStateName(clip));
 
             if (!blendState)
             {
@@ -64,11 +93,12 @@ namespace ouzel
 
         bool Sprite::initFromFile(const std::string& filename, bool mipmaps)
         {
-            frames = sharedEngine->getCache()->getSpriteFrames(filename, mipmaps);
+            clip = sharedEngine->getCache()->getSpriteClip(filename, mipmaps);
 
+            updateAnimation();
             updateBoundingBox();
 
-            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            blendState = sharedEngine->getCache()->getBlendState(getBlendStateName(clip));
 
             if (!blendState)
             {
@@ -78,66 +108,16 @@ namespace ouzel
             return true;
         }
 
-        void Sprite::update(float delta)
-        {
-            if (playing)
-            {
-                timeSinceLastFrame += delta;
-
-                while (timeSinceLastFrame > fabsf(frameInterval))
-                {
-                    timeSinceLastFrame -= fabsf(frameInterval);
-
-                    if (frameInterval > 0.0f)
-                    {
-                        ++currentFrame;
-
-                        if (currentFrame >= frames.size())
-                        {
-                            if (repeat)
-                            {
-                                currentFrame = 0;
-                            }
-                            else
-                            {
-                                currentFrame = static_cast<uint32_t>(frames.size() - 1);
-                                playing = false;
-                                sharedEngine->unscheduleUpdate(updateCallback);
-                            }
-                        }
-                    }
-                    else if (frameInterval < 0.0f)
-                    {
-                        --currentFrame;
-
-                        if (currentFrame >= frames.size()) // wrap around happened
-                        {
-                            if (repeat)
-                            {
-                                currentFrame = static_cast<uint32_t>(frames.size() - 1);
-                            }
-                            else
-                            {
-                                currentFrame = 0;
-                                playing = false;
-                                sharedEngine->unscheduleUpdate(updateCallback);
-                            }
-                        }
-                    }
-                }
-
-                updateBoundingBox();
-            }
-        }
-
         void Sprite::draw(const Matrix4& projectionMatrix,
                           const Matrix4& transformMatrix,
                           const graphics::Color& drawColor,
-                          const graphics::RenderTargetPtr& renderTarget)
+                          const graphics::RenderTargetPtr& renderTarget,
+                          bool scissorTestEnabled,
+                          const Rectangle& scissorTest)
         {
-            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
-            if (currentFrame < frames.size())
+            if (currentFrame < getFrameCount())
             {
                 Matrix4 modelViewProj = projectionMatrix * transformMatrix * offsetMatrix;
                 float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
@@ -148,27 +128,32 @@ namespace ouzel
                 std::vector<std::vector<float>> vertexShaderConstants(1);
                 vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
 
-                sharedEngine->getRenderer()->addDrawCommand({ frames[currentFrame]->getTexture() },
+                sharedEngine->getRenderer()->addDrawCommand({ clip->getFrames()[currentFrame]->getTexture() },
                                                             shader,
                                                             pixelShaderConstants,
                                                             vertexShaderConstants,
                                                             blendState,
-                                                            frames[currentFrame]->getMeshBuffer(),
+                                                            clip->getFrames()[currentFrame]->getMeshBuffer(),
                                                             0,
                                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                             0,
-                                                            renderTarget);
+                                                            renderTarget,
+                                                            false,
+                                                            scissorTestEnabled,
+                                                            scissorTest);
             }
         }
 
         void Sprite::drawWireframe(const Matrix4& projectionMatrix,
                                    const Matrix4& transformMatrix,
                                    const graphics::Color& drawColor,
-                                   const graphics::RenderTargetPtr& renderTarget)
+                                   const graphics::RenderTargetPtr& renderTarget,
+                                   bool scissorTestEnabled,
+                                   const Rectangle& scissorTest)
         {
-            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
-            if (currentFrame < frames.size())
+            if (currentFrame < getFrameCount())
             {
                 Matrix4 modelViewProj = projectionMatrix * transformMatrix * offsetMatrix;
                 float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
@@ -184,12 +169,14 @@ namespace ouzel
                                                             pixelShaderConstants,
                                                             vertexShaderConstants,
                                                             blendState,
-                                                            frames[currentFrame]->getMeshBuffer(),
+                                                            clip->getFrames()[currentFrame]->getMeshBuffer(),
                                                             0,
                                                             graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                             0,
                                                             renderTarget,
-                                                            true);
+                                                            true,
+                                                            scissorTestEnabled,
+                                                            scissorTest);
             }
         }
 
@@ -204,20 +191,24 @@ namespace ouzel
         {
             if (newFrameInterval == 0.0f)
             {
-                playing = false;
+                stop(false);
                 return;
             }
 
             repeat = pRepeat;
             frameInterval = newFrameInterval;
 
-            if (!playing && frames.size() > 1)
+            if (playing)
+            {
+                updateAnimation();
+            }
+            else if (getFrameCount() > 1)
             {
                 playing = true;
 
                 if (frameInterval > 0.0f)
                 {
-                    if (currentFrame >= frames.size() - 1)
+                    if (currentFrame >= getFrameCount() - 1)
                     {
                         currentFrame = 0;
                         timeSinceLastFrame = 0.0f;
@@ -227,14 +218,14 @@ namespace ouzel
                 {
                     if (currentFrame == 0)
                     {
-                        currentFrame = static_cast<uint32_t>(frames.size() - 1);
+                        currentFrame = getFrameCount() - 1;
                         timeSinceLastFrame = 0.0f;
                     }
                 }
 
                 updateBoundingBox();
 
-                sharedEngine->scheduleUpdate(updateCallback);
+                sharedEngine->getSpriteAnimationSystem()->addSprite(this);
             }
         }
 
@@ -243,7 +234,7 @@ namespace ouzel
             if (playing)
             {
                 playing = false;
-                sharedEngine->unscheduleUpdate(updateCallback);
+                sharedEngine->getSpriteAnimationSystem()->removeSprite(this);
             }
 
             if (resetAnimation)
@@ -254,7 +245,12 @@ namespace ouzel
 
         void Sprite::reset()
         {
-            playing = false;
+            if (playing)
+            {
+                playing = false;
+                sharedEngine->getSpriteAnimationSystem()->removeSprite(this);
+            }
+
             currentFrame = 0;
             timeSinceLastFrame = 0.0f;
 
@@ -265,19 +261,48 @@ namespace ouzel
         {
             currentFrame = frame;
 
-            if (currentFrame >= frames.size())
+            if (currentFrame >= getFrameCount())
             {
-                currentFrame = static_cast<uint32_t>(frames.size() - 1);
+                currentFrame = getFrameCount() - 1;
             }
 
+            updateAnimation();
             updateBoundingBox();
         }
 
+        const std::vector<SpriteFramePtr>& Sprite::getFrames() const
+        {
+            static const std::vector<SpriteFramePtr> EMPTY;
+
+            return clip ? clip->getFrames() : EMPTY;
+        }
+
+        void Sprite::updateAnimation()
+        {
+            if (playing)
+            {
+                if (getFrameCount() > 1)
+                {
+                    if (currentFrame >= getFrameCount())
+                    {
+                        currentFrame = getFrameCount() - 1;
+                    }
+
+                    sharedEngine->getSpriteAnimationSystem()->addSprite(this);
+                }
+                else
+                {
+                    playing = false;
+                    sharedEngine->getSpriteAnimationSystem()->removeSprite(this);
+                }
+            }
+        }
+
         void Sprite::updateBoundingBox()
         {
-            if (currentFrame < frames.size())
+            if (currentFrame < getFrameCount())
             {
-                const SpriteFramePtr& frame = frames[currentFrame];
+                const SpriteFramePtr& frame = clip->getFrames()[currentFrame];
 
                 size.width = frame->getRectangle().width;
                 size.height = frame->getRectangle().height;
@@ -290,6 +315,8 @@ namespace ouzel
                 size.width = size.height = 0.0f;
                 boundingBox.reset();
             }
+
+            markDirty();
         }
     } // namespace scene
 } // namespace ouzel
@@ -9,35 +9,42 @@
 #include "graphics/MeshBuffer.h"
 #include "math/Rectangle.h"
 #include "scene/SpriteFrame.h"
-#include "core/UpdateCallback.h"
+#include "scene/SpriteClip.h"
 
 namespace ouzel
 {
     namespace scene
     {
         class SceneManager;
+        class SpriteAnimationSystem;
 
         class Sprite: public Component
         {
+            friend SpriteAnimationSystem;
         public:
             Sprite();
             Sprite(const std::vector<SpriteFramePtr>& spriteFrames);
+            Sprite(const SpriteClipPtr& spriteClip);
             Sprite(const std::string& filename, bool mipmaps = true);
             virtual ~Sprite();
 
             virtual bool initFromSpriteFrames(const std::vector<SpriteFramePtr>& spriteFrames);
+            virtual bool initFromSpriteClip(const SpriteClipPtr& spriteClip);
             virtual bool initFromFile(const std::string& filename, bool mipmaps = true);
 
-            virtual void update(float delta);
             virtual void draw(const Matrix4& projectionMatrix,
                               const Matrix4& transformMatrix,
                               const graphics::Color& drawColor,
-                              const graphics::RenderTargetPtr& renderTarget) override;
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
 
             virtual void drawWireframe(const Matrix4& projectionMatrix,
                                        const Matrix4& transformMatrix,
                                        const graphics::Color& drawColor,
-                                       const graphics::RenderTargetPtr& renderTarget) override;
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest) override;
 
             virtual const graphics::ShaderPtr& getShader() const { return shader; }
             virtual void setShader(const graphics::ShaderPtr& newShader) { shader = newShader; }
@@ -55,11 +62,14 @@ namespace ouzel
             virtual void reset();
             virtual bool isPlaying() const { return playing; }
 
-            const std::vector<SpriteFramePtr>& getFrames() const { return frames; }
+            const SpriteClipPtr& getClip() const { return clip; }
+            const std::vector<SpriteFramePtr>& getFrames() const;
+            uint32_t getFrameCount() const { return clip ? clip->getFrameCount() : 0; }
             virtual void setCurrentFrame(uint32_t frame);
 
         protected:
             void updateBoundingBox();
+            void updateAnimation();
 
             graphics::ShaderPtr shader;
             graphics::BlendStatePtr blendState;
@@ -69,7 +79,7 @@ namespace ouzel
             Vector2 offset;
             Matrix4 offsetMatrix = Matrix4::IDENTITY;
 
-            std::vector<SpriteFramePtr> frames;
+            SpriteClipPtr clip;
 
             uint32_t currentFrame = 0;
             float frameInterval = 0.0f;
@@ -77,7 +87,7 @@ namespace ouzel
             bool repeat = false;
             float timeSinceLastFrame = 0.0f;
 
-            UpdateCallback updateCallback;
+            uint32_t animationIndex = 0xFFFFFFFF;
         };
     } // namespace scene
 } // namespace ouzel
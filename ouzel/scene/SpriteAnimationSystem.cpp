@@ -0,0 +1,187 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cmath>
+#include "SpriteAnimationSystem.h"
+#include "Sprite.h"
+#include "core/Engine.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        SpriteAnimationSystem::SpriteAnimationSystem()
+        {
+            updateCallback.callback = std::bind(&SpriteAnimationSystem::update, this, std::placeholders::_1);
+        }
+
+        SpriteAnimationSystem::~SpriteAnimationSystem()
+        {
+            for (Sprite* sprite : sprites)
+            {
+                sprite->animationIndex = INVALID_INDEX;
+            }
+
+            sharedEngine->unscheduleUpdate(updateCallback);
+        }
+
+        void SpriteAnimationSystem::addSprite(Sprite* sprite)
+        {
+            uint32_t index = sprite->animationIndex;
+
+            if (index == INVALID_INDEX)
+            {
+                index = static_cast<uint32_t>(sprites.size());
+                sprite->animationIndex = index;
+
+                sprites.push_back(sprite);
+                times.push_back(0.0f);
+                intervals.push_back(0.0f);
+                frames.push_back(0);
+                frameCounts.push_back(0);
+                steps.push_back(0);
+                reverse.push_back(0);
+                repeat.push_back(0);
+
+                if (sprites.size() == 1)
+                {
+                    sharedEngine->scheduleUpdate(updateCallback);
+                }
+            }
+
+            times[index] = sprite->timeSinceLastFrame;
+            intervals[index] = fabsf(sprite->frameInterval);
+            frames[index] = sprite->currentFrame;
+            frameCounts[index] = sprite->getFrameCount();
+            reverse[index] = sprite->frameInterval < 0.0f ? 1 : 0;
+            repeat[index] = sprite->repeat ? 1 : 0;
+        }
+
+        void SpriteAnimationSystem::removeSprite(Sprite* sprite)
+        {
+            uint32_t index = sprite->animationIndex;
+
+            if (index != INVALID_INDEX)
+            {
+                sprite->timeSinceLastFrame = times[index];
+                removeAnimation(index);
+            }
+        }
+
+        void SpriteAnimationSystem::removeAnimation(uint32_t index)
+        {
+            sprites[index]->animationIndex = INVALID_INDEX;
+
+            uint32_t last = static_cast<uint32_t>(sprites.size() - 1);
+
+            if (index != last)
+            {
+                sprites[index] = sprites[last];
+                sprites[index]->animationIndex = index;
+
+                times[index] = times[last];
+                intervals[index] = intervals[last];
+                frames[index] = frames[last];
+                frameCounts[index] = frameCounts[last];
+                steps[index] = steps[last];
+                reverse[index] = reverse[last];
+                repeat[index] = repeat[last];
+            }
+
+            sprites.pop_back();
+            times.pop_back();
+            intervals.pop_back();
+            frames.pop_back();
+            frameCounts.pop_back();
+            steps.pop_back();
+            reverse.pop_back();
+            repeat.pop_back();
+
+            if (sprites.empty())
+            {
+                sharedEngine->unscheduleUpdate(updateCallback);
+            }
+        }
+
+        void SpriteAnimationSystem::update(float delta)
+        {
+            uint32_t count = static_cast<uint32_t>(sprites.size());
+
+            // branch-free pass that works out how many frames every animation has to advance
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                float time = times[i] + delta;
+                float frameSteps = floorf(time / intervals[i]);
+
+                times[i] = time - frameSteps * intervals[i];
+                steps[i] = static_cast<uint32_t>(frameSteps);
+            }
+
+            // iterate backwards, so that finished animations can be swapped out with already processed ones
+            for (uint32_t i = count; i-- > 0;)
+            {
+                if (steps[i] == 0)
+                {
+                    continue;
+                }
+
+                uint32_t frame = frames[i];
+                uint32_t frameCount = frameCounts[i];
+                bool finished = false;
+
+                if (!reverse[i])
+                {
+                    if (steps[i] >= frameCount - frame)
+                    {
+                        if (repeat[i])
+                        {
+                            frame = static_cast<uint32_t>((static_cast<uint64_t>(frame) + steps[i]) % frameCount);
+                        }
+                        else
+                        {
+                            frame = frameCount - 1;
+                            finished = true;
+                        }
+                    }
+                    else
+                    {
+                        frame += steps[i];
+                    }
+                }
+                else
+                {
+                    if (steps[i] > frame)
+                    {
+                        if (repeat[i])
+                        {
+                            frame = (frame + frameCount - steps[i] % frameCount) % frameCount;
+                        }
+                        else
+                        {
+                            frame = 0;
+                            finished = true;
+                        }
+                    }
+                    else
+                    {
+                        frame -= steps[i];
+                    }
+                }
+
+                frames[i] = frame;
+
+                Sprite* sprite = sprites[i];
+                sprite->currentFrame = frame;
+
+                if (finished)
+                {
+                    sprite->playing = false;
+                    sprite->timeSinceLastFrame = times[i];
+                    removeAnimation(i);
+                }
+
+                sprite->updateBoundingBox();
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
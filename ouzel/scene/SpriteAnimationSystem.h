@@ -0,0 +1,52 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+#include "core/UpdateCallback.h"
+
+namespace ouzel
+{
+    class Engine;
+
+    namespace scene
+    {
+        class Sprite;
+
+        // advances all playing sprite animations in one pass over flat arrays
+        class SpriteAnimationSystem: public Noncopyable
+        {
+            friend Engine;
+        public:
+            static const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+            virtual ~SpriteAnimationSystem();
+
+            void addSprite(Sprite* sprite);
+            void removeSprite(Sprite* sprite);
+
+            uint32_t getAnimationCount() const { return static_cast<uint32_t>(sprites.size()); }
+
+        protected:
+            SpriteAnimationSystem();
+
+            void update(float delta);
+            void removeAnimation(uint32_t index);
+
+            std::vector<Sprite*> sprites;
+            std::vector<float> times;
+            std::vector<float> intervals;
+            std::vector<uint32_t> frames;
+            std::vector<uint32_t> frameCounts;
+            std::vector<uint32_t> steps;
+            std::vector<uint8_t> reverse;
+            std::vector<uint8_t> repeat;
+
+            UpdateCallback updateCallback;
+        };
+    } // namespace scene
+} // namespace ouzel
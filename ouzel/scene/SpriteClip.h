@@ -0,0 +1,29 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "utils/Types.h"
+#include "utils/Noncopyable.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // immutable frame sequence shared by all sprites that play it
+        class SpriteClip: public Noncopyable
+        {
+        public:
+            SpriteClip() {}
+            SpriteClip(const std::vector<SpriteFramePtr>& pFrames): frames(pFrames) {}
+
+            const std::vector<SpriteFramePtr>& getFrames() const { return frames; }
+            uint32_t getFrameCount() const { return static_cast<uint32_t>(frames.size()); }
+
+        protected:
+            std::vector<SpriteFramePtr> frames;
+        };
+    } // namespace scene
+} // namespace ouzel
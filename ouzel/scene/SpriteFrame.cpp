@@ -1,6 +1,7 @@
 // Copyright (C) 2016 Elviss Strazdins
 // This file is part of the Ouzel engine.
 
+#include <cstring>
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/memorystream.h>
 #include <rapidjson/document.h>
@@ -17,17 +18,172 @@ namespace ouzel
 {
     namespace scene
     {
+        static const size_t COOKED_HEADER_SIZE = 14;
+        // flags and ten floats
+        static const size_t COOKED_FRAME_SIZE = 44;
+
+        // positions and texture coordinates are in pixels
+        static SpriteFramePtr createMeshFrame(const graphics::TexturePtr& texture,
+                                              const std::vector<uint16_t>& indices,
+                                              const std::vector<Vector2>& positions,
+                                              const std::vector<Vector2>& textureCoordinates,
+                                              const Rectangle& frameRectangle,
+                                              const Size2& sourceSize,
+                                              const Vector2& sourceOffset,
+                                              const Vector2& pivot)
+        {
+            std::vector<graphics::VertexPCT> vertices;
+            vertices.reserve(positions.size());
+
+            const Size2& textureSize = texture->getSize();
+
+            Vector2 finalOffset(-sourceSize.width * pivot.x + sourceOffset.x,
+                                -sourceSize.height * pivot.y + (sourceSize.height - frameRectangle.height - sourceOffset.y));
+
+            for (size_t i = 0; i < positions.size() && i < textureCoordinates.size(); ++i)
+            {
+                vertices.push_back(graphics::VertexPCT(Vector3(positions[i].x + finalOffset.x,
+                                                               -positions[i].y - finalOffset.y,
+                                                               0.0f),
+                                                       graphics::Color(255, 255, 255, 255),
+                                                       Vector2(textureCoordinates[i].x / textureSize.width,
+                                                               textureCoordinates[i].y / textureSize.height)));
+            }
+
+            return std::make_shared<SpriteFrame>(texture, indices, vertices, frameRectangle, sourceSize, sourceOffset, pivot);
+        }
+
+        static std::vector<SpriteFramePtr> loadCookedSpriteFrames(const std::string& filename, const FileView& data, bool mipmaps)
+        {
+            std::vector<SpriteFramePtr> frames;
+
+            const uint8_t* buffer = data.getData();
+            size_t size = data.getSize();
+            size_t offset = COOKED_HEADER_SIZE;
+
+            uint32_t version = readUInt32Little(buffer + 4);
+
+            if (version != SpriteFrame::COOKED_VERSION)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load %s, unsupported version %u", filename.c_str(), version);
+                return frames;
+            }
+
+            uint32_t frameCount = readUInt32Little(buffer + 8);
+            uint16_t textureFilenameLength = readUInt16Little(buffer + 12);
+
+            if (offset + textureFilenameLength > size)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                return frames;
+            }
+
+            std::string textureFilename(reinterpret_cast<const char*>(buffer + offset), textureFilenameLength);
+            offset += textureFilenameLength;
+
+            graphics::TexturePtr texture = sharedEngine->getCache()->getTexture(textureFilename, false, mipmaps);
+
+            if (!texture)
+            {
+                return frames;
+            }
+
+            std::vector<SpriteFramePtr> result;
+            result.reserve(frameCount);
+
+            for (uint32_t frame = 0; frame < frameCount; ++frame)
+            {
+                if (offset + COOKED_FRAME_SIZE > size)
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                    return frames;
+                }
+
+                uint32_t flags = readUInt32Little(buffer + offset);
+                const uint8_t* values = buffer + offset + 4;
+                offset += COOKED_FRAME_SIZE;
+
+                Rectangle frameRectangle(readFloatLittle(values), readFloatLittle(values + 4),
+                                         readFloatLittle(values + 8), readFloatLittle(values + 12));
+                Size2 sourceSize(readFloatLittle(values + 16), readFloatLittle(values + 20));
+                Vector2 sourceOffset(readFloatLittle(values + 24), readFloatLittle(values + 28));
+                Vector2 pivot(readFloatLittle(values + 32), readFloatLittle(values + 36));
+
+                if (flags & SpriteFrame::COOKED_MESH)
+                {
+                    if (offset + 4 > size)
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                        return frames;
+                    }
+
+                    uint32_t indexCount = readUInt32Little(buffer + offset);
+                    offset += 4;
+
+                    // the indices are followed by the vertex count
+                    if (offset + static_cast<uint64_t>(indexCount) * 2 + 4 > size)
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                        return frames;
+                    }
+
+                    std::vector<uint16_t> indices(indexCount);
+
+                    for (uint16_t& index : indices)
+                    {
+                        index = readUInt16Little(buffer + offset);
+                        offset += 2;
+                    }
+
+                    uint32_t vertexCount = readUInt32Little(buffer + offset);
+                    offset += 4;
+
+                    if (offset + static_cast<uint64_t>(vertexCount) * 16 > size)
+                    {
+                        log(LOG_LEVEL_ERROR, "Failed to load %s, file is too short", filename.c_str());
+                        return frames;
+                    }
+
+                    std::vector<Vector2> positions(vertexCount);
+                    std::vector<Vector2> textureCoordinates(vertexCount);
+
+                    for (uint32_t i = 0; i < vertexCount; ++i, offset += 16)
+                    {
+                        positions[i] = Vector2(readFloatLittle(buffer + offset), readFloatLittle(buffer + offset + 4));
+                        textureCoordinates[i] = Vector2(readFloatLittle(buffer + offset + 8), readFloatLittle(buffer + offset + 12));
+                    }
+
+                    result.push_back(createMeshFrame(texture, indices, positions, textureCoordinates,
+                                                     frameRectangle, sourceSize, sourceOffset, pivot));
+                }
+                else
+                {
+                    result.push_back(std::make_shared<SpriteFrame>(texture, frameRectangle, (flags & SpriteFrame::COOKED_ROTATED) != 0,
+                                                                   sourceSize, sourceOffset, pivot));
+                }
+            }
+
+            frames.swap(result);
+
+            return frames;
+        }
+
         std::vector<SpriteFramePtr> SpriteFrame::loadSpriteFrames(const std::string& filename, bool mipmaps)
         {
             std::vector<SpriteFramePtr> frames;
 
-            std::vector<uint8_t> data;
-            if (!sharedApplication->getFileSystem()->loadFile(filename, data))
+            FileView data;
+            if (!sharedApplication->getFileSystem()->mapFile(filename, data))
             {
                 return frames;
             }
 
-            rapidjson::MemoryStream is(reinterpret_cast<char*>(data.data()), data.size());
+            if (data.getSize() >= COOKED_HEADER_SIZE && memcmp(data.getData(), "OSPR", 4) == 0)
+            {
+                return loadCookedSpriteFrames(filename, data, mipmaps);
+            }
+
+            rapidjson::MemoryStream is(reinterpret_cast<const char*>(data.getData()), data.getSize());
 
             rapidjson::Document document;
             document.ParseStream<0>(is);
@@ -94,30 +250,25 @@ namespace ouzel
                         }
                     }
 
-                    std::vector<graphics::VertexPCT> vertices;
+                    std::vector<Vector2> positions;
+                    std::vector<Vector2> textureCoordinates;
 
                     const rapidjson::Value& verticesObject = frameObject["vertices"];
                     const rapidjson::Value& verticesUVObject = frameObject["verticesUV"];
 
-                    const Size2& textureSize = texture->getSize();
-
-                    Vector2 finalOffset(-sourceSize.width * pivot.x + sourceOffset.x,
-                                        -sourceSize.height * pivot.y + (sourceSize.height - frameRectangle.height - sourceOffset.y));
-
                     for (rapidjson::SizeType vertexIndex = 0; vertexIndex < verticesObject.Size(); ++vertexIndex)
                     {
                         const rapidjson::Value& vertexObject = verticesObject[vertexIndex];
                         const rapidjson::Value& vertexUVObject = verticesUVObject[vertexIndex];
 
-                        vertices.push_back(graphics::VertexPCT(Vector3(static_cast<float>(vertexObject[0].GetInt()) + finalOffset.x,
-                                                                       -static_cast<float>(vertexObject[1].GetInt()) - finalOffset.y,
-                                                                       0.0f),
-                                                               graphics::Color(255, 255, 255, 255),
-                                                               Vector2(static_cast<float>(vertexUVObject[0].GetInt()) / textureSize.width,
-                                                                       static_cast<float>(vertexUVObject[1].GetInt()) / textureSize.height)));
+                        positions.push_back(Vector2(static_cast<float>(vertexObject[0].GetInt()),
+                                                    static_cast<float>(vertexObject[1].GetInt())));
+                        textureCoordinates.push_back(Vector2(static_cast<float>(vertexUVObject[0].GetInt()),
+                                                             static_cast<float>(vertexUVObject[1].GetInt())));
                     }
 
-                    frames.push_back(std::make_shared<SpriteFrame>(texture, indices, vertices, frameRectangle, sourceSize, sourceOffset, pivot));
+                    frames.push_back(createMeshFrame(texture, indices, positions, textureCoordinates,
+                                                     frameRectangle, sourceSize, sourceOffset, pivot));
                 }
                 else
                 {
@@ -18,6 +18,15 @@ namespace ouzel
         class SpriteFrame: public Noncopyable
         {
         public:
+            // sprite sheets written by the cooker tool start with "OSPR", version, frame count and the length and name
+            // of the texture, followed by the frames: flags, rectangle, source size, source offset and pivot (floats)
+            // and for mesh frames the count and the 16-bit indices and the count and the positions and texture
+            // coordinates of the vertices in pixels (floats), all the values are little-endian
+            static const uint32_t COOKED_VERSION = 1;
+            static const uint32_t COOKED_ROTATED = 0x01;
+            static const uint32_t COOKED_MESH = 0x02;
+
+            // loads TexturePacker JSON or cooked sprite sheets
             static std::vector<SpriteFramePtr> loadSpriteFrames(const std::string& filename, bool mipmaps = true);
 
             SpriteFrame(const graphics::TexturePtr& pTexture,
@@ -0,0 +1,290 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include "TextBatch.h"
+#include "core/Engine.h"
+#include "graphics/Renderer.h"
+#include "graphics/MeshBuffer.h"
+#include "core/Cache.h"
+#include "gui/Font.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        TextBatch::TextBatch(const std::string& fontFile)
+        {
+            shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+
+            const graphics::MeshBufferPtr& quadIndexBuffer = sharedEngine->getRenderer()->getQuadIndexBuffer(0);
+
+            meshBuffer = sharedEngine->getRenderer()->createMeshBuffer();
+            meshBuffer->initFromBuffer(nullptr, quadIndexBuffer->getIndexSize(), 0, false,
+                                       nullptr, graphics::VertexPCT::ATTRIBUTES, 0, true);
+            meshBuffer->setIndexBufferSource(quadIndexBuffer);
+
+            font = sharedEngine->getCache()->getFont(fontFile);
+        }
+
+        TextBatch::~TextBatch()
+        {
+        }
+
+        uint32_t TextBatch::addText(const std::string& text, const Vector2& position,
+                                    const Vector2& anchor, const graphics::Color& color)
+        {
+            uint32_t index;
+
+            if (!freeEntries.empty())
+            {
+                index = freeEntries.back();
+                freeEntries.pop_back();
+            }
+            else
+            {
+                index = static_cast<uint32_t>(entries.size());
+                entries.push_back(Entry());
+            }
+
+            Entry& entry = entries[index];
+            entry.used = true;
+            entry.position = position;
+            entry.anchor = anchor;
+            entry.layout.setFont(font);
+            entry.layout.setColor(color);
+            entry.layout.setText(text);
+
+            updateEntry(entry);
+
+            return index;
+        }
+
+        void TextBatch::removeText(uint32_t index)
+        {
+            Entry& entry = entries[index];
+
+            if (entry.used)
+            {
+                // the entry keeps its buffers for the next text that is added
+                entry.used = false;
+                entry.layout.setText("");
+                freeEntries.push_back(index);
+
+                updateEntry(entry);
+            }
+        }
+
+        void TextBatch::setText(uint32_t index, const std::string& text)
+        {
+            Entry& entry = entries[index];
+
+            if (entry.used && text != entry.layout.getText())
+            {
+                entry.layout.setText(text);
+
+                updateEntry(entry);
+            }
+        }
+
+        void TextBatch::setPosition(uint32_t index, const Vector2& position)
+        {
+            Entry& entry = entries[index];
+            entry.position = position;
+
+            updateEntry(entry);
+        }
+
+        void TextBatch::setAnchor(uint32_t index, const Vector2& anchor)
+        {
+            Entry& entry = entries[index];
+            entry.anchor = anchor;
+
+            updateEntry(entry);
+        }
+
+        void TextBatch::setColor(uint32_t index, const graphics::Color& color)
+        {
+            Entry& entry = entries[index];
+            entry.layout.setColor(color);
+
+            updateEntry(entry);
+        }
+
+        void TextBatch::draw(const Matrix4& projectionMatrix,
+                             const Matrix4& transformMatrix,
+                             const graphics::Color& drawColor,
+                             const graphics::RenderTargetPtr& renderTarget,
+                             bool scissorTestEnabled,
+                             const Rectangle& scissorTest)
+        {
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
+
+            if (needsVertexUpdate)
+            {
+                updateVertices();
+            }
+
+            if (needsMeshUpdate)
+            {
+                if (quadCount)
+                {
+                    sharedEngine->getRenderer()->getQuadIndexBuffer(quadCount);
+
+                    meshBuffer->setVertices(vertices.data(), quadCount * 4);
+                }
+
+                needsMeshUpdate = false;
+            }
+
+            if (!quadCount)
+            {
+                return;
+            }
+
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+            float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = { std::begin(colorVector), std::end(colorVector) };
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
+
+            sharedEngine->getRenderer()->addDrawCommand({ font->getTexture() },
+                                                        shader,
+                                                        pixelShaderConstants,
+                                                        vertexShaderConstants,
+                                                        blendState,
+                                                        meshBuffer,
+                                                        quadCount * 6,
+                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                        0,
+                                                        renderTarget,
+                                                        false,
+                                                        scissorTestEnabled,
+                                                        scissorTest);
+        }
+
+        void TextBatch::drawWireframe(const Matrix4& projectionMatrix,
+                                      const Matrix4& transformMatrix,
+                                      const graphics::Color& drawColor,
+                                      const graphics::RenderTargetPtr& renderTarget,
+                                      bool scissorTestEnabled,
+                                      const Rectangle& scissorTest)
+        {
+            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
+
+            if (!quadCount)
+            {
+                return;
+            }
+
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+            float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = { std::begin(colorVector), std::end(colorVector) };
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
+
+            sharedEngine->getRenderer()->addDrawCommand({ whitePixelTexture },
+                                                        shader,
+                                                        pixelShaderConstants,
+                                                        vertexShaderConstants,
+                                                        blendState,
+                                                        meshBuffer,
+                                                        quadCount * 6,
+                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                        0,
+                                                        renderTarget,
+                                                        false,
+                                                        scissorTestEnabled,
+                                                        scissorTest);
+        }
+
+        // bounds are updated right away, because layers cull components before drawing them, the mesh is built in draw
+        void TextBatch::updateEntry(Entry& entry)
+        {
+            entry.bounds.reset();
+
+            if (entry.used)
+            {
+                Vector2 offset(entry.position.x - entry.layout.getWidth() * entry.anchor.x,
+                               entry.position.y - entry.layout.getHeight() * entry.anchor.y);
+
+                for (const graphics::VertexPCT& vertex : entry.layout.getVertices())
+                {
+                    entry.bounds.insertPoint(Vector2(vertex.position.x + offset.x, vertex.position.y + offset.y));
+                }
+            }
+
+            boundingBox.reset();
+
+            for (const Entry& currentEntry : entries)
+            {
+                if (currentEntry.used && !currentEntry.bounds.isEmpty())
+                {
+                    boundingBox.merge(currentEntry.bounds);
+                }
+            }
+
+            needsVertexUpdate = true;
+
+            markDirty();
+        }
+
+        void TextBatch::updateVertices()
+        {
+            uint32_t quad = 0;
+
+            for (Entry& entry : entries)
+            {
+                const std::vector<graphics::VertexPCT>& entryVertices = entry.layout.getVertices();
+                uint32_t entryQuadCount = entry.layout.getQuadCount();
+                uint32_t firstChangedQuad = entry.layout.getFirstChangedQuad();
+
+                // the anchor depends on the width, so a longer or shorter text moves all of its glyphs
+                Vector2 offset(entry.position.x - entry.layout.getWidth() * entry.anchor.x,
+                               entry.position.y - entry.layout.getHeight() * entry.anchor.y);
+
+                // all glyphs are copied if the text moved on the screen or within the mesh
+                if (entry.firstQuad != quad || offset != entry.meshOffset)
+                {
+                    firstChangedQuad = 0;
+                }
+
+                if (firstChangedQuad < entryQuadCount)
+                {
+                    if (vertices.size() < (quad + entryQuadCount) * 4)
+                    {
+                        vertices.resize((quad + entryQuadCount) * 4);
+                    }
+
+                    for (uint32_t i = firstChangedQuad * 4; i < entryQuadCount * 4; ++i)
+                    {
+                        graphics::VertexPCT& vertex = vertices[quad * 4 + i];
+                        vertex = entryVertices[i];
+                        vertex.position.x += offset.x;
+                        vertex.position.y += offset.y;
+                    }
+                }
+
+                entry.firstQuad = quad;
+                entry.meshOffset = offset;
+                entry.layout.clearChanges();
+
+                quad += entryQuadCount;
+            }
+
+            vertices.resize(quad * 4);
+            quadCount = quad;
+
+            needsVertexUpdate = false;
+            needsMeshUpdate = true;
+        }
+    } // namespace scene
+} // namespace ouzel
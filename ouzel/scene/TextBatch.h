@@ -0,0 +1,100 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "scene/Component.h"
+#include "utils/Types.h"
+#include "graphics/Color.h"
+#include "graphics/Vertex.h"
+#include "gui/TextLayout.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Draws many texts of the same font with one mesh and one draw call, e.g. a table of scores or damage numbers.
+        // Texts are positioned in the space of the node the batch is added to. A changed text rewrites only its own
+        // glyphs, unless its glyph count changes, in which case the glyphs of the texts after it are moved as well.
+        class TextBatch: public Component
+        {
+        public:
+            static const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+            TextBatch(const std::string& fontFile);
+            virtual ~TextBatch();
+
+            virtual void draw(const Matrix4& projectionMatrix,
+                              const Matrix4& transformMatrix,
+                              const graphics::Color& drawColor,
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
+
+            virtual void drawWireframe(const Matrix4& projectionMatrix,
+                                       const Matrix4& transformMatrix,
+                                       const graphics::Color& drawColor,
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest) override;
+
+            // returns the index of the text, indices of removed texts are reused
+            uint32_t addText(const std::string& text, const Vector2& position,
+                             const Vector2& anchor = Vector2(0.5f, 0.5f),
+                             const graphics::Color& color = graphics::Color(255, 255, 255, 255));
+            void removeText(uint32_t index);
+
+            void setText(uint32_t index, const std::string& text);
+            const std::string& getText(uint32_t index) const { return entries[index].layout.getText(); }
+
+            void setPosition(uint32_t index, const Vector2& position);
+            const Vector2& getPosition(uint32_t index) const { return entries[index].position; }
+
+            void setAnchor(uint32_t index, const Vector2& anchor);
+            void setColor(uint32_t index, const graphics::Color& color);
+            void reserve(uint32_t index, uint32_t characterCount) { entries[index].layout.reserve(characterCount); }
+
+            uint32_t getTextCount() const { return static_cast<uint32_t>(entries.size() - freeEntries.size()); }
+            uint32_t getQuadCount() const { return quadCount; }
+
+            virtual const graphics::ShaderPtr& getShader() const { return shader; }
+            virtual void setShader(const graphics::ShaderPtr& newShader) { shader = newShader; }
+
+            virtual const graphics::BlendStatePtr& getBlendState() const { return blendState; }
+            virtual void setBlendState(const graphics::BlendStatePtr& newBlendState)  { blendState = newBlendState; }
+
+        protected:
+            struct Entry
+            {
+                TextLayout layout;
+                Vector2 position;
+                Vector2 anchor;
+                bool used = false;
+                uint32_t firstQuad = INVALID_INDEX;
+                Vector2 meshOffset;
+                AABB2 bounds;
+            };
+
+            void updateEntry(Entry& entry);
+            void updateVertices();
+
+            graphics::ShaderPtr shader;
+            graphics::BlendStatePtr blendState;
+            graphics::MeshBufferPtr meshBuffer;
+            graphics::TexturePtr whitePixelTexture;
+
+            FontPtr font;
+
+            std::vector<Entry> entries;
+            std::vector<uint32_t> freeEntries;
+
+            std::vector<graphics::VertexPCT> vertices;
+            uint32_t quadCount = 0;
+
+            bool needsVertexUpdate = false;
+            bool needsMeshUpdate = false;
+        };
+    } // namespace scene
+} // namespace ouzel
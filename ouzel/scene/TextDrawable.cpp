@@ -12,21 +12,23 @@ namespace ouzel
 {
     namespace scene
     {
-        TextDrawable::TextDrawable(const std::string& fontFile, const std::string& pText, const Vector2& pTextAnchor):
-            font(fontFile)
+        TextDrawable::TextDrawable(const std::string& fontFile, const std::string& pText, const Vector2& pTextAnchor)
         {
             shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
             blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
             whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
 
+            // glyphs are quads, so the indices come from the shared quad index buffer
+            const graphics::MeshBufferPtr& quadIndexBuffer = sharedEngine->getRenderer()->getQuadIndexBuffer(0);
+
             meshBuffer = sharedEngine->getRenderer()->createMeshBuffer();
-            meshBuffer->init();
-            meshBuffer->setIndexSize(sizeof(uint16_t));
-            meshBuffer->setVertexAttributes(graphics::VertexPCT::ATTRIBUTES);
+            meshBuffer->initFromBuffer(nullptr, quadIndexBuffer->getIndexSize(), 0, false,
+                                       nullptr, graphics::VertexPCT::ATTRIBUTES, 0, true);
+            meshBuffer->setIndexBufferSource(quadIndexBuffer);
 
             textAnchor = pTextAnchor;
 
-            texture = font.getTexture();
+            layout.setFont(sharedEngine->getCache()->getFont(fontFile));
 
             setText(pText);
         }
@@ -37,35 +39,60 @@ namespace ouzel
 
         void TextDrawable::setFont(const std::string& fontFile)
         {
-            font = BMFont(fontFile);
-            texture = font.getTexture();
+            setFont(sharedEngine->getCache()->getFont(fontFile));
+        }
+
+        void TextDrawable::setFont(const FontPtr& newFont)
+        {
+            layout.setFont(newFont);
 
-            setText(text);
+            updateLayout();
         }
 
         void TextDrawable::setTextAnchor(const Vector2& newTextAnchor)
         {
             textAnchor = newTextAnchor;
 
-            setText(text);
+            // the anchor is applied in the transformation, so only the bounds change
+            updateLayout();
+        }
+
+        Matrix4 TextDrawable::getAnchorTransform() const
+        {
+            Matrix4 anchorTransform;
+            Matrix4::createTranslation(-layout.getWidth() * textAnchor.x, -layout.getHeight() * textAnchor.y, 0.0f, anchorTransform);
+
+            return anchorTransform;
         }
 
         void TextDrawable::draw(const Matrix4& projectionMatrix,
                                 const Matrix4& transformMatrix,
                                 const graphics::Color& drawColor,
-                                const graphics::RenderTargetPtr& renderTarget)
+                                const graphics::RenderTargetPtr& renderTarget,
+                                bool scissorTestEnabled,
+                                const Rectangle& scissorTest)
         {
-            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
 
             if (needsMeshUpdate)
             {
-                meshBuffer->setIndices(indices.data(), static_cast<uint32_t>(indices.size()));
-                meshBuffer->setVertices(vertices.data(), static_cast<uint32_t>(vertices.size()));
+                if (quadCount)
+                {
+                    // grows the shared index buffer if this is the longest text so far
+                    sharedEngine->getRenderer()->getQuadIndexBuffer(quadCount);
+
+                    meshBuffer->setVertices(layout.getVertices().data(), quadCount * 4);
+                }
 
                 needsMeshUpdate = false;
             }
 
-            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+            if (!quadCount)
+            {
+                return;
+            }
+
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix * getAnchorTransform();
             float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
 
             std::vector<std::vector<float>> pixelShaderConstants(1);
@@ -74,26 +101,37 @@ namespace ouzel
             std::vector<std::vector<float>> vertexShaderConstants(1);
             vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
 
-            sharedEngine->getRenderer()->addDrawCommand({ texture },
+            // fonts with a glyph atlas upload the newly rasterized glyphs when their texture is requested
+            sharedEngine->getRenderer()->addDrawCommand({ layout.getFont()->getTexture() },
                                                         shader,
                                                         pixelShaderConstants,
                                                         vertexShaderConstants,
                                                         blendState,
                                                         meshBuffer,
-                                                        static_cast<uint32_t>(indices.size()),
+                                                        quadCount * 6,
                                                         graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                         0,
-                                                        renderTarget);
+                                                        renderTarget,
+                                                        false,
+                                                        scissorTestEnabled,
+                                                        scissorTest);
         }
 
         void TextDrawable::drawWireframe(const Matrix4& projectionMatrix,
                                          const Matrix4& transformMatrix,
                                          const graphics::Color& drawColor,
-                                         const graphics::RenderTargetPtr& renderTarget)
+                                         const graphics::RenderTargetPtr& renderTarget,
+                                         bool scissorTestEnabled,
+                                         const Rectangle& scissorTest)
         {
-            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget);
+            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
+
+            if (!quadCount)
+            {
+                return;
+            }
 
-            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix * getAnchorTransform();
             float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
 
             std::vector<std::vector<float>> pixelShaderConstants(1);
@@ -108,41 +146,54 @@ namespace ouzel
                                                         vertexShaderConstants,
                                                         blendState,
                                                         meshBuffer,
-                                                        static_cast<uint32_t>(indices.size()),
+                                                        quadCount * 6,
                                                         graphics::Renderer::DrawMode::TRIANGLE_LIST,
                                                         0,
-                                                        renderTarget);
+                                                        renderTarget,
+                                                        false,
+                                                        scissorTestEnabled,
+                                                        scissorTest);
         }
 
         void TextDrawable::setText(const std::string& newText)
         {
-            text = newText;
+            if (newText == layout.getText())
+            {
+                return;
+            }
 
-            font.getVertices(text, color, textAnchor, indices, vertices);
-            needsMeshUpdate = true;
+            layout.setText(newText);
 
-            updateBounds();
+            updateLayout();
         }
 
         void TextDrawable::setColor(const graphics::Color& newColor)
         {
-            color = newColor;
+            layout.setColor(newColor);
 
-            font.getVertices(text, color, textAnchor, indices, vertices);
-            needsMeshUpdate = true;
-
-            updateBounds();
+            updateLayout();
         }
 
-        void TextDrawable::updateBounds()
+        void TextDrawable::updateLayout()
         {
+            // unchanged text is not uploaded again
+            if (layout.getFirstChangedQuad() != TextLayout::NO_CHANGES || layout.getQuadCount() != quadCount)
+            {
+                quadCount = layout.getQuadCount();
+                layout.clearChanges();
+                needsMeshUpdate = true;
+            }
+
             boundingBox.reset();
 
-            for (const graphics::VertexPCT& vertex : vertices)
+            Vector2 offset(-layout.getWidth() * textAnchor.x, -layout.getHeight() * textAnchor.y);
+
+            for (const graphics::VertexPCT& vertex : layout.getVertices())
             {
-                boundingBox.insertPoint(Vector2(vertex.position.x, vertex.position.y));
+                boundingBox.insertPoint(Vector2(vertex.position.x + offset.x, vertex.position.y + offset.y));
             }
 
+            markDirty();
         }
     } // namespace scene
 } // namespace ouzel
@@ -7,7 +7,8 @@
 #include "scene/Component.h"
 #include "utils/Types.h"
 #include "graphics/Color.h"
-#include "gui/BMFont.h"
+#include "gui/Font.h"
+#include "gui/TextLayout.h"
 
 namespace ouzel
 {
@@ -22,22 +23,31 @@ namespace ouzel
             virtual void draw(const Matrix4& projectionMatrix,
                               const Matrix4& transformMatrix,
                               const graphics::Color& drawColor,
-                              const graphics::RenderTargetPtr& renderTarget) override;
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
 
             virtual void drawWireframe(const Matrix4& projectionMatrix,
                                        const Matrix4& transformMatrix,
                                        const graphics::Color& drawColor,
-                                       const graphics::RenderTargetPtr& renderTarget) override;
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest) override;
 
             virtual void setFont(const std::string& fontFile);
+            virtual void setFont(const FontPtr& newFont);
+            const FontPtr& getFont() const { return layout.getFont(); }
 
             virtual void setTextAnchor(const Vector2& newTextAnchor);
             virtual const Vector2& getTextAnchor() const { return textAnchor; }
 
             virtual void setText(const std::string& newText);
-            virtual const std::string& getText() const { return text; }
+            virtual const std::string& getText() const { return layout.getText(); }
 
-            virtual const graphics::Color& getColor() const { return color; }
+            // text that changes often (e.g. counters) can reserve space for its longest value
+            void reserve(uint32_t characterCount) { layout.reserve(characterCount); }
+
+            virtual const graphics::Color& getColor() const { return layout.getColor(); }
             virtual void setColor(const graphics::Color& newColor);
 
             virtual const graphics::ShaderPtr& getShader() const { return shader; }
@@ -47,22 +57,18 @@ namespace ouzel
             virtual void setBlendState(const graphics::BlendStatePtr& newBlendState)  { blendState = newBlendState; }
 
         protected:
-            void updateBounds();
+            void updateLayout();
+            Matrix4 getAnchorTransform() const;
 
             graphics::ShaderPtr shader;
             graphics::BlendStatePtr blendState;
             graphics::MeshBufferPtr meshBuffer;
-            graphics::TexturePtr texture;
             graphics::TexturePtr whitePixelTexture;
 
-            BMFont font;
+            TextLayout layout;
             Vector2 textAnchor;
-            std::string text;
-
-            std::vector<uint16_t> indices;
-            std::vector<graphics::VertexPCT> vertices;
 
-            graphics::Color color = graphics::Color(255, 255, 255, 255);
+            uint32_t quadCount = 0;
 
             bool needsMeshUpdate = false;
         };
@@ -0,0 +1,1027 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <algorithm>
+#include <map>
+#include <cstdlib>
+#include <cfloat>
+#include <rapidjson/rapidjson.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/document.h>
+#include "TileMap.h"
+#include "core/Engine.h"
+#include "core/Application.h"
+#include "core/Cache.h"
+#include "files/FileSystem.h"
+#include "graphics/Renderer.h"
+#include "graphics/Texture.h"
+#include "graphics/MeshBuffer.h"
+#include "graphics/Vertex.h"
+#include "utils/Utils.h"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static bool decodeBase64(const std::string& input, std::vector<uint8_t>& output)
+        {
+            output.clear();
+            output.reserve(input.size() * 3 / 4);
+
+            uint32_t buffer = 0;
+            uint32_t bits = 0;
+
+            for (char c : input)
+            {
+                uint32_t value;
+
+                if (c >= 'A' && c <= 'Z') value = static_cast<uint32_t>(c - 'A');
+                else if (c >= 'a' && c <= 'z') value = static_cast<uint32_t>(c - 'a') + 26;
+                else if (c >= '0' && c <= '9') value = static_cast<uint32_t>(c - '0') + 52;
+                else if (c == '+') value = 62;
+                else if (c == '/') value = 63;
+                else if (c == '=') break;
+                else if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+                else return false;
+
+                buffer = (buffer << 6) | value;
+                bits += 6;
+
+                if (bits >= 8)
+                {
+                    bits -= 8;
+                    output.push_back(static_cast<uint8_t>(buffer >> bits));
+                }
+            }
+
+            return true;
+        }
+
+        static bool decodeTileData(const std::string& encoding, const std::string& compression, const std::string& input, std::vector<uint32_t>& gids)
+        {
+            gids.clear();
+
+            if (!compression.empty())
+            {
+                log(LOG_LEVEL_ERROR, "Compressed tile data (%s) is not supported", compression.c_str());
+                return false;
+            }
+
+            if (encoding == "csv")
+            {
+                const char* current = input.c_str();
+
+                for (;;)
+                {
+                    while (*current == ',' || *current == ' ' || *current == '\t' || *current == '\r' || *current == '\n') ++current;
+                    if (*current == '\0') break;
+
+                    char* end;
+                    gids.push_back(static_cast<uint32_t>(strtoul(current, &end, 10)));
+
+                    if (end == current)
+                    {
+                        log(LOG_LEVEL_ERROR, "Invalid CSV tile data");
+                        return false;
+                    }
+
+                    current = end;
+                }
+            }
+            else if (encoding == "base64")
+            {
+                std::vector<uint8_t> data;
+
+                if (!decodeBase64(input, data))
+                {
+                    log(LOG_LEVEL_ERROR, "Invalid base64 tile data");
+                    return false;
+                }
+
+                gids.reserve(data.size() / 4);
+
+                for (size_t offset = 0; offset + 4 <= data.size(); offset += 4)
+                {
+                    gids.push_back(readUInt32Little(data.data() + offset));
+                }
+            }
+            else
+            {
+                log(LOG_LEVEL_ERROR, "Unsupported tile data encoding %s", encoding.c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        // minimal reader for the XML subset used by TMX files, returns the next tag and its attributes
+        static bool readTag(const std::string& xml, std::string::size_type& offset, std::string& name, std::map<std::string, std::string>& attributes, bool& closing)
+        {
+            for (;;)
+            {
+                offset = xml.find('<', offset);
+                if (offset == std::string::npos) return false;
+
+                if (xml.compare(offset, 4, "<!--") == 0)
+                {
+                    offset = xml.find("-->", offset);
+                    if (offset == std::string::npos) return false;
+                    offset += 3;
+                }
+                else if (xml.compare(offset, 2, "<?") == 0 || xml.compare(offset, 2, "<!") == 0)
+                {
+                    offset = xml.find('>', offset);
+                    if (offset == std::string::npos) return false;
+                    ++offset;
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            ++offset;
+
+            closing = (offset < xml.size() && xml[offset] == '/');
+            if (closing) ++offset;
+
+            std::string::size_type nameEnd = xml.find_first_of(" \t\r\n/>", offset);
+            if (nameEnd == std::string::npos) return false;
+
+            name = xml.substr(offset, nameEnd - offset);
+            offset = nameEnd;
+            attributes.clear();
+
+            for (;;)
+            {
+                offset = xml.find_first_not_of(" \t\r\n", offset);
+                if (offset == std::string::npos) return false;
+
+                if (xml[offset] == '>')
+                {
+                    ++offset;
+                    return true;
+                }
+                else if (xml[offset] == '/')
+                {
+                    offset = xml.find('>', offset);
+                    if (offset == std::string::npos) return false;
+                    ++offset;
+                    return true;
+                }
+
+                std::string::size_type equals = xml.find('=', offset);
+                if (equals == std::string::npos) return false;
+
+                std::string::size_type keyEnd = xml.find_last_not_of(" \t\r\n", equals - 1);
+                std::string key = xml.substr(offset, keyEnd + 1 - offset);
+
+                std::string::size_type quote = xml.find_first_of("\"'", equals + 1);
+                if (quote == std::string::npos) return false;
+
+                std::string::size_type valueEnd = xml.find(xml[quote], quote + 1);
+                if (valueEnd == std::string::npos) return false;
+
+                attributes[key] = xml.substr(quote + 1, valueEnd - quote - 1);
+                offset = valueEnd + 1;
+            }
+        }
+
+        static uint32_t getUIntAttribute(const std::map<std::string, std::string>& attributes, const std::string& key, uint32_t defaultValue = 0)
+        {
+            std::map<std::string, std::string>::const_iterator i = attributes.find(key);
+
+            return (i != attributes.end()) ? static_cast<uint32_t>(strtoul(i->second.c_str(), nullptr, 10)) : defaultValue;
+        }
+
+        static float getFloatAttribute(const std::map<std::string, std::string>& attributes, const std::string& key, float defaultValue = 0.0f)
+        {
+            std::map<std::string, std::string>::const_iterator i = attributes.find(key);
+
+            return (i != attributes.end()) ? strtof(i->second.c_str(), nullptr) : defaultValue;
+        }
+
+        static std::string getStringAttribute(const std::map<std::string, std::string>& attributes, const std::string& key)
+        {
+            std::map<std::string, std::string>::const_iterator i = attributes.find(key);
+
+            return (i != attributes.end()) ? i->second : std::string();
+        }
+
+        static bool getUIntMember(const rapidjson::Value& object, const char* key, uint32_t& value)
+        {
+            if (!object.HasMember(key) || !object[key].IsUint())
+            {
+                return false;
+            }
+
+            value = object[key].GetUint();
+            return true;
+        }
+
+        // tileset images are stored relative to the tile map file
+        static std::string getImagePath(const std::string& filename, const std::string& image)
+        {
+            std::string directory = FileSystem::getDirectoryPart(filename);
+
+            if (directory.empty() || FileSystem::isAbsolutePath(image))
+            {
+                return image;
+            }
+
+            return directory + FileSystem::DIRECTORY_SEPARATOR + image;
+        }
+
+        static bool isBoxVisible(const Matrix4& modelViewProj, const AABB2& box)
+        {
+            Vector3 corners[4] = {
+                Vector3(box.min.x, box.min.y, 0.0f),
+                Vector3(box.max.x, box.min.y, 0.0f),
+                Vector3(box.min.x, box.max.y, 0.0f),
+                Vector3(box.max.x, box.max.y, 0.0f)
+            };
+
+            float minX = FLT_MAX, minY = FLT_MAX;
+            float maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+            for (Vector3& corner : corners)
+            {
+                modelViewProj.transformPoint(corner);
+
+                minX = std::min(minX, corner.x);
+                minY = std::min(minY, corner.y);
+                maxX = std::max(maxX, corner.x);
+                maxY = std::max(maxY, corner.y);
+            }
+
+            // test against the clip space
+            return maxX >= -1.0f && minX <= 1.0f && maxY >= -1.0f && minY <= 1.0f;
+        }
+
+        TileMap::TileMap()
+        {
+            shader = sharedEngine->getCache()->getShader(graphics::SHADER_TEXTURE);
+            blendState = sharedEngine->getCache()->getBlendState(graphics::BLEND_ALPHA);
+            whitePixelTexture = sharedEngine->getCache()->getTexture(graphics::TEXTURE_WHITE_PIXEL);
+        }
+
+        TileMap::TileMap(const std::string& filename):
+            TileMap()
+        {
+            initFromFile(filename);
+        }
+
+        TileMap::~TileMap()
+        {
+        }
+
+        bool TileMap::init(uint32_t newWidth, uint32_t newHeight, const Size2& newTileSize)
+        {
+            width = newWidth;
+            height = newHeight;
+            tileSize = newTileSize;
+
+            chunksX = (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+            chunksY = (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+            tilesets.clear();
+            layers.clear();
+
+            updateBoundingBox();
+
+            return true;
+        }
+
+        bool TileMap::initFromFile(const std::string& filename)
+        {
+            FileView data;
+
+            if (!sharedApplication->getFileSystem()->mapFile(filename, data))
+            {
+                return false;
+            }
+
+            std::string extension = sharedApplication->getFileSystem()->getExtensionPart(filename);
+
+            if (extension == "json")
+            {
+                return loadJSON(filename, data);
+            }
+            else if (extension == "tmx")
+            {
+                return loadTMX(filename, data);
+            }
+
+            log(LOG_LEVEL_ERROR, "Unsupported tile map format %s", filename.c_str());
+            return false;
+        }
+
+        void TileMap::draw(const Matrix4& projectionMatrix,
+                           const Matrix4& transformMatrix,
+                           const graphics::Color& drawColor,
+                           const graphics::RenderTargetPtr& renderTarget,
+                           bool scissorTestEnabled,
+                           const Rectangle& scissorTest)
+        {
+            Component::draw(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
+
+            drawnChunkCount = 0;
+
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
+
+            for (TileLayer& layer : layers)
+            {
+                if (layer.hidden || layer.opacity <= 0.0f)
+                {
+                    continue;
+                }
+
+                float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() * layer.opacity };
+
+                std::vector<std::vector<float>> pixelShaderConstants(1);
+                pixelShaderConstants[0] = { std::begin(colorVector), std::end(colorVector) };
+
+                for (uint32_t chunkY = 0; chunkY < chunksY; ++chunkY)
+                {
+                    for (uint32_t chunkX = 0; chunkX < chunksX; ++chunkX)
+                    {
+                        Chunk& chunk = layer.chunks[chunkY * chunksX + chunkX];
+
+                        // chunks are built lazily, so chunks that were never visible do not allocate mesh buffers
+                        if (!isBoxVisible(modelViewProj, chunk.boundingBox))
+                        {
+                            continue;
+                        }
+
+                        if (chunk.dirty)
+                        {
+                            rebuildChunk(layer, chunkX, chunkY);
+                        }
+
+                        if (chunk.batches.empty())
+                        {
+                            continue;
+                        }
+
+                        ++drawnChunkCount;
+
+                        for (const Batch& batch : chunk.batches)
+                        {
+                            sharedEngine->getRenderer()->addDrawCommand({ tilesets[batch.tileset].texture },
+                                                                        shader,
+                                                                        pixelShaderConstants,
+                                                                        vertexShaderConstants,
+                                                                        blendState,
+                                                                        batch.meshBuffer,
+                                                                        0,
+                                                                        graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                                        0,
+                                                                        renderTarget,
+                                                                        false,
+                                                                        scissorTestEnabled,
+                                                                        scissorTest);
+                        }
+                    }
+                }
+            }
+        }
+
+        void TileMap::drawWireframe(const Matrix4& projectionMatrix,
+                                    const Matrix4& transformMatrix,
+                                    const graphics::Color& drawColor,
+                                    const graphics::RenderTargetPtr& renderTarget,
+                                    bool scissorTestEnabled,
+                                    const Rectangle& scissorTest)
+        {
+            Component::drawWireframe(projectionMatrix, transformMatrix, drawColor, renderTarget, scissorTestEnabled, scissorTest);
+
+            Matrix4 modelViewProj = projectionMatrix * transformMatrix;
+            float colorVector[] = { drawColor.getR(), drawColor.getG(), drawColor.getB(), drawColor.getA() };
+
+            std::vector<std::vector<float>> pixelShaderConstants(1);
+            pixelShaderConstants[0] = { std::begin(colorVector), std::end(colorVector) };
+
+            std::vector<std::vector<float>> vertexShaderConstants(1);
+            vertexShaderConstants[0] = { std::begin(modelViewProj.m), std::end(modelViewProj.m) };
+
+            for (const TileLayer& layer : layers)
+            {
+                if (layer.hidden)
+                {
+                    continue;
+                }
+
+                for (const Chunk& chunk : layer.chunks)
+                {
+                    if (chunk.dirty || !isBoxVisible(modelViewProj, chunk.boundingBox))
+                    {
+                        continue;
+                    }
+
+                    for (const Batch& batch : chunk.batches)
+                    {
+                        sharedEngine->getRenderer()->addDrawCommand({ whitePixelTexture },
+                                                                    shader,
+                                                                    pixelShaderConstants,
+                                                                    vertexShaderConstants,
+                                                                    blendState,
+                                                                    batch.meshBuffer,
+                                                                    0,
+                                                                    graphics::Renderer::DrawMode::TRIANGLE_LIST,
+                                                                    0,
+                                                                    renderTarget,
+                                                                    true,
+                                                                    scissorTestEnabled,
+                                                                    scissorTest);
+                    }
+                }
+            }
+        }
+
+        bool TileMap::addTileset(const Tileset& tileset)
+        {
+            if (!tileset.texture || tileset.columns == 0)
+            {
+                log(LOG_LEVEL_ERROR, "Invalid tileset");
+                return false;
+            }
+
+            std::vector<Tileset>::iterator i = std::upper_bound(tilesets.begin(), tilesets.end(), tileset, [](const Tileset& a, const Tileset& b) {
+                return a.firstGid < b.firstGid;
+            });
+
+            tilesets.insert(i, tileset);
+
+            // tileset indices of the existing batches changed
+            for (TileLayer& layer : layers)
+            {
+                for (Chunk& chunk : layer.chunks)
+                {
+                    chunk.dirty = true;
+                }
+            }
+
+            updateBoundingBox();
+            markDirty();
+
+            return true;
+        }
+
+        uint32_t TileMap::addLayer(const std::string& name)
+        {
+            TileLayer layer;
+            layer.name = name;
+            layer.tiles.resize(width * height, 0);
+            layer.chunks.resize(chunksX * chunksY);
+
+            layers.push_back(layer);
+
+            updateBoundingBox();
+            markDirty();
+
+            return static_cast<uint32_t>(layers.size() - 1);
+        }
+
+        void TileMap::setLayerOpacity(uint32_t layer, float opacity)
+        {
+            if (layer < layers.size())
+            {
+                layers[layer].opacity = opacity;
+                markDirty();
+            }
+        }
+
+        void TileMap::setLayerHidden(uint32_t layer, bool hidden)
+        {
+            if (layer < layers.size())
+            {
+                layers[layer].hidden = hidden;
+                markDirty();
+            }
+        }
+
+        uint32_t TileMap::getTile(uint32_t layer, uint32_t x, uint32_t y) const
+        {
+            if (layer >= layers.size() || x >= width || y >= height)
+            {
+                return 0;
+            }
+
+            return layers[layer].tiles[y * width + x];
+        }
+
+        bool TileMap::setTile(uint32_t layer, uint32_t x, uint32_t y, uint32_t gid)
+        {
+            if (layer >= layers.size() || x >= width || y >= height)
+            {
+                return false;
+            }
+
+            uint32_t& tile = layers[layer].tiles[y * width + x];
+
+            if (tile != gid)
+            {
+                tile = gid;
+
+                // only the chunk that contains the tile has to be rebuilt
+                layers[layer].chunks[(y / CHUNK_SIZE) * chunksX + x / CHUNK_SIZE].dirty = true;
+                markDirty();
+            }
+
+            return true;
+        }
+
+        int32_t TileMap::getTilesetIndex(uint32_t gid) const
+        {
+            // tilesets are sorted by the first gid
+            for (int32_t i = static_cast<int32_t>(tilesets.size()) - 1; i >= 0; --i)
+            {
+                if (tilesets[static_cast<uint32_t>(i)].firstGid <= gid)
+                {
+                    return i;
+                }
+            }
+
+            return -1;
+        }
+
+        void TileMap::rebuildChunk(TileLayer& layer, uint32_t chunkX, uint32_t chunkY)
+        {
+            Chunk& chunk = layer.chunks[chunkY * chunksX + chunkX];
+
+            chunk.batches.clear();
+            chunk.dirty = false;
+
+            std::vector<std::vector<uint16_t>> indices(tilesets.size());
+            std::vector<std::vector<graphics::VertexPCT>> vertices(tilesets.size());
+
+            uint32_t endX = std::min((chunkX + 1) * CHUNK_SIZE, width);
+            uint32_t endY = std::min((chunkY + 1) * CHUNK_SIZE, height);
+
+            for (uint32_t y = chunkY * CHUNK_SIZE; y < endY; ++y)
+            {
+                for (uint32_t x = chunkX * CHUNK_SIZE; x < endX; ++x)
+                {
+                    uint32_t value = layer.tiles[y * width + x];
+                    uint32_t gid = value & GID_MASK;
+
+                    if (gid == 0)
+                    {
+                        continue;
+                    }
+
+                    int32_t tilesetIndex = getTilesetIndex(gid);
+
+                    if (tilesetIndex < 0)
+                    {
+                        continue;
+                    }
+
+                    const Tileset& tileset = tilesets[static_cast<uint32_t>(tilesetIndex)];
+                    uint32_t id = gid - tileset.firstGid;
+
+                    if (tileset.tileCount && id >= tileset.tileCount)
+                    {
+                        continue;
+                    }
+
+                    const Size2& textureSize = tileset.texture->getSize();
+
+                    float left = tileset.margin + (id % tileset.columns) * (tileset.tileSize.width + tileset.spacing);
+                    float top = tileset.margin + (id / tileset.columns) * (tileset.tileSize.height + tileset.spacing);
+
+                    Vector2 leftTop(left / textureSize.width, top / textureSize.height);
+                    Vector2 rightBottom((left + tileset.tileSize.width) / textureSize.width,
+                                        (top + tileset.tileSize.height) / textureSize.height);
+
+                    if (tileset.texture->isFlipped())
+                    {
+                        leftTop.y = 1.0f - leftTop.y;
+                        rightBottom.y = 1.0f - rightBottom.y;
+                    }
+
+                    Vector2 textCoordLeftTop = leftTop;
+                    Vector2 textCoordRightTop(rightBottom.x, leftTop.y);
+                    Vector2 textCoordLeftBottom(leftTop.x, rightBottom.y);
+                    Vector2 textCoordRightBottom = rightBottom;
+
+                    // flips are applied in the same order as in Tiled
+                    if (value & FLIPPED_DIAGONALLY)
+                    {
+                        std::swap(textCoordRightTop, textCoordLeftBottom);
+                    }
+
+                    if (value & FLIPPED_HORIZONTALLY)
+                    {
+                        std::swap(textCoordLeftTop, textCoordRightTop);
+                        std::swap(textCoordLeftBottom, textCoordRightBottom);
+                    }
+
+                    if (value & FLIPPED_VERTICALLY)
+                    {
+                        std::swap(textCoordLeftTop, textCoordLeftBottom);
+                        std::swap(textCoordRightTop, textCoordRightBottom);
+                    }
+
+                    // tiles that are larger than the map tile are aligned to the bottom-left corner of the cell
+                    Vector2 position(x * tileSize.width, -static_cast<float>(y + 1) * tileSize.height);
+
+                    std::vector<uint16_t>& tilesetIndices = indices[static_cast<uint32_t>(tilesetIndex)];
+                    std::vector<graphics::VertexPCT>& tilesetVertices = vertices[static_cast<uint32_t>(tilesetIndex)];
+
+                    uint16_t startVertex = static_cast<uint16_t>(tilesetVertices.size());
+
+                    tilesetIndices.push_back(startVertex + 0);
+                    tilesetIndices.push_back(startVertex + 1);
+                    tilesetIndices.push_back(startVertex + 2);
+                    tilesetIndices.push_back(startVertex + 1);
+                    tilesetIndices.push_back(startVertex + 3);
+                    tilesetIndices.push_back(startVertex + 2);
+
+                    tilesetVertices.push_back(graphics::VertexPCT(Vector3(position.x, position.y, 0.0f),
+                                                                  graphics::Color(255, 255, 255, 255), textCoordLeftBottom));
+                    tilesetVertices.push_back(graphics::VertexPCT(Vector3(position.x + tileset.tileSize.width, position.y, 0.0f),
+                                                                  graphics::Color(255, 255, 255, 255), textCoordRightBottom));
+                    tilesetVertices.push_back(graphics::VertexPCT(Vector3(position.x, position.y + tileset.tileSize.height, 0.0f),
+                                                                  graphics::Color(255, 255, 255, 255), textCoordLeftTop));
+                    tilesetVertices.push_back(graphics::VertexPCT(Vector3(position.x + tileset.tileSize.width, position.y + tileset.tileSize.height, 0.0f),
+                                                                  graphics::Color(255, 255, 255, 255), textCoordRightTop));
+                }
+            }
+
+            for (uint32_t i = 0; i < tilesets.size(); ++i)
+            {
+                if (indices[i].empty())
+                {
+                    continue;
+                }
+
+                Batch batch;
+                batch.tileset = i;
+                batch.meshBuffer = sharedEngine->getRenderer()->createMeshBuffer();
+
+                if (!batch.meshBuffer->initFromBuffer(indices[i].data(), sizeof(uint16_t),
+                                                      static_cast<uint32_t>(indices[i].size()), false,
+                                                      vertices[i].data(), graphics::VertexPCT::ATTRIBUTES,
+                                                      static_cast<uint32_t>(vertices[i].size()), false))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to create mesh buffer for tile map chunk");
+                    continue;
+                }
+
+                chunk.batches.push_back(batch);
+            }
+
+            ++rebuiltChunkCount;
+        }
+
+        void TileMap::updateBoundingBox()
+        {
+            // tiles of tilesets with larger tiles overlap the cells above and to the right
+            Size2 overlap;
+
+            for (const Tileset& tileset : tilesets)
+            {
+                overlap.width = std::max(overlap.width, tileset.tileSize.width - tileSize.width);
+                overlap.height = std::max(overlap.height, tileset.tileSize.height - tileSize.height);
+            }
+
+            for (TileLayer& layer : layers)
+            {
+                for (uint32_t chunkY = 0; chunkY < chunksY; ++chunkY)
+                {
+                    for (uint32_t chunkX = 0; chunkX < chunksX; ++chunkX)
+                    {
+                        uint32_t endX = std::min((chunkX + 1) * CHUNK_SIZE, width);
+                        uint32_t endY = std::min((chunkY + 1) * CHUNK_SIZE, height);
+
+                        Chunk& chunk = layer.chunks[chunkY * chunksX + chunkX];
+                        chunk.boundingBox.set(Vector2(chunkX * CHUNK_SIZE * tileSize.width,
+                                                      -static_cast<float>(endY) * tileSize.height),
+                                              Vector2(endX * tileSize.width + overlap.width,
+                                                      -static_cast<float>(chunkY * CHUNK_SIZE) * tileSize.height + overlap.height));
+                    }
+                }
+            }
+
+            if (width && height)
+            {
+                boundingBox.set(Vector2(0.0f, -static_cast<float>(height) * tileSize.height),
+                                Vector2(width * tileSize.width + overlap.width, overlap.height));
+            }
+            else
+            {
+                boundingBox.reset();
+            }
+        }
+
+        bool TileMap::loadJSON(const std::string& filename, const FileView& data)
+        {
+            rapidjson::MemoryStream is(reinterpret_cast<const char*>(data.getData()), data.getSize());
+
+            rapidjson::Document document;
+            document.ParseStream<0>(is);
+
+            if (document.HasParseError() || !document.IsObject())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to parse %s", filename.c_str());
+                return false;
+            }
+
+            if (document.HasMember("infinite") && document["infinite"].IsBool() && document["infinite"].GetBool())
+            {
+                log(LOG_LEVEL_ERROR, "Infinite tile maps are not supported, file: %s", filename.c_str());
+                return false;
+            }
+
+            uint32_t mapWidth;
+            uint32_t mapHeight;
+            uint32_t mapTileWidth;
+            uint32_t mapTileHeight;
+
+            if (!getUIntMember(document, "width", mapWidth) ||
+                !getUIntMember(document, "height", mapHeight) ||
+                !getUIntMember(document, "tilewidth", mapTileWidth) ||
+                !getUIntMember(document, "tileheight", mapTileHeight))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load tile map %s, invalid map size", filename.c_str());
+                return false;
+            }
+
+            if (!document.HasMember("tilesets") || !document["tilesets"].IsArray() ||
+                !document.HasMember("layers") || !document["layers"].IsArray())
+            {
+                log(LOG_LEVEL_ERROR, "Failed to load tile map %s, tilesets or layers are missing", filename.c_str());
+                return false;
+            }
+
+            init(mapWidth, mapHeight,
+                 Size2(static_cast<float>(mapTileWidth), static_cast<float>(mapTileHeight)));
+
+            const rapidjson::Value& tilesetsArray = document["tilesets"];
+
+            for (rapidjson::SizeType index = 0; index < tilesetsArray.Size(); ++index)
+            {
+                const rapidjson::Value& tilesetObject = tilesetsArray[index];
+
+                if (!tilesetObject.IsObject())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load tile map %s, invalid tileset", filename.c_str());
+                    return false;
+                }
+
+                if (tilesetObject.HasMember("source") || !tilesetObject.HasMember("image") || !tilesetObject["image"].IsString())
+                {
+                    log(LOG_LEVEL_ERROR, "Only embedded single image tilesets are supported, file: %s", filename.c_str());
+                    return false;
+                }
+
+                Tileset tileset;
+                uint32_t tileWidth;
+                uint32_t tileHeight;
+
+                if (!getUIntMember(tilesetObject, "firstgid", tileset.firstGid) ||
+                    !getUIntMember(tilesetObject, "tilewidth", tileWidth) ||
+                    !getUIntMember(tilesetObject, "tileheight", tileHeight))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load tile map %s, invalid tileset", filename.c_str());
+                    return false;
+                }
+
+                tileset.tileSize = Size2(static_cast<float>(tileWidth), static_cast<float>(tileHeight));
+
+                uint32_t value;
+
+                if (getUIntMember(tilesetObject, "margin", value)) tileset.margin = static_cast<float>(value);
+                if (getUIntMember(tilesetObject, "spacing", value)) tileset.spacing = static_cast<float>(value);
+                getUIntMember(tilesetObject, "tilecount", tileset.tileCount);
+                tileset.texture = sharedEngine->getCache()->getTexture(getImagePath(filename, tilesetObject["image"].GetString()), false, false);
+
+                if (!tileset.texture)
+                {
+                    return false;
+                }
+
+                if (!getUIntMember(tilesetObject, "columns", tileset.columns))
+                {
+                    tileset.columns = static_cast<uint32_t>((tileset.texture->getSize().width - tileset.margin * 2.0f + tileset.spacing) /
+                                                            (tileset.tileSize.width + tileset.spacing));
+                }
+
+                if (!addTileset(tileset))
+                {
+                    return false;
+                }
+            }
+
+            const rapidjson::Value& layersArray = document["layers"];
+
+            for (rapidjson::SizeType index = 0; index < layersArray.Size(); ++index)
+            {
+                const rapidjson::Value& layerObject = layersArray[index];
+
+                if (!layerObject.IsObject() || !layerObject.HasMember("type") || !layerObject["type"].IsString())
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load tile map %s, invalid layer", filename.c_str());
+                    return false;
+                }
+
+                // object, image and group layers are not handled by the tile map
+                if (std::string(layerObject["type"].GetString()) != "tilelayer")
+                {
+                    continue;
+                }
+
+                if (!layerObject.HasMember("data") || (!layerObject["data"].IsArray() && !layerObject["data"].IsString()))
+                {
+                    log(LOG_LEVEL_ERROR, "Failed to load tile map %s, layer data is missing", filename.c_str());
+                    return false;
+                }
+
+                uint32_t layer = addLayer((layerObject.HasMember("name") && layerObject["name"].IsString()) ? layerObject["name"].GetString() : "");
+
+                if (layerObject.HasMember("opacity") && layerObject["opacity"].IsNumber()) layers[layer].opacity = layerObject["opacity"].GetFloat();
+                if (layerObject.HasMember("visible") && layerObject["visible"].IsBool()) layers[layer].hidden = !layerObject["visible"].GetBool();
+
+                const rapidjson::Value& dataValue = layerObject["data"];
+                std::vector<uint32_t> gids;
+
+                if (dataValue.IsArray())
+                {
+                    gids.reserve(dataValue.Size());
+
+                    for (rapidjson::SizeType i = 0; i < dataValue.Size(); ++i)
+                    {
+                        if (!dataValue[i].IsUint())
+                        {
+                            log(LOG_LEVEL_ERROR, "Failed to load tile map %s, invalid tile data", filename.c_str());
+                            return false;
+                        }
+
+                        gids.push_back(dataValue[i].GetUint());
+                    }
+                }
+                else
+                {
+                    std::string encoding = (layerObject.HasMember("encoding") && layerObject["encoding"].IsString()) ? layerObject["encoding"].GetString() : "base64";
+                    std::string compression = (layerObject.HasMember("compression") && layerObject["compression"].IsString()) ? layerObject["compression"].GetString() : "";
+
+                    if (!decodeTileData(encoding, compression, dataValue.GetString(), gids))
+                    {
+                        return false;
+                    }
+                }
+
+                std::copy(gids.begin(), gids.begin() + static_cast<std::ptrdiff_t>(std::min(gids.size(), layers[layer].tiles.size())), layers[layer].tiles.begin());
+            }
+
+            return true;
+        }
+
+        bool TileMap::loadTMX(const std::string& filename, const FileView& data)
+        {
+            std::string xml(reinterpret_cast<const char*>(data.getData()), data.getSize());
+            std::string::size_type offset = 0;
+
+            std::string name;
+            std::map<std::string, std::string> attributes;
+            bool closing;
+
+            bool mapFound = false;
+            bool inTileset = false;
+            bool inData = false;
+            Tileset tileset;
+            uint32_t layer = 0;
+            uint32_t tileIndex = 0;
+
+            while (readTag(xml, offset, name, attributes, closing))
+            {
+                if (name == "map" && !closing)
+                {
+                    if (getUIntAttribute(attributes, "infinite") != 0)
+                    {
+                        log(LOG_LEVEL_ERROR, "Infinite tile maps are not supported, file: %s", filename.c_str());
+                        return false;
+                    }
+
+                    init(getUIntAttribute(attributes, "width"), getUIntAttribute(attributes, "height"),
+                         Size2(getFloatAttribute(attributes, "tilewidth"), getFloatAttribute(attributes, "tileheight")));
+
+                    mapFound = true;
+                }
+                else if (!mapFound)
+                {
+                    continue;
+                }
+                else if (name == "tileset")
+                {
+                    if (!closing)
+                    {
+                        if (attributes.find("source") != attributes.end())
+                        {
+                            log(LOG_LEVEL_ERROR, "External tilesets are not supported, file: %s", filename.c_str());
+                            return false;
+                        }
+
+                        tileset = Tileset();
+                        tileset.firstGid = getUIntAttribute(attributes, "firstgid", 1);
+                        tileset.tileSize = Size2(getFloatAttribute(attributes, "tilewidth"), getFloatAttribute(attributes, "tileheight"));
+                        tileset.margin = getFloatAttribute(attributes, "margin");
+                        tileset.spacing = getFloatAttribute(attributes, "spacing");
+                        tileset.tileCount = getUIntAttribute(attributes, "tilecount");
+                        tileset.columns = getUIntAttribute(attributes, "columns");
+                        inTileset = true;
+                    }
+                    else
+                    {
+                        if (!addTileset(tileset))
+                        {
+                            return false;
+                        }
+
+                        inTileset = false;
+                    }
+                }
+                else if (name == "image" && inTileset && !closing)
+                {
+                    tileset.texture = sharedEngine->getCache()->getTexture(getImagePath(filename, getStringAttribute(attributes, "source")), false, false);
+
+                    if (!tileset.texture)
+                    {
+                        return false;
+                    }
+
+                    if (tileset.columns == 0 && tileset.tileSize.width > 0.0f)
+                    {
+                        tileset.columns = static_cast<uint32_t>((tileset.texture->getSize().width - tileset.margin * 2.0f + tileset.spacing) /
+                                                                (tileset.tileSize.width + tileset.spacing));
+                    }
+                }
+                else if (name == "layer" && !closing)
+                {
+                    layer = addLayer(getStringAttribute(attributes, "name"));
+                    layers[layer].opacity = getFloatAttribute(attributes, "opacity", 1.0f);
+                    layers[layer].hidden = getUIntAttribute(attributes, "visible", 1) == 0;
+                }
+                else if (name == "data" && !layers.empty())
+                {
+                    if (closing)
+                    {
+                        inData = false;
+                        continue;
+                    }
+
+                    std::string encoding = getStringAttribute(attributes, "encoding");
+
+                    if (encoding.empty())
+                    {
+                        // tiles are stored as <tile gid="..."/> elements
+                        inData = true;
+                        tileIndex = 0;
+                    }
+                    else
+                    {
+                        std::string::size_type end = xml.find("</data>", offset);
+
+                        if (end == std::string::npos)
+                        {
+                            log(LOG_LEVEL_ERROR, "Failed to parse %s", filename.c_str());
+                            return false;
+                        }
+
+                        std::vector<uint32_t> gids;
+
+                        if (!decodeTileData(encoding, getStringAttribute(attributes, "compression"), xml.substr(offset, end - offset), gids))
+                        {
+                            return false;
+                        }
+
+                        std::copy(gids.begin(), gids.begin() + static_cast<std::ptrdiff_t>(std::min(gids.size(), layers[layer].tiles.size())), layers[layer].tiles.begin());
+
+                        offset = end;
+                    }
+                }
+                else if (name == "tile" && inData && !closing)
+                {
+                    if (tileIndex < layers[layer].tiles.size())
+                    {
+                        layers[layer].tiles[tileIndex] = getUIntAttribute(attributes, "gid");
+                    }
+
+                    ++tileIndex;
+                }
+            }
+
+            if (!mapFound)
+            {
+                log(LOG_LEVEL_ERROR, "Failed to parse %s", filename.c_str());
+                return false;
+            }
+
+            return true;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,135 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "scene/Component.h"
+#include "utils/Types.h"
+#include "math/Size2.h"
+#include "math/AABB2.h"
+
+namespace ouzel
+{
+    class FileView;
+
+    namespace scene
+    {
+        // Tile map that is split into chunks of CHUNK_SIZE x CHUNK_SIZE tiles, every chunk has a static mesh buffer per tileset.
+        // The top-left corner of the map is at the origin of the node and rows go downwards like in Tiled.
+        class TileMap: public Component
+        {
+        public:
+            static const uint32_t CHUNK_SIZE = 32;
+
+            static const uint32_t FLIPPED_HORIZONTALLY = 0x80000000;
+            static const uint32_t FLIPPED_VERTICALLY = 0x40000000;
+            static const uint32_t FLIPPED_DIAGONALLY = 0x20000000;
+            static const uint32_t GID_MASK = ~(FLIPPED_HORIZONTALLY | FLIPPED_VERTICALLY | FLIPPED_DIAGONALLY);
+
+            struct Tileset
+            {
+                uint32_t firstGid = 1;
+                uint32_t tileCount = 0;
+                uint32_t columns = 0;
+                Size2 tileSize;
+                float margin = 0.0f;
+                float spacing = 0.0f;
+                graphics::TexturePtr texture;
+            };
+
+            TileMap();
+            TileMap(const std::string& filename);
+            virtual ~TileMap();
+
+            bool init(uint32_t newWidth, uint32_t newHeight, const Size2& newTileSize);
+            bool initFromFile(const std::string& filename);
+
+            virtual void draw(const Matrix4& projectionMatrix,
+                              const Matrix4& transformMatrix,
+                              const graphics::Color& drawColor,
+                              const graphics::RenderTargetPtr& renderTarget,
+                              bool scissorTestEnabled,
+                              const Rectangle& scissorTest) override;
+
+            virtual void drawWireframe(const Matrix4& projectionMatrix,
+                                       const Matrix4& transformMatrix,
+                                       const graphics::Color& drawColor,
+                                       const graphics::RenderTargetPtr& renderTarget,
+                                       bool scissorTestEnabled,
+                                       const Rectangle& scissorTest) override;
+
+            virtual const graphics::ShaderPtr& getShader() const { return shader; }
+            virtual void setShader(const graphics::ShaderPtr& newShader) { shader = newShader; }
+
+            virtual const graphics::BlendStatePtr& getBlendState() const { return blendState; }
+            virtual void setBlendState(const graphics::BlendStatePtr& newBlendState)  { blendState = newBlendState; }
+
+            uint32_t getWidth() const { return width; }
+            uint32_t getHeight() const { return height; }
+            const Size2& getTileSize() const { return tileSize; }
+
+            bool addTileset(const Tileset& tileset);
+            const std::vector<Tileset>& getTilesets() const { return tilesets; }
+
+            uint32_t addLayer(const std::string& name = "");
+            uint32_t getLayerCount() const { return static_cast<uint32_t>(layers.size()); }
+            const std::string& getLayerName(uint32_t layer) const { return layers[layer].name; }
+            void setLayerOpacity(uint32_t layer, float opacity);
+            void setLayerHidden(uint32_t layer, bool hidden);
+
+            uint32_t getTile(uint32_t layer, uint32_t x, uint32_t y) const;
+            bool setTile(uint32_t layer, uint32_t x, uint32_t y, uint32_t gid);
+
+            uint32_t getDrawnChunkCount() const { return drawnChunkCount; }
+            uint32_t getRebuiltChunkCount() const { return rebuiltChunkCount; }
+
+        protected:
+            struct Batch
+            {
+                uint32_t tileset;
+                graphics::MeshBufferPtr meshBuffer;
+            };
+
+            struct Chunk
+            {
+                AABB2 boundingBox;
+                std::vector<Batch> batches;
+                bool dirty = true;
+            };
+
+            struct TileLayer
+            {
+                std::string name;
+                float opacity = 1.0f;
+                bool hidden = false;
+                std::vector<uint32_t> tiles;
+                std::vector<Chunk> chunks;
+            };
+
+            bool loadJSON(const std::string& filename, const FileView& data);
+            bool loadTMX(const std::string& filename, const FileView& data);
+
+            int32_t getTilesetIndex(uint32_t gid) const;
+            void rebuildChunk(TileLayer& layer, uint32_t chunkX, uint32_t chunkY);
+            void updateBoundingBox();
+
+            graphics::ShaderPtr shader;
+            graphics::BlendStatePtr blendState;
+            graphics::TexturePtr whitePixelTexture;
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+            Size2 tileSize;
+            uint32_t chunksX = 0;
+            uint32_t chunksY = 0;
+
+            std::vector<Tileset> tilesets;
+            std::vector<TileLayer> layers;
+
+            uint32_t drawnChunkCount = 0;
+            uint32_t rebuiltChunkCount = 0;
+        };
+    } // namespace scene
+} // namespace ouzel
@@ -56,8 +56,7 @@
 {
     if (ouzel::sharedEngine)
     {
-        ouzel::Event event;
-        event.type = ouzel::Event::Type::LOW_MEMORY;
+        ouzel::Event event(ouzel::Event::Type::LOW_MEMORY);
 
         ouzel::sharedEngine->getEventDispatcher()->postEvent(event);
     }
@@ -0,0 +1,190 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#include <cstring>
+#include "Compression.h"
+
+namespace ouzel
+{
+    static const size_t MIN_MATCH = 4;
+    static const size_t MAX_OFFSET = 65535;
+
+    // the format requires the last match to start at least 12 bytes and end at least 5 bytes before the end
+    static const size_t MATCH_START_LIMIT = 12;
+    static const size_t MATCH_END_LIMIT = 5;
+
+    static const uint32_t HASH_BITS = 16;
+
+    static inline uint32_t read32(const uint8_t* data)
+    {
+        uint32_t result;
+        memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    static inline uint32_t hash32(uint32_t value)
+    {
+        return (value * 2654435761U) >> (32 - HASH_BITS);
+    }
+
+    static void writeLength(size_t length, std::vector<uint8_t>& output)
+    {
+        for (; length >= 255; length -= 255)
+        {
+            output.push_back(255);
+        }
+
+        output.push_back(static_cast<uint8_t>(length));
+    }
+
+    static void writeSequence(const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength, std::vector<uint8_t>& output)
+    {
+        size_t extraMatchLength = matchLength ? matchLength - MIN_MATCH : 0;
+
+        uint8_t token = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+        if (matchLength) token |= static_cast<uint8_t>(extraMatchLength < 15 ? extraMatchLength : 15);
+        output.push_back(token);
+
+        if (literalLength >= 15) writeLength(literalLength - 15, output);
+        output.insert(output.end(), literals, literals + literalLength);
+
+        // the last sequence has only literals
+        if (matchLength)
+        {
+            output.push_back(static_cast<uint8_t>(offset));
+            output.push_back(static_cast<uint8_t>(offset >> 8));
+
+            if (extraMatchLength >= 15) writeLength(extraMatchLength - 15, output);
+        }
+    }
+
+    void compressLZ4(const uint8_t* input, size_t inputSize, std::vector<uint8_t>& output)
+    {
+        output.clear();
+        output.reserve(inputSize + inputSize / 255 + 16);
+
+        size_t anchor = 0;
+
+        if (inputSize > MATCH_START_LIMIT)
+        {
+            // positions of the last occurrence of every hashed 4-byte sequence
+            std::vector<uint32_t> table(1 << HASH_BITS, 0xFFFFFFFF);
+            size_t matchStartLimit = inputSize - MATCH_START_LIMIT;
+            size_t matchEndLimit = inputSize - MATCH_END_LIMIT;
+            size_t position = 0;
+
+            while (position < matchStartLimit)
+            {
+                uint32_t sequence = read32(input + position);
+                uint32_t& entry = table[hash32(sequence)];
+                size_t reference = entry;
+                entry = static_cast<uint32_t>(position);
+
+                if (reference == 0xFFFFFFFF || position - reference > MAX_OFFSET || read32(input + reference) != sequence)
+                {
+                    ++position;
+                    continue;
+                }
+
+                size_t matchLength = MIN_MATCH;
+
+                while (position + matchLength < matchEndLimit && input[reference + matchLength] == input[position + matchLength])
+                {
+                    ++matchLength;
+                }
+
+                writeSequence(input + anchor, position - anchor, position - reference, matchLength, output);
+
+                position += matchLength;
+                anchor = position;
+            }
+        }
+
+        writeSequence(input + anchor, inputSize - anchor, 0, 0, output);
+    }
+
+    bool decompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize)
+    {
+        const uint8_t* inputEnd = input + inputSize;
+        uint8_t* position = output;
+        uint8_t* outputEnd = output + outputSize;
+
+        while (input < inputEnd)
+        {
+            uint8_t token = *input++;
+            size_t literalLength = token >> 4;
+
+            if (literalLength == 15)
+            {
+                uint8_t byte;
+
+                do
+                {
+                    if (input >= inputEnd) return false;
+                    byte = *input++;
+                    literalLength += byte;
+                }
+                while (byte == 255);
+            }
+
+            if (literalLength > static_cast<size_t>(inputEnd - input) ||
+                literalLength > static_cast<size_t>(outputEnd - position))
+            {
+                return false;
+            }
+
+            memcpy(position, input, literalLength);
+            input += literalLength;
+            position += literalLength;
+
+            if (input == inputEnd)
+            {
+                break;
+            }
+
+            if (inputEnd - input < 2) return false;
+
+            size_t offset = static_cast<size_t>(input[0]) | static_cast<size_t>(input[1]) << 8;
+            input += 2;
+
+            if (offset == 0 || offset > static_cast<size_t>(position - output))
+            {
+                return false;
+            }
+
+            size_t matchLength = token & 0x0F;
+
+            if (matchLength == 15)
+            {
+                uint8_t byte;
+
+                do
+                {
+                    if (input >= inputEnd) return false;
+                    byte = *input++;
+                    matchLength += byte;
+                }
+                while (byte == 255);
+            }
+
+            matchLength += MIN_MATCH;
+
+            if (matchLength > static_cast<size_t>(outputEnd - position))
+            {
+                return false;
+            }
+
+            // the match can overlap the bytes it produces, so it is copied byte by byte
+            const uint8_t* match = position - offset;
+
+            for (size_t i = 0; i < matchLength; ++i)
+            {
+                position[i] = match[i];
+            }
+
+            position += matchLength;
+        }
+
+        return position == outputEnd;
+    }
+}
@@ -0,0 +1,17 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    // compresses the data to an LZ4 block (without the frame header), favouring speed over the compression ratio
+    void compressLZ4(const uint8_t* input, size_t inputSize, std::vector<uint8_t>& output);
+
+    // decompresses an LZ4 block, that has to decompress to exactly outputSize bytes
+    bool decompressLZ4(const uint8_t* input, size_t inputSize, uint8_t* output, size_t outputSize);
+}
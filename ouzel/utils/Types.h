@@ -17,6 +17,15 @@ namespace ouzel
     class Cache;
     typedef std::shared_ptr<Cache> CachePtr;
 
+    class Font;
+    typedef std::shared_ptr<Font> FontPtr;
+
+    class BMFont;
+    typedef std::shared_ptr<BMFont> BMFontPtr;
+
+    class GlyphAtlas;
+    typedef std::shared_ptr<GlyphAtlas> GlyphAtlasPtr;
+
     class Localization;
     typedef std::shared_ptr<Localization> LocalizationPtr;
 
@@ -97,6 +106,15 @@ namespace ouzel
         class SpriteFrame;
         typedef std::shared_ptr<SpriteFrame> SpriteFramePtr;
 
+        class SpriteClip;
+        typedef std::shared_ptr<SpriteClip> SpriteClipPtr;
+
+        class SpriteAnimationSystem;
+        typedef std::shared_ptr<SpriteAnimationSystem> SpriteAnimationSystemPtr;
+
+        class ParticleWorld;
+        typedef std::shared_ptr<ParticleWorld> ParticleWorldPtr;
+
         class NodeContainer;
         typedef std::shared_ptr<NodeContainer> NodeContainerPtr;
         typedef std::weak_ptr<NodeContainer> NodeContainerWeakPtr;
@@ -120,6 +138,9 @@ namespace ouzel
         class TextDrawable;
         typedef std::shared_ptr<TextDrawable> TextDrawablePtr;
 
+        class TileMap;
+        typedef std::shared_ptr<TileMap> TileMapPtr;
+
         class Animator;
         typedef std::shared_ptr<Animator> AnimatorPtr;
         typedef std::weak_ptr<Animator> AnimatorWeakPtr;
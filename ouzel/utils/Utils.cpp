@@ -81,4 +81,59 @@ namespace ouzel
 
         return rand * diff + min;
     }
+
+    uint32_t decodeUTF8(const std::string& text, uint32_t& offset)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text.data());
+        uint32_t length = static_cast<uint32_t>(text.length());
+
+        uint32_t result = bytes[offset++];
+        uint32_t extra;
+        uint32_t minimum;
+
+        if (result < 0x80)
+        {
+            return result;
+        }
+        else if ((result & 0xE0) == 0xC0)
+        {
+            result &= 0x1F;
+            extra = 1;
+            minimum = 0x80;
+        }
+        else if ((result & 0xF0) == 0xE0)
+        {
+            result &= 0x0F;
+            extra = 2;
+            minimum = 0x800;
+        }
+        else if ((result & 0xF8) == 0xF0)
+        {
+            result &= 0x07;
+            extra = 3;
+            minimum = 0x10000;
+        }
+        else
+        {
+            return 0xFFFD;
+        }
+
+        for (uint32_t i = 0; i < extra; ++i)
+        {
+            if (offset >= length || (bytes[offset] & 0xC0) != 0x80)
+            {
+                return 0xFFFD;
+            }
+
+            result = (result << 6) | (bytes[offset++] & 0x3F);
+        }
+
+        // overlong encodings, surrogates and code points above U+10FFFF are not valid
+        if (result < minimum || result > 0x10FFFF || (result >= 0xD800 && result <= 0xDFFF))
+        {
+            return 0xFFFD;
+        }
+
+        return result;
+    }
 }
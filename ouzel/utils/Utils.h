@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 
 #include "core/CompileConfig.h"
@@ -57,6 +58,44 @@ namespace ouzel
     uint32_t random(uint32_t min = 0, uint32_t max = std::numeric_limits<uint32_t>::max());
     float randomf(float min = 0.0f, float max = 1.0f);
 
+    // PCG32 generator for code that needs many random numbers per frame, e.g. particle emitters
+    class FastRandom
+    {
+    public:
+        FastRandom(uint64_t seed = 0x853C49E6748FEA9BULL, uint64_t sequence = 0xDA3E39CB94B95BDBULL)
+        {
+            setSeed(seed, sequence);
+        }
+
+        void setSeed(uint64_t seed, uint64_t sequence = 0xDA3E39CB94B95BDBULL)
+        {
+            state = 0;
+            increment = (sequence << 1) | 1;
+            next();
+            state += seed;
+            next();
+        }
+
+        uint32_t next()
+        {
+            uint64_t oldState = state;
+            state = oldState * 6364136223846793005ULL + increment;
+            uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+            uint32_t rotation = static_cast<uint32_t>(oldState >> 59);
+            return (xorShifted >> rotation) | (xorShifted << ((~rotation + 1) & 31));
+        }
+
+        float nextFloat(float min = 0.0f, float max = 1.0f)
+        {
+            // 24 random bits fit exactly into the mantissa of a float
+            return static_cast<float>(next() >> 8) * (1.0f / 16777216.0f) * (max - min) + min;
+        }
+
+    private:
+        uint64_t state;
+        uint64_t increment;
+    };
+
     inline uint32_t readUInt32Big(const uint8_t* buffer)
     {
         uint32_t result = static_cast<uint32_t>(buffer[3]) |
@@ -77,6 +116,22 @@ namespace ouzel
         return result;
     };
 
+    inline uint64_t readUInt64Little(const uint8_t* buffer)
+    {
+        return static_cast<uint64_t>(readUInt32Little(buffer)) |
+               static_cast<uint64_t>(readUInt32Little(buffer + 4)) << 32;
+    };
+
+    // IEEE 754 single precision float
+    inline float readFloatLittle(const uint8_t* buffer)
+    {
+        uint32_t value = readUInt32Little(buffer);
+        float result;
+        memcpy(&result, &value, sizeof(result));
+
+        return result;
+    };
+
     inline uint16_t readUInt16Big(const uint8_t* buffer)
     {
         uint32_t result = static_cast<uint32_t>(buffer[0]) |
@@ -92,4 +147,7 @@ namespace ouzel
 
         return static_cast<uint16_t>(result);
     };
+
+    // decodes the UTF-8 sequence at offset and moves offset past it, malformed sequences decode to U+FFFD
+    uint32_t decodeUTF8(const std::string& text, uint32_t& offset);
 }
@@ -216,8 +216,7 @@ namespace ouzel
                     {
                         gamepads[i].reset(new GamepadWin(static_cast<int32_t>(i)));
 
-                        Event event;
-                        event.type = Event::Type::GAMEPAD_CONNECT;
+                        Event event(Event::Type::GAMEPAD_CONNECT);
 
                         event.gamepadEvent.gamepad = gamepads[i];
 
@@ -230,8 +229,7 @@ namespace ouzel
                 {
                     if (gamepads[i])
                     {
-                        Event event;
-                        event.type = Event::Type::GAMEPAD_DISCONNECT;
+                        Event event(Event::Type::GAMEPAD_DISCONNECT);
 
                         event.gamepadEvent.gamepad = gamepads[i];
 
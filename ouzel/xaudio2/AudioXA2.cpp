@@ -3,7 +3,6 @@
 
 #include "AudioXA2.h"
 #include "SoundDataXA2.h"
-#include "SoundXA2.h"
 #include "utils/Utils.h"
 
 namespace ouzel
@@ -17,6 +16,7 @@ namespace ouzel
 
         AudioXA2::~AudioXA2()
         {
+            if (sourceVoice) sourceVoice->DestroyVoice();
             if (masteringVoice) masteringVoice->DestroyVoice();
             if (xAudio) xAudio->Release();
         }
@@ -25,6 +25,12 @@ namespace ouzel
         {
             Audio::free();
 
+            if (sourceVoice)
+            {
+                sourceVoice->DestroyVoice();
+                sourceVoice = nullptr;
+            }
+
             if (masteringVoice)
             {
                 masteringVoice->DestroyVoice();
@@ -59,6 +65,35 @@ namespace ouzel
                 return false;
             }
 
+            WAVEFORMATEX waveFormat;
+            waveFormat.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+            waveFormat.nChannels = Mixer::CHANNELS;
+            waveFormat.nSamplesPerSec = mixer.getSampleRate();
+            waveFormat.wBitsPerSample = sizeof(float) * 8;
+            waveFormat.nBlockAlign = Mixer::CHANNELS * sizeof(float);
+            waveFormat.nAvgBytesPerSec = waveFormat.nSamplesPerSec * waveFormat.nBlockAlign;
+            waveFormat.cbSize = 0;
+
+            if (FAILED(xAudio->CreateSourceVoice(&sourceVoice, &waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this)))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to create source voice");
+                return false;
+            }
+
+            for (uint32_t i = 0; i < BUFFER_COUNT; ++i)
+            {
+                if (!submitBuffer(i))
+                {
+                    return false;
+                }
+            }
+
+            if (FAILED(sourceVoice->Start()))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to start consuming sound data");
+                return false;
+            }
+
             ready = true;
 
             return true;
@@ -70,10 +105,36 @@ namespace ouzel
             return soundData;
         }
 
-        SoundPtr AudioXA2::createSound()
+        void AudioXA2::OnBufferEnd(void* bufferContext)
         {
-            SoundPtr sound(new SoundXA2());
-            return sound;
+            submitBuffer(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(bufferContext)));
+        }
+
+        bool AudioXA2::submitBuffer(uint32_t index)
+        {
+            std::vector<float>& buffer = buffers[index];
+
+            buffer.resize(BUFFER_FRAMES * Mixer::CHANNELS);
+            mixer.mix(buffer.data(), BUFFER_FRAMES);
+
+            XAUDIO2_BUFFER bufferData;
+            bufferData.Flags = 0;
+            bufferData.AudioBytes = static_cast<UINT32>(buffer.size() * sizeof(float));
+            bufferData.pAudioData = reinterpret_cast<const BYTE*>(buffer.data());
+            bufferData.PlayBegin = 0;
+            bufferData.PlayLength = 0;
+            bufferData.LoopBegin = 0;
+            bufferData.LoopLength = 0;
+            bufferData.LoopCount = 0;
+            bufferData.pContext = reinterpret_cast<void*>(static_cast<uintptr_t>(index));
+
+            if (FAILED(sourceVoice->SubmitSourceBuffer(&bufferData)))
+            {
+                log(LOG_LEVEL_ERROR, "Failed to upload sound data");
+                return false;
+            }
+
+            return true;
         }
     } // namespace audio
 } // namespace ouzel
@@ -6,13 +6,14 @@
 #define NOMINMAX
 #include <xaudio2.h>
 
+#include <vector>
 #include "audio/Audio.h"
 
 namespace ouzel
 {
     namespace audio
     {
-        class AudioXA2: public Audio
+        class AudioXA2: public Audio, public IXAudio2VoiceCallback
         {
             friend Engine;
         public:
@@ -22,15 +23,31 @@ namespace ouzel
             virtual bool init() override;
 
             virtual SoundDataPtr createSoundData() override;
-            virtual SoundPtr createSound() override;
 
             IXAudio2* getXAudio() const { return xAudio; }
 
+            virtual void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32) override {}
+            virtual void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+            virtual void STDMETHODCALLTYPE OnStreamEnd() override {}
+            virtual void STDMETHODCALLTYPE OnBufferStart(void*) override {}
+            virtual void STDMETHODCALLTYPE OnBufferEnd(void* bufferContext) override;
+            virtual void STDMETHODCALLTYPE OnLoopEnd(void*) override {}
+            virtual void STDMETHODCALLTYPE OnVoiceError(void*, HRESULT) override {}
+
         protected:
             AudioXA2();
 
+            bool submitBuffer(uint32_t index);
+
             IXAudio2* xAudio = nullptr;
             IXAudio2MasteringVoice* masteringVoice = nullptr;
+
+            // the output of the mixer is streamed through one source voice, every buffer is refilled when it ends
+            static const uint32_t BUFFER_COUNT = 2;
+            static const uint32_t BUFFER_FRAMES = 1024;
+
+            IXAudio2SourceVoice* sourceVoice = nullptr;
+            std::vector<float> buffers[BUFFER_COUNT];
         };
     } // namespace audio
 } // namespace ouzel
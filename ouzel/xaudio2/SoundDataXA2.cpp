@@ -15,9 +15,9 @@ namespace ouzel
         {
         }
 
-        bool SoundDataXA2::initFromBuffer(const std::vector<uint8_t>& newData)
+        bool SoundDataXA2::initFromBuffer(const uint8_t* newData, size_t newSize)
         {
-            if (!SoundData::initFromBuffer(newData))
+            if (!SoundData::initFromBuffer(newData, newSize))
             {
                 return false;
             }
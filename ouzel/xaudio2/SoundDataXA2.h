@@ -19,7 +19,7 @@ namespace ouzel
             friend AudioXA2;
         public:
             virtual ~SoundDataXA2();
-            virtual bool initFromBuffer(const std::vector<uint8_t>& newData) override;
+            virtual bool initFromBuffer(const uint8_t* newData, size_t newSize) override;
 
             const WAVEFORMATEX& getWaveFormat() const { return waveFormat; }
 
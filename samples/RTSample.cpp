@@ -40,6 +40,28 @@ RTSample::RTSample(Samples& pSamples):
     rtNode->addComponent(rtSprite);
     layer->addChild(rtNode);
 
+    // the same semi-transparent sprite drawn through a cached and an uncached layer, both must look the same
+    scene::LayerPtr cachedLayer = make_shared<scene::Layer>();
+    cachedLayer->setCamera(make_shared<scene::Camera>());
+    cachedLayer->setCached(true);
+    addLayer(cachedLayer);
+
+    scene::LayerPtr uncachedLayer = make_shared<scene::Layer>();
+    uncachedLayer->setCamera(make_shared<scene::Camera>());
+    addLayer(uncachedLayer);
+
+    scene::NodePtr cachedWitch = make_shared<scene::Node>();
+    cachedWitch->addComponent(make_shared<scene::Sprite>("witch.png"));
+    cachedWitch->setPosition(Vector2(-200.0f, 200.0f));
+    cachedWitch->setOpacity(0.5f);
+    cachedLayer->addChild(cachedWitch);
+
+    scene::NodePtr uncachedWitch = make_shared<scene::Node>();
+    uncachedWitch->addComponent(make_shared<scene::Sprite>("witch.png"));
+    uncachedWitch->setPosition(Vector2(200.0f, 200.0f));
+    uncachedWitch->setOpacity(0.5f);
+    uncachedLayer->addChild(uncachedWitch);
+
     scene::LayerPtr guiLayer = make_shared<scene::Layer>();
     guiLayer->setCamera(make_shared<scene::Camera>());
     addLayer(guiLayer);
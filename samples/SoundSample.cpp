@@ -13,17 +13,14 @@ SoundSample::SoundSample(Samples& pSamples):
     eventHandler.uiHandler = bind(&SoundSample::handleUI, this, placeholders::_1, placeholders::_2);
     sharedEngine->getEventDispatcher()->addEventHandler(eventHandler);
 
-    audio::SoundDataPtr jumpData = sharedEngine->getAudio()->createSoundData();
-    jumpData->initFromFile("jump.wav");
+    sharedEngine->getCache()->preloadSoundData("jump.wav");
+    sharedEngine->getCache()->preloadSoundData("ambient.wav");
 
     jumpSound = sharedEngine->getAudio()->createSound();
-    jumpSound->init(jumpData);
-
-    audio::SoundDataPtr ambientData = sharedEngine->getAudio()->createSoundData();
-    ambientData->initFromFile("ambient.wav");
+    jumpSound->init(sharedEngine->getCache()->getSoundData("jump.wav"));
 
     ambientSound = sharedEngine->getAudio()->createSound();
-    ambientSound->init(ambientData);
+    ambientSound->init(sharedEngine->getCache()->getSoundData("ambient.wav"));
 
     scene::LayerPtr guiLayer = make_shared<scene::Layer>();
     guiLayer->setCamera(make_shared<scene::Camera>());
@@ -0,0 +1,249 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+// Measures the sample conversion, the resampler and the mixer. The conversions are compared with plain scalar loops,
+// that also check the results, including samples outside of the range [-1, 1], that have to be clipped.
+// Usage: audiobench [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "audio/Convert.h"
+#include "audio/Mixer.h"
+#include "audio/SoundData.h"
+
+using namespace ouzel;
+
+static const uint32_t SAMPLE_COUNT = 1000000;
+static const uint32_t SECONDS = 10;
+static const uint32_t INPUT_RATE = 44100;
+static const uint32_t OUTPUT_RATE = 48000;
+static const uint32_t MIX_FRAMES = 512;
+
+class BenchSoundData: public audio::SoundData
+{
+public:
+    BenchSoundData() {}
+};
+
+template<class T>
+static double measure(uint32_t iterations, T function)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        function();
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+static void writeUInt16(std::vector<uint8_t>& buffer, uint16_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void writeUInt32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    writeUInt16(buffer, static_cast<uint16_t>(value));
+    writeUInt16(buffer, static_cast<uint16_t>(value >> 16));
+}
+
+// 16-bit stereo wave file
+static std::vector<uint8_t> createWave(const std::vector<int16_t>& samples, uint32_t sampleRate)
+{
+    std::vector<uint8_t> result;
+    uint32_t dataSize = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+
+    result.insert(result.end(), { 'R', 'I', 'F', 'F' });
+    writeUInt32(result, 36 + dataSize);
+    result.insert(result.end(), { 'W', 'A', 'V', 'E', 'f', 'm', 't', ' ' });
+    writeUInt32(result, 16);
+    writeUInt16(result, 1); // PCM
+    writeUInt16(result, 2);
+    writeUInt32(result, sampleRate);
+    writeUInt32(result, sampleRate * 4);
+    writeUInt16(result, 4);
+    writeUInt16(result, 16);
+    result.insert(result.end(), { 'd', 'a', 't', 'a' });
+    writeUInt32(result, dataSize);
+
+    for (int16_t sample : samples)
+    {
+        writeUInt16(result, static_cast<uint16_t>(sample));
+    }
+
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t iterations = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 10;
+
+    if (iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    // every eighth sample is out of range, some of them so far that they do not fit in the integer types when scaled
+    std::vector<float> samples(SAMPLE_COUNT);
+
+    for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        samples[i] = distribution(generator) * ((i % 1024 == 0) ? 1000000.0f : (i % 8 == 0) ? 4.0f : 1.0f);
+    }
+
+    std::vector<uint8_t> input24(SAMPLE_COUNT * 3);
+    std::vector<int16_t> input16(SAMPLE_COUNT);
+
+    for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        int32_t sample = static_cast<int32_t>(std::lrint(std::max(-1.0f, std::min(1.0f, samples[i])) * 8388607.0f));
+        input24[i * 3 + 0] = static_cast<uint8_t>(sample);
+        input24[i * 3 + 1] = static_cast<uint8_t>(sample >> 8);
+        input24[i * 3 + 2] = static_cast<uint8_t>(sample >> 16);
+        input16[i] = static_cast<int16_t>(sample >> 8);
+    }
+
+    std::vector<float> output(SAMPLE_COUNT);
+    std::vector<float> reference(SAMPLE_COUNT);
+    std::vector<int16_t> output16(SAMPLE_COUNT);
+    std::vector<int16_t> reference16(SAMPLE_COUNT);
+    std::vector<uint8_t> output8(SAMPLE_COUNT);
+    std::vector<uint8_t> reference8(SAMPLE_COUNT);
+    bool failed = false;
+
+    printf("conversion of %u samples, ms (scalar ms):\n", SAMPLE_COUNT);
+
+    double time = measure(iterations, [&]() {
+        audio::convertToFloat(reinterpret_cast<const uint8_t*>(input16.data()), 16, SAMPLE_COUNT, output.data());
+    });
+    double scalarTime = measure(iterations, [&]() {
+        for (uint32_t i = 0; i < SAMPLE_COUNT; ++i) reference[i] = input16[i] / 32768.0f;
+    });
+    failed |= (output != reference);
+    printf("  16-bit to float: %.3f (%.3f)\n", time, scalarTime);
+
+    time = measure(iterations, [&]() {
+        audio::convertToFloat(input24.data(), 24, SAMPLE_COUNT, output.data());
+    });
+    scalarTime = measure(iterations, [&]() {
+        for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+        {
+            int32_t sample = static_cast<int32_t>(static_cast<uint32_t>(input24[i * 3]) << 8 |
+                                                  static_cast<uint32_t>(input24[i * 3 + 1]) << 16 |
+                                                  static_cast<uint32_t>(input24[i * 3 + 2]) << 24) >> 8;
+            reference[i] = sample / 8388608.0f;
+        }
+    });
+    failed |= (output != reference);
+    printf("  24-bit to float: %.3f (%.3f)\n", time, scalarTime);
+
+    time = measure(iterations, [&]() {
+        audio::convertFromFloat(samples.data(), SAMPLE_COUNT, 16, reinterpret_cast<uint8_t*>(output16.data()));
+    });
+    scalarTime = measure(iterations, [&]() {
+        for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+        {
+            reference16[i] = static_cast<int16_t>(std::lrint(std::max(-1.0f, std::min(1.0f, samples[i])) * 32767.0f));
+        }
+    });
+
+    // ARMv7 rounds halfway cases away from zero, so the results can differ by one
+    for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        failed |= (std::abs(output16[i] - reference16[i]) > 1);
+    }
+
+    printf("  float to 16-bit: %.3f (%.3f)\n", time, scalarTime);
+
+    time = measure(iterations, [&]() {
+        audio::convertFromFloat(samples.data(), SAMPLE_COUNT, 8, output8.data());
+    });
+    scalarTime = measure(iterations, [&]() {
+        for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+        {
+            reference8[i] = static_cast<uint8_t>(std::lrint(std::max(-1.0f, std::min(1.0f, samples[i])) * 127.0f) + 128);
+        }
+    });
+
+    for (uint32_t i = 0; i < SAMPLE_COUNT; ++i)
+    {
+        failed |= (std::abs(output8[i] - reference8[i]) > 1);
+    }
+
+    printf("  float to 8-bit:  %.3f (%.3f)\n", time, scalarTime);
+
+    if (failed)
+    {
+        fprintf(stderr, "Converted samples differ from the scalar results\n");
+        return EXIT_FAILURE;
+    }
+
+    // a 440 Hz tone with some noise
+    std::vector<float> wave(INPUT_RATE * SECONDS * 2);
+
+    for (uint32_t frame = 0; frame < INPUT_RATE * SECONDS; ++frame)
+    {
+        float value = 0.5f * std::sin(frame * 2.0f * 3.14159265f * 440.0f / INPUT_RATE) + 0.1f * distribution(generator);
+        wave[frame * 2] = value;
+        wave[frame * 2 + 1] = value;
+    }
+
+    audio::Resampler resampler;
+    std::vector<float> resampled;
+
+    if (!resampler.init(INPUT_RATE, OUTPUT_RATE, 2))
+    {
+        return EXIT_FAILURE;
+    }
+
+    time = measure(iterations, [&]() {
+        resampler.reset();
+        resampler.resample(wave, resampled);
+    });
+    printf("resampling %u s of stereo from %u Hz to %u Hz: %.3f ms\n", SECONDS, INPUT_RATE, OUTPUT_RATE, time);
+
+    // the sound data is not converted to the rate of the mixer, so every voice resamples while mixing
+    std::vector<int16_t> wave16(wave.size());
+    audio::convertFromFloat(wave.data(), static_cast<uint32_t>(wave.size()), 16, reinterpret_cast<uint8_t*>(wave16.data()));
+
+    std::shared_ptr<BenchSoundData> soundData = std::make_shared<BenchSoundData>();
+
+    if (!soundData->initFromBuffer(createWave(wave16, INPUT_RATE)))
+    {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<float> mixOutput(MIX_FRAMES * audio::Mixer::CHANNELS);
+
+    for (uint32_t voices : { 1, 8, 32 })
+    {
+        audio::Mixer mixer(voices, OUTPUT_RATE);
+
+        for (uint32_t voice = 0; voice < voices; ++voice)
+        {
+            mixer.play(soundData, true, 0, 1.0f / voices);
+        }
+
+        time = measure(iterations, [&]() {
+            for (uint32_t frame = 0; frame < OUTPUT_RATE * SECONDS; frame += MIX_FRAMES)
+            {
+                mixer.mix(mixOutput.data(), MIX_FRAMES);
+            }
+        });
+        printf("mixing %u s with %u resampled voices: %.3f ms\n", SECONDS, voices, time);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,571 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+// Cooks the files of a directory into an output directory with the same layout and file names. Images are decoded and
+// written with their mip maps as cooked textures, sprite sheets and particle definitions are converted from JSON to
+// binary files and the other files are copied. The loaders of the engine recognize the cooked files by their contents.
+// Usage: cooker [-p] [-n] [-b] [-f format] directory output-directory
+//   -p  premultiply the alpha of the textures (sprites then use the premultiplied alpha blend state)
+//   -f  pixel format of the textures: rgba8 (default), rgb565, rgba4444 (both dithered) or a8
+//   -n  store the textures uncompressed
+//   -b  store only the base level of the textures, the mip maps are generated when they are loaded
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <rapidjson/rapidjson.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/document.h>
+#include "core/Application.h"
+#include "files/Archive.h"
+#include "files/FileSystem.h"
+#include "graphics/Image.h"
+#include "graphics/PixelFormat.h"
+#include "graphics/Texture.h"
+#include "scene/ParticleDefinition.h"
+#include "scene/SpriteFrame.h"
+#include "utils/Compression.h"
+
+using namespace ouzel;
+
+struct Options
+{
+    bool premultiplyAlpha = false;
+    bool compress = true;
+    bool mipMaps = true;
+    graphics::PixelFormat pixelFormat = graphics::PixelFormat::RGBA8;
+};
+
+static bool listFiles(const std::string& directory, const std::string& prefix, std::vector<std::string>& files)
+{
+    DIR* dir = opendir(directory.c_str());
+
+    if (!dir)
+    {
+        fprintf(stderr, "Failed to open directory %s\n", directory.c_str());
+        return false;
+    }
+
+    while (dirent* ent = readdir(dir))
+    {
+        std::string name = ent->d_name;
+
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+
+        std::string path = directory + "/" + name;
+        struct stat buf;
+
+        if (stat(path.c_str(), &buf) != 0)
+        {
+            continue;
+        }
+
+        if ((buf.st_mode & S_IFMT) == S_IFDIR)
+        {
+            if (!listFiles(path, prefix + name + "/", files))
+            {
+                closedir(dir);
+                return false;
+            }
+        }
+        else if ((buf.st_mode & S_IFMT) == S_IFREG)
+        {
+            files.push_back(prefix + name);
+        }
+    }
+
+    closedir(dir);
+
+    return true;
+}
+
+static bool createDirectories(const std::string& path)
+{
+    for (size_t pos = path.find('/', 1); ; pos = path.find('/', pos + 1))
+    {
+        std::string directory = path.substr(0, pos);
+        struct stat buf;
+
+        if (stat(directory.c_str(), &buf) != 0 && mkdir(directory.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH) != 0)
+        {
+            fprintf(stderr, "Failed to create directory %s\n", directory.c_str());
+            return false;
+        }
+
+        if (pos == std::string::npos)
+        {
+            return true;
+        }
+    }
+}
+
+static bool readFile(const std::string& path, std::vector<uint8_t>& data)
+{
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    std::streamoff size = stream.tellg();
+
+    if (!stream || size < 0)
+    {
+        fprintf(stderr, "Failed to read %s\n", path.c_str());
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(size));
+    stream.seekg(0, std::ios::beg);
+
+    if (!data.empty() && !stream.read(reinterpret_cast<char*>(data.data()), size))
+    {
+        fprintf(stderr, "Failed to read %s\n", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static bool writeFile(const std::string& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+    if (!stream.write(reinterpret_cast<const char*>(data.data()), data.size()))
+    {
+        fprintf(stderr, "Failed to write %s\n", path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static void writeUInt16(std::vector<uint8_t>& buffer, uint16_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void writeUInt32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    writeUInt16(buffer, static_cast<uint16_t>(value));
+    writeUInt16(buffer, static_cast<uint16_t>(value >> 16));
+}
+
+static void writeFloat(std::vector<uint8_t>& buffer, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeUInt32(buffer, bits);
+}
+
+static void writeString(std::vector<uint8_t>& buffer, const std::string& value)
+{
+    writeUInt16(buffer, static_cast<uint16_t>(value.size()));
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+static void writeSignature(std::vector<uint8_t>& buffer, const char* signature)
+{
+    buffer.insert(buffer.end(), signature, signature + 4);
+}
+
+static bool cookTexture(const std::vector<uint8_t>& data, const Options& options, std::vector<uint8_t>& output)
+{
+    graphics::Image image;
+
+    if (!image.initFromBuffer(data))
+    {
+        return false;
+    }
+
+    std::vector<Size2> sizes(1, image.getSize());
+    std::vector<std::vector<uint8_t>> levels(1, image.getData());
+
+    if (options.mipMaps)
+    {
+        while (sizes.back().width > 1.0f || sizes.back().height > 1.0f)
+        {
+            Size2 size;
+            std::vector<uint8_t> level;
+            graphics::Image::downsample(levels.back(), sizes.back(), level, size);
+
+            sizes.push_back(size);
+            levels.push_back(std::move(level));
+        }
+    }
+
+    // the mip maps are generated from the straight alpha values
+    if (options.premultiplyAlpha)
+    {
+        for (std::vector<uint8_t>& level : levels)
+        {
+            graphics::Image::premultiplyAlpha(level);
+        }
+    }
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        std::vector<uint8_t> level;
+        graphics::encodePixels(levels[i].data(), static_cast<uint32_t>(sizes[i].width), static_cast<uint32_t>(sizes[i].height),
+                               options.pixelFormat, level);
+        levels[i].swap(level);
+    }
+
+    Archive::Compression compression = Archive::COMPRESSION_NONE;
+
+    if (options.compress)
+    {
+        std::vector<std::vector<uint8_t>> compressedLevels(levels.size());
+        size_t size = 0;
+        size_t compressedSize = 0;
+
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            compressLZ4(levels[i].data(), levels[i].size(), compressedLevels[i]);
+            size += levels[i].size();
+            compressedSize += compressedLevels[i].size();
+        }
+
+        // the same rule as for the archives, the data has to get at least 10% smaller
+        if (compressedSize < size - size / 10)
+        {
+            levels.swap(compressedLevels);
+            compression = Archive::COMPRESSION_LZ4;
+        }
+    }
+
+    output.clear();
+    writeSignature(output, "OTEX");
+    writeUInt32(output, graphics::Texture::COOKED_VERSION);
+    writeUInt32(output, static_cast<uint32_t>(sizes.front().width));
+    writeUInt32(output, static_cast<uint32_t>(sizes.front().height));
+    writeUInt32(output, static_cast<uint32_t>(levels.size()));
+    writeUInt32(output, options.premultiplyAlpha ? graphics::Texture::COOKED_PREMULTIPLIED_ALPHA : 0);
+    writeUInt32(output, compression);
+    writeUInt32(output, static_cast<uint32_t>(options.pixelFormat));
+
+    for (size_t i = 0; i < levels.size(); ++i)
+    {
+        writeUInt32(output, static_cast<uint32_t>(sizes[i].width));
+        writeUInt32(output, static_cast<uint32_t>(sizes[i].height));
+        writeUInt32(output, static_cast<uint32_t>(levels[i].size()));
+    }
+
+    for (const std::vector<uint8_t>& level : levels)
+    {
+        output.insert(output.end(), level.begin(), level.end());
+    }
+
+    return true;
+}
+
+static void cookSpriteFrames(const rapidjson::Document& document, std::vector<uint8_t>& output)
+{
+    const rapidjson::Value& framesArray = document["frames"];
+
+    output.clear();
+    writeSignature(output, "OSPR");
+    writeUInt32(output, scene::SpriteFrame::COOKED_VERSION);
+    writeUInt32(output, static_cast<uint32_t>(framesArray.Size()));
+    writeString(output, document["meta"]["image"].GetString());
+
+    for (rapidjson::SizeType index = 0; index < framesArray.Size(); ++index)
+    {
+        const rapidjson::Value& frameObject = framesArray[index];
+
+        bool mesh = frameObject.HasMember("vertices") &&
+            frameObject.HasMember("verticesUV") &&
+            frameObject.HasMember("triangles");
+
+        uint32_t flags = 0;
+
+        if (mesh)
+        {
+            flags |= scene::SpriteFrame::COOKED_MESH;
+        }
+        else if (frameObject["rotated"].GetBool())
+        {
+            flags |= scene::SpriteFrame::COOKED_ROTATED;
+        }
+
+        writeUInt32(output, flags);
+
+        const rapidjson::Value& frameRectangleObject = frameObject["frame"];
+        writeFloat(output, static_cast<float>(frameRectangleObject["x"].GetInt()));
+        writeFloat(output, static_cast<float>(frameRectangleObject["y"].GetInt()));
+        writeFloat(output, static_cast<float>(frameRectangleObject["w"].GetInt()));
+        writeFloat(output, static_cast<float>(frameRectangleObject["h"].GetInt()));
+
+        const rapidjson::Value& sourceSizeObject = frameObject["sourceSize"];
+        writeFloat(output, static_cast<float>(sourceSizeObject["w"].GetInt()));
+        writeFloat(output, static_cast<float>(sourceSizeObject["h"].GetInt()));
+
+        const rapidjson::Value& spriteSourceSizeObject = frameObject["spriteSourceSize"];
+        writeFloat(output, static_cast<float>(spriteSourceSizeObject["x"].GetInt()));
+        writeFloat(output, static_cast<float>(spriteSourceSizeObject["y"].GetInt()));
+
+        const rapidjson::Value& pivotObject = frameObject["pivot"];
+        writeFloat(output, pivotObject["x"].GetFloat());
+        writeFloat(output, pivotObject["y"].GetFloat());
+
+        if (mesh)
+        {
+            std::vector<uint16_t> indices;
+
+            const rapidjson::Value& trianglesObject = frameObject["triangles"];
+
+            for (rapidjson::SizeType triangleIndex = 0; triangleIndex < trianglesObject.Size(); ++triangleIndex)
+            {
+                const rapidjson::Value& triangleObject = trianglesObject[triangleIndex];
+
+                for (rapidjson::SizeType i = 0; i < triangleObject.Size(); ++i)
+                {
+                    indices.push_back(static_cast<uint16_t>(triangleObject[i].GetUint()));
+                }
+            }
+
+            writeUInt32(output, static_cast<uint32_t>(indices.size()));
+
+            for (uint16_t i : indices)
+            {
+                writeUInt16(output, i);
+            }
+
+            const rapidjson::Value& verticesObject = frameObject["vertices"];
+            const rapidjson::Value& verticesUVObject = frameObject["verticesUV"];
+
+            writeUInt32(output, static_cast<uint32_t>(verticesObject.Size()));
+
+            for (rapidjson::SizeType vertexIndex = 0; vertexIndex < verticesObject.Size(); ++vertexIndex)
+            {
+                const rapidjson::Value& vertexObject = verticesObject[vertexIndex];
+                const rapidjson::Value& vertexUVObject = verticesUVObject[vertexIndex];
+
+                writeFloat(output, static_cast<float>(vertexObject[rapidjson::SizeType(0)].GetInt()));
+                writeFloat(output, static_cast<float>(vertexObject[rapidjson::SizeType(1)].GetInt()));
+                writeFloat(output, static_cast<float>(vertexUVObject[rapidjson::SizeType(0)].GetInt()));
+                writeFloat(output, static_cast<float>(vertexUVObject[rapidjson::SizeType(1)].GetInt()));
+            }
+        }
+    }
+}
+
+static void cookParticleDefinition(const scene::ParticleDefinition& definition, std::vector<uint8_t>& output)
+{
+    output.clear();
+    writeSignature(output, "OPAR");
+    writeUInt32(output, scene::ParticleDefinition::COOKED_VERSION);
+
+    writeUInt32(output, definition.blendFuncSource);
+    writeUInt32(output, definition.blendFuncDestination);
+    writeUInt32(output, static_cast<uint32_t>(definition.emitterType));
+    writeUInt32(output, definition.maxParticles);
+    writeFloat(output, definition.duration);
+    writeFloat(output, definition.particleLifespan);
+    writeFloat(output, definition.particleLifespanVariance);
+
+    writeFloat(output, definition.speed);
+    writeFloat(output, definition.speedVariance);
+
+    writeFloat(output, definition.sourcePosition.x);
+    writeFloat(output, definition.sourcePosition.y);
+    writeFloat(output, definition.sourcePositionVariance.x);
+    writeFloat(output, definition.sourcePositionVariance.y);
+
+    writeUInt32(output, static_cast<uint32_t>(definition.positionType));
+
+    writeFloat(output, definition.startParticleSize);
+    writeFloat(output, definition.startParticleSizeVariance);
+    writeFloat(output, definition.finishParticleSize);
+    writeFloat(output, definition.finishParticleSizeVariance);
+    writeFloat(output, definition.angle);
+    writeFloat(output, definition.angleVariance);
+    writeFloat(output, definition.startRotation);
+    writeFloat(output, definition.startRotationVariance);
+    writeFloat(output, definition.finishRotation);
+    writeFloat(output, definition.finishRotationVariance);
+    writeFloat(output, definition.rotatePerSecond);
+    writeFloat(output, definition.rotatePerSecondVariance);
+    writeFloat(output, definition.minRadius);
+    writeFloat(output, definition.minRadiusVariance);
+    writeFloat(output, definition.maxRadius);
+    writeFloat(output, definition.maxRadiusVariance);
+
+    writeFloat(output, definition.radialAcceleration);
+    writeFloat(output, definition.radialAccelVariance);
+    writeFloat(output, definition.tangentialAcceleration);
+    writeFloat(output, definition.tangentialAccelVariance);
+
+    uint32_t flags = 0;
+    if (definition.absolutePosition) flags |= scene::ParticleDefinition::COOKED_ABSOLUTE_POSITION;
+    if (definition.yCoordFlipped) flags |= scene::ParticleDefinition::COOKED_Y_COORD_FLIPPED;
+    if (definition.rotationIsDir) flags |= scene::ParticleDefinition::COOKED_ROTATION_IS_DIR;
+    writeUInt32(output, flags);
+
+    writeFloat(output, definition.gravity.x);
+    writeFloat(output, definition.gravity.y);
+
+    writeFloat(output, definition.startColorRed);
+    writeFloat(output, definition.startColorGreen);
+    writeFloat(output, definition.startColorBlue);
+    writeFloat(output, definition.startColorAlpha);
+
+    writeFloat(output, definition.startColorRedVariance);
+    writeFloat(output, definition.startColorGreenVariance);
+    writeFloat(output, definition.startColorBlueVariance);
+    writeFloat(output, definition.startColorAlphaVariance);
+
+    writeFloat(output, definition.finishColorRed);
+    writeFloat(output, definition.finishColorGreen);
+    writeFloat(output, definition.finishColorBlue);
+    writeFloat(output, definition.finishColorAlpha);
+
+    writeFloat(output, definition.finishColorRedVariance);
+    writeFloat(output, definition.finishColorGreenVariance);
+    writeFloat(output, definition.finishColorBlueVariance);
+    writeFloat(output, definition.finishColorAlphaVariance);
+
+    writeFloat(output, definition.emissionRate);
+
+    writeString(output, definition.textureFilename);
+}
+
+static bool isImage(const std::string& filename)
+{
+    std::string extension = FileSystem::getExtensionPart(filename);
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+
+    return extension == "png" || extension == "jpg" || extension == "jpeg" || extension == "bmp" ||
+        extension == "tga" || extension == "gif" || extension == "psd";
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    int arg = 1;
+
+    for (; arg < argc && argv[arg][0] == '-'; ++arg)
+    {
+        if (strcmp(argv[arg], "-p") == 0) options.premultiplyAlpha = true;
+        else if (strcmp(argv[arg], "-n") == 0) options.compress = false;
+        else if (strcmp(argv[arg], "-b") == 0) options.mipMaps = false;
+        else if (strcmp(argv[arg], "-f") == 0 && arg + 1 < argc)
+        {
+            std::string format = argv[++arg];
+
+            if (format == "rgba8") options.pixelFormat = graphics::PixelFormat::RGBA8;
+            else if (format == "rgb565") options.pixelFormat = graphics::PixelFormat::RGB565;
+            else if (format == "rgba4444") options.pixelFormat = graphics::PixelFormat::RGBA4444;
+            else if (format == "a8") options.pixelFormat = graphics::PixelFormat::A8;
+            else
+            {
+                fprintf(stderr, "Unsupported pixel format %s\n", format.c_str());
+                return 1;
+            }
+        }
+        else break;
+    }
+
+    if (argc - arg != 2)
+    {
+        fprintf(stderr, "Usage: %s [-p] [-n] [-b] [-f format] directory output-directory\n", argv[0]);
+        return 1;
+    }
+
+    std::string directory = argv[arg];
+    std::string outputDirectory = argv[arg + 1];
+
+    // the loaders of the engine read the files through the file system of the application
+    Application application;
+
+    std::vector<std::string> files;
+
+    if (!listFiles(directory, "", files))
+    {
+        return 1;
+    }
+
+    uint32_t textureCount = 0;
+    uint32_t spriteSheetCount = 0;
+    uint32_t particleDefinitionCount = 0;
+    uint32_t copiedCount = 0;
+
+    for (const std::string& file : files)
+    {
+        std::string path = directory + "/" + file;
+        std::string outputPath = outputDirectory + "/" + file;
+
+        std::vector<uint8_t> data;
+        std::vector<uint8_t> output;
+
+        if (!readFile(path, data) || !createDirectories(FileSystem::getDirectoryPart(outputPath)))
+        {
+            return 1;
+        }
+
+        if (isImage(file))
+        {
+            if (!cookTexture(data, options, output))
+            {
+                fprintf(stderr, "Failed to cook %s\n", path.c_str());
+                return 1;
+            }
+
+            ++textureCount;
+        }
+        else if (FileSystem::getExtensionPart(file) == "json")
+        {
+            rapidjson::MemoryStream is(reinterpret_cast<const char*>(data.data()), data.size());
+
+            rapidjson::Document document;
+            document.ParseStream<0>(is);
+
+            if (!document.HasParseError() && document.IsObject() &&
+                document.HasMember("frames") && document["frames"].IsArray() &&
+                document.HasMember("meta") && document["meta"].HasMember("image"))
+            {
+                cookSpriteFrames(document, output);
+                ++spriteSheetCount;
+            }
+            else if (!document.HasParseError() && document.IsObject() && document.HasMember("maxParticles"))
+            {
+                std::string absolutePath = path;
+
+                if (!FileSystem::isAbsolutePath(absolutePath))
+                {
+                    char buffer[1024];
+                    absolutePath = std::string(getcwd(buffer, sizeof(buffer)) ? buffer : "") + "/" + path;
+                }
+
+                cookParticleDefinition(*scene::ParticleDefinition::loadParticleDefinition(absolutePath), output);
+                ++particleDefinitionCount;
+            }
+            else
+            {
+                output.swap(data);
+                ++copiedCount;
+            }
+        }
+        else
+        {
+            output.swap(data);
+            ++copiedCount;
+        }
+
+        if (!writeFile(outputPath, output))
+        {
+            return 1;
+        }
+    }
+
+    printf("Cooked %u textures, %u sprite sheets and %u particle definitions, copied %u files to %s\n",
+           textureCount, spriteSheetCount, particleDefinitionCount, copiedCount, outputDirectory.c_str());
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+// Measures the culling of node bounding boxes against the view bounds of a camera, testing every box separately
+// (as the layer did before) and in batches of coordinate arrays (as the layer does now).
+// Usage: cullbench [box-count] [iterations]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "math/AABB2.h"
+#include "scene/Camera.h"
+
+using namespace ouzel;
+
+int main(int argc, char* argv[])
+{
+    uint32_t count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 100000;
+    uint32_t iterations = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 100;
+
+    if (count == 0 || iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [box-count] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // the camera has an identity projection, so the view bounds are from -1 to 1, the boxes are spread over an area
+    // four times as large in each direction, so about a sixteenth of them are visible
+    scene::Camera camera;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> position(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> size(0.01f, 0.1f);
+
+    std::vector<AABB2> boxes(count);
+    std::vector<float> minX(count);
+    std::vector<float> minY(count);
+    std::vector<float> maxX(count);
+    std::vector<float> maxY(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Vector2 min(position(generator), position(generator));
+        Vector2 max(min.x + size(generator), min.y + size(generator));
+
+        boxes[i].set(min, max);
+        minX[i] = min.x;
+        minY[i] = min.y;
+        maxX[i] = max.x;
+        maxY[i] = max.y;
+    }
+
+    std::vector<uint32_t> singleMask((count + 31) / 32);
+    std::vector<uint32_t> batchMask((count + 31) / 32);
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        std::fill(singleMask.begin(), singleMask.end(), 0);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (camera.checkVisibility(boxes[i]))
+            {
+                singleMask[i / 32] |= 1u << (i % 32);
+            }
+        }
+    }
+
+    auto singleTime = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        camera.checkVisibility(minX.data(), minY.data(), maxX.data(), maxY.data(), count, batchMask.data());
+    }
+
+    auto batchTime = std::chrono::steady_clock::now() - start;
+
+    if (singleMask != batchMask)
+    {
+        fprintf(stderr, "Batched culling results differ from the single box results\n");
+        return EXIT_FAILURE;
+    }
+
+    uint32_t visible = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (batchMask[i / 32] & (1u << (i % 32))) ++visible;
+    }
+
+    double singleMs = std::chrono::duration<double, std::milli>(singleTime).count() / iterations;
+    double batchMs = std::chrono::duration<double, std::milli>(batchTime).count() / iterations;
+
+    printf("%u boxes, %u visible, %u iterations\n", count, visible, iterations);
+    printf("single: %.3f ms per pass\n", singleMs);
+    printf("batch:  %.3f ms per pass (%.1fx)\n", batchMs, singleMs / batchMs);
+
+    return EXIT_SUCCESS;
+}
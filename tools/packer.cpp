@@ -0,0 +1,252 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+// Packs the files of a directory into a .pak archive, that can be mounted with FileSystem::addResourcePath.
+// Usage: packer [-n] output.pak directory
+//   -n  store all the files uncompressed
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "files/Archive.h"
+#include "utils/Compression.h"
+
+using namespace ouzel;
+
+struct File
+{
+    std::string name;
+    std::string path;
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t originalSize;
+    Archive::Compression compression;
+    std::vector<uint8_t> data;
+};
+
+static bool listFiles(const std::string& directory, const std::string& prefix, std::vector<File>& files)
+{
+    DIR* dir = opendir(directory.c_str());
+
+    if (!dir)
+    {
+        fprintf(stderr, "Failed to open directory %s\n", directory.c_str());
+        return false;
+    }
+
+    while (dirent* ent = readdir(dir))
+    {
+        std::string name = ent->d_name;
+
+        if (name == "." || name == "..")
+        {
+            continue;
+        }
+
+        std::string path = directory + "/" + name;
+        struct stat buf;
+
+        if (stat(path.c_str(), &buf) != 0)
+        {
+            continue;
+        }
+
+        if ((buf.st_mode & S_IFMT) == S_IFDIR)
+        {
+            if (!listFiles(path, prefix + name + "/", files))
+            {
+                closedir(dir);
+                return false;
+            }
+        }
+        else if ((buf.st_mode & S_IFMT) == S_IFREG)
+        {
+            File file;
+            file.name = prefix + name;
+            file.path = path;
+            files.push_back(file);
+        }
+    }
+
+    closedir(dir);
+
+    return true;
+}
+
+static void writeUInt16(std::vector<uint8_t>& buffer, uint16_t value)
+{
+    buffer.push_back(static_cast<uint8_t>(value));
+    buffer.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void writeUInt32(std::vector<uint8_t>& buffer, uint32_t value)
+{
+    writeUInt16(buffer, static_cast<uint16_t>(value));
+    writeUInt16(buffer, static_cast<uint16_t>(value >> 16));
+}
+
+static void writeUInt64(std::vector<uint8_t>& buffer, uint64_t value)
+{
+    writeUInt32(buffer, static_cast<uint32_t>(value));
+    writeUInt32(buffer, static_cast<uint32_t>(value >> 32));
+}
+
+static uint64_t align(uint64_t offset)
+{
+    return (offset + Archive::ALIGNMENT - 1) / Archive::ALIGNMENT * Archive::ALIGNMENT;
+}
+
+int main(int argc, char* argv[])
+{
+    bool compress = true;
+    int arg = 1;
+
+    if (arg < argc && strcmp(argv[arg], "-n") == 0)
+    {
+        compress = false;
+        ++arg;
+    }
+
+    if (argc - arg != 2)
+    {
+        fprintf(stderr, "Usage: %s [-n] output.pak directory\n", argv[0]);
+        return 1;
+    }
+
+    std::string output = argv[arg];
+    std::string directory = argv[arg + 1];
+
+    std::vector<File> files;
+
+    if (!listFiles(directory, "", files))
+    {
+        return 1;
+    }
+
+    // sorted the same way the archive looks them up
+    for (File& file : files)
+    {
+        file.hash = Archive::hash(file.name);
+    }
+
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) {
+        return a.hash < b.hash || (a.hash == b.hash && a.name < b.name);
+    });
+
+    std::vector<uint8_t> names;
+    uint64_t offset = 0;
+
+    for (File& file : files)
+    {
+        std::ifstream stream(file.path, std::ios::binary | std::ios::ate);
+        std::streamoff size = stream.tellg();
+
+        if (!stream || size < 0 || size > 0xFFFFFFFF || file.name.size() > 0xFFFF)
+        {
+            fprintf(stderr, "Failed to read %s\n", file.path.c_str());
+            return 1;
+        }
+
+        std::vector<uint8_t> data(static_cast<size_t>(size));
+        stream.seekg(0, std::ios::beg);
+
+        if (!data.empty() && !stream.read(reinterpret_cast<char*>(data.data()), size))
+        {
+            fprintf(stderr, "Failed to read %s\n", file.path.c_str());
+            return 1;
+        }
+
+        file.originalSize = static_cast<uint32_t>(data.size());
+        file.compression = Archive::COMPRESSION_NONE;
+
+        if (compress)
+        {
+            std::vector<uint8_t> compressed;
+            compressLZ4(data.data(), data.size(), compressed);
+
+            // files that do not get at least 10% smaller (e.g. already compressed images) are stored
+            if (compressed.size() < data.size() - data.size() / 10)
+            {
+                data.swap(compressed);
+                file.compression = Archive::COMPRESSION_LZ4;
+            }
+        }
+
+        file.data.swap(data);
+        file.offset = offset;
+        offset = align(offset + file.data.size());
+    }
+
+    std::vector<uint8_t> header;
+    header.push_back('O');
+    header.push_back('P');
+    header.push_back('A');
+    header.push_back('K');
+    writeUInt32(header, Archive::VERSION);
+    writeUInt32(header, static_cast<uint32_t>(files.size()));
+
+    for (const File& file : files)
+    {
+        names.insert(names.end(), file.name.begin(), file.name.end());
+    }
+
+    writeUInt32(header, static_cast<uint32_t>(names.size()));
+
+    // the data starts after the table of contents
+    uint64_t dataOffset = align(Archive::HEADER_SIZE + files.size() * Archive::ENTRY_SIZE + names.size());
+    uint32_t nameOffset = 0;
+
+    for (const File& file : files)
+    {
+        writeUInt64(header, file.hash);
+        writeUInt64(header, dataOffset + file.offset);
+        writeUInt32(header, static_cast<uint32_t>(file.data.size()));
+        writeUInt32(header, file.originalSize);
+        writeUInt32(header, nameOffset);
+        writeUInt16(header, static_cast<uint16_t>(file.name.size()));
+        header.push_back(static_cast<uint8_t>(file.compression));
+        header.push_back(0);
+
+        nameOffset += static_cast<uint32_t>(file.name.size());
+    }
+
+    header.insert(header.end(), names.begin(), names.end());
+    header.resize(static_cast<size_t>(dataOffset), 0);
+
+    std::ofstream stream(output, std::ios::binary | std::ios::trunc);
+
+    if (!stream.write(reinterpret_cast<const char*>(header.data()), header.size()))
+    {
+        fprintf(stderr, "Failed to write %s\n", output.c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> padding(Archive::ALIGNMENT, 0);
+    uint64_t storedSize = 0;
+    uint64_t originalSize = 0;
+
+    for (const File& file : files)
+    {
+        uint64_t paddingSize = align(file.data.size()) - file.data.size();
+
+        if (!stream.write(reinterpret_cast<const char*>(file.data.data()), file.data.size()) ||
+            (&file != &files.back() && !stream.write(reinterpret_cast<const char*>(padding.data()), paddingSize)))
+        {
+            fprintf(stderr, "Failed to write %s\n", output.c_str());
+            return 1;
+        }
+
+        storedSize += file.data.size();
+        originalSize += file.originalSize;
+    }
+
+    printf("Packed %u files, %llu bytes (%llu uncompressed) to %s\n", static_cast<uint32_t>(files.size()),
+           static_cast<unsigned long long>(storedSize), static_cast<unsigned long long>(originalSize), output.c_str());
+
+    return 0;
+}
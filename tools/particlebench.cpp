@@ -0,0 +1,313 @@
+// Copyright (C) 2016 Elviss Strazdins
+// This file is part of the Ouzel engine.
+
+// Measures the particle simulation, updating an array of particle structures one particle at a time (as the particle
+// system did before) and updating the particle arrays with the kernels of the particle system, that process four
+// particles at a time. The results of the kernels are compared with the scalar results.
+// Usage: particlebench [particle-count] [iterations]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "math/MathUtils.h"
+#include "scene/ParticleSystem.h"
+
+using namespace ouzel;
+
+static const float DELTA = 1.0f / 60.0f;
+
+struct Particle
+{
+    float life = 0.0f;
+
+    Vector2 position;
+
+    float colorRed = 0.0f;
+    float colorGreen = 0.0f;
+    float colorBlue = 0.0f;
+    float colorAlpha = 0.0f;
+
+    float deltaColorRed = 0.0f;
+    float deltaColorGreen = 0.0f;
+    float deltaColorBlue = 0.0f;
+    float deltaColorAlpha = 0.0f;
+
+    float size = 0.0f;
+    float deltaSize = 0.0f;
+
+    float rotation = 0.0f;
+    float deltaRotation = 0.0f;
+
+    float radialAcceleration = 0.0f;
+    float tangentialAcceleration = 0.0f;
+
+    Vector2 direction;
+    float angle = 0.0f;
+    float radius = 0.0f;
+    float degreesPerSecond = 0.0f;
+    float deltaRadius = 0.0f;
+};
+
+template<class T>
+static double measure(uint32_t iterations, T function)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration)
+    {
+        function();
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+static void updateParticles(std::vector<Particle>& particles, const scene::ParticleDefinition& particleDefinition, float delta)
+{
+    for (Particle& particle : particles)
+    {
+        particle.life -= delta;
+
+        if (particleDefinition.emitterType == scene::ParticleDefinition::EmitterType::GRAVITY)
+        {
+            Vector2 radial;
+
+            if (particle.position.x != 0.0f || particle.position.y != 0.0f)
+            {
+                radial = particle.position;
+                radial.normalize();
+            }
+
+            // (gravity + radial + tangential) * delta
+            float accelerationX = particleDefinition.gravity.x + radial.x * particle.radialAcceleration - radial.y * particle.tangentialAcceleration;
+            float accelerationY = particleDefinition.gravity.y + radial.y * particle.radialAcceleration + radial.x * particle.tangentialAcceleration;
+
+            particle.direction.x += accelerationX * delta;
+            particle.direction.y += accelerationY * delta;
+
+            particle.position.x += particle.direction.x * delta * particleDefinition.yCoordFlipped;
+            particle.position.y += particle.direction.y * delta * particleDefinition.yCoordFlipped;
+        }
+        else
+        {
+            particle.angle += particle.degreesPerSecond * delta;
+            particle.radius += particle.deltaRadius * delta;
+            particle.position.x = -cosf(particle.angle) * particle.radius;
+            particle.position.y = -sinf(particle.angle) * particle.radius * particleDefinition.yCoordFlipped;
+        }
+
+        particle.colorRed += particle.deltaColorRed * delta;
+        particle.colorGreen += particle.deltaColorGreen * delta;
+        particle.colorBlue += particle.deltaColorBlue * delta;
+        particle.colorAlpha += particle.deltaColorAlpha * delta;
+
+        particle.size = std::max(0.0f, particle.size + particle.deltaSize * delta);
+
+        particle.rotation += particle.deltaRotation * delta;
+    }
+}
+
+static void expandQuads(const std::vector<Particle>& particles, std::vector<graphics::VertexPCT>& vertices)
+{
+    for (size_t i = 0; i < particles.size(); ++i)
+    {
+        const Particle& particle = particles[i];
+
+        float size_2 = particle.size / 2.0f;
+        Vector2 v1(-size_2, -size_2);
+        Vector2 v2(size_2, size_2);
+
+        float r = -degToRad(particle.rotation);
+        float cr = cosf(r);
+        float sr = sinf(r);
+
+        Vector2 a(v1.x * cr - v1.y * sr, v1.x * sr + v1.y * cr);
+        Vector2 b(v2.x * cr - v1.y * sr, v2.x * sr + v1.y * cr);
+        Vector2 c(v2.x * cr - v2.y * sr, v2.x * sr + v2.y * cr);
+        Vector2 d(v1.x * cr - v2.y * sr, v1.x * sr + v2.y * cr);
+
+        graphics::Color color(static_cast<uint8_t>(particle.colorRed * 255),
+                              static_cast<uint8_t>(particle.colorGreen * 255),
+                              static_cast<uint8_t>(particle.colorBlue * 255),
+                              static_cast<uint8_t>(particle.colorAlpha * 255));
+
+        vertices[i * 4 + 0].position = a + particle.position;
+        vertices[i * 4 + 0].color = color;
+
+        vertices[i * 4 + 1].position = b + particle.position;
+        vertices[i * 4 + 1].color = color;
+
+        vertices[i * 4 + 2].position = d + particle.position;
+        vertices[i * 4 + 2].color = color;
+
+        vertices[i * 4 + 3].position = c + particle.position;
+        vertices[i * 4 + 3].color = color;
+    }
+}
+
+// the sine approximation of the kernels has an absolute error below 0.001
+static bool isClose(float value, float reference, float scale)
+{
+    return fabsf(value - reference) <= 0.002f * scale + 0.001f * (1.0f + fabsf(reference));
+}
+
+static bool compareParticles(const std::vector<Particle>& reference, const scene::ParticleData& particles)
+{
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        if (!isClose(particles.positionX[i], reference[i].position.x, reference[i].radius) ||
+            !isClose(particles.positionY[i], reference[i].position.y, reference[i].radius) ||
+            !isClose(particles.colorAlpha[i], reference[i].colorAlpha, 0.0f) ||
+            !isClose(particles.size[i], reference[i].size, 0.0f) ||
+            !isClose(particles.rotation[i], reference[i].rotation, 0.0f))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool compareVertices(const std::vector<Particle>& reference,
+                            const std::vector<graphics::VertexPCT>& vertices,
+                            const std::vector<graphics::VertexPCT>& referenceVertices)
+{
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        // the corners carry the error of the rotation and of the particle position
+        float scale = reference[i / 4].size + reference[i / 4].radius;
+
+        if (!isClose(vertices[i].position.x, referenceVertices[i].position.x, scale) ||
+            !isClose(vertices[i].position.y, referenceVertices[i].position.y, scale) ||
+            std::abs(vertices[i].color.a - referenceVertices[i].color.a) > 1)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t count = (argc > 1) ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 100000;
+    uint32_t iterations = (argc > 2) ? static_cast<uint32_t>(strtoul(argv[2], nullptr, 10)) : 100;
+
+    if (count == 0 || iterations == 0)
+    {
+        fprintf(stderr, "Usage: %s [particle-count] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 generator(1);
+    auto random = [&generator](float min, float max) {
+        return std::uniform_real_distribution<float>(min, max)(generator);
+    };
+
+    std::vector<Particle> initialParticles(count);
+
+    for (Particle& particle : initialParticles)
+    {
+        // long enough to live through all of the iterations
+        particle.life = 1000000.0f;
+        particle.position = Vector2(random(-100.0f, 100.0f), random(-100.0f, 100.0f));
+        particle.colorRed = random(0.2f, 0.8f);
+        particle.colorGreen = random(0.2f, 0.8f);
+        particle.colorBlue = random(0.2f, 0.8f);
+        particle.colorAlpha = random(0.2f, 0.8f);
+        particle.deltaColorRed = random(-0.1f, 0.1f);
+        particle.deltaColorGreen = random(-0.1f, 0.1f);
+        particle.deltaColorBlue = random(-0.1f, 0.1f);
+        particle.deltaColorAlpha = random(-0.1f, 0.1f);
+        particle.size = random(1.0f, 32.0f);
+        particle.deltaSize = random(-1.0f, 1.0f);
+        particle.rotation = random(0.0f, 360.0f);
+        particle.deltaRotation = random(-90.0f, 90.0f);
+        particle.radialAcceleration = random(-10.0f, 10.0f);
+        particle.tangentialAcceleration = random(-10.0f, 10.0f);
+        particle.direction = Vector2(random(-50.0f, 50.0f), random(-50.0f, 50.0f));
+        particle.angle = random(0.0f, 2.0f * PI);
+        particle.radius = random(10.0f, 200.0f);
+        particle.degreesPerSecond = random(-2.0f, 2.0f);
+        particle.deltaRadius = random(-5.0f, 5.0f);
+    }
+
+    std::vector<graphics::VertexPCT> vertices(count * 4);
+    std::vector<graphics::VertexPCT> referenceVertices(count * 4);
+    bool failed = false;
+
+    printf("%u particles, %u iterations, ms per pass (scalar ms):\n", count, iterations);
+
+    for (scene::ParticleDefinition::EmitterType emitterType : { scene::ParticleDefinition::EmitterType::GRAVITY,
+                                                                 scene::ParticleDefinition::EmitterType::RADIUS })
+    {
+        scene::ParticleDefinition particleDefinition;
+        particleDefinition.emitterType = emitterType;
+        particleDefinition.gravity = Vector2(0.0f, -100.0f);
+
+        std::vector<Particle> reference = initialParticles;
+        scene::ParticleData particles;
+        particles.resize(count);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const Particle& particle = reference[i];
+
+            particles.life[i] = particle.life;
+            particles.positionX[i] = particle.position.x;
+            particles.positionY[i] = particle.position.y;
+            particles.colorRed[i] = particle.colorRed;
+            particles.colorGreen[i] = particle.colorGreen;
+            particles.colorBlue[i] = particle.colorBlue;
+            particles.colorAlpha[i] = particle.colorAlpha;
+            particles.deltaColorRed[i] = particle.deltaColorRed;
+            particles.deltaColorGreen[i] = particle.deltaColorGreen;
+            particles.deltaColorBlue[i] = particle.deltaColorBlue;
+            particles.deltaColorAlpha[i] = particle.deltaColorAlpha;
+            particles.size[i] = particle.size;
+            particles.deltaSize[i] = particle.deltaSize;
+            particles.rotation[i] = particle.rotation;
+            particles.deltaRotation[i] = particle.deltaRotation;
+            particles.radialAcceleration[i] = particle.radialAcceleration;
+            particles.tangentialAcceleration[i] = particle.tangentialAcceleration;
+            particles.directionX[i] = particle.direction.x;
+            particles.directionY[i] = particle.direction.y;
+            particles.angle[i] = particle.angle;
+            particles.degreesPerSecond[i] = particle.degreesPerSecond;
+            particles.radius[i] = particle.radius;
+            particles.deltaRadius[i] = particle.deltaRadius;
+        }
+
+        double time = measure(iterations, [&]() {
+            scene::integrateParticleData(particles, particleDefinition, 0, count, DELTA);
+        });
+        double scalarTime = measure(iterations, [&]() {
+            updateParticles(reference, particleDefinition, DELTA);
+        });
+        failed |= !compareParticles(reference, particles);
+
+        const char* name = (emitterType == scene::ParticleDefinition::EmitterType::GRAVITY) ? "gravity" : "radius";
+        printf("  %s update: %.3f (%.3f)\n", name, time, scalarTime);
+
+        time = measure(iterations, [&]() {
+            scene::expandParticleQuads(particles, 0, count, Vector2(), vertices.data());
+        });
+        scalarTime = measure(iterations, [&]() {
+            expandQuads(reference, referenceVertices);
+        });
+        failed |= !compareVertices(reference, vertices, referenceVertices);
+
+        printf("  %s quads:  %.3f (%.3f)\n", name, time, scalarTime);
+    }
+
+    if (failed)
+    {
+        fprintf(stderr, "Particles updated by the kernels differ from the scalar results\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}